@@ -338,11 +338,10 @@ class AsignacionesService {
       const usadas = asignacionesConservadas.filter(
         (a) => a.medicoId === medico.id
       ).length;
-      // Asumimos que maxGuardiasTotales es el límite relevante para la reparación global
-      // Si se desea usar maxGuardiasPorPeriodo, habría que calcularlo por periodo,
-      // pero el core actualmente maneja capacidades globales en 'capacidades'.
-      // Para reparación precisa por periodo, el core debería recibir capacidades por periodo o manejarlo internamente.
-      // Por ahora mantenemos la lógica original que usaba el total.
+      // Asumimos que maxGuardiasTotales es el límite relevante para la reparación global.
+      // El core acepta también 'capacidadesPorPeriodo' (vía prepareInput) para
+      // limitar por periodo en una sola pasada; la reparación mantiene por ahora
+      // la lógica original que usa solo el total.
       const restante = Math.max(0, config.maxGuardiasTotales - usadas);
       capacidadesPersonales[medico.nombre] = restante;
     }
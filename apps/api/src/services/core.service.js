@@ -19,6 +19,15 @@ class CoreService {
    *   maxGuardiasTotales: number,
    *   medicosPorDia: number,
    *   capacidades?: { "Dr A": number } // Opcional
+   *   capacidadesPorPeriodo?: { "Dr A": { "Periodo 1": number } } // Opcional
+   *   asignacionesFijas?: { "Dr A": ["2024-01-01"] } // Opcional, pares que se conservan
+   *   asignacionesPrevias?: { "Dr A": ["2024-01-01"] } // Opcional, plan previo a cambiar lo menos posible
+   *   prioridadDias?: { "2024-12-25": 10 } // Opcional, días a cubrir primero
+   *   roles?: { "Dr A": "cirujano" } // Opcional, un rol por médico
+   *   demandaPorRol?: { "2024-01-01": { "cirujano": 1 } } // Opcional, médicos por rol y día
+   *   demandaPorTurno?: { "2024-12-25": { "dia": 2, "noche": 1 } } // Opcional, médicos por turno y día
+   *   disponibilidadPorTurno?: { "Dr A": { "2024-12-25": ["noche"] } } // Opcional, turnos posibles
+   *   sesion?: 42 // Opcional, versión de plan: en modo residente el core la mantiene en memoria
    * }
    */
   prepareInput(medicos, periodos, config, extraOptions = {}) {
@@ -63,25 +72,68 @@ class CoreService {
       inputData.capacidades = extraOptions.capacidades;
     }
 
+    if (extraOptions.capacidadesPorPeriodo) {
+      inputData.capacidadesPorPeriodo = extraOptions.capacidadesPorPeriodo;
+    }
+
+    if (extraOptions.asignacionesFijas) {
+      inputData.asignacionesFijas = extraOptions.asignacionesFijas;
+    }
+
+    if (extraOptions.asignacionesPrevias) {
+      inputData.asignacionesPrevias = extraOptions.asignacionesPrevias;
+    }
+
+    if (extraOptions.prioridadDias) {
+      inputData.prioridadDias = extraOptions.prioridadDias;
+    }
+
+    if (extraOptions.roles) {
+      inputData.roles = extraOptions.roles;
+    }
+
+    if (extraOptions.demandaPorRol) {
+      inputData.demandaPorRol = extraOptions.demandaPorRol;
+    }
+
+    if (extraOptions.demandaPorTurno) {
+      inputData.demandaPorTurno = extraOptions.demandaPorTurno;
+    }
+
+    if (extraOptions.disponibilidadPorTurno) {
+      inputData.disponibilidadPorTurno = extraOptions.disponibilidadPorTurno;
+    }
+
+    if (extraOptions.sesion !== undefined) {
+      inputData.sesion = extraOptions.sesion;
+    }
+
     return inputData;
   }
 
   /**
    * Ejecuta el core C++ con los datos de entrada.
+   * `args` son opciones de línea de comandos del core (p. ej. ['--sensitivity']).
    *
    * @returns {Promise<object>} JSON response:
    * {
    *   factible: boolean,
    *   asignaciones: [ { dia: "2024-01-01", medico: "Dr A" } ],
    *   bottlenecks?: [ { id: string, razon: string, tipo: string } ] // Si factible es false
+   *   parcial?: true // Se agotó el plazo: mejor cobertura alcanzada, sin bottlenecks
    * }
    */
-  async runSolver(inputData) {
+  async runSolver(inputData, args = []) {
     const TIMEOUT_MS = 30000; // 30 segundos de timeout
+    // El core corta antes y devuelve su mejor resultado parcial
+    const DEADLINE_MS = TIMEOUT_MS - 2000;
 
     return new Promise((resolve, reject) => {
       const inputJson = JSON.stringify(inputData);
-      const process = spawn(CORE_PATH);
+      const process = spawn(CORE_PATH, [
+        `--deadline-ms=${DEADLINE_MS}`,
+        ...args,
+      ]);
 
       let stdout = '';
       let stderr = '';
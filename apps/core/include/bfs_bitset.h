@@ -0,0 +1,68 @@
+#ifndef BFS_BITSET_H
+#define BFS_BITSET_H
+
+#include "graph.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * BfsBitset: Breadth-first search over the arcs with positive capacity of a
+ * graph of any capacity width, using its arc bitsets
+ * (GraphBase::getSalientes / getEntrantes)
+ *
+ * The search is level-synchronous and picks a direction per level:
+ * - Top-down: each frontier vertex ORs in its out-row, 64 heads per word,
+ *   masked by the visited set.
+ * - Bottom-up: each unvisited vertex ANDs its in-row with the frontier
+ *   bitset to find a parent. Cheaper once fewer vertices are left unvisited
+ *   than the frontier holds, which is the common case when the frontier
+ *   reaches the large day layer.
+ *
+ * Rows are read through their summaries (GraphBase::getResumenSalientes),
+ * so only the words that hold arcs are touched: a numbering that keeps each
+ * vertex's neighbours close together makes every step cheaper.
+ *
+ * camino() keeps the exact result of a FIFO queue BFS that scans neighbours
+ * in ascending order (the parent of a vertex is the earliest-queued frontier
+ * vertex with an arc to it), so augmenting paths, and hence solutions, do
+ * not depend on the direction chosen. alcanzables() only needs the set and
+ * takes the first parent it finds.
+ *
+ * Buffers are reused across searches. Not synchronized.
+ */
+class BfsBitset {
+private:
+  std::vector<uint64_t> visitados_; // Bits past the last vertex stay set
+  std::vector<uint64_t> frontera_;  // Current level, for bottom-up steps
+  std::vector<int> cola_;           // Visited vertices in FIFO order
+  std::vector<int> posicion_;       // Index in cola_ of each visited vertex
+  std::vector<std::pair<int, int>> nuevos_; // Bottom-up: (parent pos, v)
+  int nivelesAbajoArriba_ = 0;
+  long long palabrasLeidas_ = 0;
+
+  // Search from `source`; stops once `sink` is reached (-1 = never).
+  // parent may be null; exacto = parent is the FIFO one.
+  bool buscar(const GraphBase &g, int source, int sink, int *parent,
+              bool exacto);
+
+public:
+  /**
+   * Shortest path from source to sink; parent[v] is set for the vertices on
+   * it (parent[source] = -1). parent must have one entry per vertex.
+   * @return true if the sink was reached
+   */
+  bool camino(const GraphBase &g, int source, int sink,
+              std::vector<int> &parent);
+
+  // Vertices reachable from source (source first, then no particular order)
+  const std::vector<int> &alcanzables(const GraphBase &g, int source);
+
+  // Levels of the last search done bottom-up (for tests and tuning)
+  int getNivelesAbajoArriba() const { return nivelesAbajoArriba_; }
+
+  // Row words read by all searches so far, a proxy for their memory traffic
+  long long getPalabrasLeidas() const { return palabrasLeidas_; }
+};
+
+#endif
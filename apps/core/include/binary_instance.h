@@ -0,0 +1,57 @@
+#ifndef BINARY_INSTANCE_H
+#define BINARY_INSTANCE_H
+
+#include "instance.h"
+#include <cstddef>
+#include <string>
+
+/**
+ * BinaryInstance: Memory-mapped binary instance file (.bin)
+ *
+ * The file stores the arrays of an InstanceView back to back, so loading is
+ * an mmap plus bounds checks: nothing is parsed or copied and the view
+ * points straight into the mapping.
+ *
+ * Layout (native byte order, every section 8-byte aligned):
+ *   header    "MFBI", version, byte-order mark, counts, limits, #sections
+ *   sections  table of {id, offset, size}, then the section payloads:
+ *             string table, period day lists, availability bitsets,
+ *             per-doctor and per-day arrays, and optionally the sparse
+ *             per-period capacities, the locked assignments, the previous
+ *             plan, the day priorities, the roles and the shift slots
+ *
+ * Unknown section ids are ignored, so later versions can add sections
+ * without breaking older readers.
+ */
+class BinaryInstance {
+private:
+  void *data_;
+  size_t size_;
+  InstanceView view_;
+
+  void validar(); // Checks the mapping and fills view_
+
+public:
+  /**
+   * Maps a binary instance file
+   * @throws std::runtime_error if the file cannot be mapped or is malformed
+   */
+  explicit BinaryInstance(const std::string &filePath);
+  ~BinaryInstance();
+
+  BinaryInstance(const BinaryInstance &) = delete;
+  BinaryInstance &operator=(const BinaryInstance &) = delete;
+
+  const InstanceView &view() const { return view_; }
+
+  // True if the file starts with the binary instance magic
+  static bool esBinario(const std::string &filePath);
+
+  /**
+   * Writes an instance in binary format
+   * @throws std::runtime_error if the file cannot be written
+   */
+  static void write(const InstanceView &instance, const std::string &filePath);
+};
+
+#endif
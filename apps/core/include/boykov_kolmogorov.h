@@ -0,0 +1,179 @@
+#ifndef BOYKOV_KOLMOGOROV_H
+#define BOYKOV_KOLMOGOROV_H
+
+#include "maxflow_engine.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * BoykovKolmogorov: Max-flow engine that keeps its search trees between
+ * solves, for interactive edits (--engine=boykov-kolmogorov)
+ *
+ * Boykov-Kolmogorov grows two search trees in the residual network, S from
+ * the source and T from the sink, augments along the path found where they
+ * touch, and then re-attaches the nodes cut off by saturated tree arcs
+ * (orphans) to their tree, or frees them. The trees survive every
+ * augmentation, and here also every solve: maxFlowDesde takes the network
+ * with some capacities changed (e.g. one doctor's availability toggled) and
+ * repairs only what the changes touch, in the manner of Kohli and Torr's
+ * dynamic graph cuts:
+ * - An arc that gains residual capacity reactivates its tail if it is in S
+ *   and its head if it is in T, so the search looks past it again.
+ * - An arc whose capacity drops under its flow has the excess cancelled
+ *   along a flow path source -> tail and one head -> sink.
+ * - A tree arc left without residual capacity orphans its child.
+ * The growth/augment/adopt loop then resumes from the active nodes alone, so
+ * the work follows the size of the change rather than that of the network.
+ *
+ * Neighbours are read from the residual graph's arc bitsets (only their
+ * nonzero words, see GraphBase). The trees refer to the residual graph and
+ * flow matrix the last solve left: maxFlowDesde must get them back
+ * unchanged, with a network of the same size, source and sink, or it starts
+ * from zero. Like the other engines the result is a max flow, so coverage
+ * and bottlenecks are those of Edmonds-Karp; the flow itself depends on the
+ * edit history.
+ *
+ * The residual graph and flow matrix may be of any capacity width (see
+ * EdmondsKarp::maxFlow); the search code is instantiated once per width.
+ */
+class BoykovKolmogorov : public MaxFlowEngine {
+private:
+  static constexpr uint8_t LIBRE = 0;
+  static constexpr uint8_t ARBOL_S = 1;
+  static constexpr uint8_t ARBOL_T = 2;
+  static constexpr int RAIZ = -2;     // padre_ of the source and the sink
+  static constexpr int HUERFANO = -1; // padre_ of an orphan or a free node
+
+  int n_;
+  int source_;
+  int sink_;
+  std::vector<uint8_t> arbol_;
+  std::vector<int> padre_; // Tree parent (S: tail of the arc, T: head)
+
+  // Distance to the root known valid at time marca_ (adoption heuristic)
+  std::vector<int> marca_;
+  std::vector<int> distancia_;
+  int tiempo_;
+
+  std::deque<int> activos_;
+  std::vector<uint8_t> activo_;
+  std::deque<int> huerfanos_;
+
+  // Search along flow paths when cancelling an excess
+  std::vector<int> previo_;
+  std::vector<int> visita_;
+  std::vector<int> cola_;
+  int numVisita_;
+
+  // Residual graph and flow matrix of the current solve, of its width
+  std::tuple<GraphT<uint8_t> *, GraphT<uint16_t> *, Graph *> residuales_;
+  std::tuple<MatrizFlujo<uint8_t> *, MatrizFlujo<int32_t> *> flujos_;
+  Deadline deadline_;
+  bool interrumpido_;
+  bool reanudado_;
+  int arcosCambiados_;
+
+  template <typename Cap> GraphT<Cap> &grafo() {
+    return *std::get<GraphT<Cap> *>(residuales_);
+  }
+  template <typename Cap> MatrizFlujo<Cap> &flujo() {
+    return *std::get<MatrizFlujo<Cap> *>(flujos_);
+  }
+  template <typename Cap> int residual(int u, int v) {
+    return grafo<Cap>().getCapacity(u, v);
+  }
+  void activar(int v);
+  void huerfano(int v);
+
+  // Pushes f units along u -> v
+  template <typename Cap> void empujar(int u, int v, int f);
+
+  // Keeps the trees valid after the residual capacity of u -> v changed
+  template <typename Cap> void revisar(int u, int v);
+
+  // Length of q's path to its root, or -1 if it hangs from an orphan
+  int profundidad(int q);
+
+  // Scans the residual neighbours of active node p. On meeting the other
+  // tree returns true with the arc a -> b joining S to T.
+  template <typename Cap> bool crecer(int p, int &a, int &b);
+  template <typename Cap> int aumentar(int a, int b);
+  template <typename Cap> void adoptar();
+  template <typename Cap> bool bucle(); // false if the deadline expired
+
+  // Cancels `exceso` units of flow along flow paths from x back to the
+  // source (haciaSource) or on to the sink. False if no such path exists.
+  template <typename Cap> bool cancelar(int x, int exceso, bool haciaSource);
+
+  // Applies cap(u, v) += delta to the flow and the trees
+  template <typename Cap> bool cambiarCapacidad(int u, int v, int delta);
+
+  // Brings arc u -> v to its capacity in `graph`. False if its flow could
+  // not be cancelled.
+  template <typename Cap>
+  bool actualizarArco(const Graph &graph, int u, int v);
+
+  // maxFlowDesde over every arc, or only over `arcos` if given
+  template <typename Cap>
+  int reanudar(const Graph &graph, int source, int sink,
+               GraphT<Cap> &residualGraph, MatrizFlujo<Cap> &flowGraph,
+               const std::vector<std::pair<int, int>> *arcos);
+
+  template <typename Cap> int valor();
+
+public:
+  BoykovKolmogorov();
+
+  const char *nombre() const override { return "boykov-kolmogorov"; }
+
+  void setDeadline(const Deadline &deadline) override {
+    deadline_ = deadline;
+  }
+  bool interrumpido() const override { return interrumpido_; }
+
+  // Max flow from zero, with fresh trees
+  int maxFlow(const Graph &graph, int source, int sink, Graph &residualGraph,
+              std::vector<std::vector<int>> &flowGraph) override;
+
+  // Same, at width `Cap`
+  template <typename Cap>
+  int maxFlow(const Graph &graph, int source, int sink,
+              GraphT<Cap> &residualGraph, MatrizFlujo<Cap> &flowGraph);
+
+  /**
+   * Max flow of `graph` starting from the flow and trees of the previous
+   * solve, whose residualGraph and flowGraph must be passed back unchanged.
+   * The arcs whose capacity differs from that solve's network are found
+   * from the arc bitsets and repaired as described above; a network of
+   * another size, source or sink (or a flow that cannot be repaired)
+   * starts from zero instead (see getReanudado). A solve may resume at a
+   * wider width than the previous one, from its residual graph and flow
+   * copied over.
+   */
+  template <typename Cap>
+  int maxFlowDesde(const Graph &graph, int source, int sink,
+                   GraphT<Cap> &residualGraph, MatrizFlujo<Cap> &flowGraph);
+
+  // Same, when the caller knows the only arcs (u, v) whose capacity may
+  // have changed: just those are compared, so an edit costs its repair
+  // alone instead of a pass over every arc
+  template <typename Cap>
+  int maxFlowDesde(const Graph &graph, int source, int sink,
+                   GraphT<Cap> &residualGraph, MatrizFlujo<Cap> &flowGraph,
+                   const std::vector<std::pair<int, int>> &arcos);
+
+  // The last maxFlowDesde resumed from the previous solve
+  bool getReanudado() const { return reanudado_; }
+
+  // Arcs whose capacity the last maxFlowDesde found changed
+  int getArcosCambiados() const { return arcosCambiados_; }
+
+  // Bytes held by the trees and queues
+  std::size_t memoria() const;
+};
+
+#endif
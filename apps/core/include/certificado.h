@@ -0,0 +1,74 @@
+#ifndef CERTIFICADO_H
+#define CERTIFICADO_H
+
+#include "graph.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Certificado: Check that a solve returned a maximum flow (--verify)
+ *
+ * No flow is worth more than the capacity of any source-sink cut, so a flow
+ * whose value equals the capacity of some cut is maximum, and that cut is
+ * minimum. Given the network's arcs with their capacities and flows, the
+ * reported value and the source side of the cut the result was analysed
+ * with, this checks, in time linear in the arcs plus one pass over the arc
+ * bitsets:
+ * - cota <= flow <= capacity on every arc;
+ * - conservation at every node but the source and the sink;
+ * - the net flow out of the source, and into the sink, equals the value;
+ * - the cut separates source from sink and its capacity (arcs leaving the
+ *   source side at capacity, minus lower bounds of arcs entering it) equals
+ *   the value.
+ * It relies on nothing the engine computed besides those, so a wrong
+ * residual graph, search tree or shortcut shows up as a failed check, and
+ * the fastest engine can run with every result still confirmed optimal.
+ *
+ * Arcs are fed one by one (iniciar, arco, ..., cumple), which fits every
+ * network representation: the matrix ones go through verificar.
+ */
+class Certificado {
+private:
+  std::vector<int64_t> balance_; // Flow in minus flow out, per node
+  std::vector<uint8_t> ladoSource_;
+  int source_;
+  int sink_;
+  int valor_;
+  int64_t capacidadCorte_;
+  std::string error_; // First violation found
+
+  void fallo(const std::string &mensaje);
+
+public:
+  Certificado();
+
+  // Starts a check of a flow of `valor` on `numVertices` nodes, with the
+  // cut whose source side is `ladoSource`
+  void iniciar(int numVertices, int source, int sink, int valor,
+               const std::vector<int> &ladoSource);
+
+  // Adds the arc u -> v with its capacity, flow and lower bound
+  void arco(int u, int v, int capacidad, int flujo, int cota = 0);
+
+  // Finishes the check: true if every condition holds
+  bool cumple();
+
+  // Why the last check failed, "" if it did not
+  const std::string &getError() const { return error_; }
+
+  /**
+   * The whole check on a matrix network: the arcs of `graph` (read from its
+   * bitsets), their flows from the net flow matrix and the lower bounds in
+   * `cotas`. The flow of a pair with arcs both ways goes to the one it runs
+   * along; flow on a pair with no arc is only seen through the balances of
+   * the arcs around it. The matrix may be of any width (see MatrizFlujo).
+   */
+  template <typename F>
+  bool verificar(const Graph &graph,
+                 const std::vector<std::vector<F>> &flowGraph, int source,
+                 int sink, int valor, const std::vector<int> &ladoSource,
+                 const std::vector<CotaInferior> &cotas = {});
+};
+
+#endif
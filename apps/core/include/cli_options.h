@@ -0,0 +1,68 @@
+#ifndef CLI_OPTIONS_H
+#define CLI_OPTIONS_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Command line options of the solver binary
+ *
+ *   solver [opciones] [archivo.json | archivo.bin]
+ *
+ *   --resident          Read one JSON instance per line from stdin and answer
+ *                       each with one JSON line, until EOF
+ *   --stats             Append a "stats" object to every response
+ *   --sensitivity       Append the doctor-removal sensitivity table
+ *   --deadline-ms=N     Time budget per request, from when it is read; on
+ *                       expiry answer the best flow so far ("parcial": true)
+ *   --window=N          Rolling horizon: solve N periods at a time, carrying
+ *                       each doctor's remaining total limit forward
+ *   --window-repair     Finish a windowed solve with one global repair pass
+ *   --engine=NAME       Max-flow engine of plain solves: edmonds-karp
+ *                       (default), push-relabel (multi-threaded),
+ *                       implicit (no stored Doctor-Period -> Day arcs) or
+ *                       boykov-kolmogorov (resumes from the previous solve)
+ *   --renumber          Number the Doctor-Period nodes period-major, so the
+ *                       searches read fewer bitset words (same coverage and
+ *                       bottlenecks; the assignments may differ)
+ *   --verify            Check every solved result against its optimality
+ *                       certificate (linear time); a failed check is an
+ *                       error response
+ *   --threads=N         Threads of the parallel solver paths, counting the
+ *                       one serving requests (default 0 = one per core)
+ *   --trace=FILE        Write a timeline of the solver phases, one track per
+ *                       thread, to FILE on exit (Chrome Trace Event Format,
+ *                       for Perfetto or chrome://tracing)
+ *   --no-cache          Disable the result cache
+ *   --cache-dir=DIR     Also keep cached results as files in DIR
+ *   --cache-size=N      Max results kept in memory (default 256)
+ *   --session-memory-mb=N
+ *                       Memory cap of the plan-version sessions kept in
+ *                       resident mode (default 256, 0 = keep none)
+ */
+struct CliOptions {
+  std::string archivo; // Empty = read stdin
+  bool resident = false;
+  bool stats = false;
+  bool sensibilidad = false;
+  size_t deadlineMs = 0; // 0 = no deadline
+  size_t ventana = 0;    // Periods per window, 0 = solve all at once
+  bool repararVentanas = false;
+  std::string motor = "edmonds-karp";
+  bool renumerar = false;
+  bool verificar = false;
+  size_t hilos = 0;  // 0 = one per core
+  std::string traza; // --trace output file, "" = no trace
+  bool cache = true;
+  std::string cacheDir;
+  size_t cacheSize = 256;
+  size_t sesionesMb = 256;
+};
+
+/**
+ * Parses argv. Options accept both "--name=value" and "--name value".
+ * @throws std::invalid_argument on unknown options or bad values
+ */
+CliOptions parseCliOptions(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <chrono>
+
+/**
+ * Deadline: Optional time budget for anytime solving
+ *
+ * Solvers check it between augmentations; an expired deadline stops them
+ * with the (valid, possibly not maximum) flow found so far.
+ */
+class Deadline {
+public:
+  using Reloj = std::chrono::steady_clock;
+
+private:
+  bool activo_;
+  Reloj::time_point limite_;
+
+public:
+  Deadline() : activo_(false) {}
+  explicit Deadline(Reloj::time_point limite)
+      : activo_(true), limite_(limite) {}
+
+  bool activo() const { return activo_; }
+  bool vencido() const { return activo_ && Reloj::now() >= limite_; }
+};
+
+#endif
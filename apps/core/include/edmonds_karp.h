@@ -1,24 +1,174 @@
 #ifndef EDMONDS_KARP_H
 #define EDMONDS_KARP_H
 
+#include "bfs_bitset.h"
+#include "deadline.h"
 #include "graph.h"
+#include "maxflow_engine.h"
+#include <cstddef>
+#include <utility>
 #include <vector>
 
-class EdmondsKarp {
+class EdmondsKarp : public MaxFlowEngine {
 private:
+  // Search buffers, reused across calls to avoid per-BFS allocations
+  BfsBitset bfs_;
+  std::vector<bool> visited_;
+  std::vector<int> parent_;
+
+  Deadline deadline_;
+  bool interrumpido_; // The last solve stopped at the deadline
+
+  // An arc perdidaSinNodo() changed, as it was before: residual capacity
+  // of u -> v and v -> u, and flow u -> v
+  struct Cambio {
+    int u;
+    int v;
+    int residual;
+    int inverso;
+    int flujo;
+  };
+  std::vector<Cambio> cambios_; // Reused across calls
+
+  // Walk from `nodo` along arcs with positive flow, forward to `fin` or
+  // backward to it; appends the arcs to `camino` and returns their min flow
+  template <typename F>
+  int caminoConFlujo(const std::vector<std::vector<F>> &flow, int nodo,
+                     int fin, bool haciaAdelante,
+                     std::vector<std::pair<int, int>> &camino);
+
   // BFS to find augmenting path
-  bool bfs(const Graph &residualGraph, int source, int sink,
+  bool bfs(const GraphBase &residualGraph, int source, int sink,
            std::vector<int> &parent);
 
+  // Augment along shortest paths until none is left or the deadline
+  // expires; each arc is logged into `cambios` (if given) before it changes
+  template <typename Cap>
+  int augment(GraphT<Cap> &residualGraph, int source, int sink,
+              MatrizFlujo<Cap> &flowGraph,
+              std::vector<Cambio> *cambios = nullptr);
+
 public:
+  EdmondsKarp();
+
+  const char *nombre() const override { return "edmonds-karp"; }
+
+  // Time budget checked between augmentations by every solve below. A solve
+  // that runs out of time returns the flow found so far (see interrumpido()).
+  void setDeadline(const Deadline &deadline) override {
+    deadline_ = deadline;
+  }
+  bool interrumpido() const override { return interrumpido_; }
+
   // Version that also returns the graph with flow
   int maxFlowWithResult(Graph graph, int source, int sink,
                         std::vector<std::vector<int>> &flowGraph);
 
-  // Get reachable nodes in residual graph (for Min-Cut)
+  // Same as maxFlowWithResult, but writes the residual graph into a
+  // caller-owned buffer so repeated solves do not reallocate it
+  int maxFlow(const Graph &graph, int source, int sink, Graph &residualGraph,
+              std::vector<std::vector<int>> &flowGraph) override;
+
+  /**
+   * Same, with the residual graph stored as `Cap` (uint8_t, uint16_t or
+   * int32_t), which must hold cap(u, v) + cap(v, u) for every pair of
+   * `graph` (see GraphBuilder::getAnchoCapacidad), and the flow matrix in
+   * the matching MatrizFlujo. Augmenting paths, hence the flow, are the same
+   * at every width; narrower matrices are cheaper to fill, scan and copy.
+   * The solves below take the width the same way.
+   */
+  template <typename Cap>
+  int maxFlow(const Graph &graph, int source, int sink,
+              GraphT<Cap> &residualGraph, MatrizFlujo<Cap> &flowGraph);
+
+  /**
+   * Same as maxFlow, warm-started from the flow already in flowGraph (e.g.
+   * the last solve of a network with the same nodes and arcs whose
+   * capacities changed since). Flow above an arc's new capacity is cancelled
+   * path by path first, then the rest is augmented as usual, so the work is
+   * proportional to what the capacity changes moved. The flow must be
+   * acyclic (true for any flow of a layered network); a flowGraph of
+   * another size is ignored and the solve starts from zero.
+   */
+  template <typename Cap>
+  int maxFlowDesde(const Graph &graph, int source, int sink,
+                   GraphT<Cap> &residualGraph, MatrizFlujo<Cap> &flowGraph);
+
+  /**
+   * Max flow where some arcs must carry a minimum flow. Uses the standard
+   * reduction: each lower bound is subtracted from its arc and turned into a
+   * supply/demand, a sink -> source arc closes the circulation, and a flow
+   * from a super source to a super sink must meet every demand. The feasible
+   * flow found is then augmented from source to sink as usual.
+   *
+   * Arcs must not be antiparallel to a bounded arc. On return, flowGraph is
+   * the net flow including the bounds and residualGraph respects them (the
+   * reverse residual of a bounded arc is flow - cota). The circulation
+   * network holds more than `graph`'s capacities: pick the width with
+   * anchoConCotas.
+   *
+   * @return the max flow value, or -1 if no flow meets the bounds; then
+   *         `insatisfechas` lists the indices of the bounds whose supply or
+   *         demand could not be routed (it is empty if the deadline expired
+   *         before the bounds were met)
+   */
+  template <typename Cap>
+  int maxFlowConCotas(const Graph &graph, int source, int sink,
+                      const std::vector<CotaInferior> &cotas,
+                      GraphT<Cap> &residualGraph, MatrizFlujo<Cap> &flowGraph,
+                      std::vector<size_t> &insatisfechas);
+
+  // Narrowest width whose residual graphs hold maxFlowConCotas' circulation
+  // network for `graph` of width `ancho`: its sink -> source arc and supply
+  // arcs carry up to the capacity out of the source plus the bounds
+  static AnchoCapacidad anchoConCotas(const Graph &graph, int source,
+                                      const std::vector<CotaInferior> &cotas,
+                                      AnchoCapacidad ancho);
+
+  /**
+   * Flow lost if `nodo` is removed from a solved network, without solving it
+   * again: the flow through `nodo` is cancelled path by path, its arcs are
+   * closed, and only the missing flow is rerouted in the residual graph.
+   * The flow must be acyclic (true for any flow of a layered network).
+   *
+   * residualGraph and flowGraph are as left by maxFlow. The reroute works on
+   * them in place and every arc it touches is logged and put back before
+   * returning, so they end up unchanged and a call costs the reroute rather
+   * than a copy of the V x V matrices.
+   */
+  template <typename Cap>
+  int perdidaSinNodo(GraphT<Cap> &residualGraph, MatrizFlujo<Cap> &flowGraph,
+                     int source, int sink, int nodo);
+
+  /**
+   * Max flow that fills the arcs into the sink by class: all of them start
+   * closed, each class of nodes has its arcs to the sink opened in turn and
+   * the flow is augmented before the next class is opened. Arcs into the
+   * sink from nodes in no class are opened last.
+   *
+   * Augmenting paths end at the sink and never take flow back from a sink
+   * arc, so the flow into each class is the maximum possible given the
+   * classes before it. The final flow is a max flow of `graph`.
+   */
+  template <typename Cap>
+  int maxFlowPorClases(const Graph &graph, int source, int sink,
+                       const std::vector<std::vector<int>> &clases,
+                       GraphT<Cap> &residualGraph,
+                       MatrizFlujo<Cap> &flowGraph);
+
+  // Get reachable nodes in residual graph (for Min-Cut), computing the
+  // residual capacities from the flow on the fly
   std::vector<int>
   getReachableNodes(const Graph &graph,
                     const std::vector<std::vector<int>> &flowGraph, int source);
+
+  // Same, from a residual graph as left by maxFlow / maxFlowConCotas
+  // (bitset BFS, cheaper)
+  std::vector<int> getReachableResidual(const GraphBase &residualGraph,
+                                        int source);
+
+  // Bitset words read by this engine's searches so far (see BfsBitset)
+  long long getPalabrasLeidas() const { return bfs_.getPalabrasLeidas(); }
 };
 
 #endif
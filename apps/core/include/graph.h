@@ -1,30 +1,143 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
-class Graph {
+/**
+ * Lower bound on the flow of an arc (from -> to): at least `cota` units
+ */
+struct CotaInferior {
+  int from;
+  int to;
+  int cota;
+};
+
+/**
+ * Integer width of a network's capacity storage (see GraphT)
+ */
+enum class AnchoCapacidad { U8, U16, I32 };
+
+// Narrowest width whose residual capacities hold `capacidadMaxima` (the
+// largest capacity of a network without antiparallel arcs)
+AnchoCapacidad anchoParaCapacidad(int capacidadMaxima);
+
+/**
+ * GraphBase: Vertex count and the arcs with positive capacity as bitsets,
+ * shared by the graphs of every capacity width
+ *
+ * Row u of salientes = heads of u's arcs, row v of entrantes = tails of v's
+ * arcs, palabras 64-bit words per row. Kept in sync with the capacities by
+ * GraphT::setCapacity. Used by BfsBitset, which therefore does not depend on
+ * the capacity width.
+ *
+ * Each row also has a summary with one bit per word, set iff the word is not
+ * zero, so a search only reads the words of a row that hold arcs. How many
+ * those are depends on the vertex numbering (see
+ * GraphBuilder::setRenumerar).
+ */
+class GraphBase {
+protected:
+  int numVertices = 0;
+  int palabras;
+  int palabrasResumen; // Summary words per row
+  std::vector<uint64_t> salientes;
+  std::vector<uint64_t> entrantes;
+  std::vector<uint64_t> resumenSalientes;
+  std::vector<uint64_t> resumenEntrantes;
+
+  void resetArcos(int vertices);
+  void marcarArco(int from, int to, bool positivo);
+
+public:
+  int getNumVertices() const { return numVertices; }
+
+  // Arc bitsets (see above); vertex x is bit (x & 63) of word (x >> 6)
+  int getPalabras() const { return palabras; }
+  const uint64_t *getSalientes(int from) const {
+    return salientes.data() + std::size_t(from) * palabras;
+  }
+  const uint64_t *getEntrantes(int to) const {
+    return entrantes.data() + std::size_t(to) * palabras;
+  }
+
+  // Row summaries: bit w set iff word w of the row is not zero
+  int getPalabrasResumen() const { return palabrasResumen; }
+  const uint64_t *getResumenSalientes(int from) const {
+    return resumenSalientes.data() + std::size_t(from) * palabrasResumen;
+  }
+  const uint64_t *getResumenEntrantes(int to) const {
+    return resumenEntrantes.data() + std::size_t(to) * palabrasResumen;
+  }
+};
+
+/**
+ * GraphT: Adjacency matrix of capacities stored as `Cap` (uint8_t, uint16_t
+ * or int32_t; explicitly instantiated in graph.cpp)
+ *
+ * Capacities are passed and returned as int whatever the width. A narrow
+ * graph must only be given values that fit: as a residual graph, that is
+ * cap(u, v) + cap(v, u) of the network for every pair. Graph (int32_t) is
+ * what networks are built in; narrower residual graphs cut the memory
+ * traffic of the solves that copy and scan them (see EdmondsKarp::maxFlow).
+ */
+template <typename Cap> class GraphT : public GraphBase {
 private:
-  int numVertices;
-  // Adjacency matrix for capacities
-  // capacity[u][v] = capacity of edge u -> v
-  std::vector<std::vector<int>> capacity;
+  // capacity[u * numVertices + v] = capacity of edge u -> v
+  std::vector<Cap> capacity;
+  int capacidadMaxima; // Largest capacity set since the last reset
+  bool conNegativas = false; // Some capacity set below 0 since the reset
 
 public:
-  Graph(int vertices);
+  GraphT(int vertices);
+
+  // Resize to `vertices` and clear all capacities, reusing storage. At the
+  // same size only the entries of the current arcs are cleared, so
+  // rebuilding a network costs its arcs rather than V x V.
+  void reset(int vertices);
+
+  // Same capacities as `graph`, which may be of another width; only its
+  // arcs are read, not the whole matrix
+  template <typename Otra> void copiarDe(const GraphT<Otra> &graph);
 
   // Add edge with capacity
   void addEdge(int from, int to, int cap);
 
-  // Getters
-  int getNumVertices() const;
   int getCapacity(int from, int to) const;
+  int getCapacidadMaxima() const { return capacidadMaxima; }
 
   // Setters (for flow)
   void setCapacity(int from, int to, int cap);
 
+  // Bytes held by the capacity matrix and the bitsets
+  std::size_t memoria() const;
+
   // Utilities
   void printGraph() const;
 };
 
+using Graph = GraphT<int32_t>;
+
+extern template class GraphT<uint8_t>;
+extern template class GraphT<uint16_t>;
+extern template class GraphT<int32_t>;
+
+/**
+ * Element type of the flow matrix that goes with a residual graph stored as
+ * `Cap`: signed, since the matrix holds net flows (flow[v][u] =
+ * -flow[u][v]), and wide enough for any flow such a residual graph allows
+ */
+template <typename Cap> struct TipoFlujo {
+  using type = int32_t;
+};
+template <> struct TipoFlujo<uint8_t> {
+  using type = int16_t;
+};
+
+// Net flow matrix of a solve whose residual graph is a GraphT<Cap>
+// (MatrizFlujo<int32_t> is the plain std::vector<std::vector<int>>)
+template <typename Cap>
+using MatrizFlujo = std::vector<std::vector<typename TipoFlujo<Cap>::type>>;
+
 #endif
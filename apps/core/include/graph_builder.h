@@ -2,35 +2,61 @@
 #define GRAPH_BUILDER_H
 
 #include "graph.h"
+#include "instance.h"
+#include "min_cost_flow.h"
+#include "red_implicita.h"
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
-/**
- * Structure to represent a period
- */
-struct Periodo {
-  std::string id;
-  std::vector<std::string> dias; // IDs of the days in this period
-};
-
 /**
  * Structure for the assignment result
  */
 struct Asignacion {
   std::string medico;
   std::string dia;
+  std::string rol;   // Role covered, on days with role demand
+  std::string turno; // Shift slot taken, on days with slot demand
 };
 
 /**
  * Solver result
  */
 struct Bottleneck {
-  std::string tipo; // "Doctor", "Day", "Period"
+  // "Doctor", "Day", "Period", "Role", "Slot", "DoctorInPeriod" or "Lock"
+  std::string tipo;
   std::string id;
   std::string razon; // "Saturated" or "Not covered"
 };
 
+/**
+ * Changes against the previous plan (stability-aware solving)
+ */
+struct Estabilidad {
+  int previas = 0;      // Pairs in the previous plan
+  int conservadas = 0;  // Of those, still assigned
+  int cambios = 0;      // Pairs removed + pairs added
+};
+
+/**
+ * Coverage lost if one doctor drops out (doctor-removal sensitivity)
+ */
+struct SensibilidadMedico {
+  std::string medico;
+  int asignaciones = 0; // Shifts the doctor covers in the solution
+  int diasPerdidos = 0; // Of those, shifts nobody else can take over
+};
+
+/**
+ * Coverage of the days sharing one priority (priority-weighted solving)
+ */
+struct CoberturaPrioridad {
+  int prioridad = 0;
+  int diasCubiertos = 0;
+  int diasRequeridos = 0;
+};
+
 /**
  * Assignment Result
  */
@@ -40,6 +66,11 @@ struct ResultadoAsignacion {
   int diasRequeridos;
   std::vector<Asignacion> asignaciones;
   std::vector<Bottleneck> bottlenecks; // List of bottlenecks
+  bool conEstabilidad = false; // `estabilidad` is set (previous plan given)
+  Estabilidad estabilidad;
+  std::vector<SensibilidadMedico> sensibilidad; // Only if requested
+  bool parcial = false; // Deadline expired: best flow so far, not maximum
+  std::vector<CoberturaPrioridad> coberturaPorPrioridad; // Highest first
 };
 
 /**
@@ -49,9 +80,24 @@ struct ResultadoAsignacion {
  *   Source -> [Doctors] -> [Doctor-Period] -> [Days] -> Sink
  *
  * - Source -> Doctor: capacity = available days of the doctor
- * - Doctor -> Doctor-Period: capacity = C (max shifts per period)
- * - Doctor-Period -> Day: capacity = 1 (if available)
+ * - Doctor -> Doctor-Period: capacity = max shifts per period (global, or the
+ *   doctor's per-period capacity)
+ * - Doctor-Period -> Day: capacity = 1 (if available). A locked assignment
+ *   adds the arc (through the day's first period) with lower bound 1
+ * - On days with role demand the arc goes to a Day-Role node instead (the
+ *   doctor's role; no arc if the day does not ask for it), and
+ *   Day-Role -> Day: capacity = doctors of that role required that day.
+ *   One node per demand entry, so the graph stays linear in the input
+ * - On days with slot demand the arc goes to a Day-Slot node, with
+ *   Day-Slot -> Day: capacity = doctors required in that slot. A doctor who
+ *   may take several of the day's slots goes through a Doctor-Day node
+ *   instead (one per such available pair), whose single entry arc of
+ *   capacity 1 allows at most one slot per day
  * - Day -> Sink: capacity = doctors required that day
+ *
+ * The graph is built from an InstanceView. Data given through the setters is
+ * interned into one at build time; setInstance() uses an existing view (e.g.
+ * a memory-mapped binary instance) directly.
  */
 class GraphBuilder {
 private:
@@ -65,25 +111,72 @@ private:
   int maxGuardiasTotales_;                   // C: max total days per doctor
   std::map<std::string, int> medicosPorDia_; // day -> required amount
   std::map<std::string, int> personalCapacities_; // Individual capacity (optional)
+  std::map<std::string, std::map<std::string, int>>
+    capacidadesPorPeriodo_; // doctor -> period -> limit (optional)
+  std::map<std::string, std::vector<std::string>>
+    asignacionesFijas_; // doctor -> locked days (optional)
+  std::map<std::string, std::vector<std::string>>
+    asignacionesPrevias_; // doctor -> days in the previous plan (optional)
+  std::map<std::string, int> prioridadDias_; // day -> priority (optional)
+  std::map<std::string, std::string> roles_;  // doctor -> role (optional)
+  std::map<std::string, std::map<std::string, int>>
+    demandaPorRol_; // day -> role -> doctors required (optional)
+  std::map<std::string, std::map<std::string, int>>
+    demandaPorTurno_; // day -> slot -> doctors required (optional)
+  std::map<std::string, std::map<std::string, std::vector<std::string>>>
+    disponibilidadPorTurno_; // doctor -> day -> slots allowed (optional)
+
+  // Interned instance the graph is built from
+  InternedInstance interned_;
+  const InstanceView *externalInstance_; // nullptr = use interned_
+  bool internadoValido_; // interned_ matches the setters' data
 
-  // IDs to graph indices mapping
+  // Node layout: source, doctors, doctor-periods (doctor-major, or
+  // period-major with setRenumerar), days, day-roles and day-slots (one per
+  // demand entry), doctor-days, sink
+  bool renumerar_;    // Requested doctor-period order for the next build
+  bool periodoMayor_; // Doctor-period order of the last build
   int source_;
   int sink_;
-  std::map<std::string, int> medicoToNode_;
-  std::map<std::pair<std::string, std::string>, int>
-    medicoPeriodoToNode_; // (doctor, period) -> node
-  std::map<std::string, int> diaToNode_;
+  int primerMedicoPeriodo_;
+  int primerDia_;
+  int primerDiaRol_;
+  int primerDiaTurno_;
+  int primerMedicoDia_;
+  int numMedicos_;
+  int numPeriodos_;
+
+  // Slotted days: index among them (-1 = no slots), and the layer-3 target
+  // of each (doctor, slotted day): a Day-Slot or Doctor-Day node, -1 = none
+  std::vector<int64_t> indiceDiaTurno_;
+  uint32_t numDiasTurno_ = 0;
+  std::vector<int> entradaTurno_; // doctor-major, numMedicos * numDiasTurno_
+  std::vector<std::pair<uint32_t, uint32_t>> medicoDia_; // Of each Doctor-Day
 
-  // Reverse mapping (for result extraction)
-  std::map<int, std::string> nodeToMedico_;
-  std::map<int, std::pair<std::string, std::string>> nodeToMedicoPeriodo_;
-  std::map<int, std::string> nodeToDia_;
+  // Name-sorted orders, so results and bottlenecks are listed by ID
+  std::vector<uint32_t> ordenMedicos_;
+  std::vector<uint32_t> ordenPeriodos_;
+  std::vector<uint32_t> ordenDias_;
+  std::vector<uint32_t> periodoDiasOffsets_; // Days of each period, by name
+  std::vector<uint32_t> periodoDiasOrdenados_;
 
   int numVertices_;
+  AnchoCapacidad ancho_; // Residual capacity width of the last build
+  std::string topologia_; // hashTopologia() of the last build, "" = none
+
+  // Locked assignments of the last build
+  std::vector<CotaInferior> cotas_; // One per lock, on its layer-3 arc
+  std::vector<uint32_t> cotaFija_;  // Lock index of each bound
+  std::vector<uint32_t> fijasSinPeriodo_; // Locks whose day is in no period
+  std::vector<uint32_t> fijasSinRol_; // Locks on a day not asking the role
 
 public:
   GraphBuilder();
 
+  // Clear input data, restoring the defaults. The node layout of the last
+  // build is kept so rebuild() can reuse it for the next instance.
+  void reset();
+
   // Configuration
   void setMedicos(const std::vector<std::string> &medicos);
   void setDias(const std::vector<std::string> &dias);
@@ -94,28 +187,151 @@ public:
   void setMaxGuardiasTotales(int c);
   void setMedicosPorDia(const std::map<std::string, int> &medicosPorDia);
   void setPersonalCapacities(const std::map<std::string, int> &capacities);
+  void setCapacidadesPorPeriodo(
+    const std::map<std::string, std::map<std::string, int>> &capacidades);
+  void setAsignacionesFijas(
+    const std::map<std::string, std::vector<std::string>> &fijas);
+  void setAsignacionesPrevias(
+    const std::map<std::string, std::vector<std::string>> &previas);
+  void setPrioridadDias(const std::map<std::string, int> &prioridades);
+  void setRoles(
+    const std::map<std::string, std::string> &roles,
+    const std::map<std::string, std::map<std::string, int>> &demandaPorRol);
+  void setTurnos(
+    const std::map<std::string, std::map<std::string, int>> &demandaPorTurno,
+    const std::map<std::string, std::map<std::string, std::vector<std::string>>>
+      &disponibilidadPorTurno);
   void setMedicosRequeridosTodosDias(
     int cantidad); // Shortcut: same amount for everyone
 
+  // Build from an already interned instance instead of the setters' data.
+  // The view must outlive the builder's use of it.
+  void setInstance(const InstanceView &instance);
+
+  // Intern the setters' data if it changed; returns the instance to build
+  const InstanceView &internar();
+
+  /**
+   * Vertex order of the following builds (default: off). Off, each doctor's
+   * Doctor-Period nodes are consecutive; on, the nodes are numbered
+   * period-major, so the doctors' nodes of one period are consecutive. A
+   * day's incoming arcs then fall in a few bitset words instead of being
+   * spread over the whole layer, which is what the searches of the matrix
+   * engines read. Only node numbers change: coverage and bottlenecks are
+   * the same, and results are mapped back by name. Which of the equally
+   * good assignments comes out may differ.
+   */
+  void setRenumerar(bool renumerar) { renumerar_ = renumerar; }
+
   // Construction
   Graph build();
+  void build(Graph &g); // Fills a caller-owned graph, reusing its storage
+
+  /**
+   * Builds the same network as an arc list for stability-aware solving.
+   * Doctor-Period -> Day arcs cost 0 for pairs of the previous plan and 1
+   * otherwise, so a min-cost max-flow keeps as many previous pairs as
+   * possible. The flow is warm-started with the previous pairs that still
+   * fit the capacities (a zero-cost flow, hence optimal for its value).
+   */
+  void buildEstable(MinCostFlow &red);
+
+  /**
+   * Builds the same network for the implicit engine: every layer except
+   * Doctor-Period -> Day as stored arcs, and layer 3 described by this
+   * builder's instance and node layout (see RedImplicita). Locked
+   * assignments are not placed, so it is for instances without them.
+   */
+  void buildImplicita(RedImplicita &red);
 
-  // Result extraction
+  // Compare a solution with the previous plan
+  Estabilidad medirEstabilidad(const ResultadoAsignacion &resultado);
+
+  /**
+   * Like build(g), for a graph this builder built before. If the instance has
+   * the same topology as that build (see hashTopologia), the node layout and
+   * the Doctor-Period -> Day arcs are kept and only the capacities of the
+   * other layers are rewritten.
+   * @return true if the previous topology was reused
+   */
+  bool rebuild(Graph &g);
+
+  // Result extraction, from a flow matrix of any width (see MatrizFlujo)
+  template <typename F>
   ResultadoAsignacion
-  extraerResultado(const std::vector<std::vector<int>> &flowGraph);
+  extraerResultado(const std::vector<std::vector<F>> &flowGraph);
+  ResultadoAsignacion extraerResultado(const RedImplicita &red);
+
+  // Day nodes grouped by priority, highest first (empty if the instance has
+  // no priorities). Valid after build.
+  std::vector<std::vector<int>> clasesPrioridad() const;
+
+  // Coverage per priority, highest first (empty without priorities)
+  template <typename F>
+  std::vector<CoberturaPrioridad>
+  coberturaPorPrioridad(const std::vector<std::vector<F>> &flowGraph) const;
 
   // Analyze min-cut to find bottlenecks
   std::vector<Bottleneck> analyzeMinCut(const std::vector<int> &reachableNodes);
 
+  // Locks that make the instance infeasible: those whose day is in no period
+  // or does not ask for the doctor's role, plus the given indices into
+  // getCotasInferiores() (see maxFlowConCotas)
+  std::vector<Bottleneck>
+  analyzeFijas(const std::vector<size_t> &insatisfechas);
+
+  // Locked assignments as lower bounds (valid after build)
+  const std::vector<CotaInferior> &getCotasInferiores() const { return cotas_; }
+  bool fijasColocables() const {
+    return fijasSinPeriodo_.empty() && fijasSinRol_.empty();
+  }
+
   // Useful getters
   int getSource() const { return source_; }
   int getSink() const { return sink_; }
   int getNumVertices() const { return numVertices_; }
 
+  // Narrowest capacity width that holds every residual capacity of the last
+  // build (or rebuild), for the residual graph of its max-flow solve
+  AnchoCapacidad getAnchoCapacidad() const { return ancho_; }
+  const InstanceView &getInstance() const {
+    return externalInstance_ ? *externalInstance_ : interned_.view();
+  }
+
+  // Node of each element (valid after build)
+  int nodoMedico(uint32_t m) const { return source_ + 1 + m; }
+  int nodoMedicoPeriodo(uint32_t m, uint32_t p) const {
+    return periodoMayor_ ? primerMedicoPeriodo_ + p * numMedicos_ + m
+                         : primerMedicoPeriodo_ + m * numPeriodos_ + p;
+  }
+  // Doctor and period of a Doctor-Period node
+  std::pair<uint32_t, uint32_t> medicoPeriodoDeNodo(int nodo) const {
+    uint32_t i = nodo - primerMedicoPeriodo_;
+    return periodoMayor_ ? std::make_pair(i % numMedicos_, i / numMedicos_)
+                         : std::make_pair(i / numPeriodos_, i % numPeriodos_);
+  }
+  int nodoDia(uint32_t d) const { return primerDia_ + d; }
+  int nodoDiaRol(uint32_t k) const { return primerDiaRol_ + k; }
+  int nodoDiaTurno(uint32_t k) const { return primerDiaTurno_ + k; }
+
+  // Layer-3 target of doctor m on day d: the day, its Day-Role node for the
+  // doctor's role, its Day-Slot or Doctor-Day node on a slotted day, or -1
+  // if the doctor cannot cover the day (role not demanded, or not available
+  // on a slotted day)
+  int nodoDestino(uint32_t m, uint32_t d) const;
+
 private:
+  void invalidar(); // Input changed: drop external view and interned data
   void calcularIndices();
-  bool estaDisponible(const std::string &medico, const std::string &dia) const;
-  std::string getPeriodoDeDia(const std::string &dia) const;
+  std::string claveTopologia(const InstanceView &inst) const; // With the order
+  void construir(Graph &g, const std::string &topologia);
+  void escribirCapacidades(Graph &g); // Every layer except layer 3
+  template <typename Fn>
+  void paraCadaTurno(uint32_t m, uint32_t d, Fn fn) const;
+  // Result from the flow on each arc, flujo(u, v)
+  template <typename Flujo> ResultadoAsignacion extraer(Flujo flujo);
+  int capacidadMedico(uint32_t m) const; // Source -> Doctor
+  std::vector<int64_t> primerPeriodoDeDia() const; // -1 = in no period
 };
 
 #endif
@@ -0,0 +1,279 @@
+#ifndef INSTANCE_H
+#define INSTANCE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Structure to represent a period
+ */
+struct Periodo {
+  std::string id;
+  std::vector<std::string> dias; // IDs of the days in this period
+};
+
+/**
+ * InstanceView: Interned, index-based view of an instance
+ *
+ * Doctors, days and periods are referred to by position. Their names live in
+ * one string table (doctors first, then days, then periods); availability is
+ * one bitset per doctor over day indices, and the days of each period are a
+ * CSR list of day indices.
+ *
+ * The view does not own its memory: it points either into an
+ * InternedInstance or into a memory-mapped binary instance file.
+ */
+struct InstanceView {
+  uint32_t numMedicos = 0;
+  uint32_t numDias = 0;
+  uint32_t numPeriodos = 0;
+  int32_t maxGuardiasPorPeriodo = 1;
+  int32_t maxGuardiasTotales = 999;
+
+  const uint32_t *nombreOffsets = nullptr; // numMedicos+numDias+numPeriodos+1
+  const char *nombres = nullptr;
+
+  const uint32_t *periodoOffsets = nullptr; // numPeriodos + 1
+  const uint32_t *periodoDias = nullptr;
+
+  uint32_t palabrasPorMedico = 0;          // 64-bit words per bitset
+  const uint64_t *disponibilidad = nullptr; // numMedicos * palabrasPorMedico
+  const uint32_t *diasDisponibles = nullptr; // Length of each input list
+
+  const int32_t *medicosPorDia = nullptr; // numDias
+  const int32_t *capacidades = nullptr;   // numMedicos, < 0 = global limit
+
+  // Sparse per-(doctor, period) limits, CSR by doctor with period indices
+  // ascending. nullptr offsets = none (every period uses the global limit).
+  const uint32_t *capPeriodoOffsets = nullptr; // numMedicos + 1
+  const uint32_t *capPeriodoPeriodos = nullptr;
+  const int32_t *capPeriodoValores = nullptr;
+
+  // Locked (doctor, day) assignments, as index pairs sorted by doctor, day
+  uint32_t numFijas = 0;
+  const uint32_t *fijas = nullptr; // 2 * numFijas
+
+  // Previous plan (doctor, day) pairs for stability-aware solving, same layout
+  uint32_t numPrevias = 0;
+  const uint32_t *previas = nullptr; // 2 * numPrevias
+
+  // Day priorities (higher = covered first). nullptr = none: all equal.
+  const int32_t *prioridadDia = nullptr; // numDias
+
+  // Roles: own string table, at most one role per doctor, and per-day demand
+  // per role as a CSR by day (role indices ascending). nullptr = no roles.
+  // On a day with role demand, medicosPorDia is the sum of that demand and
+  // only doctors of a demanded role can cover it.
+  uint32_t numRoles = 0;
+  const uint32_t *rolNombreOffsets = nullptr; // numRoles + 1
+  const char *rolNombres = nullptr;
+  const int32_t *rolMedico = nullptr;          // numMedicos, -1 = no role
+  const uint32_t *demandaRolOffsets = nullptr; // numDias + 1
+  const uint32_t *demandaRolRoles = nullptr;
+  const int32_t *demandaRolValores = nullptr;
+
+  // Shift slots (e.g. day/night): own string table and per-day demand per
+  // slot as a CSR by day (slot indices ascending). nullptr = no slots. On a
+  // day with slot demand, medicosPorDia is the sum of that demand and each
+  // doctor takes at most one of its slots. A day never has both role and
+  // slot demand.
+  uint32_t numTurnos = 0;
+  const uint32_t *turnoNombreOffsets = nullptr; // numTurnos + 1
+  const char *turnoNombres = nullptr;
+  const uint32_t *demandaTurnoOffsets = nullptr; // numDias + 1
+  const uint32_t *demandaTurnoTurnos = nullptr;
+  const int32_t *demandaTurnoValores = nullptr;
+
+  // Per-doctor slot restrictions: CSR by doctor of the (day, slot) demand
+  // entries the doctor may take, ascending. On a slotted day with none of
+  // them listed the doctor may take any slot. nullptr = no restrictions.
+  const uint32_t *turnoMedicoOffsets = nullptr; // numMedicos + 1
+  const uint32_t *turnoMedicoDemandas = nullptr;
+
+  std::string_view medico(uint32_t m) const { return nombre(m); }
+  std::string_view dia(uint32_t d) const { return nombre(numMedicos + d); }
+  std::string_view periodo(uint32_t p) const {
+    return nombre(numMedicos + numDias + p);
+  }
+
+  std::string_view rol(uint32_t r) const {
+    return std::string_view(rolNombres + rolNombreOffsets[r],
+                            rolNombreOffsets[r + 1] - rolNombreOffsets[r]);
+  }
+
+  bool conRoles() const { return demandaRolOffsets != nullptr; }
+
+  // Number of (day, role) demand entries
+  uint32_t numDemandasRol() const {
+    return conRoles() ? demandaRolOffsets[numDias] : 0;
+  }
+
+  // Demand entry of (day, role), or -1 if the day has no demand for it
+  int64_t demandaRol(uint32_t d, int32_t r) const {
+    if (conRoles() && r >= 0) {
+      for (uint32_t k = demandaRolOffsets[d]; k < demandaRolOffsets[d + 1];
+           k++) {
+        if (demandaRolRoles[k] == uint32_t(r)) {
+          return k;
+        }
+      }
+    }
+    return -1;
+  }
+
+  std::string_view turno(uint32_t t) const {
+    return std::string_view(turnoNombres + turnoNombreOffsets[t],
+                            turnoNombreOffsets[t + 1] - turnoNombreOffsets[t]);
+  }
+
+  bool conTurnos() const { return demandaTurnoOffsets != nullptr; }
+
+  // Days with slot demand have at least one (day, slot) entry
+  bool tieneTurnos(uint32_t d) const {
+    return conTurnos() && demandaTurnoOffsets[d] < demandaTurnoOffsets[d + 1];
+  }
+
+  // Number of (day, slot) demand entries
+  uint32_t numDemandasTurno() const {
+    return conTurnos() ? demandaTurnoOffsets[numDias] : 0;
+  }
+
+  // Whether doctor m may take demand entry k, one of day d's slots
+  bool puedeTurno(uint32_t m, uint32_t d, uint32_t k) const {
+    if (turnoMedicoOffsets == nullptr) {
+      return true;
+    }
+    const uint32_t *inicio = turnoMedicoDemandas + turnoMedicoOffsets[m];
+    const uint32_t *fin = turnoMedicoDemandas + turnoMedicoOffsets[m + 1];
+    inicio = std::lower_bound(inicio, fin, demandaTurnoOffsets[d]);
+    if (inicio == fin || *inicio >= demandaTurnoOffsets[d + 1]) {
+      return true; // No restriction on this day
+    }
+    return std::binary_search(inicio, fin, k);
+  }
+
+  bool disponible(uint32_t m, uint32_t d) const {
+    return (disponibilidad[m * palabrasPorMedico + d / 64] >> (d % 64)) & 1;
+  }
+
+  // Total shift limit of a doctor (personal capacity or global C)
+  int limite(uint32_t m) const {
+    return capacidades[m] >= 0 ? capacidades[m] : maxGuardiasTotales;
+  }
+
+  // Shift limit of a doctor in a period (per-period capacity or global)
+  int limitePeriodo(uint32_t m, uint32_t p) const {
+    if (capPeriodoOffsets != nullptr) {
+      for (uint32_t k = capPeriodoOffsets[m]; k < capPeriodoOffsets[m + 1];
+           k++) {
+        if (capPeriodoPeriodos[k] == p) {
+          return capPeriodoValores[k];
+        }
+      }
+    }
+    return maxGuardiasPorPeriodo;
+  }
+
+private:
+  std::string_view nombre(uint32_t i) const {
+    return std::string_view(nombres + nombreOffsets[i],
+                            nombreOffsets[i + 1] - nombreOffsets[i]);
+  }
+};
+
+/**
+ * InternedInstance: Owns the arrays behind an InstanceView
+ *
+ * Built from the string-keyed input (as produced by the JSON parser).
+ * Periods list only days that belong to `dias`; availability for unknown days
+ * is dropped from the bitsets but still counts towards `diasDisponibles`,
+ * which bounds the Source -> Doctor capacity. Per-period capacities, locked
+ * and previous assignments and day priorities naming an unknown doctor,
+ * period or day are ignored. Days without a priority get 0. Role names are
+ * sorted; roles of unknown doctors and demand for unknown days are ignored.
+ * Slot names are sorted too. A doctor's slot list for a day narrows which of
+ * the day's slots they may take; if none of the listed slots exists that day
+ * the doctor is not available on it. Lists for days without slot demand are
+ * ignored. Throws std::runtime_error if a day has both role and slot demand.
+ */
+class InternedInstance {
+private:
+  std::vector<uint32_t> nombreOffsets_;
+  std::string nombres_;
+  std::vector<uint32_t> periodoOffsets_;
+  std::vector<uint32_t> periodoDias_;
+  std::vector<uint64_t> disponibilidad_;
+  std::vector<uint32_t> diasDisponibles_;
+  std::vector<int32_t> medicosPorDia_;
+  std::vector<int32_t> capacidades_;
+  std::vector<uint32_t> capPeriodoOffsets_;
+  std::vector<uint32_t> capPeriodoPeriodos_;
+  std::vector<int32_t> capPeriodoValores_;
+  std::vector<uint32_t> fijas_;
+  std::vector<uint32_t> previas_;
+  std::vector<int32_t> prioridades_; // Empty = no priorities given
+  std::vector<uint32_t> rolNombreOffsets_; // Roles: all empty = none given
+  std::string rolNombres_;
+  std::vector<int32_t> rolMedico_;
+  std::vector<uint32_t> demandaRolOffsets_;
+  std::vector<uint32_t> demandaRolRoles_;
+  std::vector<int32_t> demandaRolValores_;
+  std::vector<uint32_t> turnoNombreOffsets_; // Slots: all empty = none given
+  std::string turnoNombres_;
+  std::vector<uint32_t> demandaTurnoOffsets_;
+  std::vector<uint32_t> demandaTurnoTurnos_;
+  std::vector<int32_t> demandaTurnoValores_;
+  std::vector<uint32_t> turnoMedicoOffsets_; // Empty = no restrictions
+  std::vector<uint32_t> turnoMedicoDemandas_;
+  InstanceView view_;
+
+  void apuntarVista(); // Point view_ at this object's arrays
+
+public:
+  InternedInstance() = default;
+  InternedInstance(const InternedInstance &other);
+  InternedInstance &operator=(const InternedInstance &other);
+
+  void intern(const std::vector<std::string> &medicos,
+              const std::vector<std::string> &dias,
+              const std::vector<Periodo> &periodos,
+              const std::map<std::string, std::vector<std::string>>
+                  &disponibilidad,
+              const std::map<std::string, int> &medicosPorDia,
+              const std::map<std::string, int> &capacidades,
+              const std::map<std::string, std::map<std::string, int>>
+                  &capacidadesPorPeriodo,
+              const std::map<std::string, std::vector<std::string>> &fijas,
+              const std::map<std::string, std::vector<std::string>> &previas,
+              const std::map<std::string, int> &prioridadDias,
+              const std::map<std::string, std::string> &roles,
+              const std::map<std::string, std::map<std::string, int>>
+                  &demandaPorRol,
+              const std::map<std::string, std::map<std::string, int>>
+                  &demandaPorTurno,
+              const std::map<std::string,
+                             std::map<std::string, std::vector<std::string>>>
+                  &disponibilidadPorTurno,
+              int maxGuardiasPorPeriodo, int maxGuardiasTotales);
+
+  /**
+   * Window of another instance (rolling-horizon solving): the given periods,
+   * in that order, and the given days (ascending indices into `origen`).
+   * Period day lists, locks, previous pairs, priorities and role and slot
+   * demand are cut to those days. `usados[m]` shifts already assigned to
+   * doctor m elsewhere are taken off both their total limit and their
+   * availability count, so the window only spends what is left.
+   */
+  void internarVentana(const InstanceView &origen,
+                       const std::vector<uint32_t> &periodos,
+                       const std::vector<uint32_t> &dias,
+                       const std::vector<int32_t> &usados);
+
+  const InstanceView &view() const { return view_; }
+};
+
+#endif
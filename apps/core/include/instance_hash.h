@@ -0,0 +1,54 @@
+#ifndef INSTANCE_HASH_H
+#define INSTANCE_HASH_H
+
+#include "instance.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * Hasher: 128-bit non-cryptographic hash (two mixed 64-bit lanes)
+ *
+ * Used as a content address: collisions are unlikely enough for caching, but
+ * it must not be relied on against adversarial input.
+ */
+class Hasher {
+private:
+  uint64_t a_;
+  uint64_t b_;
+
+public:
+  Hasher();
+
+  void update(std::string_view bytes);
+  void update(int64_t value);
+
+  // 32 hex characters
+  std::string hex() const;
+};
+
+/**
+ * Canonical hash of an instance
+ *
+ * Doctors, days and periods are hashed as sorted sets, so two inputs that
+ * differ only in the order of their lists (or of the days inside them) get
+ * the same hash. Everything that changes the network is included: limits,
+ * availability, period membership, per-period limits, locked and previous
+ * assignments, daily demand, day priorities, roles and shift slots.
+ */
+std::string hashInstancia(const InstanceView &instancia);
+
+/**
+ * Fingerprint of the network topology of an instance
+ *
+ * Covers what fixes the node layout and the arc set (names in input order,
+ * the days of each period, availability, locked assignments, doctor roles,
+ * which roles and slots each day asks for and which slots each doctor may
+ * take) and leaves out every capacity (limits, maxGuardiasPorPeriodo,
+ * per-period capacities, medicosPorDia, role and slot demand).
+ * Unlike hashInstancia it is positional: reordering the input changes the
+ * node numbering, so it changes the fingerprint too.
+ */
+std::string hashTopologia(const InstanceView &instancia);
+
+#endif
@@ -2,6 +2,7 @@
 #define JSON_PARSER_H
 
 #include "graph_builder.h"
+#include <functional>
 #include <string>
 
 /**
@@ -16,6 +17,22 @@ struct InputData {
   int maxGuardiasTotales;
   std::map<std::string, int> medicosPorDia;
   std::map<std::string, int> personalCapacities;
+  // Optional limit per doctor and period, overriding maxGuardiasPorPeriodo
+  std::map<std::string, std::map<std::string, int>> capacidadesPorPeriodo;
+  // Optional locked assignments (doctor -> days) that every solution keeps
+  std::map<std::string, std::vector<std::string>> asignacionesFijas;
+  // Optional previous plan (doctor -> days): solve changing as few as possible
+  std::map<std::string, std::vector<std::string>> asignacionesPrevias;
+  // Optional day priorities (day -> priority): higher days are covered first
+  std::map<std::string, int> prioridadDias;
+  // Optional role per doctor and per-day demand per role (day -> role -> n)
+  std::map<std::string, std::string> roles;
+  std::map<std::string, std::map<std::string, int>> demandaPorRol;
+  // Optional shift slots: per-day demand per slot (day -> slot -> n) and the
+  // slots each doctor may take on a day (doctor -> day -> [slots])
+  std::map<std::string, std::map<std::string, int>> demandaPorTurno;
+  std::map<std::string, std::map<std::string, std::vector<std::string>>>
+      disponibilidadPorTurno;
 };
 
 /**
@@ -28,6 +45,31 @@ struct OutputData {
   std::vector<Asignacion> asignaciones;
 };
 
+/**
+ * Execution statistics, serialized as "stats" when requested (--stats)
+ */
+struct SolveStats {
+  std::string engine;
+  std::string hash; // Canonical instance hash (cache key)
+  bool cacheHit = false;
+  long long cacheLookups = 0;
+  long long cacheHits = 0;
+  long long cacheDiskHits = 0;
+  double cacheHitRatio = 0.0;
+  size_t cacheEntries = 0;
+  bool topologyReused = false; // Graph reused from the previous solve
+  uint32_t windows = 0;         // Windows of a rolling-horizon solve, 0 = none
+  std::string session;          // Plan-version session, "" = none
+  bool sessionDelta = false;    // The request only carried changes
+  bool flowReused = false;      // Max-flow warm-started from the last flow
+  bool verified = false;        // Optimality certificate checked (--verify)
+  size_t sessionsOpen = 0;
+  size_t sessionsEvicted = 0;
+  double parseMs = 0.0;
+  double solveMs = 0.0;
+  double totalMs = 0.0;
+};
+
 /**
  * JSONParser: Parses input JSON and serializes output JSON
  */
@@ -39,21 +81,67 @@ public:
    */
   static InputData parseInput(const std::string &jsonString);
 
+  // Instance of an open session, nullptr if there is none with that ID
+  using BuscarSesion =
+      std::function<const InputData *(const std::string &sesion)>;
+
+  /**
+   * Same, for requests that may belong to a session (resident mode). The
+   * session ID ("sesion", string or integer) is returned in `sesion`, "" if
+   * none. A request with a session and no "medicos" is a delta: it starts
+   * from the session's instance and only the fields it gives change
+   * (objects merge key by key, other values replace, null clears).
+   * @throws std::runtime_error if JSON is invalid or the delta's session
+   *         is not open
+   */
+  static InputData parseInput(const std::string &jsonString,
+                              std::string &sesion,
+                              const BuscarSesion &instanciaDeSesion);
+
   /**
    * Parses a JSON file and returns input data
    * @throws std::runtime_error if file does not exist or JSON is invalid
    */
   static InputData parseInputFromFile(const std::string &filePath);
 
+  /**
+   * Converts input data back to a request that parses to the same data
+   * (e.g. to save a failing instance). indent < 0 produces a single line.
+   */
+  static std::string inputToJson(const InputData &data, int indent);
+
   /**
    * Converts result to JSON string
    */
   static std::string toJson(const ResultadoAsignacion &resultado);
 
+  /**
+   * Converts result (and stats, if not null) to JSON.
+   * indent < 0 produces a single line (resident mode).
+   */
+  static std::string toJson(const ResultadoAsignacion &resultado,
+                            const SolveStats *stats, int indent);
+
+  /**
+   * Single-line {"error": "..."} document with the message escaped
+   */
+  static std::string errorToJson(const std::string &mensaje);
+
+  /**
+   * Parses a result previously produced by toJson (e.g. from the disk cache)
+   * @throws std::runtime_error if JSON is invalid
+   */
+  static ResultadoAsignacion parseResultado(const std::string &jsonString);
+
   /**
    * Configures GraphBuilder with parsed data
    */
   static void configureBuilder(GraphBuilder &builder, const InputData &data);
+
+  /**
+   * Interns parsed data into index-based form (e.g. to write a .bin file)
+   */
+  static void internInput(const InputData &data, InternedInstance &instance);
 };
 
 #endif
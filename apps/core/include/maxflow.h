@@ -0,0 +1,115 @@
+#ifndef MAXFLOW_H
+#define MAXFLOW_H
+
+/**
+ * libmaxflow: C ABI for embedding the solver in-process
+ *
+ * Typical use:
+ *   maxflow_context *ctx = maxflow_context_create();
+ *   maxflow_load_json(ctx, json, strlen(json));   // or maxflow_load_instancia
+ *   maxflow_solve(ctx);
+ *   ... maxflow_factible(ctx), maxflow_get_asignacion(ctx, i, ...) ...
+ *   maxflow_context_free(ctx);
+ *
+ * A context can be loaded and solved any number of times. Contexts are
+ * independent, but a single context must not be used from two threads at
+ * once. Strings returned by the getters are owned by the context and stay
+ * valid until the next load, solve or free on that context.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define MAXFLOW_API __declspec(dllexport)
+#else
+#define MAXFLOW_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped on any incompatible change to the functions or structs below */
+#define MAXFLOW_ABI_VERSION 1
+
+typedef enum maxflow_status {
+  MAXFLOW_OK = 0,
+  MAXFLOW_ERROR_ARGUMENT = 1, /* NULL pointer or index out of range */
+  MAXFLOW_ERROR_INPUT = 2,    /* Invalid JSON or inconsistent instance */
+  MAXFLOW_ERROR_STATE = 3,    /* e.g. solve before load, read before solve */
+  MAXFLOW_ERROR_INTERNAL = 4  /* Out of memory or a failed solve */
+} maxflow_status;
+
+typedef struct maxflow_context maxflow_context;
+
+/**
+ * Instance given as flat arrays (no JSON round-trip).
+ *
+ * Periods and availability use CSR layout over day indices (positions in
+ * `dias`): the days of period p are
+ *   periodo_dias[periodo_offsets[p] .. periodo_offsets[p + 1])
+ * and the available days of doctor m are
+ *   disponibilidad_dias[disponibilidad_offsets[m] .. disponibilidad_offsets[m + 1])
+ */
+typedef struct maxflow_instancia {
+  const char *const *medicos;
+  size_t num_medicos;
+  const char *const *dias;
+  size_t num_dias;
+
+  const char *const *periodo_ids;
+  size_t num_periodos;
+  const uint32_t *periodo_offsets; /* num_periodos + 1 entries */
+  const uint32_t *periodo_dias;
+
+  const uint32_t *disponibilidad_offsets; /* num_medicos + 1 entries */
+  const uint32_t *disponibilidad_dias;
+
+  int max_guardias_por_periodo;
+  int max_guardias_totales;
+  const int32_t *medicos_por_dia; /* num_dias entries, NULL = 1 per day */
+  const int32_t *capacidades; /* num_medicos entries, NULL or < 0 = global */
+} maxflow_instancia;
+
+MAXFLOW_API int maxflow_abi_version(void);
+
+MAXFLOW_API maxflow_context *maxflow_context_create(void);
+MAXFLOW_API void maxflow_context_free(maxflow_context *ctx);
+
+/* Loading replaces the previous instance and discards its result */
+MAXFLOW_API maxflow_status maxflow_load_json(maxflow_context *ctx,
+                                             const char *json, size_t length);
+MAXFLOW_API maxflow_status
+maxflow_load_instancia(maxflow_context *ctx,
+                       const maxflow_instancia *instancia);
+
+MAXFLOW_API maxflow_status maxflow_solve(maxflow_context *ctx);
+
+/* Result of the last solve (0 / empty if there is none) */
+MAXFLOW_API int maxflow_factible(const maxflow_context *ctx);
+MAXFLOW_API int maxflow_dias_cubiertos(const maxflow_context *ctx);
+MAXFLOW_API int maxflow_dias_requeridos(const maxflow_context *ctx);
+
+MAXFLOW_API size_t maxflow_num_asignaciones(const maxflow_context *ctx);
+MAXFLOW_API maxflow_status maxflow_get_asignacion(const maxflow_context *ctx,
+                                                  size_t index,
+                                                  const char **medico,
+                                                  const char **dia);
+
+MAXFLOW_API size_t maxflow_num_bottlenecks(const maxflow_context *ctx);
+MAXFLOW_API maxflow_status
+maxflow_get_bottleneck(const maxflow_context *ctx, size_t index,
+                       const char **tipo, const char **id, const char **razon);
+
+/* Same document the solver binary prints on stdout, NULL before a solve */
+MAXFLOW_API const char *maxflow_result_json(maxflow_context *ctx);
+
+/* Message of the last failed call on this context ("" if none) */
+MAXFLOW_API const char *maxflow_last_error(const maxflow_context *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
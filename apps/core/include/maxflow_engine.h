@@ -0,0 +1,36 @@
+#ifndef MAXFLOW_ENGINE_H
+#define MAXFLOW_ENGINE_H
+
+#include "deadline.h"
+#include "graph.h"
+#include <vector>
+
+/**
+ * MaxFlowEngine: A max-flow algorithm a SolverContext can run plain solves
+ * with (see SolverContext::setMotor)
+ *
+ * Whatever the engine, maxFlow leaves in flowGraph a max flow as a net flow
+ * matrix (flowGraph[v][u] = -flowGraph[u][v]) and in residualGraph its
+ * residual network, so result extraction, the min cut (the vertices
+ * reachable from the source in the residual network, which is the same for
+ * every max flow) and the sensitivity table work the same after any of them.
+ * Which of the equally good flows comes out is up to the engine.
+ */
+class MaxFlowEngine {
+public:
+  virtual ~MaxFlowEngine() = default;
+
+  // Name reported in stats and used in the result cache key
+  virtual const char *nombre() const = 0;
+
+  // Time budget of the following solves; an interrupted solve still leaves
+  // a valid (possibly not maximum) flow
+  virtual void setDeadline(const Deadline &deadline) = 0;
+  virtual bool interrumpido() const = 0;
+
+  virtual int maxFlow(const Graph &graph, int source, int sink,
+                      Graph &residualGraph,
+                      std::vector<std::vector<int>> &flowGraph) = 0;
+};
+
+#endif
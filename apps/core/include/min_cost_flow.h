@@ -0,0 +1,83 @@
+#ifndef MIN_COST_FLOW_H
+#define MIN_COST_FLOW_H
+
+#include "deadline.h"
+#include <vector>
+
+/**
+ * MinCostFlow: Min-cost max-flow on an arc list (successive shortest paths)
+ *
+ * Arcs are stored in pairs (forward, reverse) so the residual network is the
+ * arc list itself. Costs must be non-negative. Shortest paths use Dijkstra
+ * with node potentials.
+ *
+ * The flow can be warm-started with empujar() before solve(): solve() then
+ * only adds flow on top of it. That keeps the result optimal as long as the
+ * starting flow is a min-cost flow for its own value, e.g. a flow that only
+ * uses zero-cost arcs.
+ */
+class MinCostFlow {
+private:
+  struct Arco {
+    int to;
+    int cap; // Residual capacity
+    int cost;
+  };
+
+  int numVertices_;
+  std::vector<Arco> arcos_; // Arc id i is arcos_[2i], its reverse arcos_[2i+1]
+  std::vector<std::vector<int>> adyacentes_; // Indices into arcos_
+  std::vector<int> capacidadOriginal_;       // Per arc id
+
+  // Search buffers, reused across solves
+  std::vector<long long> potencial_;
+  std::vector<long long> distancia_;
+  std::vector<int> arcoPrevio_;
+
+  Deadline deadline_;
+  bool interrumpido_; // The last solve stopped at the deadline
+
+  bool dijkstra(int source, int sink);
+
+public:
+  MinCostFlow();
+
+  // Clear all arcs and resize to `vertices` (storage is kept)
+  void reset(int vertices);
+
+  // Adds an arc and returns its id
+  int addArc(int from, int to, int cap, int cost);
+
+  /**
+   * Pushes `f` units along a path of arc ids, if every arc has room
+   * @return false (and changes nothing) if some arc lacks capacity
+   */
+  bool empujar(const std::vector<int> &camino, int f);
+
+  // Time budget checked between augmentations. An interrupted solve leaves
+  // a min-cost flow for the value it reached.
+  void setDeadline(const Deadline &deadline) { deadline_ = deadline; }
+  bool interrumpido() const { return interrumpido_; }
+
+  /**
+   * Augments from the current flow until no source -> sink path is left
+   * (or the deadline expires)
+   * @return flow added by this call
+   */
+  int solve(int source, int sink);
+
+  int getNumVertices() const { return numVertices_; }
+  int numArcos() const { return capacidadOriginal_.size(); }
+  int from(int arco) const { return arcos_[2 * arco + 1].to; }
+  int to(int arco) const { return arcos_[2 * arco].to; }
+  int capacidad(int arco) const { return capacidadOriginal_[arco]; }
+  int flujo(int arco) const {
+    return capacidadOriginal_[arco] - arcos_[2 * arco].cap;
+  }
+  long long costoTotal() const;
+
+  // Nodes reachable from source in the residual network (for Min-Cut)
+  std::vector<int> getReachableNodes(int source) const;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef PUSH_RELABEL_H
+#define PUSH_RELABEL_H
+
+#include "maxflow_engine.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * PushRelabel: Multi-threaded push-relabel max-flow engine for large
+ * instances (--engine=push-relabel)
+ *
+ * Runs the lock-free push-relabel of Hong (2008) over an arc list built from
+ * the Graph's arc bitsets, on a ThreadPool:
+ * - Residual capacities and excesses are atomics; a vertex's height is only
+ *   written by the task discharging it. A discharge pushes to the lowest
+ *   residual neighbour, or relabels above it, so tasks need no locks to
+ *   work on adjacent vertices.
+ * - Every discharge task keeps its own queue of active vertices and steals
+ *   from the others' when it runs dry. A vertex is in at most one queue at a
+ *   time.
+ * - After a fixed amount of relabel work the tasks stop and all heights are
+ *   recomputed as exact residual distances to the sink, with a BFS whose
+ *   large levels are split among the pool (global relabel).
+ *
+ * The first phase stops with a maximum preflow; the second one sends the
+ * excess that cannot reach the sink back to the source, with the same
+ * machinery, so the result is a max flow like Edmonds-Karp's: same value and
+ * same min cut, though in general a different flow. Which one depends on
+ * thread timing, so results are not reproducible across runs when more than
+ * one thread is used.
+ *
+ * Without a pool, or for small networks (setArcosPorHilo), everything runs
+ * on the calling thread.
+ */
+class PushRelabel : public MaxFlowEngine {
+private:
+  // Arcs of vertex u: [inicio_[u], inicio_[u + 1]), ascending by head. Both
+  // directions of every pair with capacity in some direction are present.
+  std::vector<int> inicio_;
+  std::vector<int> cabeza_;
+  std::vector<int> reverso_; // Index of the opposite arc
+  std::vector<int> capacidad_;
+
+  std::unique_ptr<std::atomic<int>[]> residual_;
+  std::unique_ptr<std::atomic<int>[]> exceso_;
+  std::unique_ptr<std::atomic<int>[]> altura_;
+  std::unique_ptr<std::atomic<bool>[]> enCola_;
+  size_t capacidadArcos_ = 0;
+  size_t capacidadVertices_ = 0;
+
+  ThreadPool *pool_;
+  int arcosPorHilo_;
+  Deadline deadline_;
+  bool interrumpido_ = false;
+  int relabelsGlobales_ = 0;
+
+  // Arc list and atomics for `graph`, with zero flow
+  void preparar(const Graph &graph);
+
+  // Push-relabel until no vertex other than `destino` and `excluido` has
+  // excess and a height below n. Heights are distances to `destino`;
+  // `excluido` keeps height `alturaExcluido` and never becomes active.
+  // Returns false if the deadline expired first (only if conPlazo).
+  bool fase(int destino, int excluido, int alturaExcluido, bool conPlazo);
+
+public:
+  PushRelabel();
+
+  const char *nombre() const override { return "push-relabel"; }
+
+  void setDeadline(const Deadline &deadline) override {
+    deadline_ = deadline;
+  }
+  bool interrumpido() const override { return interrumpido_; }
+
+  // Pool the solves run on (default: none, only the calling thread)
+  void setPool(ThreadPool *pool) { pool_ = pool; }
+
+  // Networks with fewer arcs than this per thread use fewer threads of the
+  // pool (default 16384)
+  void setArcosPorHilo(int arcos) { arcosPorHilo_ = arcos > 0 ? arcos : 1; }
+
+  // Global relabels run by the last solve (for tests and tuning)
+  int getRelabelsGlobales() const { return relabelsGlobales_; }
+
+  int maxFlow(const Graph &graph, int source, int sink, Graph &residualGraph,
+              std::vector<std::vector<int>> &flowGraph) override;
+
+  // Same, leaving the residual graph and flow matrix at width `Cap` (see
+  // EdmondsKarp::maxFlow); the arc list the threads work on is the same at
+  // every width
+  template <typename Cap>
+  int maxFlow(const Graph &graph, int source, int sink,
+              GraphT<Cap> &residualGraph, MatrizFlujo<Cap> &flowGraph);
+};
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef RED_IMPLICITA_H
+#define RED_IMPLICITA_H
+
+#include "deadline.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Certificado;
+class GraphBuilder;
+struct InstanceView;
+
+/**
+ * RedImplicita: Max-flow on the assignment network without storing its
+ * Doctor-Period -> Day arcs (--engine=implicit)
+ *
+ * Layer 3 holds almost all of the network's arcs, and they follow from the
+ * instance: (m, p) -> nodoDestino(m, d) for every day d of period p the
+ * doctor is available on, capacity 1. Only the other layers are stored, as
+ * an arc list in pairs (forward, reverse) like MinCostFlow. Layer-3 arcs are
+ * enumerated from the period's day list and the doctor's availability
+ * bitset when a search reaches them, and their flow is one bit per
+ * (occurrence of a day in a period, doctor), stored per occurrence so the
+ * reverse arcs into a day are scanned 64 doctors per word. Building is
+ * linear in the stored layers; memory is O(doctors x days / 8) plus them.
+ *
+ * Max-flow is Dinic: a BFS level graph, then augmenting paths along it with
+ * a resumable cursor per node, until the sink is unreachable. The flow value
+ * and min cut (hence coverage and bottlenecks) are those of any max flow;
+ * the concrete assignments may differ from Edmonds-Karp's.
+ *
+ * The builder passed to setCapa3 must outlive the solve and the queries.
+ */
+class RedImplicita {
+private:
+  struct Arco {
+    int to;
+    int cap; // Residual capacity
+  };
+
+  int numVertices_;
+  std::vector<Arco> arcos_; // Arc id i is arcos_[2i], its reverse arcos_[2i+1]
+  std::vector<std::vector<int>> adyacentes_; // Indices into arcos_
+  std::vector<int> capacidadOriginal_;       // Per arc id
+
+  // Layer 3
+  const GraphBuilder *builder_;
+  const InstanceView *inst_;
+  int primerMedicoPeriodo_;
+  uint32_t numMedicos_;
+  uint32_t numPeriodos_;
+  uint32_t palabrasMedicos_; // 64-bit words per occurrence in flujo_
+  std::vector<int> diaDestino_; // Day of each layer-3 head node, -1 = none
+  std::vector<uint32_t> periodoOcurrencia_; // Period of each occurrence
+  std::vector<uint8_t> repetida_; // Day already listed earlier in the period
+  std::vector<uint32_t> ocurrenciasOffsets_; // CSR by day of its occurrences
+  std::vector<uint32_t> ocurrencias_;
+  std::vector<uint64_t> flujo_; // Bit m of occurrence o: arc (m, p) -> d used
+
+  // Search buffers, reused across solves
+  std::vector<int> nivel_;
+  std::vector<int64_t> cursor_;
+  std::vector<int> cola_;
+  std::vector<int> camino_;
+
+  Deadline deadline_;
+  bool interrumpido_; // The last solve stopped at the deadline
+
+  bool esMedicoPeriodo(int u) const {
+    return u >= primerMedicoPeriodo_ &&
+           u < primerMedicoPeriodo_ + int(numMedicos_ * numPeriodos_);
+  }
+  bool bitFlujo(uint32_t o, uint32_t m) const {
+    return (flujo_[size_t(o) * palabrasMedicos_ + (m >> 6)] >> (m & 63)) & 1;
+  }
+
+  // Residual neighbour of u at or after position `cursor` of its arcs
+  // (stored ones first, then layer 3), leaving `cursor` on it; -1 if none
+  int avanzar(int u, int64_t &cursor) const;
+
+  // Pushes f units along arc `cursor` of u (as left by avanzar)
+  void empujar(int u, int64_t cursor, int f);
+  int residual(int u, int64_t cursor) const;
+
+  bool bfs(int source, int sink);
+  int aumentar(int source, int sink);
+
+public:
+  RedImplicita();
+
+  // Clear all arcs and resize to `vertices` (storage is kept)
+  void reset(int vertices);
+
+  // Adds a stored arc and returns its id
+  int addArc(int from, int to, int cap);
+
+  // Layer-3 arcs of the builder's instance and node layout. `nodo` is a
+  // layer-3 head (day, Day-Role, Day-Slot or Doctor-Day node) of day `dia`.
+  void marcarDestino(int nodo, uint32_t dia) { diaDestino_[nodo] = dia; }
+  void setCapa3(const GraphBuilder &builder);
+
+  // Time budget checked between augmentations. An interrupted solve leaves
+  // a valid flow.
+  void setDeadline(const Deadline &deadline) { deadline_ = deadline; }
+  bool interrumpido() const { return interrumpido_; }
+
+  /**
+   * Max flow from zero (or until the deadline expires)
+   * @return flow value
+   */
+  int solve(int source, int sink);
+
+  const char *nombre() const { return "implicit"; }
+  int getNumVertices() const { return numVertices_; }
+
+  // Flow on the arcs u -> v (stored or layer 3)
+  int flujo(int u, int v) const;
+
+  // Nodes reachable from source in the residual network (for Min-Cut)
+  std::vector<int> getReachableNodes(int source);
+
+  // Feeds every arc, stored or layer 3, with its capacity and flow to a
+  // started certificate check
+  void certificar(Certificado &certificado) const;
+
+  // Bytes held by the arcs, the flow bits and the search buffers
+  std::size_t memoria() const;
+};
+
+#endif
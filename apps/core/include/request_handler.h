@@ -0,0 +1,74 @@
+#ifndef REQUEST_HANDLER_H
+#define REQUEST_HANDLER_H
+
+#include "cli_options.h"
+#include "result_cache.h"
+#include "session_store.h"
+#include "solver_context.h"
+#include "thread_pool.h"
+#include "windowed_solver.h"
+#include <chrono>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+/**
+ * RequestHandler: Serves solve requests for the solver binary
+ *
+ * Owns one SolverContext and the result cache, so in resident mode every
+ * request after the first reuses the solver buffers, and identical instances
+ * (same canonical hash, same engine) are answered from the cache. With
+ * --window the loaded instance is solved by a WindowedSolver instead.
+ *
+ * Requests tied to a plan version ("sesion") are solved in that session's
+ * own context instead of the shared one (see SessionStore).
+ *
+ * The thread pool of the parallel solver paths is created here, with
+ * --threads threads counting the one serving requests, and shared by all
+ * the contexts. Only the push-relabel engine uses it, so it is created on
+ * the first push-relabel solve and never with the other engines.
+ */
+class RequestHandler {
+private:
+  using Reloj = std::chrono::steady_clock;
+
+  CliOptions opciones_;
+  std::unique_ptr<ThreadPool> pool_; // Null until pool() creates it
+  SolverContext context_;
+  WindowedSolver ventanas_; // --window: solves the instance loaded
+  ResultCache cache_;
+  SessionStore sesiones_;
+
+  // The shared pool, created on first use; null unless the engine is
+  // push-relabel and --threads allows more than one thread
+  ThreadPool *pool();
+
+  // Solve the instance loaded in `context`, with the extras requested.
+  // `completo` = false if the deadline cut the solve or the extras short.
+  ResultadoAsignacion resolver(SolverContext &context, bool &completo);
+
+  // Solve (or fetch from cache) the instance loaded in `context`. With a
+  // session, stats.session must be set and sessions over the memory cap
+  // are dropped once solved.
+  std::string responder(SolverContext &context, SolveStats stats,
+                        Reloj::time_point inicio, int indent);
+
+public:
+  explicit RequestHandler(const CliOptions &opciones);
+
+  // One request given as JSON text, possibly for a session.
+  // indent < 0 answers on a single line.
+  std::string resolverJson(const std::string &jsonInput, int indent);
+
+  // One request read from a file (JSON or .bin)
+  std::string resolverArchivo(const std::string &filePath, int indent);
+
+  // Resident mode: one JSON instance per input line, one JSON line back.
+  // A failing request answers {"error": ...} and the loop continues.
+  void runResident(std::istream &in, std::ostream &out);
+
+  CacheStats cacheStats() const { return cache_.stats(); }
+  const SessionStore &sesiones() const { return sesiones_; }
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "graph_builder.h"
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Cache counters, reported in the stats output
+ */
+struct CacheStats {
+  long long consultas = 0;
+  long long aciertos = 0;      // Memory + disk
+  long long aciertosDisco = 0; // Hits served from the disk cache
+  size_t entradas = 0;
+
+  double tasaAciertos() const {
+    return consultas > 0 ? static_cast<double>(aciertos) / consultas : 0.0;
+  }
+};
+
+/**
+ * ResultCache: Content-addressed cache of solver results
+ *
+ * Keys are "<instance hash>-<engine>". Entries live in memory with LRU
+ * eviction and, if a directory is configured, are also written there as
+ * JSON so they survive restarts. Thread-safe.
+ */
+class ResultCache {
+private:
+  using Entrada = std::pair<std::string, ResultadoAsignacion>;
+
+  size_t capacidad_;
+  std::string directorio_;
+  std::list<Entrada> lru_; // Most recently used first
+  std::unordered_map<std::string, std::list<Entrada>::iterator> indice_;
+  CacheStats stats_;
+  mutable std::mutex mutex_;
+
+  void insertar(const std::string &clave, const ResultadoAsignacion &r);
+  std::string rutaDisco(const std::string &clave) const;
+
+public:
+  // capacidad = max entries kept in memory; directorio = "" disables disk
+  explicit ResultCache(size_t capacidad = 256,
+                       const std::string &directorio = "");
+
+  static std::string clave(const std::string &hash, const std::string &engine);
+
+  // Looks the key up in memory, then on disk. Counts as one lookup.
+  bool buscar(const std::string &clave, ResultadoAsignacion &resultado);
+
+  void guardar(const std::string &clave, const ResultadoAsignacion &resultado);
+
+  CacheStats stats() const;
+};
+
+#endif
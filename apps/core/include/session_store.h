@@ -0,0 +1,62 @@
+#ifndef SESSION_STORE_H
+#define SESSION_STORE_H
+
+#include "json_parser.h"
+#include "solver_context.h"
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/**
+ * SessionStore: Solver state kept per plan version in resident mode
+ *
+ * A session holds the instance a plan version was solved from and its own
+ * SolverContext, so the built graph and the flow of its last solve stay
+ * alive between requests. Repair, what-if and sensitivity requests against
+ * the version then only send their changes (see JSONParser::parseInput):
+ * when those leave the topology as it was, only capacities are rewritten
+ * and max-flow starts from the previous flow.
+ *
+ * Sessions are dropped least recently used first while their estimated
+ * memory is over the cap; a session bigger than the whole cap is not kept.
+ * Not synchronized: resident mode serves one request at a time.
+ */
+class SessionStore {
+public:
+  struct Sesion {
+    InputData instancia;    // As opened; deltas do not change it
+    SolverContext context;  // Warm-starts from its previous flow
+    size_t bytesInstancia = 0;
+  };
+
+private:
+  using Entrada = std::pair<std::string, std::unique_ptr<Sesion>>;
+
+  size_t memoriaMaxima_;
+  std::list<Entrada> lru_; // Most recently used first
+  std::unordered_map<std::string, std::list<Entrada>::iterator> indice_;
+  size_t expiradas_ = 0;
+
+public:
+  // memoriaMaxima in bytes; 0 keeps no sessions
+  explicit SessionStore(size_t memoriaMaxima);
+
+  // Session `id`, marked as most recently used; nullptr if not open
+  Sesion *buscar(const std::string &id);
+
+  // Open session `id` with `instancia`, or replace the instance of an open
+  // one (its context keeps its buffers). `bytes` = size of the request.
+  Sesion &abrir(const std::string &id, InputData instancia, size_t bytes);
+
+  // Drop sessions, least recently used first, until the cap is met. Call
+  // after a request is answered: it may drop the session just used.
+  void expirar();
+
+  size_t numSesiones() const { return lru_.size(); }
+  size_t getExpiradas() const { return expiradas_; }
+  size_t memoriaEstimada() const;
+};
+
+#endif
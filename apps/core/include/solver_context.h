@@ -0,0 +1,252 @@
+#ifndef SOLVER_CONTEXT_H
+#define SOLVER_CONTEXT_H
+
+#include "boykov_kolmogorov.h"
+#include "certificado.h"
+#include "edmonds_karp.h"
+#include "graph.h"
+#include "graph_builder.h"
+#include "json_parser.h"
+#include "min_cost_flow.h"
+#include "push_relabel.h"
+#include "red_implicita.h"
+#include <string>
+#include <vector>
+
+/**
+ * SolverContext: Reusable state for solving one instance at a time
+ *
+ * Owns the builder, the capacity and residual graphs, the flow matrix and the
+ * Edmonds-Karp search buffers. After the first solve, loading a new instance
+ * of similar size reuses all of them instead of reallocating. When only
+ * capacities changed since the last solve (same doctors, days, periods and
+ * availability), the built graph itself is reused and just its capacities
+ * are rewritten.
+ *
+ * Locked assignments are solved as a flow with lower bounds in the same
+ * network; if the locks alone cannot be met, the result is infeasible and
+ * its bottlenecks name the conflicting locks.
+ *
+ * With a previous plan, solve() finds a max-coverage solution that changes as
+ * few previous (doctor, day) pairs as possible, using a min-cost flow warm-
+ * started from the old assignments. Previous plans cannot be combined with
+ * locked assignments.
+ *
+ * With day priorities, days are filled by priority: the flow reaches every
+ * day of a priority as far as possible before any day of a lower one. The
+ * coverage vectors the flows of this network can reach (doctors per day)
+ * form a polymatroid (a matroid only when every day needs at most one
+ * doctor), so this greedy order also maximizes the priority-weighted
+ * coverage. The result is still a max flow, so bottlenecks come from its min
+ * cut as usual.
+ *
+ * With a deadline, a solve that runs out of time returns the best flow found
+ * so far as an infeasible result marked `parcial`, without bottlenecks.
+ *
+ * With setReutilizarFlujo(true), a plain solve whose topology was reused
+ * starts max-flow from the flow of the previous solve instead of from zero
+ * (see EdmondsKarp::maxFlowDesde). The coverage is the same; which of the
+ * equally good assignments comes out may differ from a cold solve, which is
+ * why it is off by default.
+ *
+ * Plain solves (no locks, previous plan, priorities or flow reuse) run on
+ * the engine chosen with setMotor: Edmonds-Karp by default, or the
+ * multi-threaded push-relabel for very large instances. Both give the same
+ * coverage and bottlenecks; the other solves always use Edmonds-Karp.
+ *
+ * Every matrix solve but the stability-aware one keeps its residual graph
+ * and flow matrix in the narrowest integer width the network's capacities
+ * allow (see GraphBuilder::getAnchoCapacidad and MatrizFlujo), chosen per
+ * solve; solves with locks widen it for their circulation network (see
+ * EdmondsKarp::anchoConCotas), and warm starts resume at the wider of their
+ * width and the previous solve's.
+ *
+ * The "implicit" engine goes further and never builds the matrix network:
+ * instances without locks, previous plan or priorities are solved on a
+ * RedImplicita, which generates the Doctor-Period -> Day arcs from the
+ * availability bitsets. Same coverage and bottlenecks; no flow reuse, no
+ * sensitivity, and the graph and flow matrix are left empty.
+ *
+ * The "boykov-kolmogorov" engine is meant for interactive edits: each plain
+ * solve resumes from the flow and search trees of the previous one when
+ * that was a plain solve on it too, whatever changed in between (topology
+ * included), and only repairs the arcs whose capacity changed (see
+ * BoykovKolmogorov::maxFlowDesde).
+ *
+ * With setVerificar(true), every complete solve is checked against its
+ * optimality certificate (see Certificado) before it is returned: the flow
+ * respects capacities, lower bounds and conservation, and the cut its
+ * bottlenecks come from has the flow's value as capacity. The check is
+ * linear in the network, so it is cheap next to the solve; a result cut
+ * short by the deadline is not maximum and is not checked.
+ *
+ * A context holds no global state, so it is reentrant, but it is not
+ * synchronized: keep one context per thread.
+ */
+class SolverContext {
+private:
+  GraphBuilder builder_;
+  Graph graph_;
+  Graph residualGraph_;
+  GraphT<uint8_t> residual8_; // Narrow residual graphs
+  GraphT<uint16_t> residual16_;
+  std::vector<std::vector<int>> flowGraph_; // Of residual16_ and residualGraph_
+  MatrizFlujo<uint8_t> flujo8_;             // Of residual8_
+  AnchoCapacidad ancho_; // Which of the widths the last solve used
+  EdmondsKarp ek_;
+  PushRelabel pushRelabel_;
+  bool conPushRelabel_; // Engine of plain solves
+  BoykovKolmogorov boykovKolmogorov_;
+  bool conBoykovKolmogorov_;
+  bool arbolesValidos_; // residualGraph_ and flowGraph_ are as
+                        // boykovKolmogorov_ left them
+  RedImplicita implicita_;
+  bool conImplicita_;
+  MinCostFlow red_; // Stability-aware solves
+  Certificado certificado_;
+  bool verificar_;
+
+  bool loaded_;
+  bool topologiaReutilizada_;
+  bool residualValido_; // The active residual matches a plain max-flow solve
+  bool reutilizarFlujo_;
+  bool flujoValido_;     // flowGraph_ is a flow of graph_'s node layout
+  bool flujoReutilizado_;
+  int maxFlow_;
+
+  // Calls f with the residual graph and flow matrix of width `ancho`
+  template <typename F> auto conAncho(AnchoCapacidad ancho, F f) {
+    switch (ancho) {
+    case AnchoCapacidad::U8:
+      return f(residual8_, flujo8_);
+    case AnchoCapacidad::U16:
+      return f(residual16_, flowGraph_);
+    default:
+      return f(residualGraph_, flowGraph_);
+    }
+  }
+
+  // Copies the residual graph and flow of width `desde` to the wider
+  // `ancho`, for a warm start that resumes at `ancho`
+  void ensanchar(AnchoCapacidad desde, AnchoCapacidad ancho);
+
+  // Marks `resultado` partial if the solve was interrupted short of full
+  // coverage. Returns true if it did.
+  bool marcarParcial(ResultadoAsignacion &resultado, bool interrumpido);
+
+  // solve() for instances with locked assignments (lower-bound flow)
+  ResultadoAsignacion solveConFijas();
+
+  // solve() for instances with a previous plan (min-cost flow)
+  ResultadoAsignacion solveEstable();
+
+  // Plain solve() on the implicit engine (no stored layer-3 arcs)
+  ResultadoAsignacion solveImplicito();
+
+  // Throws if the certificate check just run failed
+  void exigirCertificado(bool cumple) const;
+
+public:
+  SolverContext();
+
+  // Drop the loaded instance (buffers are kept for the next one)
+  void reset();
+
+  // Load a new instance, replacing the previous one
+  void load(const InputData &data);
+
+  // Load an interned instance (e.g. a mapped .bin file) without copying it.
+  // The view must stay valid until the next load or reset.
+  void load(const InstanceView &instance);
+
+  // Time budget for the following solves (default: none)
+  void setDeadline(const Deadline &deadline);
+
+  /**
+   * Max-flow engine of plain solves: "edmonds-karp" (default),
+   * "push-relabel", "implicit" or "boykov-kolmogorov"
+   * @throws std::runtime_error on any other name
+   */
+  void setMotor(const std::string &nombre);
+
+  // Pool of the parallel paths (the push-relabel engine); default: none,
+  // everything runs on the calling thread. Must outlive the solves.
+  void setPool(ThreadPool *pool) { pushRelabel_.setPool(pool); }
+
+  // Arcs per pool thread below which push-relabel uses fewer threads (see
+  // PushRelabel::setArcosPorHilo)
+  void setArcosPorHilo(int arcos) { pushRelabel_.setArcosPorHilo(arcos); }
+
+  // Warm-start plain solves from the previous flow when the topology is
+  // reused (default: off)
+  void setReutilizarFlujo(bool reutilizar) { reutilizarFlujo_ = reutilizar; }
+
+  // Check the optimality certificate of every complete solve; a failed
+  // check makes solve() throw std::runtime_error (default: off)
+  void setVerificar(bool verificar) { verificar_ = verificar; }
+
+  // Vertex order of the networks built by the following solves (see
+  // GraphBuilder::setRenumerar; default: off)
+  void setRenumerar(bool renumerar) { builder_.setRenumerar(renumerar); }
+
+  // An instance is loaded (and not reset since)
+  bool cargado() const { return loaded_; }
+
+  /**
+   * Interns the loaded instance and checks that its fields can be combined,
+   * which solve() does first: callers can tell input errors from failures
+   * of the solve itself.
+   * @throws std::runtime_error if no instance is loaded or it is invalid
+   */
+  const InstanceView &validar();
+
+  /**
+   * Builds the graph, runs max-flow and extracts the result.
+   * Bottlenecks are computed only when the instance is not feasible.
+   * @throws std::runtime_error if validar() fails, or if the result fails
+   *         its optimality certificate (setVerificar)
+   */
+  ResultadoAsignacion solve();
+
+  /**
+   * Doctor-removal sensitivity of the last solve: for every doctor, the
+   * coverage lost if they drop out. Reroutes one doctor's flow at a time in
+   * the residual graph instead of solving the instance again per doctor.
+   * Sorted by coverage lost (largest first), then by name. Empty if the
+   * deadline expires before the table is complete.
+   * @throws std::runtime_error if the last solve had locked or previous
+   *         assignments, or if nothing was solved
+   */
+  std::vector<SensibilidadMedico> sensibilidad();
+
+  // Interned form of the loaded instance (e.g. to hash it before solving)
+  const InstanceView &instancia() { return builder_.internar(); }
+
+  // Name of the max-flow engine, part of the result cache key
+  std::string getEngine() const {
+    return conImplicita_          ? implicita_.nombre()
+           : conPushRelabel_      ? pushRelabel_.nombre()
+           : conBoykovKolmogorov_ ? boykovKolmogorov_.nombre()
+                                  : ek_.nombre();
+  }
+
+  // Results of the last solve (graph and flow matrix: see solve() variants;
+  // after a stability-aware solve only the flow matrix is up to date)
+  int getMaxFlow() const { return maxFlow_; }
+  bool getTopologiaReutilizada() const { return topologiaReutilizada_; }
+  bool getFlujoReutilizado() const { return flujoReutilizado_; }
+
+  // Approximate bytes held by the graphs and the flow matrix, which dominate
+  // a context's memory (V x V each)
+  size_t memoriaEstimada() const;
+  const Graph &getGraph() const { return graph_; }
+
+  // Calls f with the flow matrix of the last solve, whose element type
+  // depends on the width it ran at
+  template <typename F> auto conFlujo(F f) const {
+    return ancho_ == AnchoCapacidad::U8 ? f(flujo8_) : f(flowGraph_);
+  }
+  const GraphBuilder &getBuilder() const { return builder_; }
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * ThreadPool: Work-stealing task scheduler shared by the parallel solver
+ * paths (e.g. the push-relabel engine)
+ *
+ * Each worker has its own deque: it pushes and pops the tasks it launches at
+ * the back (most recent first, warm in cache) and, when it runs out, steals
+ * from the front of the others'. Tasks launched from outside the pool go to
+ * a shared queue. Idle workers spin briefly, then park on a condition
+ * variable until new work arrives.
+ *
+ * Tasks are launched and waited for in groups (Grupo). A thread waiting on a
+ * group runs pending tasks meanwhile, so tasks can launch and wait for
+ * groups of their own without deadlocking the pool, and the caller of a
+ * parallel loop works on it too: up to getHilos() + 1 tasks run at once.
+ *
+ * Owned by whoever runs the solves (one per RequestHandler) and handed to
+ * them as a pointer; a null pool means "run everything on the caller".
+ */
+class ThreadPool {
+public:
+  /**
+   * A set of tasks to wait for. Tasks must not outlive what they capture;
+   * the destructor waits for them. The first exception thrown by a task is
+   * rethrown by esperar().
+   */
+  class Grupo {
+  private:
+    ThreadPool *pool_;
+    std::atomic<int> pendientes_{0};
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+
+    friend class ThreadPool;
+    void terminar(std::exception_ptr error);
+
+  public:
+    // With a null pool, lanzar() runs each task right away
+    explicit Grupo(ThreadPool *pool) : pool_(pool) {}
+    ~Grupo();
+    Grupo(const Grupo &) = delete;
+    Grupo &operator=(const Grupo &) = delete;
+
+    void lanzar(std::function<void()> tarea);
+    void esperar();
+  };
+
+  // `hilos` worker threads (at least one)
+  explicit ThreadPool(unsigned hilos);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  unsigned getHilos() const { return trabajadores_.size(); }
+
+  // Workers parked right now (for tests)
+  unsigned getDormidos() const { return dormidos_.load(); }
+
+  // f(i) for every i in [0, n), as n tasks of one group. Runs inline with a
+  // null pool or n = 1.
+  static void paraCada(ThreadPool *pool, int n,
+                       const std::function<void(int)> &f);
+
+private:
+  struct Tarea {
+    std::function<void()> f;
+    Grupo *grupo;
+  };
+
+  struct Cola {
+    std::mutex m;
+    std::deque<Tarea> tareas;
+  };
+
+  std::vector<std::thread> trabajadores_;
+  std::vector<std::unique_ptr<Cola>> colas_; // One per worker, then shared
+  std::atomic<unsigned> epoca_{0};           // Bumped on every new task
+  std::atomic<unsigned> dormidos_{0};
+  std::atomic<bool> parar_{false};
+  std::mutex aparcarMutex_;
+  std::condition_variable aparcar_;
+
+  // Worker index of the calling thread in this pool, or -1
+  int indiceActual() const;
+
+  void encolar(Tarea tarea);
+
+  // Runs one pending task (own deque, shared queue, then stealing) from
+  // the point of view of worker `indice` (-1 = outside thread)
+  bool ejecutarUna(int indice);
+
+  void trabajar(int indice);
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef TRAZA_H
+#define TRAZA_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * Traza: Timeline of the solver phases, in Chrome Trace Event Format
+ * (--trace=file.json, opens in Perfetto or chrome://tracing)
+ *
+ * A Tramo is one span: it records its name, start and duration when it goes
+ * out of scope. Spans nest by scope, so an engine's rounds show up under
+ * the solve that ran them. Each thread records into a buffer of its own and
+ * is one track of the timeline, named by nombrarHilo() (pool workers name
+ * themselves), so parallel phases show which worker ran what.
+ *
+ * Process-wide and off by default: with tracing off a span costs one atomic
+ * load, so phases are traced unconditionally. Span names and argument keys
+ * must be string literals (they are stored as pointers).
+ */
+class Traza {
+public:
+  class Tramo {
+  private:
+    static constexpr int MAX_ARGS = 2;
+    const char *nombre_;
+    const char *categoria_;
+    int64_t inicio_; // ns since activar(), < 0 = not recording
+    const char *claves_[MAX_ARGS];
+    long long valores_[MAX_ARGS];
+    int numArgs_;
+
+  public:
+    explicit Tramo(const char *nombre, const char *categoria = "solver");
+    ~Tramo();
+    Tramo(const Tramo &) = delete;
+    Tramo &operator=(const Tramo &) = delete;
+
+    // Shown in the span's details; the first MAX_ARGS keys are kept, and
+    // the same key (literal) again replaces its value
+    void arg(const char *clave, long long valor);
+
+    // End the span now instead of at the end of the scope
+    void terminar();
+  };
+
+  // Start recording, dropping whatever was recorded before
+  static void activar();
+
+  // Stop recording and drop the events
+  static void desactivar();
+
+  static bool activa() { return activa_.load(std::memory_order_acquire); }
+
+  // Track name of the calling thread (default "thread N")
+  static void nombrarHilo(const std::string &nombre);
+
+  // Events recorded so far, as a trace JSON document
+  static std::string toJson();
+
+  // Write toJson() to `ruta`
+  // @throws std::runtime_error if the file cannot be written
+  static void escribir(const std::string &ruta);
+
+private:
+  static std::atomic<bool> activa_;
+};
+
+#endif
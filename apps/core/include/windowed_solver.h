@@ -0,0 +1,60 @@
+#ifndef WINDOWED_SOLVER_H
+#define WINDOWED_SOLVER_H
+
+#include "instance.h"
+#include "solver_context.h"
+#include <string>
+#include <vector>
+
+/**
+ * WindowedSolver: Rolling-horizon solving of long plans
+ *
+ * Periods are sorted chronologically (by their first day in input order) and
+ * solved a window of N periods at a time, each window as its own small
+ * instance (see InternedInstance::internarVentana). What every doctor was
+ * assigned in earlier windows is taken off their total limit in the later
+ * ones, so only one window's graph is alive at a time and each solve stays
+ * the size of a window however long the plan is.
+ *
+ * A day belongs to the window of its earliest period; days in no period go
+ * to the first window. Windows are solved greedily, so a window can spend a
+ * budget a later one needed. The optional repair pass then solves the whole
+ * instance once, warm-started from the windowed plan and changing as few of
+ * its pairs as possible (the stability-aware solve), which restores the
+ * global optimum at the cost of one full-size solve.
+ */
+class WindowedSolver {
+private:
+  SolverContext context_;       // Reused by every window
+  InternedInstance ventana_;    // Instance of the current window
+  std::vector<uint32_t> plan_;  // Windowed plan as (doctor, day) pairs
+  InstanceView reparacion_;     // Whole instance with plan_ as previous plan
+  uint32_t numVentanas_ = 0;
+
+public:
+  // Time budget shared by all windows and the repair pass
+  void setDeadline(const Deadline &deadline) { context_.setDeadline(deadline); }
+
+  // Max-flow engine of the windows (see SolverContext::setMotor)
+  void setMotor(const std::string &nombre) { context_.setMotor(nombre); }
+  void setPool(ThreadPool *pool) { context_.setPool(pool); }
+  void setRenumerar(bool renumerar) { context_.setRenumerar(renumerar); }
+  void setVerificar(bool verificar) { context_.setVerificar(verificar); }
+
+  /**
+   * Solves `instancia` in windows of `periodosPorVentana` periods (> 0).
+   * Assignments, coverage, bottlenecks and the per-window extras are merged,
+   * assignments in the order a plain solve lists them; the result is partial
+   * if any window ran out of time. The repair pass reports no stability
+   * (only the instance's own previous assignments would).
+   * @throws std::runtime_error if `reparar` is set and the instance has
+   *         locked or previous assignments or day priorities
+   */
+  ResultadoAsignacion solve(const InstanceView &instancia,
+                            uint32_t periodosPorVentana, bool reparar);
+
+  // Number of windows of the last solve
+  uint32_t getNumVentanas() const { return numVentanas_; }
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include "bfs_bitset.h"
+#include <algorithm>
+
+namespace {
+
+int bitBajo(uint64_t palabra) { return __builtin_ctzll(palabra); }
+
+} // namespace
+
+bool BfsBitset::buscar(const GraphBase &g, int source, int sink,
+                       int *parent, bool exacto) {
+  const int n = g.getNumVertices();
+  const int W = g.getPalabras();
+  const int R = g.getPalabrasResumen();
+  visitados_.assign(W, 0);
+  if (n % 64 != 0) {
+    visitados_[W - 1] = ~uint64_t(0) << (n % 64);
+  }
+  frontera_.resize(W);
+  cola_.clear();
+  posicion_.resize(n);
+  nivelesAbajoArriba_ = 0;
+
+  auto visitar = [&](int v, int padre) {
+    visitados_[v >> 6] |= uint64_t(1) << (v & 63);
+    posicion_[v] = cola_.size();
+    cola_.push_back(v);
+    if (parent != nullptr) {
+      parent[v] = padre;
+    }
+  };
+  visitar(source, -1);
+
+  size_t inicio = 0;
+  while (inicio < cola_.size()) {
+    size_t fin = cola_.size();
+    size_t pendientes = n - fin;
+    if (pendientes == 0) {
+      break;
+    }
+
+    if (pendientes >= fin - inicio) {
+      // Top-down: heads of each frontier vertex not visited yet, in
+      // ascending order, as a FIFO queue BFS would enqueue them
+      for (size_t i = inicio; i < fin; i++) {
+        int u = cola_[i];
+        const uint64_t *fila = g.getSalientes(u);
+        const uint64_t *resumen = g.getResumenSalientes(u);
+        for (int r = 0; r < R; r++) {
+          for (uint64_t ws = resumen[r]; ws != 0; ws &= ws - 1) {
+            int w = (r << 6) + bitBajo(ws);
+            palabrasLeidas_++;
+            uint64_t nuevos = fila[w] & ~visitados_[w];
+            while (nuevos != 0) {
+              int v = (w << 6) + bitBajo(nuevos);
+              nuevos &= nuevos - 1;
+              visitar(v, u);
+              if (v == sink) {
+                return true;
+              }
+            }
+          }
+        }
+      }
+    } else {
+      // Bottom-up: a parent in the frontier for each unvisited vertex
+      nivelesAbajoArriba_++;
+      std::fill(frontera_.begin(), frontera_.end(), 0);
+      for (size_t i = inicio; i < fin; i++) {
+        frontera_[cola_[i] >> 6] |= uint64_t(1) << (cola_[i] & 63);
+      }
+
+      nuevos_.clear();
+      for (int w = 0; w < W; w++) {
+        uint64_t libres = ~visitados_[w];
+        while (libres != 0) {
+          int v = (w << 6) + bitBajo(libres);
+          libres &= libres - 1;
+          const uint64_t *columna = g.getEntrantes(v);
+          const uint64_t *resumen = g.getResumenEntrantes(v);
+          int mejor = -1; // Queue position of the parent
+          for (int r = 0; r < R && (exacto || mejor < 0); r++) {
+            for (uint64_t ws = resumen[r]; ws != 0; ws &= ws - 1) {
+              int x = (r << 6) + bitBajo(ws);
+              palabrasLeidas_++;
+              uint64_t candidatos = columna[x] & frontera_[x];
+              if (candidatos == 0) {
+                continue;
+              }
+              if (!exacto) {
+                mejor = posicion_[(x << 6) + bitBajo(candidatos)];
+                break;
+              }
+              // The FIFO parent is the earliest-queued candidate
+              while (candidatos != 0) {
+                int pos = posicion_[(x << 6) + bitBajo(candidatos)];
+                candidatos &= candidatos - 1;
+                if (mejor < 0 || pos < mejor) {
+                  mejor = pos;
+                }
+              }
+            }
+          }
+          if (mejor >= 0) {
+            nuevos_.emplace_back(mejor, v);
+          }
+        }
+      }
+
+      // Enqueue in top-down order: by parent position, then by vertex
+      std::sort(nuevos_.begin(), nuevos_.end());
+      bool encontrado = false;
+      for (const auto &[pos, v] : nuevos_) {
+        visitar(v, cola_[pos]);
+        encontrado = encontrado || v == sink;
+      }
+      if (encontrado) {
+        return true;
+      }
+    }
+    inicio = fin;
+  }
+
+  return false;
+}
+
+bool BfsBitset::camino(const GraphBase &g, int source, int sink,
+                       std::vector<int> &parent) {
+  return buscar(g, source, sink, parent.data(), true);
+}
+
+const std::vector<int> &BfsBitset::alcanzables(const GraphBase &g,
+                                               int source) {
+  buscar(g, source, -1, nullptr, false);
+  return cola_;
+}
@@ -0,0 +1,486 @@
+#include "binary_instance.h"
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const char MAGIC[4] = {'M', 'F', 'B', 'I'};
+const uint32_t VERSION = 1;
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct Cabecera {
+  char magic[4];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint32_t numMedicos;
+  uint32_t numDias;
+  uint32_t numPeriodos;
+  int32_t maxGuardiasPorPeriodo;
+  int32_t maxGuardiasTotales;
+  uint32_t palabrasPorMedico;
+  uint32_t numSecciones;
+};
+
+struct Seccion {
+  uint32_t id;
+  uint32_t reservado;
+  uint64_t offset;
+  uint64_t size;
+};
+
+enum SeccionId : uint32_t {
+  NOMBRE_OFFSETS = 1,
+  NOMBRES = 2,
+  PERIODO_OFFSETS = 3,
+  PERIODO_DIAS = 4,
+  DISPONIBILIDAD = 5,
+  DIAS_DISPONIBLES = 6,
+  MEDICOS_POR_DIA = 7,
+  CAPACIDADES = 8,
+  CAP_PERIODO_OFFSETS = 9, // Optional: per-period capacities
+  CAP_PERIODO_PERIODOS = 10,
+  CAP_PERIODO_VALORES = 11,
+  FIJAS = 12,   // Optional: locked (doctor, day) pairs
+  PREVIAS = 13, // Optional: previous plan (doctor, day) pairs
+  PRIORIDADES = 14, // Optional: day priorities
+  ROL_NOMBRE_OFFSETS = 15, // Optional: roles (all six sections or none)
+  ROL_NOMBRES = 16,
+  ROL_MEDICO = 17,
+  DEMANDA_ROL_OFFSETS = 18,
+  DEMANDA_ROL_ROLES = 19,
+  DEMANDA_ROL_VALORES = 20,
+  TURNO_NOMBRE_OFFSETS = 21, // Optional: shift slots (all five or none)
+  TURNO_NOMBRES = 22,
+  DEMANDA_TURNO_OFFSETS = 23,
+  DEMANDA_TURNO_TURNOS = 24,
+  DEMANDA_TURNO_VALORES = 25,
+  TURNO_MEDICO_OFFSETS = 26, // Optional, with slots: restrictions (both)
+  TURNO_MEDICO_DEMANDAS = 27,
+  NUM_SECCIONES = 27
+};
+
+uint64_t alinear(uint64_t offset) { return (offset + 7) & ~uint64_t(7); }
+
+[[noreturn]] void invalido(const std::string &razon) {
+  throw std::runtime_error("Invalid binary instance: " + razon);
+}
+
+// Checks that an array of offsets is non-decreasing and ends within `limite`
+void validarOffsets(const uint32_t *offsets, size_t n, uint64_t limite,
+                    const char *nombre) {
+  if (offsets[0] != 0) {
+    invalido(std::string(nombre) + " must start at 0");
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (offsets[i + 1] < offsets[i]) {
+      invalido(std::string(nombre) + " are not sorted");
+    }
+  }
+  if (offsets[n] > limite) {
+    invalido(std::string(nombre) + " out of range");
+  }
+}
+
+} // namespace
+
+BinaryInstance::BinaryInstance(const std::string &filePath)
+    : data_(nullptr), size_(0) {
+  int fd = open(filePath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open file: " + filePath);
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(Cabecera)) {
+    close(fd);
+    invalido("file too small");
+  }
+  size_ = st.st_size;
+
+  data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data_ == MAP_FAILED) {
+    data_ = nullptr;
+    throw std::runtime_error("Could not map file: " + filePath);
+  }
+
+  try {
+    validar();
+  } catch (...) {
+    munmap(data_, size_);
+    throw;
+  }
+}
+
+BinaryInstance::~BinaryInstance() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+}
+
+void BinaryInstance::validar() {
+  const char *base = static_cast<const char *>(data_);
+  const Cabecera *cab = reinterpret_cast<const Cabecera *>(base);
+
+  if (std::memcmp(cab->magic, MAGIC, sizeof(MAGIC)) != 0) {
+    invalido("bad magic");
+  }
+  if (cab->byteOrder != BYTE_ORDER_MARK) {
+    invalido("written with a different byte order");
+  }
+  if (cab->version != VERSION) {
+    invalido("unsupported version " + std::to_string(cab->version));
+  }
+
+  uint64_t tablaInicio = alinear(sizeof(Cabecera));
+  if (tablaInicio + uint64_t(cab->numSecciones) * sizeof(Seccion) > size_) {
+    invalido("truncated section table");
+  }
+  const Seccion *tabla =
+      reinterpret_cast<const Seccion *>(base + tablaInicio);
+
+  // Locate each known section and check its bounds and expected size
+  const void *secciones[NUM_SECCIONES + 1] = {};
+  uint64_t tamanos[NUM_SECCIONES + 1] = {};
+  for (uint32_t i = 0; i < cab->numSecciones; i++) {
+    const Seccion &s = tabla[i];
+    if (s.offset % 8 != 0 || s.offset > size_ || s.size > size_ - s.offset) {
+      invalido("section " + std::to_string(s.id) + " out of bounds");
+    }
+    if (s.id >= 1 && s.id <= NUM_SECCIONES) {
+      secciones[s.id] = base + s.offset;
+      tamanos[s.id] = s.size;
+    }
+  }
+
+  uint64_t M = cab->numMedicos;
+  uint64_t D = cab->numDias;
+  uint64_t P = cab->numPeriodos;
+  uint64_t W = cab->palabrasPorMedico;
+  if (W != (D + 63) / 64) {
+    invalido("bitset width does not match the number of days");
+  }
+
+  auto requerir = [&](SeccionId id, uint64_t esperado, const char *nombre) {
+    if (secciones[id] == nullptr) {
+      invalido(std::string("missing section ") + nombre);
+    }
+    if (esperado != UINT64_MAX && tamanos[id] != esperado) {
+      invalido(std::string("wrong size for section ") + nombre);
+    }
+  };
+  requerir(NOMBRE_OFFSETS, (M + D + P + 1) * 4, "nombreOffsets");
+  requerir(NOMBRES, UINT64_MAX, "nombres");
+  requerir(PERIODO_OFFSETS, (P + 1) * 4, "periodoOffsets");
+  requerir(PERIODO_DIAS, UINT64_MAX, "periodoDias");
+  requerir(DISPONIBILIDAD, M * W * 8, "disponibilidad");
+  requerir(DIAS_DISPONIBLES, M * 4, "diasDisponibles");
+  requerir(MEDICOS_POR_DIA, D * 4, "medicosPorDia");
+  requerir(CAPACIDADES, M * 4, "capacidades");
+
+  view_ = InstanceView();
+  view_.numMedicos = cab->numMedicos;
+  view_.numDias = cab->numDias;
+  view_.numPeriodos = cab->numPeriodos;
+  view_.maxGuardiasPorPeriodo = cab->maxGuardiasPorPeriodo;
+  view_.maxGuardiasTotales = cab->maxGuardiasTotales;
+  view_.palabrasPorMedico = cab->palabrasPorMedico;
+  view_.nombreOffsets = static_cast<const uint32_t *>(secciones[NOMBRE_OFFSETS]);
+  view_.nombres = static_cast<const char *>(secciones[NOMBRES]);
+  view_.periodoOffsets =
+      static_cast<const uint32_t *>(secciones[PERIODO_OFFSETS]);
+  view_.periodoDias = static_cast<const uint32_t *>(secciones[PERIODO_DIAS]);
+  view_.disponibilidad =
+      static_cast<const uint64_t *>(secciones[DISPONIBILIDAD]);
+  view_.diasDisponibles =
+      static_cast<const uint32_t *>(secciones[DIAS_DISPONIBLES]);
+  view_.medicosPorDia = static_cast<const int32_t *>(secciones[MEDICOS_POR_DIA]);
+  view_.capacidades = static_cast<const int32_t *>(secciones[CAPACIDADES]);
+
+  // Per-period capacities: all three sections or none
+  if (secciones[CAP_PERIODO_OFFSETS] != nullptr) {
+    requerir(CAP_PERIODO_OFFSETS, (M + 1) * 4, "capPeriodoOffsets");
+    requerir(CAP_PERIODO_PERIODOS, UINT64_MAX, "capPeriodoPeriodos");
+    requerir(CAP_PERIODO_VALORES, tamanos[CAP_PERIODO_PERIODOS],
+             "capPeriodoValores");
+    view_.capPeriodoOffsets =
+        static_cast<const uint32_t *>(secciones[CAP_PERIODO_OFFSETS]);
+    view_.capPeriodoPeriodos =
+        static_cast<const uint32_t *>(secciones[CAP_PERIODO_PERIODOS]);
+    view_.capPeriodoValores =
+        static_cast<const int32_t *>(secciones[CAP_PERIODO_VALORES]);
+  }
+  auto pares = [&](SeccionId id, const char *nombre, uint32_t &num,
+                   const uint32_t *&datos) {
+    if (secciones[id] != nullptr) {
+      if (tamanos[id] % 8 != 0) {
+        invalido(std::string("wrong size for section ") + nombre);
+      }
+      num = tamanos[id] / 8;
+      datos = static_cast<const uint32_t *>(secciones[id]);
+    }
+  };
+  pares(FIJAS, "fijas", view_.numFijas, view_.fijas);
+  pares(PREVIAS, "previas", view_.numPrevias, view_.previas);
+  if (secciones[PRIORIDADES] != nullptr) {
+    requerir(PRIORIDADES, D * 4, "prioridades");
+    view_.prioridadDia = static_cast<const int32_t *>(secciones[PRIORIDADES]);
+  }
+  if (secciones[ROL_NOMBRE_OFFSETS] != nullptr) {
+    if (tamanos[ROL_NOMBRE_OFFSETS] < 4 || tamanos[ROL_NOMBRE_OFFSETS] % 4) {
+      invalido("wrong size for section rolNombreOffsets");
+    }
+    view_.numRoles = tamanos[ROL_NOMBRE_OFFSETS] / 4 - 1;
+    requerir(ROL_NOMBRES, UINT64_MAX, "rolNombres");
+    requerir(ROL_MEDICO, M * 4, "rolMedico");
+    requerir(DEMANDA_ROL_OFFSETS, (D + 1) * 4, "demandaRolOffsets");
+    requerir(DEMANDA_ROL_ROLES, UINT64_MAX, "demandaRolRoles");
+    requerir(DEMANDA_ROL_VALORES, tamanos[DEMANDA_ROL_ROLES],
+             "demandaRolValores");
+    view_.rolNombreOffsets =
+        static_cast<const uint32_t *>(secciones[ROL_NOMBRE_OFFSETS]);
+    view_.rolNombres = static_cast<const char *>(secciones[ROL_NOMBRES]);
+    view_.rolMedico = static_cast<const int32_t *>(secciones[ROL_MEDICO]);
+    view_.demandaRolOffsets =
+        static_cast<const uint32_t *>(secciones[DEMANDA_ROL_OFFSETS]);
+    view_.demandaRolRoles =
+        static_cast<const uint32_t *>(secciones[DEMANDA_ROL_ROLES]);
+    view_.demandaRolValores =
+        static_cast<const int32_t *>(secciones[DEMANDA_ROL_VALORES]);
+  }
+  if (secciones[TURNO_NOMBRE_OFFSETS] != nullptr) {
+    if (tamanos[TURNO_NOMBRE_OFFSETS] < 4 || tamanos[TURNO_NOMBRE_OFFSETS] % 4) {
+      invalido("wrong size for section turnoNombreOffsets");
+    }
+    view_.numTurnos = tamanos[TURNO_NOMBRE_OFFSETS] / 4 - 1;
+    requerir(TURNO_NOMBRES, UINT64_MAX, "turnoNombres");
+    requerir(DEMANDA_TURNO_OFFSETS, (D + 1) * 4, "demandaTurnoOffsets");
+    requerir(DEMANDA_TURNO_TURNOS, UINT64_MAX, "demandaTurnoTurnos");
+    requerir(DEMANDA_TURNO_VALORES, tamanos[DEMANDA_TURNO_TURNOS],
+             "demandaTurnoValores");
+    view_.turnoNombreOffsets =
+        static_cast<const uint32_t *>(secciones[TURNO_NOMBRE_OFFSETS]);
+    view_.turnoNombres = static_cast<const char *>(secciones[TURNO_NOMBRES]);
+    view_.demandaTurnoOffsets =
+        static_cast<const uint32_t *>(secciones[DEMANDA_TURNO_OFFSETS]);
+    view_.demandaTurnoTurnos =
+        static_cast<const uint32_t *>(secciones[DEMANDA_TURNO_TURNOS]);
+    view_.demandaTurnoValores =
+        static_cast<const int32_t *>(secciones[DEMANDA_TURNO_VALORES]);
+
+    if (secciones[TURNO_MEDICO_OFFSETS] != nullptr) {
+      requerir(TURNO_MEDICO_OFFSETS, (M + 1) * 4, "turnoMedicoOffsets");
+      requerir(TURNO_MEDICO_DEMANDAS, UINT64_MAX, "turnoMedicoDemandas");
+      view_.turnoMedicoOffsets =
+          static_cast<const uint32_t *>(secciones[TURNO_MEDICO_OFFSETS]);
+      view_.turnoMedicoDemandas =
+          static_cast<const uint32_t *>(secciones[TURNO_MEDICO_DEMANDAS]);
+    }
+  }
+
+  // Indices read later without checks must stay in range
+  validarOffsets(view_.nombreOffsets, M + D + P, tamanos[NOMBRES], "names");
+  validarOffsets(view_.periodoOffsets, P, tamanos[PERIODO_DIAS] / 4,
+                 "period offsets");
+  for (uint32_t k = 0; k < view_.periodoOffsets[P]; k++) {
+    if (view_.periodoDias[k] >= D) {
+      invalido("period day index out of range");
+    }
+  }
+  if (view_.capPeriodoOffsets != nullptr) {
+    validarOffsets(view_.capPeriodoOffsets, M,
+                   tamanos[CAP_PERIODO_PERIODOS] / 4, "capacity offsets");
+    for (uint32_t k = 0; k < view_.capPeriodoOffsets[M]; k++) {
+      if (view_.capPeriodoPeriodos[k] >= P) {
+        invalido("capacity period index out of range");
+      }
+    }
+  }
+  for (uint32_t f = 0; f < view_.numFijas; f++) {
+    if (view_.fijas[2 * f] >= M || view_.fijas[2 * f + 1] >= D) {
+      invalido("locked assignment index out of range");
+    }
+  }
+  if (view_.conRoles()) {
+    validarOffsets(view_.rolNombreOffsets, view_.numRoles,
+                   tamanos[ROL_NOMBRES], "role names");
+    validarOffsets(view_.demandaRolOffsets, D,
+                   tamanos[DEMANDA_ROL_ROLES] / 4, "role demand offsets");
+    for (uint32_t m = 0; m < M; m++) {
+      if (view_.rolMedico[m] < -1 ||
+          view_.rolMedico[m] >= int64_t(view_.numRoles)) {
+        invalido("doctor role index out of range");
+      }
+    }
+    for (uint32_t k = 0; k < view_.numDemandasRol(); k++) {
+      if (view_.demandaRolRoles[k] >= view_.numRoles) {
+        invalido("role demand index out of range");
+      }
+    }
+  }
+  if (view_.conTurnos()) {
+    validarOffsets(view_.turnoNombreOffsets, view_.numTurnos,
+                   tamanos[TURNO_NOMBRES], "slot names");
+    validarOffsets(view_.demandaTurnoOffsets, D,
+                   tamanos[DEMANDA_TURNO_TURNOS] / 4, "slot demand offsets");
+    for (uint32_t k = 0; k < view_.numDemandasTurno(); k++) {
+      if (view_.demandaTurnoTurnos[k] >= view_.numTurnos) {
+        invalido("slot demand index out of range");
+      }
+    }
+    for (uint32_t d = 0; d < D && view_.conRoles(); d++) {
+      if (view_.tieneTurnos(d) &&
+          view_.demandaRolOffsets[d] < view_.demandaRolOffsets[d + 1]) {
+        invalido("day with both role and slot demand");
+      }
+    }
+    if (view_.turnoMedicoOffsets != nullptr) {
+      validarOffsets(view_.turnoMedicoOffsets, M,
+                     tamanos[TURNO_MEDICO_DEMANDAS] / 4, "slot restrictions");
+      for (uint32_t m = 0; m < M; m++) {
+        for (uint32_t k = view_.turnoMedicoOffsets[m];
+             k < view_.turnoMedicoOffsets[m + 1]; k++) {
+          if (view_.turnoMedicoDemandas[k] >= view_.numDemandasTurno() ||
+              (k > view_.turnoMedicoOffsets[m] &&
+               view_.turnoMedicoDemandas[k] <= view_.turnoMedicoDemandas[k - 1])) {
+            invalido("slot restriction out of range or not sorted");
+          }
+        }
+      }
+    }
+  }
+  for (uint32_t f = 0; f < view_.numPrevias; f++) {
+    if (view_.previas[2 * f] >= M || view_.previas[2 * f + 1] >= D) {
+      invalido("previous assignment index out of range");
+    }
+  }
+}
+
+bool BinaryInstance::esBinario(const std::string &filePath) {
+  std::ifstream file(filePath, std::ios::binary);
+  char magic[sizeof(MAGIC)] = {};
+  file.read(magic, sizeof(magic));
+  return file.gcount() == sizeof(magic) &&
+         std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void BinaryInstance::write(const InstanceView &inst,
+                           const std::string &filePath) {
+  uint64_t M = inst.numMedicos;
+  uint64_t D = inst.numDias;
+  uint64_t P = inst.numPeriodos;
+  uint64_t W = inst.palabrasPorMedico;
+
+  struct Payload {
+    SeccionId id;
+    const void *data;
+    uint64_t size;
+  };
+  std::vector<Payload> payloads = {
+      {NOMBRE_OFFSETS, inst.nombreOffsets, (M + D + P + 1) * 4},
+      {NOMBRES, inst.nombres, inst.nombreOffsets[M + D + P]},
+      {PERIODO_OFFSETS, inst.periodoOffsets, (P + 1) * 4},
+      {PERIODO_DIAS, inst.periodoDias, uint64_t(inst.periodoOffsets[P]) * 4},
+      {DISPONIBILIDAD, inst.disponibilidad, M * W * 8},
+      {DIAS_DISPONIBLES, inst.diasDisponibles, M * 4},
+      {MEDICOS_POR_DIA, inst.medicosPorDia, D * 4},
+      {CAPACIDADES, inst.capacidades, M * 4},
+  };
+  if (inst.capPeriodoOffsets != nullptr) {
+    uint64_t n = inst.capPeriodoOffsets[M];
+    payloads.push_back({CAP_PERIODO_OFFSETS, inst.capPeriodoOffsets,
+                        (M + 1) * 4});
+    payloads.push_back({CAP_PERIODO_PERIODOS, inst.capPeriodoPeriodos, n * 4});
+    payloads.push_back({CAP_PERIODO_VALORES, inst.capPeriodoValores, n * 4});
+  }
+  if (inst.numFijas > 0) {
+    payloads.push_back({FIJAS, inst.fijas, uint64_t(inst.numFijas) * 8});
+  }
+  if (inst.numPrevias > 0) {
+    payloads.push_back({PREVIAS, inst.previas, uint64_t(inst.numPrevias) * 8});
+  }
+  if (inst.prioridadDia != nullptr) {
+    payloads.push_back({PRIORIDADES, inst.prioridadDia, D * 4});
+  }
+  if (inst.conRoles()) {
+    uint64_t R = inst.numRoles;
+    uint64_t K = inst.numDemandasRol();
+    payloads.push_back({ROL_NOMBRE_OFFSETS, inst.rolNombreOffsets, (R + 1) * 4});
+    payloads.push_back({ROL_NOMBRES, inst.rolNombres, inst.rolNombreOffsets[R]});
+    payloads.push_back({ROL_MEDICO, inst.rolMedico, M * 4});
+    payloads.push_back({DEMANDA_ROL_OFFSETS, inst.demandaRolOffsets, (D + 1) * 4});
+    payloads.push_back({DEMANDA_ROL_ROLES, inst.demandaRolRoles, K * 4});
+    payloads.push_back({DEMANDA_ROL_VALORES, inst.demandaRolValores, K * 4});
+  }
+  if (inst.conTurnos()) {
+    uint64_t T = inst.numTurnos;
+    uint64_t K = inst.numDemandasTurno();
+    payloads.push_back(
+        {TURNO_NOMBRE_OFFSETS, inst.turnoNombreOffsets, (T + 1) * 4});
+    payloads.push_back(
+        {TURNO_NOMBRES, inst.turnoNombres, inst.turnoNombreOffsets[T]});
+    payloads.push_back(
+        {DEMANDA_TURNO_OFFSETS, inst.demandaTurnoOffsets, (D + 1) * 4});
+    payloads.push_back({DEMANDA_TURNO_TURNOS, inst.demandaTurnoTurnos, K * 4});
+    payloads.push_back({DEMANDA_TURNO_VALORES, inst.demandaTurnoValores, K * 4});
+    if (inst.turnoMedicoOffsets != nullptr) {
+      payloads.push_back(
+          {TURNO_MEDICO_OFFSETS, inst.turnoMedicoOffsets, (M + 1) * 4});
+      payloads.push_back({TURNO_MEDICO_DEMANDAS, inst.turnoMedicoDemandas,
+                          uint64_t(inst.turnoMedicoOffsets[M]) * 4});
+    }
+  }
+
+  Cabecera cab = {};
+  std::memcpy(cab.magic, MAGIC, sizeof(MAGIC));
+  cab.version = VERSION;
+  cab.byteOrder = BYTE_ORDER_MARK;
+  cab.numMedicos = inst.numMedicos;
+  cab.numDias = inst.numDias;
+  cab.numPeriodos = inst.numPeriodos;
+  cab.maxGuardiasPorPeriodo = inst.maxGuardiasPorPeriodo;
+  cab.maxGuardiasTotales = inst.maxGuardiasTotales;
+  cab.palabrasPorMedico = inst.palabrasPorMedico;
+  cab.numSecciones = payloads.size();
+
+  std::vector<Seccion> tabla;
+  uint64_t offset =
+      alinear(alinear(sizeof(Cabecera)) + payloads.size() * sizeof(Seccion));
+  for (const auto &p : payloads) {
+    tabla.push_back({p.id, 0, offset, p.size});
+    offset = alinear(offset + p.size);
+  }
+
+  std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error("Could not open file for writing: " + filePath);
+  }
+
+  const char ceros[8] = {};
+  auto rellenar = [&](uint64_t hasta) {
+    file.write(ceros, hasta - static_cast<uint64_t>(file.tellp()));
+  };
+
+  file.write(reinterpret_cast<const char *>(&cab), sizeof(cab));
+  rellenar(alinear(sizeof(Cabecera)));
+  file.write(reinterpret_cast<const char *>(tabla.data()),
+             tabla.size() * sizeof(Seccion));
+  for (size_t i = 0; i < tabla.size(); i++) {
+    rellenar(tabla[i].offset);
+    if (payloads[i].size > 0) {
+      file.write(static_cast<const char *>(payloads[i].data),
+                 payloads[i].size);
+    }
+  }
+  rellenar(offset);
+
+  if (!file) {
+    throw std::runtime_error("Could not write file: " + filePath);
+  }
+}
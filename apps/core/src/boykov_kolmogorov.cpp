@@ -0,0 +1,538 @@
+#include "boykov_kolmogorov.h"
+#include "traza.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// Calls fn(v) for every bit v of a bitset row, through its summary, in
+// ascending order until fn returns true. Each word is read once, so fn may
+// change the row.
+template <typename Fn>
+bool paraCadaBit(const uint64_t *fila, const uint64_t *resumen, int palabras,
+                 Fn fn) {
+  for (int r = 0; r < palabras; r++) {
+    for (uint64_t ws = resumen[r]; ws != 0; ws &= ws - 1) {
+      int w = (r << 6) + __builtin_ctzll(ws);
+      for (uint64_t bits = fila[w]; bits != 0; bits &= bits - 1) {
+        if (fn((w << 6) + __builtin_ctzll(bits))) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+template <typename F>
+void resetFlowGraph(std::vector<std::vector<F>> &flowGraph, int n) {
+  flowGraph.resize(n);
+  for (auto &row : flowGraph) {
+    row.assign(n, 0);
+  }
+}
+
+} // namespace
+
+BoykovKolmogorov::BoykovKolmogorov()
+    : n_(-1), source_(-1), sink_(-1), tiempo_(0), numVisita_(0),
+      residuales_(nullptr, nullptr, nullptr), flujos_(nullptr, nullptr),
+      interrumpido_(false),
+      reanudado_(false), arcosCambiados_(0) {}
+
+void BoykovKolmogorov::activar(int v) {
+  if (!activo_[v]) {
+    activo_[v] = 1;
+    activos_.push_back(v);
+  }
+}
+
+void BoykovKolmogorov::huerfano(int v) {
+  padre_[v] = HUERFANO;
+  huerfanos_.push_back(v);
+}
+
+template <typename Cap>
+void BoykovKolmogorov::empujar(int u, int v, int f) {
+  grafo<Cap>().setCapacity(u, v, residual<Cap>(u, v) - f);
+  grafo<Cap>().setCapacity(v, u, residual<Cap>(v, u) + f);
+  flujo<Cap>()[u][v] += f;
+  flujo<Cap>()[v][u] -= f;
+}
+
+template <typename Cap>
+void BoykovKolmogorov::revisar(int u, int v) {
+  if (residual<Cap>(u, v) > 0) {
+    if (arbol_[u] == ARBOL_S && arbol_[v] != ARBOL_S) {
+      activar(u);
+    }
+    if (arbol_[v] == ARBOL_T && arbol_[u] != ARBOL_T) {
+      activar(v);
+    }
+    return;
+  }
+  if (arbol_[v] == ARBOL_S && padre_[v] == u) {
+    huerfano(v);
+  }
+  if (arbol_[u] == ARBOL_T && padre_[u] == v) {
+    huerfano(u);
+  }
+}
+
+int BoykovKolmogorov::profundidad(int q) {
+  int d = 0;
+  for (int j = q;; j = padre_[j]) {
+    if (marca_[j] == tiempo_) {
+      d += distancia_[j];
+      break;
+    }
+    if (padre_[j] == RAIZ) {
+      marca_[j] = tiempo_;
+      distancia_[j] = 0;
+      break;
+    }
+    if (padre_[j] == HUERFANO) {
+      return -1;
+    }
+    d++;
+  }
+  // Remember the distances along the path for the next candidates
+  for (int j = q; marca_[j] != tiempo_; j = padre_[j]) {
+    marca_[j] = tiempo_;
+    distancia_[j] = d--;
+  }
+  return distancia_[q];
+}
+
+template <typename Cap>
+bool BoykovKolmogorov::crecer(int p, int &a, int &b) {
+  const int R = grafo<Cap>().getPalabrasResumen();
+  auto unir = [&](int q) {
+    arbol_[q] = arbol_[p];
+    padre_[q] = p;
+    marca_[q] = marca_[p];
+    distancia_[q] = distancia_[p] + 1;
+  };
+  // A neighbour already in the tree moves under p if that is closer to the
+  // root, as far as p's mark tells
+  auto acercar = [&](int q) {
+    if (padre_[q] != RAIZ && marca_[q] <= marca_[p] &&
+        distancia_[q] > distancia_[p]) {
+      padre_[q] = p;
+      marca_[q] = marca_[p];
+      distancia_[q] = distancia_[p] + 1;
+    }
+  };
+
+  if (arbol_[p] == ARBOL_S) {
+    return paraCadaBit(grafo<Cap>().getSalientes(p),
+                       grafo<Cap>().getResumenSalientes(p), R, [&](int q) {
+                         if (arbol_[q] == LIBRE) {
+                           unir(q);
+                           activar(q);
+                         } else if (arbol_[q] == ARBOL_T) {
+                           a = p;
+                           b = q;
+                           return true;
+                         } else {
+                           acercar(q);
+                         }
+                         return false;
+                       });
+  }
+  return paraCadaBit(grafo<Cap>().getEntrantes(p),
+                     grafo<Cap>().getResumenEntrantes(p), R, [&](int q) {
+                       if (arbol_[q] == LIBRE) {
+                         unir(q);
+                         activar(q);
+                       } else if (arbol_[q] == ARBOL_S) {
+                         a = q;
+                         b = p;
+                         return true;
+                       } else {
+                         acercar(q);
+                       }
+                       return false;
+                     });
+}
+
+template <typename Cap>
+int BoykovKolmogorov::aumentar(int a, int b) {
+  int f = residual<Cap>(a, b);
+  for (int x = a; padre_[x] != RAIZ; x = padre_[x]) {
+    f = std::min(f, residual<Cap>(padre_[x], x));
+  }
+  for (int x = b; padre_[x] != RAIZ; x = padre_[x]) {
+    f = std::min(f, residual<Cap>(x, padre_[x]));
+  }
+
+  empujar<Cap>(a, b, f);
+  for (int x = a; padre_[x] != RAIZ;) {
+    int p = padre_[x];
+    empujar<Cap>(p, x, f);
+    if (residual<Cap>(p, x) == 0) {
+      huerfano(x);
+    }
+    x = p;
+  }
+  for (int x = b; padre_[x] != RAIZ;) {
+    int p = padre_[x];
+    empujar<Cap>(x, p, f);
+    if (residual<Cap>(x, p) == 0) {
+      huerfano(x);
+    }
+    x = p;
+  }
+  return f;
+}
+
+template <typename Cap>
+void BoykovKolmogorov::adoptar() {
+  const int R = grafo<Cap>().getPalabrasResumen();
+  while (!huerfanos_.empty()) {
+    int p = huerfanos_.front();
+    huerfanos_.pop_front();
+    bool enS = arbol_[p] == ARBOL_S;
+    // Candidate parents: S nodes with an arc into p, T nodes p has an arc to
+    const uint64_t *hacia = enS ? grafo<Cap>().getEntrantes(p)
+                                : grafo<Cap>().getSalientes(p);
+    const uint64_t *resumenHacia = enS ? grafo<Cap>().getResumenEntrantes(p)
+                                       : grafo<Cap>().getResumenSalientes(p);
+    const uint64_t *desde = enS ? grafo<Cap>().getSalientes(p)
+                                : grafo<Cap>().getEntrantes(p);
+    const uint64_t *resumenDesde = enS ? grafo<Cap>().getResumenSalientes(p)
+                                       : grafo<Cap>().getResumenEntrantes(p);
+
+    int mejor = -1;
+    int distanciaMejor = std::numeric_limits<int>::max();
+    paraCadaBit(hacia, resumenHacia, R, [&](int q) {
+      if (arbol_[q] == arbol_[p]) {
+        int d = profundidad(q);
+        if (d >= 0 && d < distanciaMejor) {
+          mejor = q;
+          distanciaMejor = d;
+        }
+      }
+      return false;
+    });
+    if (mejor >= 0) {
+      padre_[p] = mejor;
+      marca_[p] = tiempo_;
+      distancia_[p] = distanciaMejor + 1;
+      continue;
+    }
+
+    // No way back to the root: p leaves the tree, its neighbours that could
+    // reach it again look again, and its children become orphans
+    paraCadaBit(hacia, resumenHacia, R, [&](int q) {
+      if (arbol_[q] == arbol_[p]) {
+        activar(q);
+      }
+      return false;
+    });
+    paraCadaBit(desde, resumenDesde, R, [&](int q) {
+      if (arbol_[q] == arbol_[p] && padre_[q] == p) {
+        huerfano(q);
+      }
+      return false;
+    });
+    arbol_[p] = LIBRE;
+  }
+}
+
+template <typename Cap>
+bool BoykovKolmogorov::bucle() {
+  // Grow, augment and adopt rounds, too short to be spans of their own
+  Traza::Tramo tramo("search", "boykov-kolmogorov");
+  int aumentos = 0;
+  while (true) {
+    if (deadline_.vencido()) {
+      return false;
+    }
+    int p = -1;
+    while (!activos_.empty() && p < 0) {
+      int x = activos_.front();
+      activos_.pop_front();
+      activo_[x] = 0;
+      if (arbol_[x] != LIBRE) {
+        p = x;
+      }
+    }
+    if (p < 0) {
+      return true;
+    }
+
+    int a, b;
+    if (!crecer<Cap>(p, a, b)) {
+      continue;
+    }
+    tiempo_++;
+    aumentar<Cap>(a, b);
+    adoptar<Cap>();
+    if (arbol_[p] != LIBRE && !activo_[p]) {
+      // p may have more neighbours across: it stays first in line
+      activo_[p] = 1;
+      activos_.push_front(p);
+    }
+    tramo.arg("paths", ++aumentos);
+    if (aumentos % 256 == 0 && deadline_.vencido()) {
+      return false;
+    }
+  }
+}
+
+template <typename Cap>
+bool BoykovKolmogorov::cancelar(int x, int exceso, bool haciaSource) {
+  const int R = grafo<Cap>().getPalabrasResumen();
+  const int destino = haciaSource ? source_ : sink_;
+  MatrizFlujo<Cap> &matriz = flujo<Cap>();
+  while (exceso > 0 && x != destino) {
+    // BFS over arcs with flow: into the current node towards the source
+    // (flow z -> y leaves residual y -> z), out of it towards the sink
+    numVisita_++;
+    cola_.assign(1, x);
+    visita_[x] = numVisita_;
+    bool llegado = false;
+    for (size_t i = 0; i < cola_.size() && !llegado; i++) {
+      int y = cola_[i];
+      const uint64_t *fila = haciaSource ? grafo<Cap>().getSalientes(y)
+                                         : grafo<Cap>().getEntrantes(y);
+      const uint64_t *resumen = haciaSource
+                                    ? grafo<Cap>().getResumenSalientes(y)
+                                    : grafo<Cap>().getResumenEntrantes(y);
+      llegado = paraCadaBit(fila, resumen, R, [&](int z) {
+        int f = haciaSource ? matriz[z][y] : matriz[y][z];
+        if (f <= 0 || visita_[z] == numVisita_) {
+          return false;
+        }
+        visita_[z] = numVisita_;
+        previo_[z] = y;
+        cola_.push_back(z);
+        return z == destino;
+      });
+    }
+    if (!llegado) {
+      return false;
+    }
+
+    int f = exceso;
+    for (int z = destino; z != x; z = previo_[z]) {
+      int y = previo_[z];
+      f = std::min<int>(f, haciaSource ? matriz[z][y] : matriz[y][z]);
+    }
+    for (int z = destino; z != x; z = previo_[z]) {
+      int y = previo_[z];
+      int u = haciaSource ? z : y;
+      int v = haciaSource ? y : z;
+      empujar<Cap>(v, u, f); // Undoes f units of u -> v
+      revisar<Cap>(u, v);
+      revisar<Cap>(v, u);
+    }
+    exceso -= f;
+  }
+  return true;
+}
+
+template <typename Cap>
+bool BoykovKolmogorov::cambiarCapacidad(int u, int v, int delta) {
+  int r = residual<Cap>(u, v) + delta;
+  if (r >= 0) {
+    grafo<Cap>().setCapacity(u, v, r);
+    revisar<Cap>(u, v);
+    return true;
+  }
+
+  // The flow exceeds the new capacity: drop the excess on the arc, which
+  // leaves u with that much inflow to spare and v short of it
+  int exceso = -r;
+  grafo<Cap>().setCapacity(u, v, 0);
+  grafo<Cap>().setCapacity(v, u, residual<Cap>(v, u) - exceso);
+  flujo<Cap>()[u][v] -= exceso;
+  flujo<Cap>()[v][u] += exceso;
+  revisar<Cap>(u, v);
+  revisar<Cap>(v, u);
+  return cancelar<Cap>(u, exceso, true) && cancelar<Cap>(v, exceso, false);
+}
+
+template <typename Cap>
+int BoykovKolmogorov::valor() {
+  int total = 0;
+  for (int v : flujo<Cap>()[source_]) {
+    total += v;
+  }
+  return total;
+}
+
+int BoykovKolmogorov::maxFlow(const Graph &graph, int source, int sink,
+                              Graph &residualGraph,
+                              std::vector<std::vector<int>> &flowGraph) {
+  return maxFlow<int32_t>(graph, source, sink, residualGraph, flowGraph);
+}
+
+template <typename Cap>
+int BoykovKolmogorov::maxFlow(const Graph &graph, int source, int sink,
+                              GraphT<Cap> &residualGraph,
+                              MatrizFlujo<Cap> &flowGraph) {
+  int n = graph.getNumVertices();
+  Traza::Tramo tramo("max-flow", "boykov-kolmogorov");
+  interrumpido_ = false;
+  reanudado_ = false;
+  arcosCambiados_ = 0;
+  residualGraph.copiarDe(graph);
+  resetFlowGraph(flowGraph, n);
+  std::get<GraphT<Cap> *>(residuales_) = &residualGraph;
+  std::get<MatrizFlujo<Cap> *>(flujos_) = &flowGraph;
+
+  n_ = n;
+  source_ = source;
+  sink_ = sink;
+  arbol_.assign(n, LIBRE);
+  padre_.assign(n, HUERFANO);
+  marca_.assign(n, 0);
+  distancia_.assign(n, 0);
+  tiempo_ = 0;
+  activos_.clear();
+  activo_.assign(n, 0);
+  huerfanos_.clear();
+  previo_.assign(n, -1);
+  visita_.assign(n, 0);
+  numVisita_ = 0;
+  if (source == sink) {
+    n_ = -1; // No trees to resume from
+    return 0;
+  }
+
+  arbol_[source] = ARBOL_S;
+  arbol_[sink] = ARBOL_T;
+  padre_[source] = RAIZ;
+  padre_[sink] = RAIZ;
+  activar(source);
+  activar(sink);
+  interrumpido_ = !bucle<Cap>();
+  return valor<Cap>();
+}
+
+template <typename Cap>
+bool BoykovKolmogorov::actualizarArco(const Graph &graph, int u, int v) {
+  int delta = graph.getCapacity(u, v) -
+              (grafo<Cap>().getCapacity(u, v) + flujo<Cap>()[u][v]);
+  if (delta == 0) {
+    return true;
+  }
+  arcosCambiados_++;
+  return cambiarCapacidad<Cap>(u, v, delta);
+}
+
+template <typename Cap>
+int BoykovKolmogorov::maxFlowDesde(const Graph &graph, int source, int sink,
+                                   GraphT<Cap> &residualGraph,
+                                   MatrizFlujo<Cap> &flowGraph) {
+  return reanudar(graph, source, sink, residualGraph, flowGraph, nullptr);
+}
+
+template <typename Cap>
+int BoykovKolmogorov::maxFlowDesde(
+    const Graph &graph, int source, int sink, GraphT<Cap> &residualGraph,
+    MatrizFlujo<Cap> &flowGraph,
+    const std::vector<std::pair<int, int>> &arcos) {
+  return reanudar(graph, source, sink, residualGraph, flowGraph, &arcos);
+}
+
+template <typename Cap>
+int BoykovKolmogorov::reanudar(const Graph &graph, int source, int sink,
+                               GraphT<Cap> &residualGraph,
+                               MatrizFlujo<Cap> &flowGraph,
+                               const std::vector<std::pair<int, int>> *arcos) {
+  int n = graph.getNumVertices();
+  if (n != n_ || source != source_ || sink != sink_ ||
+      residualGraph.getNumVertices() != n ||
+      static_cast<int>(flowGraph.size()) != n) {
+    return maxFlow(graph, source, sink, residualGraph, flowGraph);
+  }
+  Traza::Tramo tramo("resume", "boykov-kolmogorov");
+  interrumpido_ = false;
+  std::get<GraphT<Cap> *>(residuales_) = &residualGraph;
+  std::get<MatrizFlujo<Cap> *>(flujos_) = &flowGraph;
+  arcosCambiados_ = 0;
+  tiempo_++;
+
+  Traza::Tramo actualizacion("update arcs", "boykov-kolmogorov");
+  bool valido = true;
+  for (size_t i = 0; arcos && i < arcos->size() && valido; i++) {
+    valido = actualizarArco<Cap>(graph, (*arcos)[i].first,
+                                 (*arcos)[i].second);
+  }
+
+  // Capacities of the previous network are residual + flow. Every arc of
+  // either network has a bit in the new graph's row, the residual row (some
+  // capacity left) or the residual column (flow on it).
+  const int R = graph.getPalabrasResumen();
+  for (int u = 0; u < n && !arcos && valido; u++) {
+    const uint64_t *filas[3] = {graph.getSalientes(u),
+                                residualGraph.getSalientes(u),
+                                residualGraph.getEntrantes(u)};
+    const uint64_t *resumenes[3] = {graph.getResumenSalientes(u),
+                                    residualGraph.getResumenSalientes(u),
+                                    residualGraph.getResumenEntrantes(u)};
+    for (int r = 0; r < R; r++) {
+      uint64_t ws = resumenes[0][r] | resumenes[1][r] | resumenes[2][r];
+      for (; ws != 0; ws &= ws - 1) {
+        int w = (r << 6) + __builtin_ctzll(ws);
+        uint64_t bits = filas[0][w] | filas[1][w] | filas[2][w];
+        for (; bits != 0 && valido; bits &= bits - 1) {
+          valido = actualizarArco<Cap>(graph, u,
+                                       (w << 6) + __builtin_ctzll(bits));
+        }
+      }
+    }
+  }
+  actualizacion.arg("changed", arcosCambiados_);
+  actualizacion.terminar();
+  if (!valido) {
+    // A flow that cannot be carried back (cycles): start over
+    return maxFlow(graph, source, sink, residualGraph, flowGraph);
+  }
+
+  reanudado_ = true;
+  Traza::Tramo adopcion("adopt orphans", "boykov-kolmogorov");
+  adoptar<Cap>();
+  adopcion.terminar();
+  interrumpido_ = !bucle<Cap>();
+  return valor<Cap>();
+}
+
+std::size_t BoykovKolmogorov::memoria() const {
+  return arbol_.size() + activo_.size() +
+         (padre_.size() + marca_.size() + distancia_.size() + previo_.size() +
+          visita_.size() + cola_.size() + activos_.size() +
+          huerfanos_.size()) *
+             sizeof(int);
+}
+
+template int BoykovKolmogorov::maxFlow(const Graph &, int, int,
+                                       GraphT<uint8_t> &,
+                                       MatrizFlujo<uint8_t> &);
+template int BoykovKolmogorov::maxFlow(const Graph &, int, int,
+                                       GraphT<uint16_t> &,
+                                       MatrizFlujo<uint16_t> &);
+template int BoykovKolmogorov::maxFlow(const Graph &, int, int,
+                                       GraphT<int32_t> &,
+                                       MatrizFlujo<int32_t> &);
+template int BoykovKolmogorov::maxFlowDesde(const Graph &, int, int,
+                                            GraphT<uint8_t> &,
+                                            MatrizFlujo<uint8_t> &);
+template int BoykovKolmogorov::maxFlowDesde(const Graph &, int, int,
+                                            GraphT<uint16_t> &,
+                                            MatrizFlujo<uint16_t> &);
+template int BoykovKolmogorov::maxFlowDesde(const Graph &, int, int,
+                                            GraphT<int32_t> &,
+                                            MatrizFlujo<int32_t> &);
+template int BoykovKolmogorov::maxFlowDesde(
+    const Graph &, int, int, GraphT<uint8_t> &, MatrizFlujo<uint8_t> &,
+    const std::vector<std::pair<int, int>> &);
+template int BoykovKolmogorov::maxFlowDesde(
+    const Graph &, int, int, GraphT<uint16_t> &, MatrizFlujo<uint16_t> &,
+    const std::vector<std::pair<int, int>> &);
+template int BoykovKolmogorov::maxFlowDesde(
+    const Graph &, int, int, GraphT<int32_t> &, MatrizFlujo<int32_t> &,
+    const std::vector<std::pair<int, int>> &);
@@ -0,0 +1,149 @@
+#include "certificado.h"
+#include <unordered_map>
+
+Certificado::Certificado()
+    : source_(-1), sink_(-1), valor_(0), capacidadCorte_(0) {}
+
+void Certificado::fallo(const std::string &mensaje) {
+  if (error_.empty()) {
+    error_ = mensaje;
+  }
+}
+
+void Certificado::iniciar(int numVertices, int source, int sink, int valor,
+                          const std::vector<int> &ladoSource) {
+  balance_.assign(numVertices, 0);
+  ladoSource_.assign(numVertices, 0);
+  source_ = source;
+  sink_ = sink;
+  valor_ = valor;
+  capacidadCorte_ = 0;
+  error_.clear();
+  if (source < 0 || source >= numVertices || sink < 0 ||
+      sink >= numVertices) {
+    fallo("Source or sink out of range");
+    return;
+  }
+  for (int v : ladoSource) {
+    if (v < 0 || v >= numVertices) {
+      fallo("Cut node " + std::to_string(v) + " out of range");
+      return;
+    }
+    ladoSource_[v] = 1;
+  }
+}
+
+void Certificado::arco(int u, int v, int capacidad, int flujo, int cota) {
+  if (!error_.empty()) {
+    return;
+  }
+  int n = balance_.size();
+  if (u < 0 || u >= n || v < 0 || v >= n) {
+    fallo("Arc " + std::to_string(u) + " -> " + std::to_string(v) +
+          " out of range");
+    return;
+  }
+  if (flujo < cota || flujo > capacidad) {
+    fallo("Arc " + std::to_string(u) + " -> " + std::to_string(v) +
+          " carries " + std::to_string(flujo) + ", outside [" +
+          std::to_string(cota) + ", " + std::to_string(capacidad) + "]");
+    return;
+  }
+  balance_[u] -= flujo;
+  balance_[v] += flujo;
+  if (ladoSource_[u] && !ladoSource_[v]) {
+    capacidadCorte_ += capacidad;
+  } else if (!ladoSource_[u] && ladoSource_[v]) {
+    capacidadCorte_ -= cota;
+  }
+}
+
+bool Certificado::cumple() {
+  if (!error_.empty()) {
+    return false;
+  }
+  for (size_t x = 0; x < balance_.size(); x++) {
+    if (int(x) != source_ && int(x) != sink_ && balance_[x] != 0) {
+      fallo("Flow not conserved at node " + std::to_string(x) + " (net " +
+            std::to_string(balance_[x]) + ")");
+      return false;
+    }
+  }
+  if (-balance_[source_] != valor_ || balance_[sink_] != valor_) {
+    fallo("Flow value " + std::to_string(valor_) + " but the source sends " +
+          std::to_string(-balance_[source_]) + " and the sink receives " +
+          std::to_string(balance_[sink_]));
+    return false;
+  }
+  if (!ladoSource_[source_] || ladoSource_[sink_]) {
+    fallo("The cut does not separate the source from the sink");
+    return false;
+  }
+  if (capacidadCorte_ != valor_) {
+    fallo("Cut capacity " + std::to_string(capacidadCorte_) +
+          " differs from the flow value " + std::to_string(valor_) +
+          ": the flow is not maximum");
+    return false;
+  }
+  return true;
+}
+
+template <typename F>
+bool Certificado::verificar(const Graph &graph,
+                            const std::vector<std::vector<F>> &flowGraph,
+                            int source, int sink, int valor,
+                            const std::vector<int> &ladoSource,
+                            const std::vector<CotaInferior> &cotas) {
+  const int n = graph.getNumVertices();
+  iniciar(n, source, sink, valor, ladoSource);
+  bool mismoTamano = static_cast<int>(flowGraph.size()) == n;
+  for (int u = 0; u < n && mismoTamano; u++) {
+    mismoTamano = static_cast<int>(flowGraph[u].size()) == n;
+  }
+  if (!mismoTamano) {
+    fallo("Flow matrix of another size than the network");
+    return false;
+  }
+  std::unordered_map<int64_t, int> cotaDe;
+  for (const auto &c : cotas) {
+    cotaDe[int64_t(c.from) * n + c.to] = c.cota;
+  }
+
+  const int R = graph.getPalabrasResumen();
+  for (int u = 0; u < n && error_.empty(); u++) {
+    const uint64_t *fila = graph.getSalientes(u);
+    const uint64_t *resumen = graph.getResumenSalientes(u);
+    for (int r = 0; r < R; r++) {
+      for (uint64_t ws = resumen[r]; ws != 0; ws &= ws - 1) {
+        int w = (r << 6) + __builtin_ctzll(ws);
+        for (uint64_t bits = fila[w]; bits != 0; bits &= bits - 1) {
+          int v = (w << 6) + __builtin_ctzll(bits);
+          int f = flowGraph[u][v];
+          if (flowGraph[v][u] != -f) {
+            fallo("Flow matrix not antisymmetric at " + std::to_string(u) +
+                  ", " + std::to_string(v));
+          }
+          if (f < 0 && graph.getCapacity(v, u) > 0) {
+            f = 0; // Counted on the arc v -> u
+          }
+          int cota = 0;
+          if (!cotaDe.empty()) {
+            auto it = cotaDe.find(int64_t(u) * n + v);
+            cota = it != cotaDe.end() ? it->second : 0;
+          }
+          arco(u, v, graph.getCapacity(u, v), f, cota);
+        }
+      }
+    }
+  }
+  return cumple();
+}
+
+template bool Certificado::verificar(const Graph &,
+                                     const std::vector<std::vector<int16_t>> &,
+                                     int, int, int, const std::vector<int> &,
+                                     const std::vector<CotaInferior> &);
+template bool Certificado::verificar(const Graph &,
+                                     const std::vector<std::vector<int32_t>> &,
+                                     int, int, int, const std::vector<int> &,
+                                     const std::vector<CotaInferior> &);
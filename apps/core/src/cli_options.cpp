@@ -0,0 +1,112 @@
+#include "cli_options.h"
+#include <stdexcept>
+
+namespace {
+
+// Value of "--name=value" or "--name value" (advancing i); throws if missing
+std::string valorOpcion(const std::string &arg, const std::string &nombre,
+                        int argc, char *argv[], int &i) {
+  if (arg.size() > nombre.size() && arg[nombre.size()] == '=') {
+    return arg.substr(nombre.size() + 1);
+  }
+  if (i + 1 >= argc) {
+    throw std::invalid_argument("Missing value for " + nombre);
+  }
+  return argv[++i];
+}
+
+bool esOpcion(const std::string &arg, const std::string &nombre) {
+  return arg == nombre || arg.rfind(nombre + "=", 0) == 0;
+}
+
+size_t enteroPositivo(const std::string &valor, const std::string &nombre) {
+  try {
+    size_t usados = 0;
+    long long n = std::stoll(valor, &usados);
+    if (usados == valor.size() && n >= 0) {
+      return static_cast<size_t>(n);
+    }
+  } catch (const std::exception &) {
+  }
+  throw std::invalid_argument("Invalid value for " + nombre + ": " + valor);
+}
+
+} // namespace
+
+CliOptions parseCliOptions(int argc, char *argv[]) {
+  CliOptions opciones;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+
+    if (arg == "--resident") {
+      opciones.resident = true;
+    } else if (arg == "--stats") {
+      opciones.stats = true;
+    } else if (arg == "--sensitivity") {
+      opciones.sensibilidad = true;
+    } else if (arg == "--window-repair") {
+      opciones.repararVentanas = true;
+    } else if (arg == "--renumber") {
+      opciones.renumerar = true;
+    } else if (arg == "--verify") {
+      opciones.verificar = true;
+    } else if (arg == "--no-cache") {
+      opciones.cache = false;
+    } else if (esOpcion(arg, "--cache-dir")) {
+      opciones.cacheDir = valorOpcion(arg, "--cache-dir", argc, argv, i);
+    } else if (esOpcion(arg, "--deadline-ms")) {
+      opciones.deadlineMs = enteroPositivo(
+          valorOpcion(arg, "--deadline-ms", argc, argv, i), "--deadline-ms");
+    } else if (esOpcion(arg, "--window")) {
+      opciones.ventana = enteroPositivo(
+          valorOpcion(arg, "--window", argc, argv, i), "--window");
+    } else if (esOpcion(arg, "--engine")) {
+      opciones.motor = valorOpcion(arg, "--engine", argc, argv, i);
+      if (opciones.motor != "edmonds-karp" &&
+          opciones.motor != "push-relabel" && opciones.motor != "implicit" &&
+          opciones.motor != "boykov-kolmogorov") {
+        throw std::invalid_argument("Invalid value for --engine: " +
+                                    opciones.motor);
+      }
+    } else if (esOpcion(arg, "--threads")) {
+      opciones.hilos = enteroPositivo(
+          valorOpcion(arg, "--threads", argc, argv, i), "--threads");
+    } else if (esOpcion(arg, "--trace")) {
+      opciones.traza = valorOpcion(arg, "--trace", argc, argv, i);
+      if (opciones.traza.empty()) {
+        throw std::invalid_argument("Missing value for --trace");
+      }
+    } else if (esOpcion(arg, "--cache-size")) {
+      opciones.cacheSize = enteroPositivo(
+          valorOpcion(arg, "--cache-size", argc, argv, i), "--cache-size");
+    } else if (esOpcion(arg, "--session-memory-mb")) {
+      opciones.sesionesMb = enteroPositivo(
+          valorOpcion(arg, "--session-memory-mb", argc, argv, i),
+          "--session-memory-mb");
+    } else if (arg.rfind("--", 0) == 0) {
+      throw std::invalid_argument("Unknown option: " + arg);
+    } else if (opciones.archivo.empty()) {
+      opciones.archivo = arg;
+    } else {
+      throw std::invalid_argument("Only one input file is accepted");
+    }
+  }
+
+  if (opciones.repararVentanas && opciones.ventana == 0) {
+    throw std::invalid_argument("--window-repair needs --window");
+  }
+  if (opciones.sensibilidad && opciones.ventana > 0) {
+    throw std::invalid_argument("--sensitivity cannot be used with --window");
+  }
+  if (opciones.sensibilidad && opciones.motor == "implicit") {
+    throw std::invalid_argument(
+        "--sensitivity cannot be used with --engine=implicit");
+  }
+
+  if (opciones.resident && !opciones.archivo.empty()) {
+    throw std::invalid_argument("--resident reads from stdin, not a file");
+  }
+
+  return opciones;
+}
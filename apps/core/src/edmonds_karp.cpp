@@ -1,62 +1,64 @@
 #include "edmonds_karp.h"
+#include "traza.h"
+#include <algorithm>
 #include <limits>
-#include <queue>
+#include <stdexcept>
+#include <unordered_map>
 
-bool EdmondsKarp::bfs(const Graph &residualGraph, int source, int sink,
-                      std::vector<int> &parent) {
-  int n = residualGraph.getNumVertices();
-  std::vector<bool> visited(n, false);
-
-  std::queue<int> q;
-  q.push(source);
-  visited[source] = true;
-  parent[source] = -1;
-
-  while (!q.empty()) {
-    int u = q.front();
-    q.pop();
+namespace {
 
-    for (int v = 0; v < n; v++) {
-      // If not visited and residual capacity exists
-      if (!visited[v] && residualGraph.getCapacity(u, v) > 0) {
-        visited[v] = true;
-        parent[v] = u;
-        q.push(v);
-
-        // If we reach the sink, we found a path
-        if (v == sink) {
-          return true;
-        }
-      }
-    }
+// Zero a square flow matrix of size n, keeping the rows' storage
+template <typename F>
+void resetFlowGraph(std::vector<std::vector<F>> &flowGraph, int n) {
+  flowGraph.resize(n);
+  for (auto &row : flowGraph) {
+    row.assign(n, 0);
   }
-
-  return false;
 }
 
-int EdmondsKarp::maxFlowWithResult(Graph graph, int source, int sink,
-                                   std::vector<std::vector<int>> &flowGraph) {
-  int n = graph.getNumVertices();
+} // namespace
 
-  // Initialize flow matrix
-  flowGraph.resize(n, std::vector<int>(n, 0));
+EdmondsKarp::EdmondsKarp() : interrumpido_(false) {}
 
-  // Create residual graph
-  Graph residualGraph = graph;
+bool EdmondsKarp::bfs(const GraphBase &residualGraph, int source, int sink,
+                      std::vector<int> &parent) {
+  return bfs_.camino(residualGraph, source, sink, parent);
+}
 
-  std::vector<int> parent(n);
+template <typename Cap>
+int EdmondsKarp::augment(GraphT<Cap> &residualGraph, int source, int sink,
+                         MatrizFlujo<Cap> &flowGraph,
+                         std::vector<Cambio> *cambios) {
+  int n = residualGraph.getNumVertices();
+  parent_.assign(n, -1);
   int maxFlowValue = 0;
+  Traza::Tramo tramo("max-flow", "edmonds-karp");
+  int caminos = 0;
+
+  while (true) {
+    if (deadline_.vencido()) {
+      interrumpido_ = true;
+      break;
+    }
+    // One BFS round: shortest augmenting path, then push along it
+    Traza::Tramo ronda("bfs round", "edmonds-karp");
+    if (!bfs(residualGraph, source, sink, parent_)) {
+      break;
+    }
 
-  while (bfs(residualGraph, source, sink, parent)) {
     int pathFlow = std::numeric_limits<int>::max();
 
-    for (int v = sink; v != source; v = parent[v]) {
-      int u = parent[v];
+    for (int v = sink; v != source; v = parent_[v]) {
+      int u = parent_[v];
       pathFlow = std::min(pathFlow, residualGraph.getCapacity(u, v));
     }
 
-    for (int v = sink; v != source; v = parent[v]) {
-      int u = parent[v];
+    for (int v = sink; v != source; v = parent_[v]) {
+      int u = parent_[v];
+      if (cambios != nullptr) {
+        cambios->push_back({u, v, residualGraph.getCapacity(u, v),
+                            residualGraph.getCapacity(v, u), flowGraph[u][v]});
+      }
 
       // Update flow
       flowGraph[u][v] += pathFlow;
@@ -71,38 +73,359 @@ int EdmondsKarp::maxFlowWithResult(Graph graph, int source, int sink,
     }
 
     maxFlowValue += pathFlow;
+    ronda.arg("flow", pathFlow);
+    caminos++;
   }
 
+  tramo.arg("paths", caminos);
+  tramo.arg("flow", maxFlowValue);
   return maxFlowValue;
 }
 
+int EdmondsKarp::maxFlowWithResult(Graph graph, int source, int sink,
+                                   std::vector<std::vector<int>> &flowGraph) {
+  // `graph` is already a private copy: use it as the residual graph
+  interrumpido_ = false;
+  resetFlowGraph(flowGraph, graph.getNumVertices());
+  return augment(graph, source, sink, flowGraph);
+}
+
+int EdmondsKarp::maxFlow(const Graph &graph, int source, int sink,
+                         Graph &residualGraph,
+                         std::vector<std::vector<int>> &flowGraph) {
+  return maxFlow<int32_t>(graph, source, sink, residualGraph, flowGraph);
+}
+
+template <typename Cap>
+int EdmondsKarp::maxFlow(const Graph &graph, int source, int sink,
+                         GraphT<Cap> &residualGraph,
+                         MatrizFlujo<Cap> &flowGraph) {
+  interrumpido_ = false;
+  residualGraph.copiarDe(graph);
+  resetFlowGraph(flowGraph, graph.getNumVertices());
+  return augment(residualGraph, source, sink, flowGraph);
+}
+
+template <typename Cap>
+int EdmondsKarp::maxFlowDesde(const Graph &graph, int source, int sink,
+                              GraphT<Cap> &residualGraph,
+                              MatrizFlujo<Cap> &flowGraph) {
+  int n = graph.getNumVertices();
+  if (static_cast<int>(flowGraph.size()) != n) {
+    return maxFlow(graph, source, sink, residualGraph, flowGraph);
+  }
+  interrumpido_ = false;
+
+  // Cancel the flow over each arc's capacity along source -> u -> v -> sink
+  // paths. Cancelling only lowers flows, so arcs already checked stay valid.
+  std::vector<std::pair<int, int>> camino;
+  for (int u = 0; u < n; u++) {
+    for (int v = 0; v < n; v++) {
+      while (flowGraph[u][v] > 0 &&
+             flowGraph[u][v] > graph.getCapacity(u, v)) {
+        camino.assign(1, {u, v});
+        int f = std::min(
+            {flowGraph[u][v] - graph.getCapacity(u, v),
+             caminoConFlujo(flowGraph, v, sink, true, camino),
+             caminoConFlujo(flowGraph, u, source, false, camino)});
+        if (f == 0) {
+          // Not a flow of this network: start from zero instead
+          return maxFlow(graph, source, sink, residualGraph, flowGraph);
+        }
+        for (const auto &[a, b] : camino) {
+          flowGraph[a][b] -= f;
+          flowGraph[b][a] += f;
+        }
+      }
+    }
+  }
+
+  int valor = 0;
+  residualGraph.reset(n);
+  for (int u = 0; u < n; u++) {
+    valor += flowGraph[source][u];
+    for (int v = 0; v < n; v++) {
+      int residual = graph.getCapacity(u, v) - flowGraph[u][v];
+      if (residual > 0) {
+        residualGraph.setCapacity(u, v, residual);
+      }
+    }
+  }
+  return valor + augment(residualGraph, source, sink, flowGraph);
+}
+
+template <typename Cap>
+int EdmondsKarp::maxFlowConCotas(const Graph &graph, int source, int sink,
+                                 const std::vector<CotaInferior> &cotas,
+                                 GraphT<Cap> &residualGraph,
+                                 MatrizFlujo<Cap> &flowGraph,
+                                 std::vector<size_t> &insatisfechas) {
+  // Enough for the sink -> source arc at the width anchoConCotas picked
+  const int INF = std::numeric_limits<Cap>::max();
+  int n = graph.getNumVertices();
+  int superSource = n;
+  int superSink = n + 1;
+  insatisfechas.clear();
+  interrumpido_ = false;
+
+  // Circulation network: capacities minus bounds, plus sink -> source
+  residualGraph.reset(n + 2);
+  for (int u = 0; u < n; u++) {
+    for (int v = 0; v < n; v++) {
+      int cap = graph.getCapacity(u, v);
+      if (cap > 0) {
+        residualGraph.setCapacity(u, v, cap);
+      }
+    }
+  }
+  std::vector<int> exceso(n, 0);
+  for (const auto &c : cotas) {
+    residualGraph.setCapacity(c.from, c.to,
+                              residualGraph.getCapacity(c.from, c.to) - c.cota);
+    exceso[c.to] += c.cota;
+    exceso[c.from] -= c.cota;
+  }
+  residualGraph.setCapacity(sink, source, INF);
+
+  int demanda = 0;
+  for (int v = 0; v < n; v++) {
+    if (exceso[v] > 0) {
+      residualGraph.setCapacity(superSource, v, exceso[v]);
+      demanda += exceso[v];
+    } else if (exceso[v] < 0) {
+      residualGraph.setCapacity(v, superSink, -exceso[v]);
+    }
+  }
+
+  resetFlowGraph(flowGraph, n + 2);
+  int factible = augment(residualGraph, superSource, superSink, flowGraph);
+
+  if (factible < demanda) {
+    for (size_t i = 0; i < cotas.size() && !interrumpido_; i++) {
+      int to = cotas[i].to;
+      int from = cotas[i].from;
+      if (flowGraph[superSource][to] < exceso[to] ||
+          flowGraph[from][superSink] < -exceso[from]) {
+        insatisfechas.push_back(i);
+      }
+    }
+    residualGraph.reset(n);
+    resetFlowGraph(flowGraph, n);
+    return -1;
+  }
+
+  // Flow value so far is what went around through sink -> source
+  int valor = flowGraph[sink][source];
+
+  // Back to the original network: drop the extra nodes and arc, add bounds
+  flowGraph.resize(n);
+  for (auto &row : flowGraph) {
+    row.resize(n);
+  }
+  flowGraph[sink][source] = 0;
+  flowGraph[source][sink] = 0;
+  for (const auto &c : cotas) {
+    flowGraph[c.from][c.to] += c.cota;
+    flowGraph[c.to][c.from] -= c.cota;
+  }
+
+  residualGraph.reset(n);
+  for (int u = 0; u < n; u++) {
+    for (int v = 0; v < n; v++) {
+      int residual = graph.getCapacity(u, v) - flowGraph[u][v];
+      if (residual > 0) {
+        residualGraph.setCapacity(u, v, residual);
+      }
+    }
+  }
+  // A bounded arc may only give back flow above its bound
+  for (const auto &c : cotas) {
+    residualGraph.setCapacity(
+        c.to, c.from, residualGraph.getCapacity(c.to, c.from) - c.cota);
+  }
+
+  return valor + augment(residualGraph, source, sink, flowGraph);
+}
+
+AnchoCapacidad
+EdmondsKarp::anchoConCotas(const Graph &graph, int source,
+                           const std::vector<CotaInferior> &cotas,
+                           AnchoCapacidad ancho) {
+  int n = graph.getNumVertices();
+  // Bounds past an arc's capacity leave negative residuals: only int32_t
+  std::unordered_map<int64_t, int64_t> cotaDe;
+  std::vector<int64_t> exceso(n, 0);
+  for (const auto &c : cotas) {
+    int64_t &cota = cotaDe[int64_t(c.from) * n + c.to];
+    cota += c.cota;
+    if (cota > graph.getCapacity(c.from, c.to)) {
+      return AnchoCapacidad::I32;
+    }
+    exceso[c.to] += c.cota;
+    exceso[c.from] -= c.cota;
+  }
+
+  int64_t maxima = 0;
+  for (int v = 0; v < n; v++) {
+    maxima += graph.getCapacity(source, v);
+  }
+  int64_t excesoMaximo = 0;
+  for (int64_t e : exceso) {
+    excesoMaximo = std::max(excesoMaximo, e < 0 ? -e : e);
+  }
+  maxima += excesoMaximo;
+  return std::max(ancho, anchoParaCapacidad(static_cast<int>(std::min<int64_t>(
+                             maxima, std::numeric_limits<int>::max()))));
+}
+
+template <typename Cap>
+int EdmondsKarp::maxFlowPorClases(const Graph &graph, int source, int sink,
+                                  const std::vector<std::vector<int>> &clases,
+                                  GraphT<Cap> &residualGraph,
+                                  MatrizFlujo<Cap> &flowGraph) {
+  interrumpido_ = false;
+  residualGraph.copiarDe(graph);
+  int n = graph.getNumVertices();
+  resetFlowGraph(flowGraph, n);
+
+  std::vector<int> cerrada(n, 0); // Capacity to the sink, until opened
+  for (int v = 0; v < n; v++) {
+    cerrada[v] = residualGraph.getCapacity(v, sink);
+    residualGraph.setCapacity(v, sink, 0);
+  }
+
+  auto abrir = [&](int v) {
+    residualGraph.setCapacity(v, sink, cerrada[v]);
+    cerrada[v] = 0;
+  };
+
+  int total = 0;
+  for (const auto &clase : clases) {
+    for (int v : clase) {
+      abrir(v);
+    }
+    total += augment(residualGraph, source, sink, flowGraph);
+  }
+  for (int v = 0; v < n; v++) {
+    if (cerrada[v] > 0) {
+      abrir(v);
+    }
+  }
+  return total + augment(residualGraph, source, sink, flowGraph);
+}
+
+template <typename F>
+int EdmondsKarp::caminoConFlujo(const std::vector<std::vector<F>> &flow,
+                                int nodo, int fin, bool haciaAdelante,
+                                std::vector<std::pair<int, int>> &camino) {
+  int n = flow.size();
+  int minimo = std::numeric_limits<int>::max();
+  for (int u = nodo; u != fin;) {
+    int siguiente = -1;
+    for (int v = 0; v < n && siguiente < 0; v++) {
+      int f = haciaAdelante ? flow[u][v] : flow[v][u];
+      if (f > 0) {
+        siguiente = v;
+        minimo = std::min(minimo, f);
+      }
+    }
+    if (siguiente < 0) {
+      return 0; // Flow not conserved: nothing to cancel on this side
+    }
+    camino.emplace_back(haciaAdelante ? u : siguiente,
+                        haciaAdelante ? siguiente : u);
+    u = siguiente;
+  }
+  return minimo;
+}
+
+template <typename Cap>
+int EdmondsKarp::perdidaSinNodo(GraphT<Cap> &residualGraph,
+                                MatrizFlujo<Cap> &flowGraph, int source,
+                                int sink, int nodo) {
+  if (nodo == source || nodo == sink) {
+    throw std::invalid_argument("Cannot remove the source or the sink");
+  }
+
+  interrumpido_ = false;
+  cambios_.clear();
+  auto registrar = [&](int u, int v) {
+    cambios_.push_back({u, v, residualGraph.getCapacity(u, v),
+                        residualGraph.getCapacity(v, u), flowGraph[u][v]});
+  };
+
+  // Cancel every source -> nodo -> sink path of the current flow
+  int cancelado = 0;
+  std::vector<std::pair<int, int>> camino;
+  while (true) {
+    camino.clear();
+    int f = std::min(caminoConFlujo(flowGraph, nodo, sink, true, camino),
+                     caminoConFlujo(flowGraph, nodo, source, false, camino));
+    if (f == 0) {
+      break;
+    }
+    for (const auto &[u, v] : camino) {
+      registrar(u, v);
+      flowGraph[u][v] -= f;
+      flowGraph[v][u] += f;
+      residualGraph.setCapacity(u, v, residualGraph.getCapacity(u, v) + f);
+      residualGraph.setCapacity(v, u, residualGraph.getCapacity(v, u) - f);
+    }
+    cancelado += f;
+  }
+
+  // Close the node: its arcs with residual capacity either way
+  const int W = residualGraph.getPalabras();
+  camino.clear();
+  for (int w = 0; w < W; w++) {
+    uint64_t vecinos = residualGraph.getSalientes(nodo)[w] |
+                       residualGraph.getEntrantes(nodo)[w];
+    for (; vecinos != 0; vecinos &= vecinos - 1) {
+      camino.emplace_back(nodo, (w << 6) + __builtin_ctzll(vecinos));
+    }
+  }
+  for (const auto &[u, v] : camino) {
+    registrar(u, v);
+    residualGraph.setCapacity(u, v, 0);
+    residualGraph.setCapacity(v, u, 0);
+  }
+
+  // Reroute what it carried, then undo every change, latest first
+  int perdida = cancelado - augment(residualGraph, source, sink, flowGraph,
+                                    &cambios_);
+  for (auto c = cambios_.rbegin(); c != cambios_.rend(); ++c) {
+    residualGraph.setCapacity(c->u, c->v, c->residual);
+    residualGraph.setCapacity(c->v, c->u, c->inverso);
+    flowGraph[c->u][c->v] = c->flujo;
+    flowGraph[c->v][c->u] = -c->flujo;
+  }
+  return perdida;
+}
+
 std::vector<int>
 EdmondsKarp::getReachableNodes(const Graph &graph,
                                const std::vector<std::vector<int>> &flowGraph,
                                int source) {
   int n = graph.getNumVertices();
-  std::vector<bool> visited(n, false);
+  visited_.assign(n, false);
   std::vector<int> reachable;
-  std::queue<int> q;
 
-  q.push(source);
-  visited[source] = true;
   reachable.push_back(source);
+  visited_[source] = true;
 
-  while (!q.empty()) {
-    int u = q.front();
-    q.pop();
+  // `reachable` doubles as the BFS queue: vertices are appended in visit order
+  for (size_t head = 0; head < reachable.size(); head++) {
+    int u = reachable[head];
 
     for (int v = 0; v < n; v++) {
-      if (!visited[v]) {
+      if (!visited_[v]) {
         // Residual capacity = Original capacity - Net flow
         // Note: flowGraph[u][v] can be negative if flow goes from v to u
         int residualCap = graph.getCapacity(u, v) - flowGraph[u][v];
 
         if (residualCap > 0) {
-          visited[v] = true;
+          visited_[v] = true;
           reachable.push_back(v);
-          q.push(v);
         }
       }
     }
@@ -110,3 +433,58 @@ EdmondsKarp::getReachableNodes(const Graph &graph,
 
   return reachable;
 }
+
+std::vector<int>
+EdmondsKarp::getReachableResidual(const GraphBase &residualGraph, int source) {
+  Traza::Tramo tramo("min-cut");
+  return bfs_.alcanzables(residualGraph, source);
+}
+
+template int EdmondsKarp::maxFlow(const Graph &, int, int, GraphT<uint8_t> &,
+                                  MatrizFlujo<uint8_t> &);
+template int EdmondsKarp::maxFlowDesde(const Graph &, int, int,
+                                       GraphT<uint8_t> &,
+                                       MatrizFlujo<uint8_t> &);
+template int EdmondsKarp::maxFlowConCotas(const Graph &, int, int,
+                                          const std::vector<CotaInferior> &,
+                                          GraphT<uint8_t> &,
+                                          MatrizFlujo<uint8_t> &,
+                                          std::vector<size_t> &);
+template int EdmondsKarp::maxFlowPorClases(
+    const Graph &, int, int, const std::vector<std::vector<int>> &,
+    GraphT<uint8_t> &, MatrizFlujo<uint8_t> &);
+template int EdmondsKarp::perdidaSinNodo(GraphT<uint8_t> &,
+                                         MatrizFlujo<uint8_t> &, int, int,
+                                         int);
+template int EdmondsKarp::maxFlow(const Graph &, int, int, GraphT<uint16_t> &,
+                                  MatrizFlujo<uint16_t> &);
+template int EdmondsKarp::maxFlowDesde(const Graph &, int, int,
+                                       GraphT<uint16_t> &,
+                                       MatrizFlujo<uint16_t> &);
+template int EdmondsKarp::maxFlowConCotas(const Graph &, int, int,
+                                          const std::vector<CotaInferior> &,
+                                          GraphT<uint16_t> &,
+                                          MatrizFlujo<uint16_t> &,
+                                          std::vector<size_t> &);
+template int EdmondsKarp::maxFlowPorClases(
+    const Graph &, int, int, const std::vector<std::vector<int>> &,
+    GraphT<uint16_t> &, MatrizFlujo<uint16_t> &);
+template int EdmondsKarp::perdidaSinNodo(GraphT<uint16_t> &,
+                                         MatrizFlujo<uint16_t> &, int, int,
+                                         int);
+template int EdmondsKarp::maxFlow(const Graph &, int, int, GraphT<int32_t> &,
+                                  MatrizFlujo<int32_t> &);
+template int EdmondsKarp::maxFlowDesde(const Graph &, int, int,
+                                       GraphT<int32_t> &,
+                                       MatrizFlujo<int32_t> &);
+template int EdmondsKarp::maxFlowConCotas(const Graph &, int, int,
+                                          const std::vector<CotaInferior> &,
+                                          GraphT<int32_t> &,
+                                          MatrizFlujo<int32_t> &,
+                                          std::vector<size_t> &);
+template int EdmondsKarp::maxFlowPorClases(
+    const Graph &, int, int, const std::vector<std::vector<int>> &,
+    GraphT<int32_t> &, MatrizFlujo<int32_t> &);
+template int EdmondsKarp::perdidaSinNodo(GraphT<int32_t> &,
+                                         MatrizFlujo<int32_t> &, int, int,
+                                         int);
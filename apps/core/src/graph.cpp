@@ -1,34 +1,148 @@
 #include "graph.h"
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 
-Graph::Graph(int vertices) : numVertices(vertices) {
-  // Initialize capacity matrix with zeros
-  capacity.resize(vertices, std::vector<int>(vertices, 0));
+AnchoCapacidad anchoParaCapacidad(int capacidadMaxima) {
+  if (capacidadMaxima <= std::numeric_limits<uint8_t>::max()) {
+    return AnchoCapacidad::U8;
+  }
+  if (capacidadMaxima <= std::numeric_limits<uint16_t>::max()) {
+    return AnchoCapacidad::U16;
+  }
+  return AnchoCapacidad::I32;
 }
 
-void Graph::addEdge(int from, int to, int cap) {
-  if (from >= 0 && from < numVertices && to >= 0 && to < numVertices) {
-    capacity[from][to] = cap;
+void GraphBase::resetArcos(int vertices) {
+  numVertices = vertices;
+  palabras = (vertices + 63) / 64;
+  palabrasResumen = (palabras + 63) / 64;
+  salientes.assign(size_t(vertices) * palabras, 0);
+  entrantes.assign(size_t(vertices) * palabras, 0);
+  resumenSalientes.assign(size_t(vertices) * palabrasResumen, 0);
+  resumenEntrantes.assign(size_t(vertices) * palabrasResumen, 0);
+}
+
+void GraphBase::marcarArco(int from, int to, bool positivo) {
+  uint64_t bitTo = uint64_t(1) << (to & 63);
+  uint64_t bitFrom = uint64_t(1) << (from & 63);
+  uint64_t &s = salientes[size_t(from) * palabras + (to >> 6)];
+  uint64_t &e = entrantes[size_t(to) * palabras + (from >> 6)];
+  uint64_t &rs =
+      resumenSalientes[size_t(from) * palabrasResumen + (to >> 12)];
+  uint64_t &re =
+      resumenEntrantes[size_t(to) * palabrasResumen + (from >> 12)];
+  uint64_t palabraTo = uint64_t(1) << ((to >> 6) & 63);
+  uint64_t palabraFrom = uint64_t(1) << ((from >> 6) & 63);
+  if (positivo) {
+    s |= bitTo;
+    e |= bitFrom;
+    rs |= palabraTo;
+    re |= palabraFrom;
+  } else {
+    s &= ~bitTo;
+    e &= ~bitFrom;
+    if (s == 0) {
+      rs &= ~palabraTo;
+    }
+    if (e == 0) {
+      re &= ~palabraFrom;
+    }
+  }
+}
+
+template <typename Cap> GraphT<Cap>::GraphT(int vertices) {
+  reset(vertices);
+}
+
+template <typename Cap> void GraphT<Cap>::reset(int vertices) {
+  if (vertices == numVertices && !conNegativas) {
+    // Every non-zero entry has its bit set
+    for (int u = 0; u < numVertices; u++) {
+      const uint64_t *fila = getSalientes(u);
+      const uint64_t *resumen = getResumenSalientes(u);
+      for (int r = 0; r < palabrasResumen; r++) {
+        for (uint64_t ws = resumen[r]; ws != 0; ws &= ws - 1) {
+          int w = (r << 6) + __builtin_ctzll(ws);
+          for (uint64_t bits = fila[w]; bits != 0; bits &= bits - 1) {
+            capacity[size_t(u) * numVertices + (w << 6) +
+                     __builtin_ctzll(bits)] = 0;
+          }
+        }
+      }
+    }
+  } else {
+    capacity.assign(size_t(vertices) * vertices, 0);
+  }
+  resetArcos(vertices);
+  capacidadMaxima = 0;
+  conNegativas = false;
+}
+
+template <typename Cap>
+template <typename Otra>
+void GraphT<Cap>::copiarDe(const GraphT<Otra> &graph) {
+  int n = graph.getNumVertices();
+  reset(n);
+  size_t palabrasTotales = size_t(n) * palabras;
+  size_t resumenTotal = size_t(n) * palabrasResumen;
+  salientes.assign(graph.getSalientes(0),
+                   graph.getSalientes(0) + palabrasTotales);
+  entrantes.assign(graph.getEntrantes(0),
+                   graph.getEntrantes(0) + palabrasTotales);
+  resumenSalientes.assign(graph.getResumenSalientes(0),
+                          graph.getResumenSalientes(0) + resumenTotal);
+  resumenEntrantes.assign(graph.getResumenEntrantes(0),
+                          graph.getResumenEntrantes(0) + resumenTotal);
+  for (int u = 0; u < n; u++) {
+    const uint64_t *fila = getSalientes(u);
+    for (int w = 0; w < palabras; w++) {
+      for (uint64_t bits = fila[w]; bits != 0; bits &= bits - 1) {
+        int v = (w << 6) + __builtin_ctzll(bits);
+        int cap = graph.getCapacity(u, v);
+        capacity[size_t(u) * n + v] = static_cast<Cap>(cap);
+        capacidadMaxima = std::max(capacidadMaxima, cap);
+      }
+    }
   }
 }
 
-int Graph::getNumVertices() const { return numVertices; }
+template <typename Cap>
+void GraphT<Cap>::addEdge(int from, int to, int cap) {
+  setCapacity(from, to, cap);
+}
 
-int Graph::getCapacity(int from, int to) const {
+template <typename Cap> int GraphT<Cap>::getCapacity(int from, int to) const {
   if (from >= 0 && from < numVertices && to >= 0 && to < numVertices) {
-    return capacity[from][to];
+    return capacity[size_t(from) * numVertices + to];
   }
   return 0;
 }
 
-void Graph::setCapacity(int from, int to, int cap) {
+template <typename Cap>
+void GraphT<Cap>::setCapacity(int from, int to, int cap) {
   if (from >= 0 && from < numVertices && to >= 0 && to < numVertices) {
-    capacity[from][to] = cap;
+    Cap &actual = capacity[size_t(from) * numVertices + to];
+    if ((actual > 0) != (cap > 0)) {
+      marcarArco(from, to, cap > 0);
+    }
+    actual = static_cast<Cap>(cap);
+    if (cap > capacidadMaxima) {
+      capacidadMaxima = cap;
+    }
+    conNegativas = conNegativas || cap < 0;
   }
 }
 
-void Graph::printGraph() const {
+template <typename Cap> size_t GraphT<Cap>::memoria() const {
+  return capacity.size() * sizeof(Cap) +
+         (salientes.size() + entrantes.size() + resumenSalientes.size() +
+          resumenEntrantes.size()) *
+             sizeof(uint64_t);
+}
+
+template <typename Cap> void GraphT<Cap>::printGraph() const {
   std::cout << "Graph (Capacity Matrix):\n";
   std::cout << "    ";
   for (int i = 0; i < numVertices; i++) {
@@ -39,8 +153,21 @@ void Graph::printGraph() const {
   for (int i = 0; i < numVertices; i++) {
     std::cout << std::setw(4) << i;
     for (int j = 0; j < numVertices; j++) {
-      std::cout << std::setw(4) << capacity[i][j];
+      std::cout << std::setw(4) << getCapacity(i, j);
     }
     std::cout << "\n";
   }
 }
+
+template class GraphT<uint8_t>;
+template class GraphT<uint16_t>;
+template class GraphT<int32_t>;
+
+// Residual graphs are copied from the int32_t networks built by GraphBuilder,
+// and widened when a warm start resumes at a wider width than its last solve
+template void GraphT<uint8_t>::copiarDe(const GraphT<int32_t> &);
+template void GraphT<uint16_t>::copiarDe(const GraphT<int32_t> &);
+template void GraphT<int32_t>::copiarDe(const GraphT<int32_t> &);
+template void GraphT<uint16_t>::copiarDe(const GraphT<uint8_t> &);
+template void GraphT<int32_t>::copiarDe(const GraphT<uint8_t> &);
+template void GraphT<int32_t>::copiarDe(const GraphT<uint16_t> &);
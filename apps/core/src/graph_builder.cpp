@@ -1,195 +1,690 @@
 #include "graph_builder.h"
+#include "instance_hash.h"
+#include "traza.h"
 #include <algorithm>
+#include <functional>
+#include <numeric>
+#include <set>
+
+namespace {
+
+// Indices [0, n) sorted by name, ties kept in input order
+template <typename NameFn>
+void ordenarPorNombre(std::vector<uint32_t> &orden, uint32_t n, NameFn nombre) {
+  orden.resize(n);
+  std::iota(orden.begin(), orden.end(), 0);
+  std::stable_sort(orden.begin(), orden.end(), [&](uint32_t a, uint32_t b) {
+    return nombre(a) < nombre(b);
+  });
+}
+
+} // namespace
 
 GraphBuilder::GraphBuilder()
-    : maxGuardiasPorPeriodo_(1), maxGuardiasTotales_(999), source_(0), sink_(0),
-      numVertices_(0) {}
+    : maxGuardiasPorPeriodo_(1), maxGuardiasTotales_(999),
+      externalInstance_(nullptr), internadoValido_(false), renumerar_(false),
+      periodoMayor_(false), source_(0), sink_(0), primerMedicoPeriodo_(0),
+      primerDia_(0), primerDiaRol_(0), primerDiaTurno_(0), primerMedicoDia_(0),
+      numMedicos_(0), numPeriodos_(0), numVertices_(0),
+      ancho_(AnchoCapacidad::I32) {}
+
+void GraphBuilder::reset() {
+  medicos_.clear();
+  dias_.clear();
+  periodos_.clear();
+  disponibilidad_.clear();
+  maxGuardiasPorPeriodo_ = 1;
+  maxGuardiasTotales_ = 999;
+  medicosPorDia_.clear();
+  personalCapacities_.clear();
+  capacidadesPorPeriodo_.clear();
+  asignacionesFijas_.clear();
+  asignacionesPrevias_.clear();
+  prioridadDias_.clear();
+  roles_.clear();
+  demandaPorRol_.clear();
+  demandaPorTurno_.clear();
+  disponibilidadPorTurno_.clear();
+
+  externalInstance_ = nullptr;
+  internadoValido_ = false;
+}
 
 void GraphBuilder::setMedicos(const std::vector<std::string> &medicos) {
   medicos_ = medicos;
+  invalidar();
 }
 
 void GraphBuilder::setDias(const std::vector<std::string> &dias) {
   dias_ = dias;
+  invalidar();
 }
 
 void GraphBuilder::setPeriodos(const std::vector<Periodo> &periodos) {
   periodos_ = periodos;
+  invalidar();
 }
 
 void GraphBuilder::setDisponibilidad(
     const std::map<std::string, std::vector<std::string>> &disponibilidad) {
   disponibilidad_ = disponibilidad;
+  invalidar();
 }
 
 void GraphBuilder::setMaxGuardiasPorPeriodo(int c) {
   maxGuardiasPorPeriodo_ = c;
+  invalidar();
 }
 
-void GraphBuilder::setMaxGuardiasTotales(int c) { maxGuardiasTotales_ = c; }
+void GraphBuilder::setMaxGuardiasTotales(int c) {
+  maxGuardiasTotales_ = c;
+  invalidar();
+}
 
 void GraphBuilder::setMedicosPorDia(
     const std::map<std::string, int> &medicosPorDia) {
   medicosPorDia_ = medicosPorDia;
+  invalidar();
 }
 
 void GraphBuilder::setPersonalCapacities(
     const std::map<std::string, int> &capacities) {
   personalCapacities_ = capacities;
+  invalidar();
+}
+
+void GraphBuilder::setCapacidadesPorPeriodo(
+    const std::map<std::string, std::map<std::string, int>> &capacidades) {
+  capacidadesPorPeriodo_ = capacidades;
+  invalidar();
+}
+
+void GraphBuilder::setAsignacionesFijas(
+    const std::map<std::string, std::vector<std::string>> &fijas) {
+  asignacionesFijas_ = fijas;
+  invalidar();
+}
+
+void GraphBuilder::setAsignacionesPrevias(
+    const std::map<std::string, std::vector<std::string>> &previas) {
+  asignacionesPrevias_ = previas;
+  invalidar();
+}
+
+void GraphBuilder::setPrioridadDias(
+    const std::map<std::string, int> &prioridades) {
+  prioridadDias_ = prioridades;
+  invalidar();
+}
+
+void GraphBuilder::setRoles(
+    const std::map<std::string, std::string> &roles,
+    const std::map<std::string, std::map<std::string, int>> &demandaPorRol) {
+  roles_ = roles;
+  demandaPorRol_ = demandaPorRol;
+  invalidar();
+}
+
+void GraphBuilder::setTurnos(
+    const std::map<std::string, std::map<std::string, int>> &demandaPorTurno,
+    const std::map<std::string, std::map<std::string, std::vector<std::string>>>
+        &disponibilidadPorTurno) {
+  demandaPorTurno_ = demandaPorTurno;
+  disponibilidadPorTurno_ = disponibilidadPorTurno;
+  invalidar();
 }
 
 void GraphBuilder::setMedicosRequeridosTodosDias(int cantidad) {
   for (const auto &dia : dias_) {
     medicosPorDia_[dia] = cantidad;
   }
+  invalidar();
+}
+
+void GraphBuilder::setInstance(const InstanceView &instance) {
+  externalInstance_ = &instance;
+}
+
+void GraphBuilder::invalidar() {
+  externalInstance_ = nullptr;
+  internadoValido_ = false;
+}
+
+const InstanceView &GraphBuilder::internar() {
+  if (!externalInstance_ && !internadoValido_) {
+    Traza::Tramo tramo("intern");
+    interned_.intern(medicos_, dias_, periodos_, disponibilidad_,
+                     medicosPorDia_, personalCapacities_,
+                     capacidadesPorPeriodo_, asignacionesFijas_,
+                     asignacionesPrevias_, prioridadDias_, roles_,
+                     demandaPorRol_, demandaPorTurno_, disponibilidadPorTurno_,
+                     maxGuardiasPorPeriodo_, maxGuardiasTotales_);
+    internadoValido_ = true;
+  }
+  return getInstance();
 }
 
 void GraphBuilder::calcularIndices() {
-  int currentNode = 0;
+  const InstanceView &inst = getInstance();
+
+  // Layers are numbered consecutively, so nodes are computed, not looked up
+  source_ = 0;
+  periodoMayor_ = renumerar_;
+  numMedicos_ = inst.numMedicos;
+  numPeriodos_ = inst.numPeriodos;
+  primerMedicoPeriodo_ = source_ + 1 + inst.numMedicos;
+  primerDia_ = primerMedicoPeriodo_ + inst.numMedicos * inst.numPeriodos;
+  primerDiaRol_ = primerDia_ + inst.numDias;
+  primerDiaTurno_ = primerDiaRol_ + inst.numDemandasRol();
+  primerMedicoDia_ = primerDiaTurno_ + inst.numDemandasTurno();
+
+  // Slotted days: a doctor who may take one slot goes straight to it; with
+  // several, through a Doctor-Day node. Only for available (or locked)
+  // pairs, so the extra nodes grow with the real slot availability.
+  indiceDiaTurno_.assign(inst.numDias, -1);
+  numDiasTurno_ = 0;
+  for (uint32_t d = 0; d < inst.numDias; d++) {
+    if (inst.tieneTurnos(d)) {
+      indiceDiaTurno_[d] = numDiasTurno_++;
+    }
+  }
+  entradaTurno_.assign(size_t(inst.numMedicos) * numDiasTurno_, -1);
+  medicoDia_.clear();
+  auto agregarEntrada = [&](uint32_t m, uint32_t d) {
+    int &entrada = entradaTurno_[size_t(m) * numDiasTurno_ + indiceDiaTurno_[d]];
+    if (entrada >= 0) {
+      return;
+    }
+    int opciones = 0;
+    paraCadaTurno(m, d, [&](uint32_t k) {
+      entrada = nodoDiaTurno(k);
+      opciones++;
+    });
+    if (opciones > 1) {
+      entrada = primerMedicoDia_ + medicoDia_.size();
+      medicoDia_.emplace_back(m, d);
+    }
+  };
+  for (uint32_t m = 0; m < inst.numMedicos && numDiasTurno_ > 0; m++) {
+    for (uint32_t d = 0; d < inst.numDias; d++) {
+      if (indiceDiaTurno_[d] >= 0 && inst.disponible(m, d)) {
+        agregarEntrada(m, d);
+      }
+    }
+  }
+  for (uint32_t f = 0; f < inst.numFijas && numDiasTurno_ > 0; f++) {
+    if (indiceDiaTurno_[inst.fijas[2 * f + 1]] >= 0) {
+      agregarEntrada(inst.fijas[2 * f], inst.fijas[2 * f + 1]);
+    }
+  }
+
+  sink_ = primerMedicoDia_ + medicoDia_.size();
+  numVertices_ = sink_ + 1;
 
-  // Source
-  source_ = currentNode++;
+  ordenarPorNombre(ordenMedicos_, inst.numMedicos,
+                   [&](uint32_t m) { return inst.medico(m); });
+  ordenarPorNombre(ordenPeriodos_, inst.numPeriodos,
+                   [&](uint32_t p) { return inst.periodo(p); });
+  ordenarPorNombre(ordenDias_, inst.numDias,
+                   [&](uint32_t d) { return inst.dia(d); });
 
-  // Layer 1: Doctors
-  for (const auto &medico : medicos_) {
-    medicoToNode_[medico] = currentNode;
-    nodeToMedico_[currentNode] = medico;
-    currentNode++;
+  // Days of each period in name order, without repetitions
+  std::vector<uint32_t> rango(inst.numDias);
+  for (uint32_t i = 0; i < inst.numDias; i++) {
+    rango[ordenDias_[i]] = i;
   }
+  periodoDiasOffsets_.assign(1, 0);
+  periodoDiasOrdenados_.clear();
+  for (uint32_t p = 0; p < inst.numPeriodos; p++) {
+    auto inicio = periodoDiasOrdenados_.end() - periodoDiasOrdenados_.begin();
+    periodoDiasOrdenados_.insert(periodoDiasOrdenados_.end(),
+                                 inst.periodoDias + inst.periodoOffsets[p],
+                                 inst.periodoDias + inst.periodoOffsets[p + 1]);
+    auto begin = periodoDiasOrdenados_.begin() + inicio;
+    std::sort(begin, periodoDiasOrdenados_.end(),
+              [&](uint32_t a, uint32_t b) { return rango[a] < rango[b]; });
+    periodoDiasOrdenados_.erase(std::unique(begin, periodoDiasOrdenados_.end()),
+                                periodoDiasOrdenados_.end());
+    periodoDiasOffsets_.push_back(periodoDiasOrdenados_.size());
+  }
+}
 
-  // Layer 2: Doctor-Period
-  for (const auto &medico : medicos_) {
-    for (const auto &periodo : periodos_) {
-      auto key = std::make_pair(medico, periodo.id);
-      medicoPeriodoToNode_[key] = currentNode;
-      nodeToMedicoPeriodo_[currentNode] = key;
-      currentNode++;
+template <typename Fn>
+void GraphBuilder::paraCadaTurno(uint32_t m, uint32_t d, Fn fn) const {
+  const InstanceView &inst = getInstance();
+  for (uint32_t k = inst.demandaTurnoOffsets[d];
+       k < inst.demandaTurnoOffsets[d + 1]; k++) {
+    if (inst.puedeTurno(m, d, k)) {
+      fn(k);
     }
   }
+}
 
-  // Layer 3: Days
-  for (const auto &dia : dias_) {
-    diaToNode_[dia] = currentNode;
-    nodeToDia_[currentNode] = dia;
-    currentNode++;
+int GraphBuilder::nodoDestino(uint32_t m, uint32_t d) const {
+  const InstanceView &inst = getInstance();
+  if (inst.conTurnos() && indiceDiaTurno_[d] >= 0) {
+    return entradaTurno_[size_t(m) * numDiasTurno_ + indiceDiaTurno_[d]];
+  }
+  if (!inst.conRoles() ||
+      inst.demandaRolOffsets[d] == inst.demandaRolOffsets[d + 1]) {
+    return nodoDia(d);
   }
+  int64_t k = inst.demandaRol(d, inst.rolMedico[m]);
+  return k < 0 ? -1 : nodoDiaRol(k);
+}
+
+Graph GraphBuilder::build() {
+  Graph g(0);
+  build(g);
+  return g;
+}
 
-  // Sink
-  sink_ = currentNode++;
+void GraphBuilder::build(Graph &g) {
+  // Intern the input and calculate node indices
+  const InstanceView &inst = internar();
+  Traza::Tramo tramo("build");
+  construir(g, claveTopologia(inst));
+}
 
-  numVertices_ = currentNode;
+std::string GraphBuilder::claveTopologia(const InstanceView &inst) const {
+  // A layout in the other vertex order is a different topology
+  return hashTopologia(inst) + (renumerar_ ? "+renumber" : "");
 }
 
-bool GraphBuilder::estaDisponible(const std::string &medico,
-                                  const std::string &dia) const {
-  auto it = disponibilidad_.find(medico);
-  if (it == disponibilidad_.end()) {
+bool GraphBuilder::rebuild(Graph &g) {
+  const InstanceView &inst = internar();
+  Traza::Tramo tramo("build");
+  std::string topologia = claveTopologia(inst);
+  if (topologia != topologia_ || g.getNumVertices() != numVertices_) {
+    construir(g, topologia);
     return false;
   }
-  const auto &diasDisponibles = it->second;
-  return std::find(diasDisponibles.begin(), diasDisponibles.end(), dia) !=
-         diasDisponibles.end();
+
+  // Same layout and layer-3 arcs: only capacities can have changed
+  tramo.arg("reused", 1);
+  escribirCapacidades(g);
+  return true;
 }
 
-std::string GraphBuilder::getPeriodoDeDia(const std::string &dia) const {
-  for (const auto &periodo : periodos_) {
-    if (std::find(periodo.dias.begin(), periodo.dias.end(), dia) !=
-        periodo.dias.end()) {
-      return periodo.id;
+void GraphBuilder::construir(Graph &g, const std::string &topologia) {
+  calcularIndices();
+  topologia_ = topologia;
+
+  const InstanceView &inst = getInstance();
+  g.reset(numVertices_);
+  escribirCapacidades(g);
+
+  // LAYER 3: Doctor-Period -> Days
+  // Capacity = 1 if the doctor is available that day
+  for (uint32_t m = 0; m < inst.numMedicos; m++) {
+    for (uint32_t p = 0; p < inst.numPeriodos; p++) {
+      int mpNode = nodoMedicoPeriodo(m, p);
+      for (uint32_t k = inst.periodoOffsets[p]; k < inst.periodoOffsets[p + 1];
+           k++) {
+        uint32_t d = inst.periodoDias[k];
+        int destino = nodoDestino(m, d);
+        if (destino >= 0 && inst.disponible(m, d)) {
+          g.addEdge(mpNode, destino, 1);
+        }
+      }
     }
   }
-  return "";
-}
 
-Graph GraphBuilder::build() {
-  // Calculate node indices
-  calcularIndices();
+  // Locked assignments: lower bound 1 on the arc through the first period
+  // that contains the day (added even if the doctor is no longer available)
+  cotas_.clear();
+  cotaFija_.clear();
+  fijasSinPeriodo_.clear();
+  fijasSinRol_.clear();
+  if (inst.numFijas > 0) {
+    std::vector<int64_t> periodoDe = primerPeriodoDeDia();
+    for (uint32_t f = 0; f < inst.numFijas; f++) {
+      uint32_t m = inst.fijas[2 * f];
+      uint32_t d = inst.fijas[2 * f + 1];
+      if (periodoDe[d] < 0) {
+        fijasSinPeriodo_.push_back(f);
+        continue;
+      }
+      int destino = nodoDestino(m, d);
+      if (destino < 0) {
+        fijasSinRol_.push_back(f);
+        continue;
+      }
+      int mpNode = nodoMedicoPeriodo(m, periodoDe[d]);
+      g.addEdge(mpNode, destino, 1);
+      cotas_.push_back({mpNode, destino, 1});
+      cotaFija_.push_back(f);
+    }
+  }
 
-  Graph g(numVertices_);
+  // Doctor-Days -> Day-Slots: capacity = 1 for each slot the doctor may take
+  for (size_t i = 0; i < medicoDia_.size(); i++) {
+    auto [m, d] = medicoDia_[i];
+    paraCadaTurno(m, d, [&](uint32_t k) {
+      g.addEdge(primerMedicoDia_ + i, nodoDiaTurno(k), 1);
+    });
+  }
+}
+
+void GraphBuilder::escribirCapacidades(Graph &g) {
+  const InstanceView &inst = getInstance();
+  int maxima = 1; // Layer 3 arcs
+  auto arco = [&](int from, int to, int cap) {
+    g.addEdge(from, to, cap);
+    maxima = std::max(maxima, cap);
+  };
 
   // LAYER 1: Source -> Doctors
   // Capacity = min(C, available days of doctor)
-  // C = maxGuardiasTotales_ (total shift limit per doctor)
-  for (const auto &medico : medicos_) {
-    int diasDisponibles = 0;
-    auto it = disponibilidad_.find(medico);
-    if (it != disponibilidad_.end()) {
-      diasDisponibles = it->second.size();
+  // C = maxGuardiasTotales (total shift limit per doctor), unless the doctor
+  // has a personal capacity
+  for (uint32_t m = 0; m < inst.numMedicos; m++) {
+    arco(source_, nodoMedico(m), capacidadMedico(m));
+  }
+
+  // LAYER 2: Doctors -> Doctor-Period
+  // Capacity = maxGuardiasPorPeriodo (max 1 day per period per specs), then
+  // the doctor's sparse per-period capacities on top
+  for (uint32_t m = 0; m < inst.numMedicos; m++) {
+    for (uint32_t p = 0; p < inst.numPeriodos; p++) {
+      arco(nodoMedico(m), nodoMedicoPeriodo(m, p), inst.maxGuardiasPorPeriodo);
     }
+    if (inst.capPeriodoOffsets != nullptr) {
+      for (uint32_t k = inst.capPeriodoOffsets[m];
+           k < inst.capPeriodoOffsets[m + 1]; k++) {
+        arco(nodoMedico(m), nodoMedicoPeriodo(m, inst.capPeriodoPeriodos[k]),
+             inst.capPeriodoValores[k]);
+      }
+    }
+  }
 
-    // Apply limit C: the doctor cannot work more than C days in total
-    // If personal capacity is defined, use it. Otherwise, use global C.
-    int limit = maxGuardiasTotales_;
-    if (personalCapacities_.count(medico)) {
-      limit = personalCapacities_[medico];
+  // Day-Roles -> Days
+  // Capacity = doctors of the role required that day
+  for (uint32_t d = 0; d < inst.numDias && inst.conRoles(); d++) {
+    for (uint32_t k = inst.demandaRolOffsets[d];
+         k < inst.demandaRolOffsets[d + 1]; k++) {
+      arco(nodoDiaRol(k), nodoDia(d), inst.demandaRolValores[k]);
     }
-    int capacidad = std::min(limit, diasDisponibles);
-    g.addEdge(source_, medicoToNode_[medico], capacidad);
   }
 
-  // LAYER 2: Doctors -> Doctor-Period
-  // Capacity = maxGuardiasPorPeriodo (max 1 day per period per specs)
-  for (const auto &medico : medicos_) {
-    for (const auto &periodo : periodos_) {
-      auto key = std::make_pair(medico, periodo.id);
-      g.addEdge(medicoToNode_[medico], medicoPeriodoToNode_[key],
-                maxGuardiasPorPeriodo_);
+  // Day-Slots -> Days
+  // Capacity = doctors required in that slot
+  for (uint32_t d = 0; d < inst.numDias && inst.conTurnos(); d++) {
+    for (uint32_t k = inst.demandaTurnoOffsets[d];
+         k < inst.demandaTurnoOffsets[d + 1]; k++) {
+      arco(nodoDiaTurno(k), nodoDia(d), inst.demandaTurnoValores[k]);
     }
   }
 
-  // LAYER 3: Doctor-Period -> Days
-  // Capacity = 1 if the doctor is available that day
-  for (const auto &medico : medicos_) {
-    for (const auto &periodo : periodos_) {
-      auto mpKey = std::make_pair(medico, periodo.id);
-      int mpNode = medicoPeriodoToNode_[mpKey];
-
-      for (const auto &dia : periodo.dias) {
-        if (estaDisponible(medico, dia)) {
-          g.addEdge(mpNode, diaToNode_[dia], 1);
+  // FINAL: Days -> Sink
+  // Capacity = doctors required that day
+  for (uint32_t d = 0; d < inst.numDias; d++) {
+    arco(nodoDia(d), sink_, inst.medicosPorDia[d]);
+  }
+
+  // No antiparallel arcs, so no residual capacity exceeds the largest one
+  ancho_ = anchoParaCapacidad(maxima);
+}
+
+int GraphBuilder::capacidadMedico(uint32_t m) const {
+  const InstanceView &inst = getInstance();
+  int diasDisponibles = inst.diasDisponibles[m];
+  return std::min(inst.limite(m), diasDisponibles);
+}
+
+std::vector<int64_t> GraphBuilder::primerPeriodoDeDia() const {
+  const InstanceView &inst = getInstance();
+  std::vector<int64_t> periodoDe(inst.numDias, -1);
+  for (uint32_t p = inst.numPeriodos; p-- > 0;) {
+    for (uint32_t k = inst.periodoOffsets[p]; k < inst.periodoOffsets[p + 1];
+         k++) {
+      periodoDe[inst.periodoDias[k]] = p;
+    }
+  }
+  return periodoDe;
+}
+
+void GraphBuilder::buildImplicita(RedImplicita &red) {
+  const InstanceView &inst = internar();
+  Traza::Tramo tramo("build");
+  calcularIndices();
+  topologia_.clear(); // The next rebuild() must not trust a previous graph
+  cotas_.clear();
+  cotaFija_.clear();
+  fijasSinPeriodo_.clear();
+  fijasSinRol_.clear();
+
+  // Same layers and capacities as build(), except layer 3. A negative limit
+  // is no arc in the matrix graph; here it must be an arc of capacity 0.
+  red.reset(numVertices_);
+  for (uint32_t m = 0; m < inst.numMedicos; m++) {
+    red.addArc(source_, nodoMedico(m), std::max(0, capacidadMedico(m)));
+  }
+  for (uint32_t m = 0; m < inst.numMedicos; m++) {
+    for (uint32_t p = 0; p < inst.numPeriodos; p++) {
+      red.addArc(nodoMedico(m), nodoMedicoPeriodo(m, p),
+                 std::max(0, inst.limitePeriodo(m, p)));
+    }
+  }
+  for (uint32_t d = 0; d < inst.numDias && inst.conRoles(); d++) {
+    for (uint32_t k = inst.demandaRolOffsets[d];
+         k < inst.demandaRolOffsets[d + 1]; k++) {
+      red.addArc(nodoDiaRol(k), nodoDia(d), inst.demandaRolValores[k]);
+      red.marcarDestino(nodoDiaRol(k), d);
+    }
+  }
+  for (uint32_t d = 0; d < inst.numDias && inst.conTurnos(); d++) {
+    for (uint32_t k = inst.demandaTurnoOffsets[d];
+         k < inst.demandaTurnoOffsets[d + 1]; k++) {
+      red.addArc(nodoDiaTurno(k), nodoDia(d), inst.demandaTurnoValores[k]);
+      red.marcarDestino(nodoDiaTurno(k), d);
+    }
+  }
+  for (size_t i = 0; i < medicoDia_.size(); i++) {
+    auto [m, d] = medicoDia_[i];
+    paraCadaTurno(m, d, [&](uint32_t k) {
+      red.addArc(primerMedicoDia_ + i, nodoDiaTurno(k), 1);
+    });
+    red.marcarDestino(primerMedicoDia_ + i, d);
+  }
+  for (uint32_t d = 0; d < inst.numDias; d++) {
+    red.addArc(nodoDia(d), sink_, inst.medicosPorDia[d]);
+    red.marcarDestino(nodoDia(d), d);
+  }
+  red.setCapa3(*this);
+}
+
+void GraphBuilder::buildEstable(MinCostFlow &red) {
+  const InstanceView &inst = internar();
+  Traza::Tramo tramo("build");
+  calcularIndices();
+  topologia_.clear(); // The next rebuild() must not trust a previous graph
+
+  const uint32_t M = inst.numMedicos;
+  const uint32_t P = inst.numPeriodos;
+  red.reset(numVertices_);
+
+  // Same layers and capacities as build()
+  std::vector<int> arcoMedico(M);
+  for (uint32_t m = 0; m < M; m++) {
+    arcoMedico[m] = red.addArc(source_, nodoMedico(m), capacidadMedico(m), 0);
+  }
+  std::vector<int> arcoMedicoPeriodo(size_t(M) * P);
+  for (uint32_t m = 0; m < M; m++) {
+    for (uint32_t p = 0; p < P; p++) {
+      arcoMedicoPeriodo[m * P + p] =
+          red.addArc(nodoMedico(m), nodoMedicoPeriodo(m, p),
+                     inst.limitePeriodo(m, p), 0);
+    }
+  }
+
+  // Previous pairs, as a dense doctor x day lookup
+  std::vector<uint8_t> esPrevia(size_t(M) * inst.numDias, 0);
+  for (uint32_t f = 0; f < inst.numPrevias; f++) {
+    esPrevia[size_t(inst.previas[2 * f]) * inst.numDias +
+             inst.previas[2 * f + 1]] = 1;
+  }
+
+  // Layer 3, remembering the arcs of previous pairs through the first period
+  // that contains their day (the arcs after it are appended below)
+  std::vector<int64_t> periodoDe = primerPeriodoDeDia();
+  std::vector<std::vector<int>> caminosPrevios;
+  std::vector<uint32_t> diaPrevio;
+  for (uint32_t m = 0; m < M; m++) {
+    for (uint32_t p = 0; p < P; p++) {
+      for (uint32_t k = inst.periodoOffsets[p]; k < inst.periodoOffsets[p + 1];
+           k++) {
+        uint32_t d = inst.periodoDias[k];
+        if (!inst.disponible(m, d)) {
+          continue;
+        }
+        int destino = nodoDestino(m, d);
+        if (destino < 0) {
+          continue;
+        }
+        bool previa = esPrevia[size_t(m) * inst.numDias + d];
+        int arco = red.addArc(nodoMedicoPeriodo(m, p), destino, 1,
+                              previa ? 0 : 1);
+        if (previa && periodoDe[d] == p) {
+          caminosPrevios.push_back(
+              {arcoMedico[m], arcoMedicoPeriodo[m * P + p], arco});
+          diaPrevio.push_back(d);
         }
       }
     }
   }
 
-  // FINAL: Days -> Sink
-  // Capacity = doctors required that day
-  for (const auto &dia : dias_) {
-    int requeridos = 1; // Default: 1 doctor per day
-    auto it = medicosPorDia_.find(dia);
-    if (it != medicosPorDia_.end()) {
-      requeridos = it->second;
+  std::vector<int> arcoDiaRol(inst.numDemandasRol());
+  for (uint32_t d = 0; d < inst.numDias && inst.conRoles(); d++) {
+    for (uint32_t k = inst.demandaRolOffsets[d];
+         k < inst.demandaRolOffsets[d + 1]; k++) {
+      arcoDiaRol[k] = red.addArc(nodoDiaRol(k), nodoDia(d),
+                                 inst.demandaRolValores[k], 0);
+    }
+  }
+  std::vector<int> arcoDiaTurno(inst.numDemandasTurno());
+  for (uint32_t d = 0; d < inst.numDias && inst.conTurnos(); d++) {
+    for (uint32_t k = inst.demandaTurnoOffsets[d];
+         k < inst.demandaTurnoOffsets[d + 1]; k++) {
+      arcoDiaTurno[k] = red.addArc(nodoDiaTurno(k), nodoDia(d),
+                                   inst.demandaTurnoValores[k], 0);
     }
-    g.addEdge(diaToNode_[dia], sink_, requeridos);
+  }
+  std::vector<std::vector<int>> arcosMedicoDia(medicoDia_.size());
+  for (size_t i = 0; i < medicoDia_.size(); i++) {
+    auto [m, d] = medicoDia_[i];
+    paraCadaTurno(m, d, [&](uint32_t k) {
+      arcosMedicoDia[i].push_back(
+          red.addArc(primerMedicoDia_ + i, nodoDiaTurno(k), 1, 0));
+    });
+  }
+  std::vector<int> arcoDia(inst.numDias);
+  for (uint32_t d = 0; d < inst.numDias; d++) {
+    arcoDia[d] = red.addArc(nodoDia(d), sink_, inst.medicosPorDia[d], 0);
   }
 
-  return g;
+  // Warm start with every previous pair that still fits (on a Doctor-Day
+  // node, in the first of its slots with room)
+  for (size_t i = 0; i < caminosPrevios.size(); i++) {
+    auto &camino = caminosPrevios[i];
+    uint32_t d = diaPrevio[i];
+    int destino = red.to(camino.back());
+    if (destino >= primerMedicoDia_) {
+      for (int arco : arcosMedicoDia[destino - primerMedicoDia_]) {
+        camino.push_back(arco);
+        camino.push_back(arcoDiaTurno[red.to(arco) - primerDiaTurno_]);
+        camino.push_back(arcoDia[d]);
+        if (red.empujar(camino, 1)) {
+          break;
+        }
+        camino.resize(camino.size() - 3);
+      }
+      continue;
+    }
+    if (destino >= primerDiaTurno_) {
+      camino.push_back(arcoDiaTurno[destino - primerDiaTurno_]);
+    } else if (destino != nodoDia(d)) {
+      camino.push_back(arcoDiaRol[destino - primerDiaRol_]);
+    }
+    camino.push_back(arcoDia[d]);
+    red.empujar(camino, 1);
+  }
 }
 
+Estabilidad
+GraphBuilder::medirEstabilidad(const ResultadoAsignacion &resultado) {
+  const InstanceView &inst = getInstance();
+  Estabilidad e;
+  e.previas = inst.numPrevias;
+
+  std::set<std::pair<std::string_view, std::string_view>> previas;
+  for (uint32_t f = 0; f < inst.numPrevias; f++) {
+    previas.emplace(inst.medico(inst.previas[2 * f]),
+                    inst.dia(inst.previas[2 * f + 1]));
+  }
+  for (const auto &a : resultado.asignaciones) {
+    if (previas.count({a.medico, a.dia})) {
+      e.conservadas++;
+    }
+  }
+
+  int nuevas = static_cast<int>(resultado.asignaciones.size()) - e.conservadas;
+  e.cambios = (e.previas - e.conservadas) + nuevas;
+  return e;
+}
+
+template <typename F>
 ResultadoAsignacion
-GraphBuilder::extraerResultado(const std::vector<std::vector<int>> &flowGraph) {
+GraphBuilder::extraerResultado(const std::vector<std::vector<F>> &flowGraph) {
+  return extraer([&](int u, int v) { return flowGraph[u][v]; });
+}
+
+ResultadoAsignacion GraphBuilder::extraerResultado(const RedImplicita &red) {
+  return extraer([&](int u, int v) { return red.flujo(u, v); });
+}
+
+template <typename Flujo>
+ResultadoAsignacion GraphBuilder::extraer(Flujo flujo) {
+  Traza::Tramo tramo("extract");
+  const InstanceView &inst = getInstance();
   ResultadoAsignacion resultado;
   resultado.factible = false;
   resultado.diasCubiertos = 0;
   resultado.diasRequeridos = 0;
 
   // Calculate required days
-  for (const auto &dia : dias_) {
-    auto it = medicosPorDia_.find(dia);
-    resultado.diasRequeridos += (it != medicosPorDia_.end()) ? it->second : 1;
+  for (uint32_t d = 0; d < inst.numDias; d++) {
+    resultado.diasRequeridos += inst.medicosPorDia[d];
   }
 
   // Extract assignments from Doctor-Period -> Days
-  for (const auto &[mpNode, mpPair] : nodeToMedicoPeriodo_) {
-    const std::string &medico = mpPair.first;
-
-    for (const auto &[dia, diaNode] : diaToNode_) {
-      if (flowGraph[mpNode][diaNode] > 0) {
-        Asignacion asig;
-        asig.medico = medico;
-        asig.dia = dia;
-        resultado.asignaciones.push_back(asig);
-        resultado.diasCubiertos++;
+  for (uint32_t m = 0; m < inst.numMedicos; m++) {
+    for (uint32_t p = 0; p < inst.numPeriodos; p++) {
+      int mpNode = nodoMedicoPeriodo(m, p);
+
+      for (uint32_t k = periodoDiasOffsets_[p]; k < periodoDiasOffsets_[p + 1];
+           k++) {
+        uint32_t d = periodoDiasOrdenados_[k];
+        int destino = nodoDestino(m, d);
+        if (destino >= 0 && flujo(mpNode, destino) > 0) {
+          Asignacion asig;
+          asig.medico = std::string(inst.medico(m));
+          asig.dia = std::string(inst.dia(d));
+          if (destino >= primerMedicoDia_) {
+            paraCadaTurno(m, d, [&](uint32_t t) {
+              if (flujo(destino, nodoDiaTurno(t)) > 0) {
+                asig.turno = std::string(inst.turno(inst.demandaTurnoTurnos[t]));
+              }
+            });
+          } else if (destino >= primerDiaTurno_) {
+            uint32_t t = destino - primerDiaTurno_;
+            asig.turno = std::string(inst.turno(inst.demandaTurnoTurnos[t]));
+          } else if (destino != nodoDia(d)) {
+            asig.rol = std::string(inst.rol(inst.rolMedico[m]));
+          }
+          resultado.asignaciones.push_back(asig);
+          resultado.diasCubiertos++;
+        }
       }
     }
   }
@@ -199,8 +694,49 @@ GraphBuilder::extraerResultado(const std::vector<std::vector<int>> &flowGraph) {
   return resultado;
 }
 
+std::vector<std::vector<int>> GraphBuilder::clasesPrioridad() const {
+  const InstanceView &inst = getInstance();
+  std::vector<std::vector<int>> clases;
+  if (inst.prioridadDia == nullptr) {
+    return clases;
+  }
+
+  std::map<int, std::vector<int>, std::greater<int>> porPrioridad;
+  for (uint32_t d = 0; d < inst.numDias; d++) {
+    porPrioridad[inst.prioridadDia[d]].push_back(nodoDia(d));
+  }
+  for (auto &[prioridad, nodos] : porPrioridad) {
+    clases.push_back(std::move(nodos));
+  }
+  return clases;
+}
+
+template <typename F>
+std::vector<CoberturaPrioridad> GraphBuilder::coberturaPorPrioridad(
+    const std::vector<std::vector<F>> &flowGraph) const {
+  const InstanceView &inst = getInstance();
+  std::vector<CoberturaPrioridad> cobertura;
+  if (inst.prioridadDia == nullptr) {
+    return cobertura;
+  }
+
+  std::map<int, CoberturaPrioridad, std::greater<int>> porPrioridad;
+  for (uint32_t d = 0; d < inst.numDias; d++) {
+    CoberturaPrioridad &c = porPrioridad[inst.prioridadDia[d]];
+    c.prioridad = inst.prioridadDia[d];
+    c.diasRequeridos += inst.medicosPorDia[d];
+    c.diasCubiertos += flowGraph[nodoDia(d)][sink_];
+  }
+  for (const auto &[prioridad, c] : porPrioridad) {
+    cobertura.push_back(c);
+  }
+  return cobertura;
+}
+
 std::vector<Bottleneck>
 GraphBuilder::analyzeMinCut(const std::vector<int> &reachableNodes) {
+  Traza::Tramo tramo("bottlenecks");
+  const InstanceView &inst = getInstance();
   std::vector<Bottleneck> bottlenecks;
   std::vector<bool> isReachable(numVertices_, false);
   for (int node : reachableNodes) {
@@ -209,33 +745,120 @@ GraphBuilder::analyzeMinCut(const std::vector<int> &reachableNodes) {
 
   // 1. Uncovered Days
   // If a DAY node is not reachable from Source, it means flow didn't reach it.
-  for (const auto &[dia, node] : diaToNode_) {
-    if (!isReachable[node]) {
-      bottlenecks.push_back({"Day", dia, "Could not assign enough doctors"});
+  for (uint32_t d : ordenDias_) {
+    if (!isReachable[nodoDia(d)]) {
+      bottlenecks.push_back({"Day", std::string(inst.dia(d)),
+                             "Could not assign enough doctors"});
+    }
+  }
+
+  // 1b. Uncovered roles
+  // A Day-Role node not reachable: not enough doctors of that role that day
+  for (uint32_t d : ordenDias_) {
+    for (uint32_t k = inst.conRoles() ? inst.demandaRolOffsets[d] : 0;
+         inst.conRoles() && k < inst.demandaRolOffsets[d + 1]; k++) {
+      if (!isReachable[nodoDiaRol(k)]) {
+        bottlenecks.push_back(
+            {"Role",
+             std::string(inst.dia(d)) + " / " +
+                 std::string(inst.rol(inst.demandaRolRoles[k])),
+             "Could not assign enough doctors with this role"});
+      }
+    }
+  }
+
+  // 1c. Uncovered shift slots
+  // A Day-Slot node not reachable: not enough doctors for that slot
+  for (uint32_t d : ordenDias_) {
+    for (uint32_t k = inst.conTurnos() ? inst.demandaTurnoOffsets[d] : 0;
+         inst.conTurnos() && k < inst.demandaTurnoOffsets[d + 1]; k++) {
+      if (!isReachable[nodoDiaTurno(k)]) {
+        bottlenecks.push_back(
+            {"Slot",
+             std::string(inst.dia(d)) + " / " +
+                 std::string(inst.turno(inst.demandaTurnoTurnos[k])),
+             "Could not assign enough doctors to this shift slot"});
+      }
     }
   }
 
   // 2. Globally Saturated Doctors
   // If Source (Reachable) -> Doctor (Unreachable)
   // Means the Source->Doctor edge is saturated (Total Capacity exhausted)
-  for (const auto &[medico, node] : medicoToNode_) {
-    if (!isReachable[node]) {
+  for (uint32_t m : ordenMedicos_) {
+    if (!isReachable[nodoMedico(m)]) {
       // The Doctor node is unreachable, so the Source->Doctor edge (cap=C) is
       // full.
-      bottlenecks.push_back(
-          {"Doctor", medico, "Reached maximum total shifts limit"});
+      bottlenecks.push_back({"Doctor", std::string(inst.medico(m)),
+                             "Reached maximum total shifts limit"});
     }
   }
 
   // 3. Period Saturated Doctors
   // If Doctor (Reachable) -> DoctorPeriod (Unreachable)
   // Means the doctor had total shifts available, but saturated the period limit
-  for (const auto &[key, node] : medicoPeriodoToNode_) {
-    if (isReachable[medicoToNode_[key.first]] && !isReachable[node]) {
-      bottlenecks.push_back({"DoctorInPeriod", key.first + " in " + key.second,
-                             "Reached shift limit in this period"});
+  for (uint32_t m : ordenMedicos_) {
+    if (!isReachable[nodoMedico(m)]) {
+      continue;
+    }
+    for (uint32_t p : ordenPeriodos_) {
+      if (!isReachable[nodoMedicoPeriodo(m, p)]) {
+        bottlenecks.push_back(
+            {"DoctorInPeriod",
+             std::string(inst.medico(m)) + " in " + std::string(inst.periodo(p)),
+             "Reached shift limit in this period"});
+      }
     }
   }
 
   return bottlenecks;
 }
+
+std::vector<Bottleneck>
+GraphBuilder::analyzeFijas(const std::vector<size_t> &insatisfechas) {
+  Traza::Tramo tramo("bottlenecks");
+  const InstanceView &inst = getInstance();
+  std::vector<Bottleneck> bottlenecks;
+
+  std::vector<int> fijasPorDia(inst.numDias, 0);
+  for (uint32_t f = 0; f < inst.numFijas; f++) {
+    fijasPorDia[inst.fijas[2 * f + 1]]++;
+  }
+
+  auto id = [&](uint32_t f) {
+    return std::string(inst.medico(inst.fijas[2 * f])) + " on " +
+           std::string(inst.dia(inst.fijas[2 * f + 1]));
+  };
+
+  for (uint32_t f : fijasSinPeriodo_) {
+    bottlenecks.push_back({"Lock", id(f), "Locked day is not in any period"});
+  }
+  for (uint32_t f : fijasSinRol_) {
+    bottlenecks.push_back(
+        {"Lock", id(f), "Locked day does not require the doctor's role"});
+  }
+  for (size_t i : insatisfechas) {
+    uint32_t f = cotaFija_[i];
+    uint32_t d = inst.fijas[2 * f + 1];
+    if (fijasPorDia[d] > inst.medicosPorDia[d]) {
+      bottlenecks.push_back(
+          {"Lock", id(f), "More locked doctors than required that day"});
+    } else {
+      bottlenecks.push_back(
+          {"Lock", id(f), "Locked shifts exceed the doctor's limits"});
+    }
+  }
+
+  std::sort(bottlenecks.begin(), bottlenecks.end(),
+            [](const Bottleneck &a, const Bottleneck &b) { return a.id < b.id; });
+  return bottlenecks;
+}
+
+template ResultadoAsignacion GraphBuilder::extraerResultado(
+    const std::vector<std::vector<int16_t>> &);
+template ResultadoAsignacion GraphBuilder::extraerResultado(
+    const std::vector<std::vector<int32_t>> &);
+template std::vector<CoberturaPrioridad> GraphBuilder::coberturaPorPrioridad(
+    const std::vector<std::vector<int16_t>> &) const;
+template std::vector<CoberturaPrioridad> GraphBuilder::coberturaPorPrioridad(
+    const std::vector<std::vector<int32_t>> &) const;
@@ -0,0 +1,610 @@
+#include "instance.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+// Flattens doctor -> [days] into sorted (doctor, day) index pairs without
+// repetitions, dropping unknown doctors and days. Returns the pair count.
+uint32_t internarPares(
+    const std::vector<std::string> &medicos,
+    const std::unordered_map<std::string, uint32_t> &diaIndex,
+    const std::map<std::string, std::vector<std::string>> &porMedico,
+    std::vector<uint32_t> &salida) {
+  std::vector<std::pair<uint32_t, uint32_t>> pares;
+  for (uint32_t m = 0; m < medicos.size(); m++) {
+    auto it = porMedico.find(medicos[m]);
+    if (it != porMedico.end()) {
+      for (const auto &dia : it->second) {
+        auto d = diaIndex.find(dia);
+        if (d != diaIndex.end()) {
+          pares.emplace_back(m, d->second);
+        }
+      }
+    }
+  }
+  std::sort(pares.begin(), pares.end());
+  pares.erase(std::unique(pares.begin(), pares.end()), pares.end());
+
+  salida.clear();
+  for (const auto &[m, d] : pares) {
+    salida.push_back(m);
+    salida.push_back(d);
+  }
+  return pares.size();
+}
+
+} // namespace
+
+InternedInstance::InternedInstance(const InternedInstance &other)
+    : nombreOffsets_(other.nombreOffsets_), nombres_(other.nombres_),
+      periodoOffsets_(other.periodoOffsets_),
+      periodoDias_(other.periodoDias_),
+      disponibilidad_(other.disponibilidad_),
+      diasDisponibles_(other.diasDisponibles_),
+      medicosPorDia_(other.medicosPorDia_), capacidades_(other.capacidades_),
+      capPeriodoOffsets_(other.capPeriodoOffsets_),
+      capPeriodoPeriodos_(other.capPeriodoPeriodos_),
+      capPeriodoValores_(other.capPeriodoValores_), fijas_(other.fijas_),
+      previas_(other.previas_), prioridades_(other.prioridades_),
+      rolNombreOffsets_(other.rolNombreOffsets_),
+      rolNombres_(other.rolNombres_), rolMedico_(other.rolMedico_),
+      demandaRolOffsets_(other.demandaRolOffsets_),
+      demandaRolRoles_(other.demandaRolRoles_),
+      demandaRolValores_(other.demandaRolValores_),
+      turnoNombreOffsets_(other.turnoNombreOffsets_),
+      turnoNombres_(other.turnoNombres_),
+      demandaTurnoOffsets_(other.demandaTurnoOffsets_),
+      demandaTurnoTurnos_(other.demandaTurnoTurnos_),
+      demandaTurnoValores_(other.demandaTurnoValores_),
+      turnoMedicoOffsets_(other.turnoMedicoOffsets_),
+      turnoMedicoDemandas_(other.turnoMedicoDemandas_), view_(other.view_) {
+  apuntarVista();
+}
+
+InternedInstance &InternedInstance::operator=(const InternedInstance &other) {
+  if (this != &other) {
+    nombreOffsets_ = other.nombreOffsets_;
+    nombres_ = other.nombres_;
+    periodoOffsets_ = other.periodoOffsets_;
+    periodoDias_ = other.periodoDias_;
+    disponibilidad_ = other.disponibilidad_;
+    diasDisponibles_ = other.diasDisponibles_;
+    medicosPorDia_ = other.medicosPorDia_;
+    capacidades_ = other.capacidades_;
+    capPeriodoOffsets_ = other.capPeriodoOffsets_;
+    capPeriodoPeriodos_ = other.capPeriodoPeriodos_;
+    capPeriodoValores_ = other.capPeriodoValores_;
+    fijas_ = other.fijas_;
+    previas_ = other.previas_;
+    prioridades_ = other.prioridades_;
+    rolNombreOffsets_ = other.rolNombreOffsets_;
+    rolNombres_ = other.rolNombres_;
+    rolMedico_ = other.rolMedico_;
+    demandaRolOffsets_ = other.demandaRolOffsets_;
+    demandaRolRoles_ = other.demandaRolRoles_;
+    demandaRolValores_ = other.demandaRolValores_;
+    turnoNombreOffsets_ = other.turnoNombreOffsets_;
+    turnoNombres_ = other.turnoNombres_;
+    demandaTurnoOffsets_ = other.demandaTurnoOffsets_;
+    demandaTurnoTurnos_ = other.demandaTurnoTurnos_;
+    demandaTurnoValores_ = other.demandaTurnoValores_;
+    turnoMedicoOffsets_ = other.turnoMedicoOffsets_;
+    turnoMedicoDemandas_ = other.turnoMedicoDemandas_;
+    view_ = other.view_;
+    apuntarVista();
+  }
+  return *this;
+}
+
+void InternedInstance::apuntarVista() {
+  view_.nombreOffsets = nombreOffsets_.data();
+  view_.nombres = nombres_.data();
+  view_.periodoOffsets = periodoOffsets_.data();
+  view_.periodoDias = periodoDias_.data();
+  view_.disponibilidad = disponibilidad_.data();
+  view_.diasDisponibles = diasDisponibles_.data();
+  view_.medicosPorDia = medicosPorDia_.data();
+  view_.capacidades = capacidades_.data();
+  view_.capPeriodoOffsets = capPeriodoOffsets_.data();
+  view_.capPeriodoPeriodos = capPeriodoPeriodos_.data();
+  view_.capPeriodoValores = capPeriodoValores_.data();
+  view_.fijas = fijas_.data();
+  view_.previas = previas_.data();
+  view_.prioridadDia = prioridades_.empty() ? nullptr : prioridades_.data();
+  if (!rolMedico_.empty()) {
+    view_.rolNombreOffsets = rolNombreOffsets_.data();
+    view_.rolNombres = rolNombres_.data();
+    view_.rolMedico = rolMedico_.data();
+    view_.demandaRolOffsets = demandaRolOffsets_.data();
+    view_.demandaRolRoles = demandaRolRoles_.data();
+    view_.demandaRolValores = demandaRolValores_.data();
+  } else {
+    view_.rolNombreOffsets = nullptr;
+    view_.rolNombres = nullptr;
+    view_.rolMedico = nullptr;
+    view_.demandaRolOffsets = nullptr;
+    view_.demandaRolRoles = nullptr;
+    view_.demandaRolValores = nullptr;
+  }
+  bool conTurnos = !demandaTurnoOffsets_.empty();
+  view_.turnoNombreOffsets = conTurnos ? turnoNombreOffsets_.data() : nullptr;
+  view_.turnoNombres = conTurnos ? turnoNombres_.data() : nullptr;
+  view_.demandaTurnoOffsets = conTurnos ? demandaTurnoOffsets_.data() : nullptr;
+  view_.demandaTurnoTurnos = conTurnos ? demandaTurnoTurnos_.data() : nullptr;
+  view_.demandaTurnoValores = conTurnos ? demandaTurnoValores_.data() : nullptr;
+  bool restringidos = !turnoMedicoOffsets_.empty();
+  view_.turnoMedicoOffsets = restringidos ? turnoMedicoOffsets_.data() : nullptr;
+  view_.turnoMedicoDemandas =
+      restringidos ? turnoMedicoDemandas_.data() : nullptr;
+}
+
+void InternedInstance::intern(
+    const std::vector<std::string> &medicos,
+    const std::vector<std::string> &dias, const std::vector<Periodo> &periodos,
+    const std::map<std::string, std::vector<std::string>> &disponibilidad,
+    const std::map<std::string, int> &medicosPorDia,
+    const std::map<std::string, int> &capacidades,
+    const std::map<std::string, std::map<std::string, int>>
+        &capacidadesPorPeriodo,
+    const std::map<std::string, std::vector<std::string>> &fijas,
+    const std::map<std::string, std::vector<std::string>> &previas,
+    const std::map<std::string, int> &prioridadDias,
+    const std::map<std::string, std::string> &roles,
+    const std::map<std::string, std::map<std::string, int>> &demandaPorRol,
+    const std::map<std::string, std::map<std::string, int>> &demandaPorTurno,
+    const std::map<std::string, std::map<std::string, std::vector<std::string>>>
+        &disponibilidadPorTurno,
+    int maxGuardiasPorPeriodo, int maxGuardiasTotales) {
+  uint32_t numMedicos = medicos.size();
+  uint32_t numDias = dias.size();
+  uint32_t numPeriodos = periodos.size();
+
+  // String table: doctors, then days, then periods
+  nombres_.clear();
+  nombreOffsets_.clear();
+  auto agregarNombre = [this](const std::string &nombre) {
+    nombreOffsets_.push_back(nombres_.size());
+    nombres_ += nombre;
+  };
+  for (const auto &medico : medicos) {
+    agregarNombre(medico);
+  }
+  for (const auto &dia : dias) {
+    agregarNombre(dia);
+  }
+  for (const auto &periodo : periodos) {
+    agregarNombre(periodo.id);
+  }
+  nombreOffsets_.push_back(nombres_.size());
+
+  // First occurrence wins, as with the string-keyed lookups
+  std::unordered_map<std::string, uint32_t> diaIndex;
+  diaIndex.reserve(numDias);
+  for (uint32_t d = 0; d < numDias; d++) {
+    diaIndex.emplace(dias[d], d);
+  }
+
+  // Period days (CSR)
+  periodoOffsets_.assign(1, 0);
+  periodoDias_.clear();
+  for (const auto &periodo : periodos) {
+    for (const auto &dia : periodo.dias) {
+      auto it = diaIndex.find(dia);
+      if (it != diaIndex.end()) {
+        periodoDias_.push_back(it->second);
+      }
+    }
+    periodoOffsets_.push_back(periodoDias_.size());
+  }
+
+  // Availability bitsets
+  uint32_t palabras = (numDias + 63) / 64;
+  disponibilidad_.assign(static_cast<size_t>(numMedicos) * palabras, 0);
+  diasDisponibles_.assign(numMedicos, 0);
+  capacidades_.assign(numMedicos, -1);
+  for (uint32_t m = 0; m < numMedicos; m++) {
+    auto it = disponibilidad.find(medicos[m]);
+    if (it != disponibilidad.end()) {
+      diasDisponibles_[m] = it->second.size();
+      for (const auto &dia : it->second) {
+        auto d = diaIndex.find(dia);
+        if (d != diaIndex.end()) {
+          disponibilidad_[m * palabras + d->second / 64] |=
+              uint64_t(1) << (d->second % 64);
+        }
+      }
+    }
+    auto cap = capacidades.find(medicos[m]);
+    if (cap != capacidades.end()) {
+      capacidades_[m] = cap->second;
+    }
+  }
+
+  // Per-period capacities (CSR by doctor, periods ascending)
+  std::unordered_map<std::string, uint32_t> periodoIndex;
+  periodoIndex.reserve(numPeriodos);
+  for (uint32_t p = 0; p < numPeriodos; p++) {
+    periodoIndex.emplace(periodos[p].id, p);
+  }
+  capPeriodoOffsets_.assign(1, 0);
+  capPeriodoPeriodos_.clear();
+  capPeriodoValores_.clear();
+  std::map<uint32_t, int32_t> porPeriodo;
+  for (uint32_t m = 0; m < numMedicos; m++) {
+    auto it = capacidadesPorPeriodo.find(medicos[m]);
+    if (it != capacidadesPorPeriodo.end()) {
+      porPeriodo.clear();
+      for (const auto &[periodo, cap] : it->second) {
+        auto p = periodoIndex.find(periodo);
+        if (p != periodoIndex.end()) {
+          porPeriodo[p->second] = cap;
+        }
+      }
+      for (const auto &[p, cap] : porPeriodo) {
+        capPeriodoPeriodos_.push_back(p);
+        capPeriodoValores_.push_back(cap);
+      }
+    }
+    capPeriodoOffsets_.push_back(capPeriodoPeriodos_.size());
+  }
+
+  // Locked and previous assignments: sorted (doctor, day) index pairs
+  uint32_t numFijas = internarPares(medicos, diaIndex, fijas, fijas_);
+  uint32_t numPrevias = internarPares(medicos, diaIndex, previas, previas_);
+
+  // Required doctors per day (default 1)
+  medicosPorDia_.assign(numDias, 1);
+  for (uint32_t d = 0; d < numDias; d++) {
+    auto it = medicosPorDia.find(dias[d]);
+    if (it != medicosPorDia.end()) {
+      medicosPorDia_[d] = it->second;
+    }
+  }
+
+  // Day priorities (only if any were given)
+  prioridades_.clear();
+  if (!prioridadDias.empty()) {
+    prioridades_.assign(numDias, 0);
+    for (uint32_t d = 0; d < numDias; d++) {
+      auto it = prioridadDias.find(dias[d]);
+      if (it != prioridadDias.end()) {
+        prioridades_[d] = it->second;
+      }
+    }
+  }
+
+  // Roles (only if any were given): sorted names, role per doctor, demand
+  // per day. A day with role demand requires exactly that many doctors.
+  rolNombreOffsets_.clear();
+  rolNombres_.clear();
+  rolMedico_.clear();
+  demandaRolOffsets_.clear();
+  demandaRolRoles_.clear();
+  demandaRolValores_.clear();
+  uint32_t numRoles = 0;
+  if (!roles.empty() || !demandaPorRol.empty()) {
+    std::map<std::string, uint32_t> rolIndex;
+    for (const auto &[medico, rol] : roles) {
+      rolIndex.emplace(rol, 0);
+    }
+    for (const auto &[dia, demanda] : demandaPorRol) {
+      for (const auto &[rol, cantidad] : demanda) {
+        rolIndex.emplace(rol, 0);
+      }
+    }
+    rolNombreOffsets_.push_back(0);
+    for (auto &[rol, indice] : rolIndex) {
+      indice = numRoles++;
+      rolNombres_ += rol;
+      rolNombreOffsets_.push_back(rolNombres_.size());
+    }
+
+    rolMedico_.assign(numMedicos, -1);
+    for (uint32_t m = 0; m < numMedicos; m++) {
+      auto it = roles.find(medicos[m]);
+      if (it != roles.end()) {
+        rolMedico_[m] = rolIndex[it->second];
+      }
+    }
+
+    demandaRolOffsets_.push_back(0);
+    for (uint32_t d = 0; d < numDias; d++) {
+      auto it = demandaPorRol.find(dias[d]);
+      if (it != demandaPorRol.end()) {
+        int total = 0;
+        for (const auto &[rol, cantidad] : it->second) {
+          demandaRolRoles_.push_back(rolIndex[rol]);
+          demandaRolValores_.push_back(cantidad);
+          total += cantidad;
+        }
+        medicosPorDia_[d] = total;
+      }
+      demandaRolOffsets_.push_back(demandaRolRoles_.size());
+    }
+  }
+
+  // Shift slots (only if any were given): sorted names, demand per day, then
+  // each doctor's allowed (day, slot) entries
+  turnoNombreOffsets_.clear();
+  turnoNombres_.clear();
+  demandaTurnoOffsets_.clear();
+  demandaTurnoTurnos_.clear();
+  demandaTurnoValores_.clear();
+  turnoMedicoOffsets_.clear();
+  turnoMedicoDemandas_.clear();
+  uint32_t numTurnos = 0;
+  if (!demandaPorTurno.empty()) {
+    std::map<std::string, uint32_t> turnoIndex;
+    for (const auto &[dia, demanda] : demandaPorTurno) {
+      for (const auto &[turno, cantidad] : demanda) {
+        turnoIndex.emplace(turno, 0);
+      }
+    }
+    turnoNombreOffsets_.push_back(0);
+    for (auto &[turno, indice] : turnoIndex) {
+      indice = numTurnos++;
+      turnoNombres_ += turno;
+      turnoNombreOffsets_.push_back(turnoNombres_.size());
+    }
+
+    demandaTurnoOffsets_.push_back(0);
+    for (uint32_t d = 0; d < numDias; d++) {
+      auto it = demandaPorTurno.find(dias[d]);
+      if (it != demandaPorTurno.end() && !it->second.empty()) {
+        if (!demandaRolOffsets_.empty() &&
+            demandaRolOffsets_[d] < demandaRolOffsets_[d + 1]) {
+          throw std::runtime_error("Day " + dias[d] +
+                                   " has both role and shift slot demand");
+        }
+        int total = 0;
+        for (const auto &[turno, cantidad] : it->second) {
+          demandaTurnoTurnos_.push_back(turnoIndex[turno]);
+          demandaTurnoValores_.push_back(cantidad);
+          total += cantidad;
+        }
+        medicosPorDia_[d] = total;
+      }
+      demandaTurnoOffsets_.push_back(demandaTurnoTurnos_.size());
+    }
+
+    if (!disponibilidadPorTurno.empty()) {
+      turnoMedicoOffsets_.push_back(0);
+      std::vector<uint32_t> entradas;
+      for (uint32_t m = 0; m < numMedicos; m++) {
+        auto it = disponibilidadPorTurno.find(medicos[m]);
+        if (it != disponibilidadPorTurno.end()) {
+          entradas.clear();
+          for (const auto &[dia, turnos] : it->second) {
+            auto d = diaIndex.find(dia);
+            if (d == diaIndex.end() ||
+                demandaTurnoOffsets_[d->second] ==
+                    demandaTurnoOffsets_[d->second + 1]) {
+              continue;
+            }
+            size_t antes = entradas.size();
+            for (uint32_t k = demandaTurnoOffsets_[d->second];
+                 k < demandaTurnoOffsets_[d->second + 1]; k++) {
+              std::string_view nombre(turnoNombres_);
+              nombre = nombre.substr(
+                  turnoNombreOffsets_[demandaTurnoTurnos_[k]],
+                  turnoNombreOffsets_[demandaTurnoTurnos_[k] + 1] -
+                      turnoNombreOffsets_[demandaTurnoTurnos_[k]]);
+              if (std::find(turnos.begin(), turnos.end(), nombre) !=
+                  turnos.end()) {
+                entradas.push_back(k);
+              }
+            }
+            if (entradas.size() == antes) {
+              // None of the listed slots exists that day
+              disponibilidad_[m * palabras + d->second / 64] &=
+                  ~(uint64_t(1) << (d->second % 64));
+            }
+          }
+          std::sort(entradas.begin(), entradas.end());
+          turnoMedicoDemandas_.insert(turnoMedicoDemandas_.end(),
+                                      entradas.begin(), entradas.end());
+        }
+        turnoMedicoOffsets_.push_back(turnoMedicoDemandas_.size());
+      }
+    }
+  }
+
+  view_ = InstanceView();
+  view_.numMedicos = numMedicos;
+  view_.numDias = numDias;
+  view_.numPeriodos = numPeriodos;
+  view_.maxGuardiasPorPeriodo = maxGuardiasPorPeriodo;
+  view_.maxGuardiasTotales = maxGuardiasTotales;
+  view_.palabrasPorMedico = palabras;
+  view_.numFijas = numFijas;
+  view_.numPrevias = numPrevias;
+  view_.numRoles = numRoles;
+  view_.numTurnos = numTurnos;
+  apuntarVista();
+}
+
+void InternedInstance::internarVentana(const InstanceView &o,
+                                       const std::vector<uint32_t> &periodos,
+                                       const std::vector<uint32_t> &dias,
+                                       const std::vector<int32_t> &usados) {
+  const uint32_t numMedicos = o.numMedicos;
+  const uint32_t numDias = dias.size();
+  const uint32_t numPeriodos = periodos.size();
+
+  // Old index -> window index (-1 = outside the window). Days keep their
+  // relative order, so sorted index lists stay sorted once remapped.
+  std::vector<int64_t> nuevoDia(o.numDias, -1);
+  for (uint32_t i = 0; i < numDias; i++) {
+    nuevoDia[dias[i]] = i;
+  }
+  std::vector<int64_t> nuevoPeriodo(o.numPeriodos, -1);
+  for (uint32_t i = 0; i < numPeriodos; i++) {
+    nuevoPeriodo[periodos[i]] = i;
+  }
+
+  nombres_.clear();
+  nombreOffsets_.clear();
+  auto agregarNombre = [this](std::string_view nombre) {
+    nombreOffsets_.push_back(nombres_.size());
+    nombres_ += nombre;
+  };
+  for (uint32_t m = 0; m < numMedicos; m++) {
+    agregarNombre(o.medico(m));
+  }
+  for (uint32_t d : dias) {
+    agregarNombre(o.dia(d));
+  }
+  for (uint32_t p : periodos) {
+    agregarNombre(o.periodo(p));
+  }
+  nombreOffsets_.push_back(nombres_.size());
+
+  periodoOffsets_.assign(1, 0);
+  periodoDias_.clear();
+  for (uint32_t p : periodos) {
+    for (uint32_t k = o.periodoOffsets[p]; k < o.periodoOffsets[p + 1]; k++) {
+      if (nuevoDia[o.periodoDias[k]] >= 0) {
+        periodoDias_.push_back(nuevoDia[o.periodoDias[k]]);
+      }
+    }
+    periodoOffsets_.push_back(periodoDias_.size());
+  }
+
+  // Availability, and what is left of each doctor's limits
+  uint32_t palabras = (numDias + 63) / 64;
+  disponibilidad_.assign(static_cast<size_t>(numMedicos) * palabras, 0);
+  diasDisponibles_.assign(numMedicos, 0);
+  capacidades_.assign(numMedicos, 0);
+  for (uint32_t m = 0; m < numMedicos; m++) {
+    for (uint32_t i = 0; i < numDias; i++) {
+      if (o.disponible(m, dias[i])) {
+        disponibilidad_[m * palabras + i / 64] |= uint64_t(1) << (i % 64);
+      }
+    }
+    diasDisponibles_[m] =
+        std::max<int64_t>(0, int64_t(o.diasDisponibles[m]) - usados[m]);
+    capacidades_[m] = std::max(0, o.limite(m) - usados[m]);
+  }
+
+  // Per-period capacities of the window's periods, re-sorted by new index
+  capPeriodoOffsets_.assign(1, 0);
+  capPeriodoPeriodos_.clear();
+  capPeriodoValores_.clear();
+  std::vector<std::pair<uint32_t, int32_t>> porPeriodo;
+  for (uint32_t m = 0; m < numMedicos; m++) {
+    porPeriodo.clear();
+    for (uint32_t k = o.capPeriodoOffsets ? o.capPeriodoOffsets[m] : 0;
+         o.capPeriodoOffsets && k < o.capPeriodoOffsets[m + 1]; k++) {
+      if (nuevoPeriodo[o.capPeriodoPeriodos[k]] >= 0) {
+        porPeriodo.emplace_back(nuevoPeriodo[o.capPeriodoPeriodos[k]],
+                                o.capPeriodoValores[k]);
+      }
+    }
+    std::sort(porPeriodo.begin(), porPeriodo.end());
+    for (const auto &[p, cap] : porPeriodo) {
+      capPeriodoPeriodos_.push_back(p);
+      capPeriodoValores_.push_back(cap);
+    }
+    capPeriodoOffsets_.push_back(capPeriodoPeriodos_.size());
+  }
+
+  auto recortarPares = [&](const uint32_t *pares, uint32_t n,
+                           std::vector<uint32_t> &salida) {
+    salida.clear();
+    for (uint32_t f = 0; f < n; f++) {
+      if (nuevoDia[pares[2 * f + 1]] >= 0) {
+        salida.push_back(pares[2 * f]);
+        salida.push_back(nuevoDia[pares[2 * f + 1]]);
+      }
+    }
+    return static_cast<uint32_t>(salida.size() / 2);
+  };
+  uint32_t numFijas = recortarPares(o.fijas, o.numFijas, fijas_);
+  uint32_t numPrevias = recortarPares(o.previas, o.numPrevias, previas_);
+
+  medicosPorDia_.resize(numDias);
+  prioridades_.clear();
+  for (uint32_t i = 0; i < numDias; i++) {
+    medicosPorDia_[i] = o.medicosPorDia[dias[i]];
+    if (o.prioridadDia != nullptr) {
+      prioridades_.push_back(o.prioridadDia[dias[i]]);
+    }
+  }
+
+  // Roles: same names and doctor roles, demand of the window's days
+  rolNombreOffsets_.clear();
+  rolNombres_.clear();
+  rolMedico_.clear();
+  demandaRolOffsets_.clear();
+  demandaRolRoles_.clear();
+  demandaRolValores_.clear();
+  if (o.conRoles()) {
+    rolNombreOffsets_.assign(o.rolNombreOffsets,
+                             o.rolNombreOffsets + o.numRoles + 1);
+    rolNombres_.assign(o.rolNombres, o.rolNombreOffsets[o.numRoles]);
+    rolMedico_.assign(o.rolMedico, o.rolMedico + numMedicos);
+    demandaRolOffsets_.push_back(0);
+    for (uint32_t d : dias) {
+      for (uint32_t k = o.demandaRolOffsets[d]; k < o.demandaRolOffsets[d + 1];
+           k++) {
+        demandaRolRoles_.push_back(o.demandaRolRoles[k]);
+        demandaRolValores_.push_back(o.demandaRolValores[k]);
+      }
+      demandaRolOffsets_.push_back(demandaRolRoles_.size());
+    }
+  }
+
+  // Slots: same names, demand of the window's days, restrictions remapped to
+  // the new demand entries
+  turnoNombreOffsets_.clear();
+  turnoNombres_.clear();
+  demandaTurnoOffsets_.clear();
+  demandaTurnoTurnos_.clear();
+  demandaTurnoValores_.clear();
+  turnoMedicoOffsets_.clear();
+  turnoMedicoDemandas_.clear();
+  if (o.conTurnos()) {
+    turnoNombreOffsets_.assign(o.turnoNombreOffsets,
+                               o.turnoNombreOffsets + o.numTurnos + 1);
+    turnoNombres_.assign(o.turnoNombres, o.turnoNombreOffsets[o.numTurnos]);
+    std::vector<int64_t> nuevaDemanda(o.numDemandasTurno(), -1);
+    demandaTurnoOffsets_.push_back(0);
+    for (uint32_t d : dias) {
+      for (uint32_t k = o.demandaTurnoOffsets[d];
+           k < o.demandaTurnoOffsets[d + 1]; k++) {
+        nuevaDemanda[k] = demandaTurnoTurnos_.size();
+        demandaTurnoTurnos_.push_back(o.demandaTurnoTurnos[k]);
+        demandaTurnoValores_.push_back(o.demandaTurnoValores[k]);
+      }
+      demandaTurnoOffsets_.push_back(demandaTurnoTurnos_.size());
+    }
+    if (o.turnoMedicoOffsets != nullptr) {
+      turnoMedicoOffsets_.push_back(0);
+      for (uint32_t m = 0; m < numMedicos; m++) {
+        for (uint32_t k = o.turnoMedicoOffsets[m];
+             k < o.turnoMedicoOffsets[m + 1]; k++) {
+          if (nuevaDemanda[o.turnoMedicoDemandas[k]] >= 0) {
+            turnoMedicoDemandas_.push_back(
+                nuevaDemanda[o.turnoMedicoDemandas[k]]);
+          }
+        }
+        turnoMedicoOffsets_.push_back(turnoMedicoDemandas_.size());
+      }
+    }
+  }
+
+  view_ = InstanceView();
+  view_.numMedicos = numMedicos;
+  view_.numDias = numDias;
+  view_.numPeriodos = numPeriodos;
+  view_.maxGuardiasPorPeriodo = o.maxGuardiasPorPeriodo;
+  view_.maxGuardiasTotales = o.maxGuardiasTotales;
+  view_.palabrasPorMedico = palabras;
+  view_.numFijas = numFijas;
+  view_.numPrevias = numPrevias;
+  view_.numRoles = o.conRoles() ? o.numRoles : 0;
+  view_.numTurnos = o.conTurnos() ? o.numTurnos : 0;
+  apuntarVista();
+}
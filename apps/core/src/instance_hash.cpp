@@ -0,0 +1,285 @@
+#include "instance_hash.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// splitmix64 finalizer: spreads every input bit over the whole word
+uint64_t mezclar(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+// Length-prefixed, so ("ab", "c") and ("a", "bc") serialize differently
+void agregar(std::string &blob, std::string_view campo) {
+  blob += std::to_string(campo.size());
+  blob += ':';
+  blob += campo;
+}
+
+void agregar(std::string &blob, int64_t valor) {
+  blob += std::to_string(valor);
+  blob += ';';
+}
+
+// Hash a list of serialized elements as a set (sorted first)
+void actualizarConjunto(Hasher &hasher, std::vector<std::string> &elementos) {
+  std::sort(elementos.begin(), elementos.end());
+  hasher.update(static_cast<int64_t>(elementos.size()));
+  for (const auto &e : elementos) {
+    hasher.update(e);
+  }
+}
+
+} // namespace
+
+Hasher::Hasher() : a_(0xcbf29ce484222325ULL), b_(0x84222325cbf29ce4ULL) {}
+
+void Hasher::update(std::string_view bytes) {
+  update(static_cast<int64_t>(bytes.size()));
+  for (unsigned char c : bytes) {
+    a_ = (a_ ^ c) * 0x100000001b3ULL;
+    b_ = (b_ + c) * 0xc6a4a7935bd1e995ULL;
+    b_ ^= b_ >> 29;
+  }
+}
+
+void Hasher::update(int64_t value) {
+  uint64_t v = static_cast<uint64_t>(value);
+  a_ = mezclar(a_ ^ v);
+  b_ = mezclar(b_ + v + 0x9e3779b97f4a7c15ULL);
+}
+
+std::string Hasher::hex() const {
+  static const char digitos[] = "0123456789abcdef";
+  uint64_t lanes[2] = {mezclar(a_ ^ (b_ >> 1)), mezclar(b_ ^ (a_ << 1))};
+  std::string out;
+  for (uint64_t lane : lanes) {
+    for (int shift = 60; shift >= 0; shift -= 4) {
+      out += digitos[(lane >> shift) & 0xf];
+    }
+  }
+  return out;
+}
+
+std::string hashInstancia(const InstanceView &inst) {
+  Hasher hasher;
+  hasher.update("maxflow-instance-v1");
+  hasher.update(static_cast<int64_t>(inst.maxGuardiasPorPeriodo));
+
+  // Days: name, demand and priority (if not 0, so hashes of instances
+  // without priorities stay as they were)
+  std::vector<std::string> elementos;
+  for (uint32_t d = 0; d < inst.numDias; d++) {
+    std::string blob;
+    agregar(blob, inst.dia(d));
+    agregar(blob, inst.medicosPorDia[d]);
+    if (inst.prioridadDia != nullptr && inst.prioridadDia[d] != 0) {
+      agregar(blob, "p");
+      agregar(blob, inst.prioridadDia[d]);
+    }
+    if (inst.conRoles() &&
+        inst.demandaRolOffsets[d] < inst.demandaRolOffsets[d + 1]) {
+      agregar(blob, "r"); // Roles are sorted by name, so this is canonical
+      for (uint32_t k = inst.demandaRolOffsets[d];
+           k < inst.demandaRolOffsets[d + 1]; k++) {
+        agregar(blob, inst.rol(inst.demandaRolRoles[k]));
+        agregar(blob, inst.demandaRolValores[k]);
+      }
+    }
+    if (inst.tieneTurnos(d)) {
+      agregar(blob, "t"); // Slots are sorted by name too
+      for (uint32_t k = inst.demandaTurnoOffsets[d];
+           k < inst.demandaTurnoOffsets[d + 1]; k++) {
+        agregar(blob, inst.turno(inst.demandaTurnoTurnos[k]));
+        agregar(blob, inst.demandaTurnoValores[k]);
+      }
+    }
+    elementos.push_back(std::move(blob));
+  }
+  actualizarConjunto(hasher, elementos);
+
+  // Periods: ID and sorted set of day names
+  elementos.clear();
+  for (uint32_t p = 0; p < inst.numPeriodos; p++) {
+    std::vector<std::string_view> dias;
+    for (uint32_t k = inst.periodoOffsets[p]; k < inst.periodoOffsets[p + 1];
+         k++) {
+      dias.push_back(inst.dia(inst.periodoDias[k]));
+    }
+    std::sort(dias.begin(), dias.end());
+    dias.erase(std::unique(dias.begin(), dias.end()), dias.end());
+
+    std::string blob;
+    agregar(blob, inst.periodo(p));
+    for (auto dia : dias) {
+      agregar(blob, dia);
+    }
+    elementos.push_back(std::move(blob));
+  }
+  actualizarConjunto(hasher, elementos);
+
+  // Locked and previous days of each doctor
+  std::vector<std::vector<std::string_view>> fijas(inst.numMedicos);
+  for (uint32_t f = 0; f < inst.numFijas; f++) {
+    fijas[inst.fijas[2 * f]].push_back(inst.dia(inst.fijas[2 * f + 1]));
+  }
+  std::vector<std::vector<std::string_view>> previas(inst.numMedicos);
+  for (uint32_t f = 0; f < inst.numPrevias; f++) {
+    previas[inst.previas[2 * f]].push_back(inst.dia(inst.previas[2 * f + 1]));
+  }
+
+  // Doctors: name, effective limit, availability count, available days,
+  // per-period limits, locked and previous days
+  elementos.clear();
+  for (uint32_t m = 0; m < inst.numMedicos; m++) {
+    std::vector<std::string_view> dias;
+    for (uint32_t d = 0; d < inst.numDias; d++) {
+      if (inst.disponible(m, d)) {
+        dias.push_back(inst.dia(d));
+      }
+    }
+    std::sort(dias.begin(), dias.end());
+
+    std::string blob;
+    agregar(blob, inst.medico(m));
+    agregar(blob, inst.limite(m));
+    agregar(blob, inst.diasDisponibles[m]);
+    for (auto dia : dias) {
+      agregar(blob, dia);
+    }
+
+    // Per-period limits that differ from the global one, by period name
+    std::vector<std::pair<std::string_view, int>> limites;
+    for (uint32_t p = 0; p < inst.numPeriodos; p++) {
+      int limite = inst.limitePeriodo(m, p);
+      if (limite != inst.maxGuardiasPorPeriodo) {
+        limites.emplace_back(inst.periodo(p), limite);
+      }
+    }
+    std::sort(limites.begin(), limites.end());
+    agregar(blob, static_cast<int64_t>(limites.size()));
+    for (const auto &[periodo, limite] : limites) {
+      agregar(blob, periodo);
+      agregar(blob, limite);
+    }
+
+    if (inst.conRoles() && inst.rolMedico[m] >= 0) {
+      agregar(blob, "r");
+      agregar(blob, inst.rol(inst.rolMedico[m]));
+    }
+
+    // Slots the doctor may take, on days where that is restricted
+    if (inst.turnoMedicoOffsets != nullptr &&
+        inst.turnoMedicoOffsets[m] < inst.turnoMedicoOffsets[m + 1]) {
+      std::vector<std::pair<std::string_view, std::string_view>> turnos;
+      for (uint32_t k = inst.turnoMedicoOffsets[m];
+           k < inst.turnoMedicoOffsets[m + 1]; k++) {
+        uint32_t e = inst.turnoMedicoDemandas[k];
+        uint32_t d = std::upper_bound(inst.demandaTurnoOffsets,
+                                      inst.demandaTurnoOffsets + inst.numDias,
+                                      e) -
+                     inst.demandaTurnoOffsets - 1;
+        turnos.emplace_back(inst.dia(d), inst.turno(inst.demandaTurnoTurnos[e]));
+      }
+      std::sort(turnos.begin(), turnos.end());
+      agregar(blob, "t");
+      for (const auto &[dia, turno] : turnos) {
+        agregar(blob, dia);
+        agregar(blob, turno);
+      }
+    }
+
+    for (auto *lista : {&fijas[m], &previas[m]}) {
+      std::sort(lista->begin(), lista->end());
+      agregar(blob, static_cast<int64_t>(lista->size()));
+      for (auto dia : *lista) {
+        agregar(blob, dia);
+      }
+    }
+    elementos.push_back(std::move(blob));
+  }
+  actualizarConjunto(hasher, elementos);
+
+  return hasher.hex();
+}
+
+std::string hashTopologia(const InstanceView &inst) {
+  Hasher hasher;
+  hasher.update("maxflow-topology-v1");
+  hasher.update(static_cast<int64_t>(inst.numMedicos));
+  hasher.update(static_cast<int64_t>(inst.numDias));
+  hasher.update(static_cast<int64_t>(inst.numPeriodos));
+
+  uint32_t numNombres = inst.numMedicos + inst.numDias + inst.numPeriodos;
+  hasher.update(std::string_view(inst.nombres, inst.nombreOffsets[numNombres]));
+  for (uint32_t i = 0; i <= numNombres; i++) {
+    hasher.update(static_cast<int64_t>(inst.nombreOffsets[i]));
+  }
+
+  for (uint32_t p = 0; p <= inst.numPeriodos; p++) {
+    hasher.update(static_cast<int64_t>(inst.periodoOffsets[p]));
+  }
+  for (uint32_t k = 0; k < inst.periodoOffsets[inst.numPeriodos]; k++) {
+    hasher.update(static_cast<int64_t>(inst.periodoDias[k]));
+  }
+
+  uint64_t palabras = uint64_t(inst.numMedicos) * inst.palabrasPorMedico;
+  for (uint64_t w = 0; w < palabras; w++) {
+    hasher.update(static_cast<int64_t>(inst.disponibilidad[w]));
+  }
+
+  // Roles decide the layer-3 targets and add Day-Role nodes
+  if (inst.conRoles()) {
+    hasher.update(std::string_view(inst.rolNombres,
+                                   inst.rolNombreOffsets[inst.numRoles]));
+    for (uint32_t r = 0; r <= inst.numRoles; r++) {
+      hasher.update(static_cast<int64_t>(inst.rolNombreOffsets[r]));
+    }
+    for (uint32_t m = 0; m < inst.numMedicos; m++) {
+      hasher.update(static_cast<int64_t>(inst.rolMedico[m]));
+    }
+    for (uint32_t d = 0; d <= inst.numDias; d++) {
+      hasher.update(static_cast<int64_t>(inst.demandaRolOffsets[d]));
+    }
+    for (uint32_t k = 0; k < inst.numDemandasRol(); k++) {
+      hasher.update(static_cast<int64_t>(inst.demandaRolRoles[k]));
+    }
+  }
+
+  // Slots add Day-Slot and Doctor-Day nodes
+  if (inst.conTurnos()) {
+    hasher.update("turnos");
+    hasher.update(std::string_view(inst.turnoNombres,
+                                   inst.turnoNombreOffsets[inst.numTurnos]));
+    for (uint32_t t = 0; t <= inst.numTurnos; t++) {
+      hasher.update(static_cast<int64_t>(inst.turnoNombreOffsets[t]));
+    }
+    for (uint32_t d = 0; d <= inst.numDias; d++) {
+      hasher.update(static_cast<int64_t>(inst.demandaTurnoOffsets[d]));
+    }
+    for (uint32_t k = 0; k < inst.numDemandasTurno(); k++) {
+      hasher.update(static_cast<int64_t>(inst.demandaTurnoTurnos[k]));
+    }
+    if (inst.turnoMedicoOffsets != nullptr) {
+      for (uint32_t m = 0; m <= inst.numMedicos; m++) {
+        hasher.update(static_cast<int64_t>(inst.turnoMedicoOffsets[m]));
+      }
+      for (uint32_t k = 0; k < inst.turnoMedicoOffsets[inst.numMedicos]; k++) {
+        hasher.update(static_cast<int64_t>(inst.turnoMedicoDemandas[k]));
+      }
+    }
+  }
+
+  // Locks add arcs and lower bounds
+  hasher.update(static_cast<int64_t>(inst.numFijas));
+  for (uint32_t k = 0; k < 2 * inst.numFijas; k++) {
+    hasher.update(static_cast<int64_t>(inst.fijas[k]));
+  }
+
+  return hasher.hex();
+}
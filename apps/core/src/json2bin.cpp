@@ -0,0 +1,24 @@
+#include "binary_instance.h"
+#include "json_parser.h"
+#include <iostream>
+
+// Convierte una instancia JSON al formato binario que el solver mapea en
+// memoria: json2bin <entrada.json> <salida.bin>
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    std::cerr << "Uso: " << argv[0] << " <entrada.json> <salida.bin>"
+              << std::endl;
+    return 1;
+  }
+
+  try {
+    InputData data = JSONParser::parseInputFromFile(argv[1]);
+    InternedInstance instancia;
+    JSONParser::internInput(data, instancia);
+    BinaryInstance::write(instancia.view(), argv[2]);
+    return 0;
+  } catch (const std::exception &e) {
+    std::cerr << R"({"error": ")" << e.what() << R"("})" << std::endl;
+    return 1;
+  }
+}
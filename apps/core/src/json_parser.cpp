@@ -5,90 +5,221 @@
 
 using json = nlohmann::json;
 
-InputData JSONParser::parseInput(const std::string &jsonString) {
-  InputData data;
+namespace {
 
-  try {
-    json j = json::parse(jsonString);
+// Reads the fields present in `j` into `data`. Objects are merged key by key
+// (each key given replaces its entry), any other value replaces the whole
+// field, and null clears an optional field. parseInput starts from the
+// defaults, a session delta from the session's instance.
+void leerCampos(const json &j, InputData &data) {
+  // Parse doctors
+  if (j.contains("medicos") && j["medicos"].is_array()) {
+    data.medicos.clear();
+    for (const auto &medico : j["medicos"]) {
+      data.medicos.push_back(medico.get<std::string>());
+    }
+  }
 
-    // Parse doctors
-    if (j.contains("medicos") && j["medicos"].is_array()) {
-      for (const auto &medico : j["medicos"]) {
-        data.medicos.push_back(medico.get<std::string>());
+  // Parse days
+  if (j.contains("dias") && j["dias"].is_array()) {
+    data.dias.clear();
+    for (const auto &dia : j["dias"]) {
+      data.dias.push_back(dia.get<std::string>());
+    }
+  }
+
+  // Parse periods
+  if (j.contains("periodos") && j["periodos"].is_array()) {
+    data.periodos.clear();
+    for (const auto &p : j["periodos"]) {
+      Periodo periodo;
+      periodo.id = p["id"].get<std::string>();
+      if (p.contains("dias") && p["dias"].is_array()) {
+        for (const auto &dia : p["dias"]) {
+          periodo.dias.push_back(dia.get<std::string>());
+        }
       }
+      data.periodos.push_back(periodo);
     }
+  }
 
-    // Parse days
-    if (j.contains("dias") && j["dias"].is_array()) {
-      for (const auto &dia : j["dias"]) {
-        data.dias.push_back(dia.get<std::string>());
+  // Parse availability
+  if (j.contains("disponibilidad") && j["disponibilidad"].is_object()) {
+    for (auto &[medico, dias] : j["disponibilidad"].items()) {
+      std::vector<std::string> diasDisponibles;
+      for (const auto &dia : dias) {
+        diasDisponibles.push_back(dia.get<std::string>());
       }
+      data.disponibilidad[medico] = diasDisponibles;
     }
+  }
 
-    // Parse periods
-    if (j.contains("periodos") && j["periodos"].is_array()) {
-      for (const auto &p : j["periodos"]) {
-        Periodo periodo;
-        periodo.id = p["id"].get<std::string>();
-        if (p.contains("dias") && p["dias"].is_array()) {
-          for (const auto &dia : p["dias"]) {
-            periodo.dias.push_back(dia.get<std::string>());
-          }
-        }
-        data.periodos.push_back(periodo);
+  // Parse maxGuardiasPorPeriodo (max days per period)
+  if (j.contains("maxGuardiasPorPeriodo")) {
+    data.maxGuardiasPorPeriodo = j["maxGuardiasPorPeriodo"].get<int>();
+  }
+
+  // Parse maxGuardiasTotales (C: max total days per doctor)
+  if (j.contains("maxGuardiasTotales")) {
+    data.maxGuardiasTotales = j["maxGuardiasTotales"].get<int>();
+  }
+
+  // Parse medicosPorDia
+  if (j.contains("medicosPorDia")) {
+    if (j["medicosPorDia"].is_number()) {
+      // Single value for all days
+      int cantidad = j["medicosPorDia"].get<int>();
+      for (const auto &dia : data.dias) {
+        data.medicosPorDia[dia] = cantidad;
+      }
+    } else if (j["medicosPorDia"].is_object()) {
+      // Specific value per day
+      for (auto &[dia, cantidad] : j["medicosPorDia"].items()) {
+        data.medicosPorDia[dia] = cantidad.get<int>();
       }
     }
+  }
+
+  // Optional fields given as null are dropped
+  auto borrarSiNulo = [&](const char *campo, auto &valor) {
+    if (j.contains(campo) && j[campo].is_null()) {
+      valor.clear();
+    }
+  };
+  borrarSiNulo("capacidades", data.personalCapacities);
+  borrarSiNulo("capacidadesPorPeriodo", data.capacidadesPorPeriodo);
+  borrarSiNulo("asignacionesFijas", data.asignacionesFijas);
+  borrarSiNulo("asignacionesPrevias", data.asignacionesPrevias);
+  borrarSiNulo("prioridadDias", data.prioridadDias);
+  borrarSiNulo("roles", data.roles);
+  borrarSiNulo("demandaPorRol", data.demandaPorRol);
+  borrarSiNulo("demandaPorTurno", data.demandaPorTurno);
+  borrarSiNulo("disponibilidadPorTurno", data.disponibilidadPorTurno);
 
-    // Parse availability
-    if (j.contains("disponibilidad") && j["disponibilidad"].is_object()) {
-      for (auto &[medico, dias] : j["disponibilidad"].items()) {
-        std::vector<std::string> diasDisponibles;
+  // Parse personal capacities (Optional)
+  if (j.contains("capacidades") && j["capacidades"].is_object()) {
+    for (auto &[medico, cap] : j["capacidades"].items()) {
+      data.personalCapacities[medico] = cap.get<int>();
+    }
+  }
+
+  // Parse per-period capacities (Optional): {"medico": {"periodo": n}}
+  if (j.contains("capacidadesPorPeriodo") &&
+      j["capacidadesPorPeriodo"].is_object()) {
+    for (auto &[medico, caps] : j["capacidadesPorPeriodo"].items()) {
+      for (auto &[periodo, cap] : caps.items()) {
+        data.capacidadesPorPeriodo[medico][periodo] = cap.get<int>();
+      }
+    }
+  }
+
+  // Parse locked and previous assignments (Optional): {"medico": [dias]}
+  auto parsePares = [&](const char *campo,
+                        std::map<std::string, std::vector<std::string>> &out) {
+    if (j.contains(campo) && j[campo].is_object()) {
+      for (auto &[medico, dias] : j[campo].items()) {
+        out[medico].clear();
         for (const auto &dia : dias) {
-          diasDisponibles.push_back(dia.get<std::string>());
+          out[medico].push_back(dia.get<std::string>());
         }
-        data.disponibilidad[medico] = diasDisponibles;
       }
     }
+  };
+  parsePares("asignacionesFijas", data.asignacionesFijas);
+  parsePares("asignacionesPrevias", data.asignacionesPrevias);
 
-    // Parse maxGuardiasPorPeriodo (max days per period, default 1)
-    if (j.contains("maxGuardiasPorPeriodo")) {
-      data.maxGuardiasPorPeriodo = j["maxGuardiasPorPeriodo"].get<int>();
-    } else {
-      data.maxGuardiasPorPeriodo = 1; // Default per specs
+  // Parse roles (Optional): {"medico": "rol"}, {"dia": {"rol": n}}
+  if (j.contains("roles") && j["roles"].is_object()) {
+    for (auto &[medico, rol] : j["roles"].items()) {
+      data.roles[medico] = rol.get<std::string>();
     }
-
-    // Parse maxGuardiasTotales (C: max total days per doctor)
-    if (j.contains("maxGuardiasTotales")) {
-      data.maxGuardiasTotales = j["maxGuardiasTotales"].get<int>();
-    } else {
-      data.maxGuardiasTotales = 999; // No limit by default
+  }
+  if (j.contains("demandaPorRol") && j["demandaPorRol"].is_object()) {
+    for (auto &[dia, demanda] : j["demandaPorRol"].items()) {
+      for (auto &[rol, cantidad] : demanda.items()) {
+        data.demandaPorRol[dia][rol] = cantidad.get<int>();
+      }
     }
+  }
 
-    // Parse medicosPorDia
-    if (j.contains("medicosPorDia")) {
-      if (j["medicosPorDia"].is_number()) {
-        // Single value for all days
-        int cantidad = j["medicosPorDia"].get<int>();
-        for (const auto &dia : data.dias) {
-          data.medicosPorDia[dia] = cantidad;
-        }
-      } else if (j["medicosPorDia"].is_object()) {
-        // Specific value per day
-        for (auto &[dia, cantidad] : j["medicosPorDia"].items()) {
-          data.medicosPorDia[dia] = cantidad.get<int>();
+  // Parse shift slots (Optional): {"dia": {"turno": n}},
+  // {"medico": {"dia": [turnos]}}
+  if (j.contains("demandaPorTurno") && j["demandaPorTurno"].is_object()) {
+    for (auto &[dia, demanda] : j["demandaPorTurno"].items()) {
+      for (auto &[turno, cantidad] : demanda.items()) {
+        data.demandaPorTurno[dia][turno] = cantidad.get<int>();
+      }
+    }
+  }
+  if (j.contains("disponibilidadPorTurno") &&
+      j["disponibilidadPorTurno"].is_object()) {
+    for (auto &[medico, porDia] : j["disponibilidadPorTurno"].items()) {
+      for (auto &[dia, turnos] : porDia.items()) {
+        auto &lista = data.disponibilidadPorTurno[medico][dia];
+        lista.clear();
+        for (const auto &turno : turnos) {
+          lista.push_back(turno.get<std::string>());
         }
       }
-    } else {
-      // Default: 1 doctor per day
-      for (const auto &dia : data.dias) {
-        data.medicosPorDia[dia] = 1;
+    }
+  }
+
+  // Parse day priorities (Optional): {"dia": prioridad}
+  if (j.contains("prioridadDias") && j["prioridadDias"].is_object()) {
+    for (auto &[dia, prioridad] : j["prioridadDias"].items()) {
+      data.prioridadDias[dia] = prioridad.get<int>();
+    }
+  }
+}
+
+// Session ID of a request ("sesion": string or number), "" = none
+std::string leerSesion(const json &j) {
+  if (!j.contains("sesion") || j["sesion"].is_null()) {
+    return "";
+  }
+  if (j["sesion"].is_string()) {
+    return j["sesion"].get<std::string>();
+  }
+  if (j["sesion"].is_number_integer()) {
+    return j["sesion"].dump();
+  }
+  throw std::runtime_error("sesion must be a string or an integer");
+}
+
+} // namespace
+
+InputData JSONParser::parseInput(const std::string &jsonString) {
+  std::string sesion;
+  return parseInput(jsonString, sesion, nullptr);
+}
+
+InputData JSONParser::parseInput(const std::string &jsonString,
+                                 std::string &sesion,
+                                 const BuscarSesion &instanciaDeSesion) {
+  InputData data;
+
+  try {
+    json j = json::parse(jsonString);
+    sesion = leerSesion(j);
+
+    // Without doctors the request only carries changes to its session
+    if (!sesion.empty() && !j.contains("medicos") && instanciaDeSesion) {
+      const InputData *base = instanciaDeSesion(sesion);
+      if (base == nullptr) {
+        throw std::runtime_error("Unknown session: " + sesion);
       }
+      data = *base;
+      leerCampos(j, data);
+      return data;
     }
 
-    // Parse personal capacities (Optional)
-    if (j.contains("capacidades") && j["capacidades"].is_object()) {
-      for (auto &[medico, cap] : j["capacidades"].items()) {
-        data.personalCapacities[medico] = cap.get<int>();
+    data.maxGuardiasPorPeriodo = 1; // Default per specs
+    data.maxGuardiasTotales = 999;  // No limit by default
+    leerCampos(j, data);
+    if (!j.contains("medicosPorDia")) {
+      // Default: 1 doctor per day
+      for (const auto &dia : data.dias) {
+        data.medicosPorDia[dia] = 1;
       }
     }
 
@@ -112,7 +243,48 @@ InputData JSONParser::parseInputFromFile(const std::string &filePath) {
   return parseInput(content);
 }
 
+std::string JSONParser::inputToJson(const InputData &data, int indent) {
+  json j;
+  j["medicos"] = data.medicos;
+  j["dias"] = data.dias;
+  j["periodos"] = json::array();
+  for (const auto &periodo : data.periodos) {
+    j["periodos"].push_back({{"id", periodo.id}, {"dias", periodo.dias}});
+  }
+  j["disponibilidad"] = data.disponibilidad;
+  j["maxGuardiasPorPeriodo"] = data.maxGuardiasPorPeriodo;
+  j["maxGuardiasTotales"] = data.maxGuardiasTotales;
+  // Always an object: a missing one would default every day to 1
+  j["medicosPorDia"] = json::object();
+  for (const auto &[dia, cantidad] : data.medicosPorDia) {
+    j["medicosPorDia"][dia] = cantidad;
+  }
+
+  // Optional fields, only when given
+  auto escribir = [&](const char *campo, const auto &valor) {
+    if (!valor.empty()) {
+      j[campo] = valor;
+    }
+  };
+  escribir("capacidades", data.personalCapacities);
+  escribir("capacidadesPorPeriodo", data.capacidadesPorPeriodo);
+  escribir("asignacionesFijas", data.asignacionesFijas);
+  escribir("asignacionesPrevias", data.asignacionesPrevias);
+  escribir("prioridadDias", data.prioridadDias);
+  escribir("roles", data.roles);
+  escribir("demandaPorRol", data.demandaPorRol);
+  escribir("demandaPorTurno", data.demandaPorTurno);
+  escribir("disponibilidadPorTurno", data.disponibilidadPorTurno);
+
+  return j.dump(indent);
+}
+
 std::string JSONParser::toJson(const ResultadoAsignacion &resultado) {
+  return toJson(resultado, nullptr, 2); // Indented with 2 spaces
+}
+
+std::string JSONParser::toJson(const ResultadoAsignacion &resultado,
+                               const SolveStats *stats, int indent) {
   json j;
 
   j["factible"] = resultado.factible;
@@ -121,7 +293,14 @@ std::string JSONParser::toJson(const ResultadoAsignacion &resultado) {
 
   j["asignaciones"] = json::array();
   for (const auto &asig : resultado.asignaciones) {
-    j["asignaciones"].push_back({{"medico", asig.medico}, {"dia", asig.dia}});
+    json a = {{"medico", asig.medico}, {"dia", asig.dia}};
+    if (!asig.rol.empty()) {
+      a["rol"] = asig.rol;
+    }
+    if (!asig.turno.empty()) {
+      a["turno"] = asig.turno;
+    }
+    j["asignaciones"].push_back(a);
   }
 
   if (!resultado.factible) {
@@ -132,7 +311,135 @@ std::string JSONParser::toJson(const ResultadoAsignacion &resultado) {
     }
   }
 
-  return j.dump(2); // Indented with 2 spaces
+  if (resultado.parcial) {
+    j["parcial"] = true;
+  }
+
+  if (!resultado.coberturaPorPrioridad.empty()) {
+    j["coberturaPorPrioridad"] = json::array();
+    for (const auto &c : resultado.coberturaPorPrioridad) {
+      j["coberturaPorPrioridad"].push_back(
+          {{"prioridad", c.prioridad},
+           {"diasCubiertos", c.diasCubiertos},
+           {"diasRequeridos", c.diasRequeridos}});
+    }
+  }
+
+  if (resultado.conEstabilidad) {
+    j["estabilidad"] = {{"previas", resultado.estabilidad.previas},
+                        {"conservadas", resultado.estabilidad.conservadas},
+                        {"cambios", resultado.estabilidad.cambios}};
+  }
+
+  if (!resultado.sensibilidad.empty()) {
+    j["sensibilidad"] = json::array();
+    for (const auto &s : resultado.sensibilidad) {
+      j["sensibilidad"].push_back({{"medico", s.medico},
+                                   {"asignaciones", s.asignaciones},
+                                   {"diasPerdidos", s.diasPerdidos}});
+    }
+  }
+
+  if (stats != nullptr) {
+    j["stats"] = {
+        {"engine", stats->engine},
+        {"hash", stats->hash},
+        {"cache",
+         {{"hit", stats->cacheHit},
+          {"lookups", stats->cacheLookups},
+          {"hits", stats->cacheHits},
+          {"diskHits", stats->cacheDiskHits},
+          {"hitRatio", stats->cacheHitRatio},
+          {"entries", stats->cacheEntries}}},
+        {"topologyReused", stats->topologyReused},
+        {"timingsMs",
+         {{"parse", stats->parseMs},
+          {"solve", stats->solveMs},
+          {"total", stats->totalMs}}}};
+    if (stats->windows > 0) {
+      j["stats"]["windows"] = stats->windows;
+    }
+    if (stats->verified) {
+      j["stats"]["verified"] = true;
+    }
+    if (!stats->session.empty()) {
+      j["stats"]["session"] = {{"id", stats->session},
+                               {"delta", stats->sessionDelta},
+                               {"flowReused", stats->flowReused},
+                               {"open", stats->sessionsOpen},
+                               {"evicted", stats->sessionsEvicted}};
+    }
+  }
+
+  return j.dump(indent);
+}
+
+std::string JSONParser::errorToJson(const std::string &mensaje) {
+  json j;
+  j["error"] = mensaje;
+  return j.dump();
+}
+
+ResultadoAsignacion JSONParser::parseResultado(const std::string &jsonString) {
+  ResultadoAsignacion resultado;
+
+  try {
+    json j = json::parse(jsonString);
+
+    resultado.factible = j.at("factible").get<bool>();
+    resultado.diasCubiertos = j.at("diasCubiertos").get<int>();
+    resultado.diasRequeridos = j.at("diasRequeridos").get<int>();
+
+    for (const auto &a : j.at("asignaciones")) {
+      resultado.asignaciones.push_back({a.at("medico").get<std::string>(),
+                                        a.at("dia").get<std::string>(),
+                                        a.value("rol", std::string()),
+                                        a.value("turno", std::string())});
+    }
+
+    if (j.contains("bottlenecks")) {
+      for (const auto &b : j["bottlenecks"]) {
+        resultado.bottlenecks.push_back({b.at("tipo").get<std::string>(),
+                                         b.at("id").get<std::string>(),
+                                         b.at("razon").get<std::string>()});
+      }
+    }
+
+    resultado.parcial = j.value("parcial", false);
+
+    if (j.contains("coberturaPorPrioridad")) {
+      for (const auto &c : j["coberturaPorPrioridad"]) {
+        CoberturaPrioridad fila;
+        fila.prioridad = c.at("prioridad").get<int>();
+        fila.diasCubiertos = c.at("diasCubiertos").get<int>();
+        fila.diasRequeridos = c.at("diasRequeridos").get<int>();
+        resultado.coberturaPorPrioridad.push_back(fila);
+      }
+    }
+
+    if (j.contains("estabilidad")) {
+      const auto &e = j["estabilidad"];
+      resultado.conEstabilidad = true;
+      resultado.estabilidad.previas = e.at("previas").get<int>();
+      resultado.estabilidad.conservadas = e.at("conservadas").get<int>();
+      resultado.estabilidad.cambios = e.at("cambios").get<int>();
+    }
+
+    if (j.contains("sensibilidad")) {
+      for (const auto &s : j["sensibilidad"]) {
+        SensibilidadMedico fila;
+        fila.medico = s.at("medico").get<std::string>();
+        fila.asignaciones = s.at("asignaciones").get<int>();
+        fila.diasPerdidos = s.at("diasPerdidos").get<int>();
+        resultado.sensibilidad.push_back(fila);
+      }
+    }
+  } catch (const json::exception &e) {
+    throw std::runtime_error("Error parsing result JSON: " +
+                             std::string(e.what()));
+  }
+
+  return resultado;
 }
 
 void JSONParser::configureBuilder(GraphBuilder &builder,
@@ -145,4 +452,21 @@ void JSONParser::configureBuilder(GraphBuilder &builder,
   builder.setMaxGuardiasTotales(data.maxGuardiasTotales);
   builder.setMedicosPorDia(data.medicosPorDia);
   builder.setPersonalCapacities(data.personalCapacities);
+  builder.setCapacidadesPorPeriodo(data.capacidadesPorPeriodo);
+  builder.setAsignacionesFijas(data.asignacionesFijas);
+  builder.setAsignacionesPrevias(data.asignacionesPrevias);
+  builder.setPrioridadDias(data.prioridadDias);
+  builder.setRoles(data.roles, data.demandaPorRol);
+  builder.setTurnos(data.demandaPorTurno, data.disponibilidadPorTurno);
+}
+
+void JSONParser::internInput(const InputData &data,
+                             InternedInstance &instance) {
+  instance.intern(data.medicos, data.dias, data.periodos, data.disponibilidad,
+                  data.medicosPorDia, data.personalCapacities,
+                  data.capacidadesPorPeriodo, data.asignacionesFijas,
+                  data.asignacionesPrevias, data.prioridadDias, data.roles,
+                  data.demandaPorRol, data.demandaPorTurno,
+                  data.disponibilidadPorTurno, data.maxGuardiasPorPeriodo,
+                  data.maxGuardiasTotales);
 }
@@ -1,83 +1,67 @@
-#include "edmonds_karp.h"
-#include "graph.h"
-#include "graph_builder.h"
+#include "cli_options.h"
 #include "json_parser.h"
+#include "request_handler.h"
+#include "traza.h"
 #include <iostream>
 #include <sstream>
 
-int main(int argc, char *argv[]) {
-  std::string jsonInput;
-
-  // Leer JSON de stdin o archivo
-  if (argc > 1) {
-    // Si se pasa un archivo como argumento
-    try {
-      InputData data = JSONParser::parseInputFromFile(argv[1]);
-      GraphBuilder builder;
-      JSONParser::configureBuilder(builder, data);
-      Graph g = builder.build();
-
-      EdmondsKarp ek;
-      std::vector<std::vector<int>> flowGraph;
-      ek.maxFlowWithResult(g, builder.getSource(), builder.getSink(),
-                         flowGraph);
+namespace {
 
-      ResultadoAsignacion resultado = builder.extraerResultado(flowGraph);
+// Serve what the command line asks for; returns the exit code
+int servir(const CliOptions &opciones) {
+  RequestHandler handler(opciones);
 
-      if (!resultado.factible) {
-        // Calcular Min-Cut para identificar cuellos de botella
-        std::vector<int> reachable =
-            ek.getReachableNodes(g, flowGraph, builder.getSource());
-        resultado.bottlenecks = builder.analyzeMinCut(reachable);
-      }
+  // Modo residente: una instancia JSON por línea hasta EOF
+  if (opciones.resident) {
+    handler.runResident(std::cin, std::cout);
+    return 0;
+  }
 
-      std::cout << JSONParser::toJson(resultado) << std::endl;
-      return 0;
-    } catch (const std::exception &e) {
-      std::cerr << R"({"error": ")" << e.what() << R"("})" << std::endl;
-      return 1;
-    }
+  // Leer JSON de stdin o archivo (JSON o instancia binaria .bin)
+  if (!opciones.archivo.empty()) {
+    std::cout << handler.resolverArchivo(opciones.archivo, 2) << std::endl;
+    return 0;
   }
 
-  // Leer de stdin
   std::stringstream buffer;
   buffer << std::cin.rdbuf();
-  jsonInput = buffer.str();
+  std::string jsonInput = buffer.str();
 
   if (jsonInput.empty()) {
     std::cerr << R"({"error": "No se recibió entrada JSON"})" << std::endl;
     return 1;
   }
 
-  try {
-    // Parsear JSON
-    InputData data = JSONParser::parseInput(jsonInput);
-
-    // Configurar y construir grafo
-    GraphBuilder builder;
-    JSONParser::configureBuilder(builder, data);
-    Graph g = builder.build();
-
-    // Ejecutar Edmonds-Karp
-    EdmondsKarp ek;
-    std::vector<std::vector<int>> flowGraph;
-    ek.maxFlowWithResult(g, builder.getSource(), builder.getSink(), flowGraph);
+  // Construir grafo, ejecutar Edmonds-Karp y calcular Min-Cut si hace falta
+  std::cout << handler.resolverJson(jsonInput, 2) << std::endl;
+  return 0;
+}
 
-    // Extraer y devolver resultado
-    ResultadoAsignacion resultado = builder.extraerResultado(flowGraph);
+} // namespace
 
-    if (!resultado.factible) {
-      // Calcular Min-Cut para identificar cuellos de botella
-      std::vector<int> reachable =
-          ek.getReachableNodes(g, flowGraph, builder.getSource());
-      resultado.bottlenecks = builder.analyzeMinCut(reachable);
+int main(int argc, char *argv[]) {
+  std::string traza;
+  int codigo = 1;
+  try {
+    CliOptions opciones = parseCliOptions(argc, argv);
+    traza = opciones.traza;
+    if (!traza.empty()) {
+      Traza::nombrarHilo("main");
+      Traza::activar();
     }
-
-    std::cout << JSONParser::toJson(resultado) << std::endl;
-
-    return 0;
+    codigo = servir(opciones);
   } catch (const std::exception &e) {
-    std::cerr << R"({"error": ")" << e.what() << R"("})" << std::endl;
-    return 1;
+    std::cerr << JSONParser::errorToJson(e.what()) << std::endl;
+  }
+
+  // The trace is written after a failed request too: that is when it helps
+  if (!traza.empty()) {
+    try {
+      Traza::escribir(traza);
+    } catch (const std::exception &e) {
+      std::cerr << JSONParser::errorToJson(e.what()) << std::endl;
+      return 1;
+    }
   }
+  return codigo;
 }
@@ -0,0 +1,267 @@
+#include "maxflow.h"
+#include "json_parser.h"
+#include "solver_context.h"
+#include <algorithm>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+struct maxflow_context {
+  SolverContext solver;
+  ResultadoAsignacion resultado;
+  bool resuelto = false;
+  std::string json;
+  std::string error;
+};
+
+namespace {
+
+// Run `fn` translating C++ exceptions into status codes: nothing may unwind
+// across the C boundary. Running out of memory is always internal.
+template <typename Fn>
+maxflow_status guarded(maxflow_context *ctx, maxflow_status onError, Fn fn) {
+  try {
+    fn();
+    ctx->error.clear();
+    return MAXFLOW_OK;
+  } catch (const std::bad_alloc &) {
+    ctx->error = "Out of memory";
+    return MAXFLOW_ERROR_INTERNAL;
+  } catch (const std::exception &e) {
+    ctx->error = e.what();
+  } catch (...) {
+    ctx->error = "Unknown error";
+  }
+  return onError;
+}
+
+void discardResult(maxflow_context *ctx) {
+  ctx->resuelto = false;
+  ctx->resultado = ResultadoAsignacion();
+  ctx->json.clear();
+}
+
+// Days [offsets[i], offsets[i + 1]) of a CSR list, as day names
+std::vector<std::string> diasCsr(const maxflow_instancia *inst,
+                                 const uint32_t *offsets,
+                                 const uint32_t *indices, size_t i,
+                                 const char *campo) {
+  std::vector<std::string> dias;
+  for (uint32_t k = offsets[i]; k < offsets[i + 1]; k++) {
+    if (indices == nullptr || indices[k] >= inst->num_dias) {
+      throw std::invalid_argument(std::string("Invalid day index in ") +
+                                  campo);
+    }
+    dias.push_back(inst->dias[indices[k]]);
+  }
+  return dias;
+}
+
+// Field of `inst` whose name array holds a NULL entry, or nullptr if none
+// does (missing arrays are left to toInputData)
+const char *nombreNulo(const maxflow_instancia *inst) {
+  auto conNulo = [](const char *const *nombres, size_t n) {
+    return nombres != nullptr &&
+           std::find(nombres, nombres + n, nullptr) != nombres + n;
+  };
+  if (conNulo(inst->medicos, inst->num_medicos)) {
+    return "medicos";
+  }
+  if (conNulo(inst->dias, inst->num_dias)) {
+    return "dias";
+  }
+  if (conNulo(inst->periodo_ids, inst->num_periodos)) {
+    return "periodo_ids";
+  }
+  return nullptr;
+}
+
+InputData toInputData(const maxflow_instancia *inst) {
+  if ((inst->num_medicos > 0 && inst->medicos == nullptr) ||
+      (inst->num_dias > 0 && inst->dias == nullptr) ||
+      (inst->num_periodos > 0 &&
+       (inst->periodo_ids == nullptr || inst->periodo_offsets == nullptr)) ||
+      (inst->num_medicos > 0 && inst->disponibilidad_offsets == nullptr)) {
+    throw std::invalid_argument("Missing array in instance");
+  }
+
+  InputData data;
+  data.medicos.assign(inst->medicos, inst->medicos + inst->num_medicos);
+  data.dias.assign(inst->dias, inst->dias + inst->num_dias);
+
+  for (size_t p = 0; p < inst->num_periodos; p++) {
+    Periodo periodo;
+    periodo.id = inst->periodo_ids[p];
+    periodo.dias = diasCsr(inst, inst->periodo_offsets, inst->periodo_dias, p,
+                           "periodo_dias");
+    data.periodos.push_back(periodo);
+  }
+
+  for (size_t m = 0; m < inst->num_medicos; m++) {
+    data.disponibilidad[data.medicos[m]] =
+        diasCsr(inst, inst->disponibilidad_offsets, inst->disponibilidad_dias,
+                m, "disponibilidad_dias");
+    if (inst->capacidades != nullptr && inst->capacidades[m] >= 0) {
+      data.personalCapacities[data.medicos[m]] = inst->capacidades[m];
+    }
+  }
+
+  data.maxGuardiasPorPeriodo = inst->max_guardias_por_periodo;
+  data.maxGuardiasTotales = inst->max_guardias_totales;
+  for (size_t d = 0; d < inst->num_dias; d++) {
+    data.medicosPorDia[data.dias[d]] =
+        inst->medicos_por_dia != nullptr ? inst->medicos_por_dia[d] : 1;
+  }
+
+  return data;
+}
+
+} // namespace
+
+extern "C" {
+
+int maxflow_abi_version(void) { return MAXFLOW_ABI_VERSION; }
+
+maxflow_context *maxflow_context_create(void) {
+  try {
+    return new maxflow_context();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void maxflow_context_free(maxflow_context *ctx) { delete ctx; }
+
+maxflow_status maxflow_load_json(maxflow_context *ctx, const char *json,
+                                 size_t length) {
+  if (ctx == nullptr) {
+    return MAXFLOW_ERROR_ARGUMENT;
+  }
+  if (json == nullptr) {
+    ctx->error = "JSON input is NULL";
+    return MAXFLOW_ERROR_ARGUMENT;
+  }
+  discardResult(ctx);
+  ctx->solver.reset();
+  return guarded(ctx, MAXFLOW_ERROR_INPUT, [&] {
+    ctx->solver.load(JSONParser::parseInput(std::string(json, length)));
+  });
+}
+
+maxflow_status maxflow_load_instancia(maxflow_context *ctx,
+                                      const maxflow_instancia *instancia) {
+  if (ctx == nullptr) {
+    return MAXFLOW_ERROR_ARGUMENT;
+  }
+  if (instancia == nullptr) {
+    ctx->error = "Instance is NULL";
+    return MAXFLOW_ERROR_ARGUMENT;
+  }
+  if (const char *campo = nombreNulo(instancia)) {
+    ctx->error = std::string("NULL name in ") + campo;
+    return MAXFLOW_ERROR_ARGUMENT;
+  }
+  discardResult(ctx);
+  ctx->solver.reset();
+  return guarded(ctx, MAXFLOW_ERROR_INPUT,
+                 [&] { ctx->solver.load(toInputData(instancia)); });
+}
+
+maxflow_status maxflow_solve(maxflow_context *ctx) {
+  if (ctx == nullptr) {
+    return MAXFLOW_ERROR_ARGUMENT;
+  }
+  discardResult(ctx);
+  if (!ctx->solver.cargado()) {
+    ctx->error = "No instance loaded";
+    return MAXFLOW_ERROR_STATE;
+  }
+  // Fields that cannot be combined are the caller's input; anything failing
+  // after that is the solver's
+  maxflow_status status =
+      guarded(ctx, MAXFLOW_ERROR_INPUT, [&] { ctx->solver.validar(); });
+  if (status != MAXFLOW_OK) {
+    return status;
+  }
+  return guarded(ctx, MAXFLOW_ERROR_INTERNAL, [&] {
+    ctx->resultado = ctx->solver.solve();
+    ctx->resuelto = true;
+  });
+}
+
+int maxflow_factible(const maxflow_context *ctx) {
+  return ctx != nullptr && ctx->resuelto && ctx->resultado.factible ? 1 : 0;
+}
+
+int maxflow_dias_cubiertos(const maxflow_context *ctx) {
+  return ctx != nullptr && ctx->resuelto ? ctx->resultado.diasCubiertos : 0;
+}
+
+int maxflow_dias_requeridos(const maxflow_context *ctx) {
+  return ctx != nullptr && ctx->resuelto ? ctx->resultado.diasRequeridos : 0;
+}
+
+size_t maxflow_num_asignaciones(const maxflow_context *ctx) {
+  return ctx != nullptr ? ctx->resultado.asignaciones.size() : 0;
+}
+
+maxflow_status maxflow_get_asignacion(const maxflow_context *ctx,
+                                      size_t index, const char **medico,
+                                      const char **dia) {
+  if (ctx == nullptr || index >= ctx->resultado.asignaciones.size()) {
+    return MAXFLOW_ERROR_ARGUMENT;
+  }
+  const Asignacion &asig = ctx->resultado.asignaciones[index];
+  if (medico != nullptr) {
+    *medico = asig.medico.c_str();
+  }
+  if (dia != nullptr) {
+    *dia = asig.dia.c_str();
+  }
+  return MAXFLOW_OK;
+}
+
+size_t maxflow_num_bottlenecks(const maxflow_context *ctx) {
+  return ctx != nullptr ? ctx->resultado.bottlenecks.size() : 0;
+}
+
+maxflow_status maxflow_get_bottleneck(const maxflow_context *ctx,
+                                      size_t index, const char **tipo,
+                                      const char **id, const char **razon) {
+  if (ctx == nullptr || index >= ctx->resultado.bottlenecks.size()) {
+    return MAXFLOW_ERROR_ARGUMENT;
+  }
+  const Bottleneck &b = ctx->resultado.bottlenecks[index];
+  if (tipo != nullptr) {
+    *tipo = b.tipo.c_str();
+  }
+  if (id != nullptr) {
+    *id = b.id.c_str();
+  }
+  if (razon != nullptr) {
+    *razon = b.razon.c_str();
+  }
+  return MAXFLOW_OK;
+}
+
+const char *maxflow_result_json(maxflow_context *ctx) {
+  if (ctx == nullptr || !ctx->resuelto) {
+    return nullptr;
+  }
+  if (ctx->json.empty()) {
+    try {
+      ctx->json = JSONParser::toJson(ctx->resultado);
+    } catch (const std::exception &e) {
+      ctx->error = e.what();
+      return nullptr;
+    }
+  }
+  return ctx->json.c_str();
+}
+
+const char *maxflow_last_error(const maxflow_context *ctx) {
+  return ctx != nullptr ? ctx->error.c_str() : "Context is NULL";
+}
+
+} // extern "C"
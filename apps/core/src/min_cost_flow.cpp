@@ -0,0 +1,152 @@
+#include "min_cost_flow.h"
+#include "traza.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace {
+
+const long long INF = std::numeric_limits<long long>::max();
+
+} // namespace
+
+MinCostFlow::MinCostFlow() : numVertices_(0), interrumpido_(false) {}
+
+void MinCostFlow::reset(int vertices) {
+  numVertices_ = vertices;
+  arcos_.clear();
+  capacidadOriginal_.clear();
+  adyacentes_.resize(vertices);
+  for (auto &lista : adyacentes_) {
+    lista.clear();
+  }
+  potencial_.assign(vertices, 0);
+}
+
+int MinCostFlow::addArc(int from, int to, int cap, int cost) {
+  int id = capacidadOriginal_.size();
+  adyacentes_[from].push_back(arcos_.size());
+  arcos_.push_back({to, cap, cost});
+  adyacentes_[to].push_back(arcos_.size());
+  arcos_.push_back({from, 0, -cost});
+  capacidadOriginal_.push_back(cap);
+  return id;
+}
+
+bool MinCostFlow::empujar(const std::vector<int> &camino, int f) {
+  for (int arco : camino) {
+    if (arcos_[2 * arco].cap < f) {
+      return false;
+    }
+  }
+  for (int arco : camino) {
+    arcos_[2 * arco].cap -= f;
+    arcos_[2 * arco + 1].cap += f;
+  }
+  return true;
+}
+
+bool MinCostFlow::dijkstra(int source, int sink) {
+  using Entrada = std::pair<long long, int>;
+  distancia_.assign(numVertices_, INF);
+  arcoPrevio_.assign(numVertices_, -1);
+
+  std::priority_queue<Entrada, std::vector<Entrada>, std::greater<Entrada>>
+      cola;
+  distancia_[source] = 0;
+  cola.push({0, source});
+
+  while (!cola.empty()) {
+    auto [d, u] = cola.top();
+    cola.pop();
+    if (d > distancia_[u]) {
+      continue;
+    }
+    for (int i : adyacentes_[u]) {
+      const Arco &a = arcos_[i];
+      if (a.cap <= 0) {
+        continue;
+      }
+      // Reduced cost, non-negative while potentials are valid
+      long long nd = d + a.cost + potencial_[u] - potencial_[a.to];
+      if (nd < distancia_[a.to]) {
+        distancia_[a.to] = nd;
+        arcoPrevio_[a.to] = i;
+        cola.push({nd, a.to});
+      }
+    }
+  }
+
+  return distancia_[sink] != INF;
+}
+
+int MinCostFlow::solve(int source, int sink) {
+  // Residual arcs of the starting flow have non-negative costs (see header),
+  // so zero potentials are valid
+  potencial_.assign(numVertices_, 0);
+  int total = 0;
+  interrumpido_ = false;
+  Traza::Tramo tramo("min-cost flow", "min-cost-flow");
+
+  while (true) {
+    if (deadline_.vencido()) {
+      interrumpido_ = true;
+      break;
+    }
+    // One round: cheapest augmenting path, then push along it
+    Traza::Tramo ronda("dijkstra round", "min-cost-flow");
+    if (!dijkstra(source, sink)) {
+      break;
+    }
+
+    for (int v = 0; v < numVertices_; v++) {
+      if (distancia_[v] != INF) {
+        potencial_[v] += distancia_[v];
+      }
+    }
+
+    int pathFlow = std::numeric_limits<int>::max();
+    for (int v = sink; v != source; v = arcos_[arcoPrevio_[v] ^ 1].to) {
+      pathFlow = std::min(pathFlow, arcos_[arcoPrevio_[v]].cap);
+    }
+    for (int v = sink; v != source; v = arcos_[arcoPrevio_[v] ^ 1].to) {
+      arcos_[arcoPrevio_[v]].cap -= pathFlow;
+      arcos_[arcoPrevio_[v] ^ 1].cap += pathFlow;
+    }
+    total += pathFlow;
+    ronda.arg("flow", pathFlow);
+  }
+
+  tramo.arg("flow", total);
+  return total;
+}
+
+long long MinCostFlow::costoTotal() const {
+  long long costo = 0;
+  for (int a = 0; a < numArcos(); a++) {
+    costo += static_cast<long long>(flujo(a)) * arcos_[2 * a].cost;
+  }
+  return costo;
+}
+
+std::vector<int> MinCostFlow::getReachableNodes(int source) const {
+  Traza::Tramo tramo("min-cut", "min-cost-flow");
+  std::vector<bool> visited(numVertices_, false);
+  std::vector<int> reachable;
+
+  reachable.push_back(source);
+  visited[source] = true;
+
+  for (size_t head = 0; head < reachable.size(); head++) {
+    for (int i : adyacentes_[reachable[head]]) {
+      const Arco &a = arcos_[i];
+      if (a.cap > 0 && !visited[a.to]) {
+        visited[a.to] = true;
+        reachable.push_back(a.to);
+      }
+    }
+  }
+
+  return reachable;
+}
@@ -0,0 +1,348 @@
+#include "push_relabel.h"
+#include "traza.h"
+#include <algorithm>
+#include <climits>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// Active vertices of one slot: it takes from the front, others steal from
+// the back
+struct Cola {
+  std::mutex m;
+  std::deque<int> vertices;
+};
+
+} // namespace
+
+PushRelabel::PushRelabel() : pool_(nullptr), arcosPorHilo_(16384) {}
+
+void PushRelabel::preparar(const Graph &graph) {
+  Traza::Tramo tramo("prepare", "push-relabel");
+  const int n = graph.getNumVertices();
+  const int W = graph.getPalabras();
+
+  inicio_.assign(n + 1, 0);
+  cabeza_.clear();
+  capacidad_.clear();
+  for (int u = 0; u < n; u++) {
+    inicio_[u] = cabeza_.size();
+    const uint64_t *salientes = graph.getSalientes(u);
+    const uint64_t *entrantes = graph.getEntrantes(u);
+    for (int w = 0; w < W; w++) {
+      uint64_t vecinos = salientes[w] | entrantes[w];
+      while (vecinos != 0) {
+        int v = (w << 6) + __builtin_ctzll(vecinos);
+        vecinos &= vecinos - 1;
+        if (v != u) {
+          cabeza_.push_back(v);
+          capacidad_.push_back(graph.getCapacity(u, v));
+        }
+      }
+    }
+  }
+  inicio_[n] = cabeza_.size();
+
+  const size_t m = cabeza_.size();
+  reverso_.resize(m);
+  for (int u = 0; u < n; u++) {
+    for (int a = inicio_[u]; a < inicio_[u + 1]; a++) {
+      int v = cabeza_[a];
+      if (u < v) {
+        int b = std::lower_bound(cabeza_.begin() + inicio_[v],
+                                 cabeza_.begin() + inicio_[v + 1], u) -
+                cabeza_.begin();
+        reverso_[a] = b;
+        reverso_[b] = a;
+      }
+    }
+  }
+
+  if (m > capacidadArcos_) {
+    residual_.reset(new std::atomic<int>[m]);
+    capacidadArcos_ = m;
+  }
+  if (static_cast<size_t>(n) > capacidadVertices_) {
+    exceso_.reset(new std::atomic<int>[n]);
+    altura_.reset(new std::atomic<int>[n]);
+    enCola_.reset(new std::atomic<bool>[n]);
+    capacidadVertices_ = n;
+  }
+  for (size_t a = 0; a < m; a++) {
+    residual_[a].store(capacidad_[a], std::memory_order_relaxed);
+  }
+  for (int v = 0; v < n; v++) {
+    exceso_[v].store(0, std::memory_order_relaxed);
+    altura_[v].store(0, std::memory_order_relaxed);
+    enCola_[v].store(false, std::memory_order_relaxed);
+  }
+}
+
+bool PushRelabel::fase(int destino, int excluido, int alturaExcluido,
+                       bool conPlazo) {
+  const int n = static_cast<int>(inicio_.size()) - 1;
+  const int m = cabeza_.size();
+  const int INF = 2 * n; // Height of the vertices that cannot reach destino
+  // Relabel work between global relabels (as in Cherkassky-Goldberg's hi_pr)
+  const long umbral = 6L * n + m / 2;
+  // Slots: one slice of the vertices, one queue and one discharge task each
+  const int T = pool_ == nullptr
+                    ? 1
+                    : std::max(1, std::min<int>(pool_->getHilos() + 1,
+                                                m / arcosPorHilo_));
+
+  std::vector<Cola> colas(T);
+  std::vector<std::vector<int>> siguientes(T);
+  std::vector<int> frontera;
+  std::atomic<int> pendientes{0}; // Queued or being discharged
+  std::atomic<long> trabajo{0};
+  std::atomic<bool> relabelPedido{false};
+  std::atomic<bool> vencido{false};
+
+  auto activar = [&](int t, int v) {
+    if (v != destino && v != excluido && !enCola_[v].exchange(true)) {
+      pendientes.fetch_add(1);
+      std::lock_guard<std::mutex> lock(colas[t].m);
+      colas[t].vertices.push_back(v);
+    }
+  };
+
+  auto tomar = [&](int t, int &v) {
+    for (int i = 0; i < T; i++) {
+      Cola &cola = colas[(t + i) % T];
+      std::lock_guard<std::mutex> lock(cola.m);
+      if (!cola.vertices.empty()) {
+        if (i == 0) {
+          v = cola.vertices.front();
+          cola.vertices.pop_front();
+        } else {
+          v = cola.vertices.back();
+          cola.vertices.pop_back();
+        }
+        return true;
+      }
+    }
+    return false;
+  };
+
+  // Push to the lowest residual neighbour while it is lower, else relabel
+  // just above it. Only this thread lowers v's excess and residuals, so what
+  // it read is a lower bound of what it pushes against.
+  auto descargar = [&](int t, int v, int &ops, long &trabajoLocal) {
+    int h = altura_[v].load();
+    while (h < n && exceso_[v].load() > 0) {
+      int mejor = -1;
+      int hMin = INT_MAX;
+      for (int a = inicio_[v]; a < inicio_[v + 1]; a++) {
+        if (residual_[a].load(std::memory_order_relaxed) > 0) {
+          int hw = altura_[cabeza_[a]].load(std::memory_order_relaxed);
+          if (hw < hMin) {
+            hMin = hw;
+            mejor = a;
+          }
+        }
+      }
+      if (mejor < 0) {
+        altura_[v].store(INF);
+        return;
+      }
+
+      if (h > hMin) {
+        int w = cabeza_[mejor];
+        int d = std::min(exceso_[v].load(), residual_[mejor].load());
+        residual_[mejor].fetch_sub(d);
+        residual_[reverso_[mejor]].fetch_add(d);
+        exceso_[v].fetch_sub(d);
+        if (exceso_[w].fetch_add(d) == 0) {
+          activar(t, w);
+        }
+      } else {
+        h = hMin + 1;
+        altura_[v].store(h);
+        trabajoLocal += 12 + inicio_[v + 1] - inicio_[v];
+        if (trabajoLocal > 1024) {
+          if (trabajo.fetch_add(trabajoLocal) + trabajoLocal > umbral) {
+            relabelPedido.store(true);
+          }
+          trabajoLocal = 0;
+        }
+      }
+
+      if ((++ops & 255) == 0) {
+        if (conPlazo && deadline_.vencido()) {
+          vencido.store(true);
+        }
+        if (vencido.load() || relabelPedido.load()) {
+          return;
+        }
+      }
+    }
+  };
+
+  for (;;) {
+    // Global relabel: heights = exact residual distances to destino, one BFS
+    // level at a time, large levels split among the slots
+    relabelsGlobales_++;
+    Traza::Tramo relabel("global relabel", "push-relabel");
+    ThreadPool::paraCada(pool_, T, [&](int t) {
+      for (int v = long(n) * t / T; v < long(n) * (t + 1) / T; v++) {
+        altura_[v].store(v == destino    ? 0
+                         : v == excluido ? alturaExcluido
+                                         : INF);
+        enCola_[v].store(false);
+      }
+      colas[t].vertices.clear();
+    });
+    frontera.assign(1, destino);
+    int nivel = 1;
+    for (; !frontera.empty(); nivel++) {
+      const size_t total = frontera.size();
+      const int partes = std::min<size_t>(T, 1 + total / 1024);
+      ThreadPool::paraCada(pool_, partes, [&](int t) {
+        for (size_t i = total * t / partes; i < total * (t + 1) / partes;
+             i++) {
+          int u = frontera[i];
+          for (int a = inicio_[u]; a < inicio_[u + 1]; a++) {
+            int w = cabeza_[a];
+            int libre = INF;
+            if (w != excluido &&
+                residual_[reverso_[a]].load(std::memory_order_relaxed) > 0 &&
+                altura_[w].load(std::memory_order_relaxed) == INF &&
+                altura_[w].compare_exchange_strong(libre, nivel)) {
+              siguientes[t].push_back(w);
+            }
+          }
+        }
+      });
+      frontera.clear();
+      for (auto &s : siguientes) {
+        frontera.insert(frontera.end(), s.begin(), s.end());
+        s.clear();
+      }
+    }
+
+    // Vertices with excess that can reach destino, queued by slice
+    pendientes.store(0);
+    trabajo.store(0);
+    relabelPedido.store(false);
+    ThreadPool::paraCada(pool_, T, [&](int t) {
+      int locales = 0;
+      for (int v = long(n) * t / T; v < long(n) * (t + 1) / T; v++) {
+        if (v != destino && v != excluido && exceso_[v].load() > 0 &&
+            altura_[v].load() < n) {
+          enCola_[v].store(true);
+          colas[t].vertices.push_back(v);
+          locales++;
+        }
+      }
+      pendientes.fetch_add(locales);
+    });
+    relabel.arg("levels", nivel - 1);
+    relabel.arg("active", pendientes.load());
+    relabel.terminar();
+    if (conPlazo && deadline_.vencido()) {
+      return false;
+    }
+    if (pendientes.load() == 0) {
+      return true;
+    }
+
+    // Discharge until every queue is empty or a global relabel is due. A
+    // slot that starts late or runs dry steals from the others' queues, so
+    // the round is correct however many slots actually run at once.
+    Traza::Tramo ronda("discharge round", "push-relabel");
+    ThreadPool::paraCada(pool_, T, [&](int t) {
+      Traza::Tramo descarga("discharge", "push-relabel");
+      int ops = 0;
+      int descargados = 0;
+      long trabajoLocal = 0;
+      while (!relabelPedido.load() && !vencido.load()) {
+        int v;
+        if (!tomar(t, v)) {
+          if (pendientes.load() == 0) {
+            break;
+          }
+          std::this_thread::yield();
+          continue;
+        }
+        descargar(t, v, ops, trabajoLocal);
+        descargados++;
+        // Pushes to v after this store see it free and queue it; pushes
+        // before it are seen by the check below
+        enCola_[v].store(false);
+        if (exceso_[v].load() > 0 && altura_[v].load() < n) {
+          activar(t, v);
+        }
+        pendientes.fetch_sub(1);
+      }
+      descarga.arg("slot", t);
+      descarga.arg("vertices", descargados);
+    });
+    if (vencido.load()) {
+      return false;
+    }
+  }
+}
+
+int PushRelabel::maxFlow(const Graph &graph, int source, int sink,
+                         Graph &residualGraph,
+                         std::vector<std::vector<int>> &flowGraph) {
+  return maxFlow<int32_t>(graph, source, sink, residualGraph, flowGraph);
+}
+
+template <typename Cap>
+int PushRelabel::maxFlow(const Graph &graph, int source, int sink,
+                         GraphT<Cap> &residualGraph,
+                         MatrizFlujo<Cap> &flowGraph) {
+  const int n = graph.getNumVertices();
+  Traza::Tramo tramo("max-flow", "push-relabel");
+  interrumpido_ = false;
+  relabelsGlobales_ = 0;
+  preparar(graph);
+
+  if (source != sink) {
+    for (int a = inicio_[source]; a < inicio_[source + 1]; a++) {
+      int c = residual_[a].load();
+      if (c > 0) {
+        residual_[a].store(0);
+        residual_[reverso_[a]].fetch_add(c);
+        exceso_[cabeza_[a]].fetch_add(c);
+        exceso_[source].fetch_sub(c);
+      }
+    }
+    // Max preflow, then the excess that cannot reach the sink goes back
+    Traza::Tramo preflujo("max preflow", "push-relabel");
+    interrumpido_ = !fase(sink, source, n, true);
+    preflujo.terminar();
+    Traza::Tramo retorno("return excess", "push-relabel");
+    fase(source, sink, 2 * n, false);
+  }
+
+  Traza::Tramo matriz("flow matrix", "push-relabel");
+
+  flowGraph.resize(n);
+  for (auto &row : flowGraph) {
+    row.assign(n, 0);
+  }
+  residualGraph.reset(n);
+  for (int u = 0; u < n; u++) {
+    for (int a = inicio_[u]; a < inicio_[u + 1]; a++) {
+      int r = residual_[a].load();
+      flowGraph[u][cabeza_[a]] = capacidad_[a] - r;
+      if (r > 0) {
+        residualGraph.setCapacity(u, cabeza_[a], r);
+      }
+    }
+  }
+  tramo.arg("global relabels", relabelsGlobales_);
+  return source != sink ? exceso_[sink].load() : 0;
+}
+
+template int PushRelabel::maxFlow(const Graph &, int, int, GraphT<uint8_t> &,
+                                  MatrizFlujo<uint8_t> &);
+template int PushRelabel::maxFlow(const Graph &, int, int, GraphT<uint16_t> &,
+                                  MatrizFlujo<uint16_t> &);
+template int PushRelabel::maxFlow(const Graph &, int, int, GraphT<int32_t> &,
+                                  MatrizFlujo<int32_t> &);
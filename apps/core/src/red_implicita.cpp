@@ -0,0 +1,342 @@
+#include "red_implicita.h"
+#include "traza.h"
+#include "certificado.h"
+#include "graph_builder.h"
+#include <algorithm>
+#include <limits>
+
+RedImplicita::RedImplicita()
+    : numVertices_(0), builder_(nullptr), inst_(nullptr),
+      primerMedicoPeriodo_(0), numMedicos_(0), numPeriodos_(0),
+      palabrasMedicos_(0), interrumpido_(false) {}
+
+void RedImplicita::reset(int vertices) {
+  numVertices_ = vertices;
+  arcos_.clear();
+  capacidadOriginal_.clear();
+  adyacentes_.resize(vertices);
+  for (auto &lista : adyacentes_) {
+    lista.clear();
+  }
+  diaDestino_.assign(vertices, -1);
+  builder_ = nullptr;
+  inst_ = nullptr;
+  numMedicos_ = 0;
+  numPeriodos_ = 0;
+  periodoOcurrencia_.clear();
+  repetida_.clear();
+  ocurrenciasOffsets_.clear();
+  ocurrencias_.clear();
+  flujo_.clear();
+}
+
+int RedImplicita::addArc(int from, int to, int cap) {
+  int id = capacidadOriginal_.size();
+  adyacentes_[from].push_back(arcos_.size());
+  arcos_.push_back({to, cap});
+  adyacentes_[to].push_back(arcos_.size());
+  arcos_.push_back({from, 0});
+  capacidadOriginal_.push_back(cap);
+  return id;
+}
+
+void RedImplicita::setCapa3(const GraphBuilder &builder) {
+  builder_ = &builder;
+  inst_ = &builder.getInstance();
+  numMedicos_ = inst_->numMedicos;
+  numPeriodos_ = inst_->numPeriodos;
+  primerMedicoPeriodo_ = builder.nodoMedicoPeriodo(0, 0);
+  palabrasMedicos_ = (numMedicos_ + 63) / 64;
+
+  // Occurrences of each day in the periods' day lists; a day listed twice
+  // in one period is one arc, as in the built graph
+  uint32_t total = numPeriodos_ > 0 ? inst_->periodoOffsets[numPeriodos_] : 0;
+  periodoOcurrencia_.resize(total);
+  repetida_.assign(total, 0);
+  ocurrenciasOffsets_.assign(inst_->numDias + 1, 0);
+  std::vector<int64_t> vistoEn(inst_->numDias, -1);
+  for (uint32_t p = 0; p < numPeriodos_; p++) {
+    for (uint32_t o = inst_->periodoOffsets[p];
+         o < inst_->periodoOffsets[p + 1]; o++) {
+      uint32_t d = inst_->periodoDias[o];
+      periodoOcurrencia_[o] = p;
+      repetida_[o] = vistoEn[d] == p;
+      if (!repetida_[o]) {
+        vistoEn[d] = p;
+        ocurrenciasOffsets_[d + 1]++;
+      }
+    }
+  }
+  for (uint32_t d = 0; d < inst_->numDias; d++) {
+    ocurrenciasOffsets_[d + 1] += ocurrenciasOffsets_[d];
+  }
+  ocurrencias_.resize(ocurrenciasOffsets_[inst_->numDias]);
+  std::vector<uint32_t> siguiente(ocurrenciasOffsets_.begin(),
+                                  ocurrenciasOffsets_.end() - 1);
+  for (uint32_t o = 0; o < total; o++) {
+    if (!repetida_[o]) {
+      ocurrencias_[siguiente[inst_->periodoDias[o]]++] = o;
+    }
+  }
+
+  flujo_.assign(size_t(total) * palabrasMedicos_, 0);
+}
+
+int RedImplicita::avanzar(int u, int64_t &cursor) const {
+  const std::vector<int> &lista = adyacentes_[u];
+  const int64_t grado = lista.size();
+  for (; cursor < grado; cursor++) {
+    const Arco &a = arcos_[lista[cursor]];
+    if (a.cap > 0) {
+      return a.to;
+    }
+  }
+
+  if (esMedicoPeriodo(u)) {
+    // (m, p) -> the heads of its free arcs, in the period's day order
+    auto [m, p] = builder_->medicoPeriodoDeNodo(u);
+    uint32_t inicio = inst_->periodoOffsets[p];
+    uint32_t fin = inst_->periodoOffsets[p + 1];
+    for (uint32_t o = inicio + (cursor - grado); o < fin; o++) {
+      uint32_t d = inst_->periodoDias[o];
+      if (!repetida_[o] && inst_->disponible(m, d) && !bitFlujo(o, m)) {
+        int v = builder_->nodoDestino(m, d);
+        if (v >= 0) {
+          cursor = grado + (o - inicio);
+          return v;
+        }
+      }
+    }
+    cursor = grado + (fin - inicio);
+    return -1;
+  }
+
+  if (diaDestino_[u] < 0 || numMedicos_ == 0) {
+    return -1;
+  }
+  // Head of layer 3 -> the (m, p) whose arc into it carries flow. Position
+  // j * numMedicos_ + m = doctor m on the day's j-th occurrence.
+  uint32_t d = diaDestino_[u];
+  int64_t i = cursor - grado;
+  uint32_t j = ocurrenciasOffsets_[d] + i / numMedicos_;
+  uint32_t m = i % numMedicos_;
+  for (; j < ocurrenciasOffsets_[d + 1]; j++, m = 0) {
+    uint32_t o = ocurrencias_[j];
+    const uint64_t *fila = flujo_.data() + size_t(o) * palabrasMedicos_;
+    for (uint32_t w = m >> 6; w < palabrasMedicos_; w++) {
+      uint64_t bits = fila[w];
+      if (w == m >> 6) {
+        bits &= ~uint64_t(0) << (m & 63);
+      }
+      for (; bits != 0; bits &= bits - 1) {
+        uint32_t medico = (w << 6) + __builtin_ctzll(bits);
+        if (builder_->nodoDestino(medico, d) == u) {
+          cursor = grado + int64_t(j - ocurrenciasOffsets_[d]) * numMedicos_ +
+                   medico;
+          return builder_->nodoMedicoPeriodo(medico, periodoOcurrencia_[o]);
+        }
+      }
+    }
+  }
+  int64_t ocurrencias = ocurrenciasOffsets_[d + 1] - ocurrenciasOffsets_[d];
+  cursor = grado + ocurrencias * numMedicos_;
+  return -1;
+}
+
+int RedImplicita::residual(int u, int64_t cursor) const {
+  const int64_t grado = adyacentes_[u].size();
+  if (cursor < grado) {
+    return arcos_[adyacentes_[u][cursor]].cap;
+  }
+  return 1; // Layer-3 arcs have capacity 1
+}
+
+void RedImplicita::empujar(int u, int64_t cursor, int f) {
+  const int64_t grado = adyacentes_[u].size();
+  if (cursor < grado) {
+    int a = adyacentes_[u][cursor];
+    arcos_[a].cap -= f;
+    arcos_[a ^ 1].cap += f;
+    return;
+  }
+
+  int64_t i = cursor - grado;
+  if (esMedicoPeriodo(u)) {
+    auto [m, p] = builder_->medicoPeriodoDeNodo(u);
+    uint32_t o = inst_->periodoOffsets[p] + i;
+    flujo_[size_t(o) * palabrasMedicos_ + (m >> 6)] |= uint64_t(1) << (m & 63);
+  } else {
+    uint32_t d = diaDestino_[u];
+    uint32_t o = ocurrencias_[ocurrenciasOffsets_[d] + i / numMedicos_];
+    uint32_t m = i % numMedicos_;
+    flujo_[size_t(o) * palabrasMedicos_ + (m >> 6)] &=
+        ~(uint64_t(1) << (m & 63));
+  }
+}
+
+bool RedImplicita::bfs(int source, int sink) {
+  nivel_.assign(numVertices_, -1);
+  cola_.clear();
+  nivel_[source] = 0;
+  cola_.push_back(source);
+  for (size_t head = 0; head < cola_.size(); head++) {
+    int u = cola_[head];
+    for (int64_t c = 0;; c++) {
+      int v = avanzar(u, c);
+      if (v < 0) {
+        break;
+      }
+      if (nivel_[v] < 0) {
+        nivel_[v] = nivel_[u] + 1;
+        cola_.push_back(v);
+      }
+    }
+  }
+  return sink >= 0 && nivel_[sink] >= 0;
+}
+
+int RedImplicita::aumentar(int source, int sink) {
+  camino_.clear();
+  int u = source;
+  while (true) {
+    if (u == sink) {
+      int f = std::numeric_limits<int>::max();
+      for (int x : camino_) {
+        f = std::min(f, residual(x, cursor_[x]));
+      }
+      for (int x : camino_) {
+        empujar(x, cursor_[x], f);
+      }
+      return f;
+    }
+
+    int v = avanzar(u, cursor_[u]);
+    while (v >= 0 && nivel_[v] != nivel_[u] + 1) {
+      cursor_[u]++;
+      v = avanzar(u, cursor_[u]);
+    }
+    if (v >= 0) {
+      camino_.push_back(u);
+      u = v;
+      continue;
+    }
+
+    // Dead end: no path to the sink through u in this phase
+    nivel_[u] = -1;
+    if (camino_.empty()) {
+      return 0;
+    }
+    u = camino_.back();
+    camino_.pop_back();
+    cursor_[u]++;
+  }
+}
+
+int RedImplicita::solve(int source, int sink) {
+  interrumpido_ = false;
+  for (size_t a = 0; a < capacidadOriginal_.size(); a++) {
+    arcos_[2 * a].cap = capacidadOriginal_[a];
+    arcos_[2 * a + 1].cap = 0;
+  }
+  std::fill(flujo_.begin(), flujo_.end(), 0);
+  if (source == sink) {
+    return 0;
+  }
+
+  Traza::Tramo tramo("max-flow", "implicit");
+  int total = 0;
+  int aumentos = 0;
+  while (true) {
+    if (deadline_.vencido()) {
+      interrumpido_ = true;
+      return total;
+    }
+    // Phase: BFS levels, then a blocking flow along them
+    Traza::Tramo niveles("bfs levels", "implicit");
+    if (!bfs(source, sink)) {
+      return total;
+    }
+    niveles.arg("sink level", nivel_[sink]);
+    niveles.terminar();
+    Traza::Tramo bloqueante("blocking flow", "implicit");
+    cursor_.assign(numVertices_, 0);
+    for (int f = aumentar(source, sink); f > 0; f = aumentar(source, sink)) {
+      total += f;
+      tramo.arg("flow", total);
+      bloqueante.arg("paths", ++aumentos);
+      if (aumentos % 256 == 0 && deadline_.vencido()) {
+        interrumpido_ = true;
+        return total;
+      }
+    }
+  }
+}
+
+int RedImplicita::flujo(int u, int v) const {
+  int total = 0;
+  for (int i : adyacentes_[u]) {
+    if (i % 2 == 0 && arcos_[i].to == v) {
+      total += capacidadOriginal_[i / 2] - arcos_[i].cap;
+    }
+  }
+
+  if (esMedicoPeriodo(u) && diaDestino_[v] >= 0) {
+    auto [m, p] = builder_->medicoPeriodoDeNodo(u);
+    uint32_t d = diaDestino_[v];
+    for (uint32_t j = ocurrenciasOffsets_[d]; j < ocurrenciasOffsets_[d + 1];
+         j++) {
+      uint32_t o = ocurrencias_[j];
+      if (periodoOcurrencia_[o] == p && bitFlujo(o, m) &&
+          builder_->nodoDestino(m, d) == v) {
+        total++;
+      }
+    }
+  }
+  return total;
+}
+
+std::vector<int> RedImplicita::getReachableNodes(int source) {
+  Traza::Tramo tramo("min-cut", "implicit");
+  bfs(source, -1);
+  return cola_;
+}
+
+void RedImplicita::certificar(Certificado &certificado) const {
+  for (int u = 0; u < numVertices_; u++) {
+    for (int i : adyacentes_[u]) {
+      if (i % 2 == 0) {
+        certificado.arco(u, arcos_[i].to, capacidadOriginal_[i / 2],
+                         capacidadOriginal_[i / 2] - arcos_[i].cap);
+      }
+    }
+  }
+  for (uint32_t p = 0; p < numPeriodos_; p++) {
+    for (uint32_t o = inst_->periodoOffsets[p];
+         o < inst_->periodoOffsets[p + 1]; o++) {
+      uint32_t d = inst_->periodoDias[o];
+      for (uint32_t m = 0; m < numMedicos_ && !repetida_[o]; m++) {
+        int v = inst_->disponible(m, d) ? builder_->nodoDestino(m, d) : -1;
+        if (v >= 0) {
+          certificado.arco(builder_->nodoMedicoPeriodo(m, p), v, 1,
+                           bitFlujo(o, m));
+        }
+      }
+    }
+  }
+}
+
+std::size_t RedImplicita::memoria() const {
+  std::size_t bytes = arcos_.size() * sizeof(Arco) +
+                      capacidadOriginal_.size() * sizeof(int) +
+                      flujo_.size() * sizeof(uint64_t) +
+                      (periodoOcurrencia_.size() + ocurrencias_.size() +
+                       ocurrenciasOffsets_.size()) *
+                          sizeof(uint32_t) +
+                      repetida_.size();
+  for (const auto &lista : adyacentes_) {
+    bytes += sizeof(lista) + lista.size() * sizeof(int);
+  }
+  // Per-node search buffers
+  bytes += size_t(numVertices_) * (3 * sizeof(int) + sizeof(int64_t));
+  return bytes;
+}
@@ -0,0 +1,214 @@
+#include "request_handler.h"
+#include "binary_instance.h"
+#include "instance_hash.h"
+#include "json_parser.h"
+#include "traza.h"
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <thread>
+
+namespace {
+
+double msDesde(std::chrono::steady_clock::time_point inicio) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - inicio)
+      .count();
+}
+
+} // namespace
+
+RequestHandler::RequestHandler(const CliOptions &opciones)
+    : opciones_(opciones), cache_(opciones.cacheSize, opciones.cacheDir),
+      sesiones_(opciones.sesionesMb << 20) {}
+
+ThreadPool *RequestHandler::pool() {
+  if (pool_ == nullptr && opciones_.motor == "push-relabel") {
+    unsigned hilos = opciones_.hilos > 0 ? opciones_.hilos
+                                         : std::thread::hardware_concurrency();
+    if (hilos > 1) {
+      // The thread waiting on a parallel loop works on it too
+      pool_ = std::make_unique<ThreadPool>(hilos - 1);
+    }
+  }
+  return pool_.get();
+}
+
+std::string RequestHandler::resolverJson(const std::string &jsonInput,
+                                         int indent) {
+  auto inicio = Reloj::now();
+  Traza::Tramo tramo("request");
+  tramo.arg("bytes", jsonInput.size());
+  Traza::Tramo parse("parse");
+  SolveStats stats;
+  InputData data = JSONParser::parseInput(
+      jsonInput, stats.session, [&](const std::string &id) {
+        stats.sessionDelta = true;
+        SessionStore::Sesion *sesion = sesiones_.buscar(id);
+        return sesion ? &sesion->instancia : nullptr;
+      });
+
+  SolverContext *context = &context_;
+  if (stats.sessionDelta) {
+    context = &sesiones_.buscar(stats.session)->context;
+    context->load(data);
+  } else if (!stats.session.empty()) {
+    SessionStore::Sesion &sesion =
+        sesiones_.abrir(stats.session, std::move(data), jsonInput.size());
+    context = &sesion.context;
+    context->load(sesion.instancia);
+  } else {
+    context->load(data);
+  }
+  parse.terminar();
+  stats.parseMs = msDesde(inicio);
+  return responder(*context, stats, inicio, indent);
+}
+
+std::string RequestHandler::resolverArchivo(const std::string &filePath,
+                                            int indent) {
+  auto inicio = Reloj::now();
+  Traza::Tramo tramo("request");
+  Traza::Tramo parse("parse");
+
+  // The mapped file must stay alive until the response is built
+  std::unique_ptr<BinaryInstance> binaria;
+  InputData data;
+  if (BinaryInstance::esBinario(filePath)) {
+    binaria = std::make_unique<BinaryInstance>(filePath);
+    context_.load(binaria->view());
+  } else {
+    data = JSONParser::parseInputFromFile(filePath);
+    context_.load(data);
+  }
+
+  parse.terminar();
+  SolveStats stats;
+  stats.parseMs = msDesde(inicio);
+  std::string respuesta = responder(context_, stats, inicio, indent);
+  context_.reset(); // Do not keep a view into the unmapped file
+  return respuesta;
+}
+
+ResultadoAsignacion RequestHandler::resolver(SolverContext &context,
+                                             bool &completo) {
+  if (opciones_.ventana > 0) {
+    ResultadoAsignacion resultado = ventanas_.solve(
+        context.instancia(), opciones_.ventana, opciones_.repararVentanas);
+    completo = !resultado.parcial;
+    return resultado;
+  }
+
+  ResultadoAsignacion resultado = context.solve();
+  completo = !resultado.parcial;
+  if (opciones_.sensibilidad && completo) {
+    resultado.sensibilidad = context.sensibilidad();
+    // An empty table means the deadline expired while building it
+    completo = !resultado.sensibilidad.empty() ||
+               context.instancia().numMedicos == 0;
+  }
+  return resultado;
+}
+
+std::string RequestHandler::responder(SolverContext &context, SolveStats stats,
+                                      Reloj::time_point inicio, int indent) {
+  context.setMotor(opciones_.motor);
+  context.setPool(pool());
+  context.setRenumerar(opciones_.renumerar);
+  context.setVerificar(opciones_.verificar);
+  ventanas_.setMotor(opciones_.motor);
+  ventanas_.setPool(pool());
+  ventanas_.setRenumerar(opciones_.renumerar);
+  ventanas_.setVerificar(opciones_.verificar);
+  stats.engine = context.getEngine();
+
+  ResultadoAsignacion resultado;
+  auto inicioSolve = Reloj::now();
+  if (opciones_.deadlineMs > 0) {
+    Deadline deadline(inicio + std::chrono::milliseconds(opciones_.deadlineMs));
+    context.setDeadline(deadline);
+    ventanas_.setDeadline(deadline);
+  }
+
+  // Windowed results, the sensitivity table and renumbered solves (which may
+  // pick other assignments) are different cache entries
+  std::string variante = stats.engine;
+  if (opciones_.renumerar) {
+    variante += "+renumber";
+  }
+  if (opciones_.ventana > 0) {
+    variante += "+window=" + std::to_string(opciones_.ventana);
+    if (opciones_.repararVentanas) {
+      variante += "+repair";
+    }
+  }
+  if (opciones_.sensibilidad) {
+    variante += "+sensitivity";
+  }
+
+  bool resuelto = false;
+  if (opciones_.cache) {
+    Traza::Tramo consulta("cache lookup");
+    stats.hash = hashInstancia(context.instancia());
+    std::string clave = ResultCache::clave(stats.hash, variante);
+    stats.cacheHit = cache_.buscar(clave, resultado);
+    consulta.arg("hit", stats.cacheHit);
+    consulta.terminar();
+    if (!stats.cacheHit) {
+      bool completo;
+      resultado = resolver(context, completo);
+      resuelto = true;
+      if (completo) { // A result cut by the deadline depends on timing
+        cache_.guardar(clave, resultado);
+      }
+    }
+  } else {
+    bool completo;
+    resultado = resolver(context, completo);
+    resuelto = true;
+  }
+  // A result cut by the deadline is not checked (not a max flow)
+  stats.verified = resuelto && opciones_.verificar && !resultado.parcial;
+  if (resuelto && opciones_.ventana > 0) {
+    stats.windows = ventanas_.getNumVentanas();
+  } else if (resuelto) {
+    stats.topologyReused = context.getTopologiaReutilizada();
+    stats.flowReused = context.getFlujoReutilizado();
+  }
+  stats.solveMs = msDesde(inicioSolve);
+
+  if (!stats.session.empty()) {
+    sesiones_.expirar(); // May drop `context`: not used past this point
+    stats.sessionsOpen = sesiones_.numSesiones();
+    stats.sessionsEvicted = sesiones_.getExpiradas();
+  }
+
+  Traza::Tramo serializar("serialize");
+  if (!opciones_.stats) {
+    return JSONParser::toJson(resultado, nullptr, indent);
+  }
+
+  CacheStats cs = cache_.stats();
+  stats.cacheLookups = cs.consultas;
+  stats.cacheHits = cs.aciertos;
+  stats.cacheDiskHits = cs.aciertosDisco;
+  stats.cacheHitRatio = cs.tasaAciertos();
+  stats.cacheEntries = cs.entradas;
+  stats.totalMs = msDesde(inicio);
+  return JSONParser::toJson(resultado, &stats, indent);
+}
+
+void RequestHandler::runResident(std::istream &in, std::ostream &out) {
+  std::string linea;
+  while (std::getline(in, linea)) {
+    if (linea.find_first_not_of(" \t\r") == std::string::npos) {
+      continue;
+    }
+    try {
+      out << resolverJson(linea, -1) << "\n";
+    } catch (const std::exception &e) {
+      out << JSONParser::errorToJson(e.what()) << "\n";
+    }
+    out.flush();
+  }
+}
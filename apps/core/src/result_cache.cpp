@@ -0,0 +1,106 @@
+#include "result_cache.h"
+#include "json_parser.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+
+ResultCache::ResultCache(size_t capacidad, const std::string &directorio)
+    : capacidad_(capacidad), directorio_(directorio) {}
+
+std::string ResultCache::clave(const std::string &hash,
+                               const std::string &engine) {
+  return hash + "-" + engine;
+}
+
+std::string ResultCache::rutaDisco(const std::string &clave) const {
+  return directorio_ + "/" + clave + ".json";
+}
+
+void ResultCache::insertar(const std::string &clave,
+                           const ResultadoAsignacion &r) {
+  auto it = indice_.find(clave);
+  if (it != indice_.end()) {
+    lru_.erase(it->second);
+    indice_.erase(it);
+  }
+  if (capacidad_ == 0) {
+    return;
+  }
+
+  lru_.emplace_front(clave, r);
+  indice_[clave] = lru_.begin();
+
+  while (lru_.size() > capacidad_) {
+    indice_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+  stats_.entradas = lru_.size();
+}
+
+bool ResultCache::buscar(const std::string &clave,
+                         ResultadoAsignacion &resultado) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.consultas++;
+
+  auto it = indice_.find(clave);
+  if (it != indice_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+    resultado = it->second->second;
+    stats_.aciertos++;
+    return true;
+  }
+
+  if (directorio_.empty()) {
+    return false;
+  }
+
+  std::ifstream file(rutaDisco(clave));
+  if (!file.is_open()) {
+    return false;
+  }
+  try {
+    std::string contenido((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+    resultado = JSONParser::parseResultado(contenido);
+  } catch (const std::exception &) {
+    // A damaged entry is just a miss; it is overwritten on the next store
+    return false;
+  }
+
+  insertar(clave, resultado);
+  stats_.aciertos++;
+  stats_.aciertosDisco++;
+  return true;
+}
+
+void ResultCache::guardar(const std::string &clave,
+                          const ResultadoAsignacion &resultado) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  insertar(clave, resultado);
+
+  if (directorio_.empty()) {
+    return;
+  }
+
+  // Write to a temporary file and rename, so readers never see half a file
+  std::string ruta = rutaDisco(clave);
+  std::string temporal = ruta + "." + std::to_string(getpid()) + ".tmp";
+  {
+    std::ofstream file(temporal, std::ios::trunc);
+    if (!file.is_open()) {
+      return; // The disk cache is best effort
+    }
+    file << JSONParser::toJson(resultado);
+    if (!file) {
+      std::remove(temporal.c_str());
+      return;
+    }
+  }
+  std::rename(temporal.c_str(), ruta.c_str());
+}
+
+CacheStats ResultCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
@@ -0,0 +1,53 @@
+#include "session_store.h"
+
+namespace {
+
+size_t memoriaSesion(const SessionStore::Sesion &sesion) {
+  return sesion.bytesInstancia + sesion.context.memoriaEstimada();
+}
+
+} // namespace
+
+SessionStore::SessionStore(size_t memoriaMaxima)
+    : memoriaMaxima_(memoriaMaxima) {}
+
+SessionStore::Sesion *SessionStore::buscar(const std::string &id) {
+  auto it = indice_.find(id);
+  if (it == indice_.end()) {
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second.get();
+}
+
+SessionStore::Sesion &SessionStore::abrir(const std::string &id,
+                                          InputData instancia, size_t bytes) {
+  Sesion *sesion = buscar(id);
+  if (sesion == nullptr) {
+    lru_.emplace_front(id, std::make_unique<Sesion>());
+    indice_[id] = lru_.begin();
+    sesion = lru_.front().second.get();
+    sesion->context.setReutilizarFlujo(true);
+  }
+  sesion->instancia = std::move(instancia);
+  sesion->bytesInstancia = bytes;
+  return *sesion;
+}
+
+void SessionStore::expirar() {
+  size_t total = memoriaEstimada();
+  while (!lru_.empty() && total > memoriaMaxima_) {
+    total -= memoriaSesion(*lru_.back().second);
+    indice_.erase(lru_.back().first);
+    lru_.pop_back();
+    expiradas_++;
+  }
+}
+
+size_t SessionStore::memoriaEstimada() const {
+  size_t total = 0;
+  for (const auto &entrada : lru_) {
+    total += memoriaSesion(*entrada.second);
+  }
+  return total;
+}
@@ -0,0 +1,385 @@
+#include "solver_context.h"
+#include "traza.h"
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+
+// Residual graph and flow of one width copied into those of another, wider
+// one (nothing to do at the same width, never asked to narrow)
+template <typename Desde, typename Cap>
+void copiarEnsanchado(const GraphT<Desde> &residual,
+                      const MatrizFlujo<Desde> &flujo, GraphT<Cap> &ancho,
+                      MatrizFlujo<Cap> &flujoAncho) {
+  if constexpr (sizeof(Desde) < sizeof(Cap)) {
+    ancho.copiarDe(residual);
+    if constexpr (!std::is_same_v<MatrizFlujo<Desde>, MatrizFlujo<Cap>>) {
+      flujoAncho.resize(flujo.size());
+      for (size_t u = 0; u < flujo.size(); u++) {
+        flujoAncho[u].assign(flujo[u].begin(), flujo[u].end());
+      }
+    }
+  }
+}
+
+} // namespace
+
+SolverContext::SolverContext()
+    : graph_(0), residualGraph_(0), residual8_(0), residual16_(0),
+      ancho_(AnchoCapacidad::I32), conPushRelabel_(false),
+      conBoykovKolmogorov_(false), arbolesValidos_(false),
+      conImplicita_(false), verificar_(false), loaded_(false),
+      topologiaReutilizada_(false), residualValido_(false),
+      reutilizarFlujo_(false), flujoValido_(false), flujoReutilizado_(false),
+      maxFlow_(0) {}
+
+void SolverContext::reset() {
+  // flujoValido_ survives, like the builder's node layout it refers to
+  builder_.reset();
+  loaded_ = false;
+  topologiaReutilizada_ = false;
+  residualValido_ = false;
+  flujoReutilizado_ = false;
+  maxFlow_ = 0;
+}
+
+void SolverContext::load(const InputData &data) {
+  reset();
+  JSONParser::configureBuilder(builder_, data);
+  loaded_ = true;
+}
+
+void SolverContext::load(const InstanceView &instance) {
+  reset();
+  builder_.setInstance(instance);
+  loaded_ = true;
+}
+
+void SolverContext::setMotor(const std::string &nombre) {
+  if (nombre != ek_.nombre() && nombre != pushRelabel_.nombre() &&
+      nombre != implicita_.nombre() && nombre != boykovKolmogorov_.nombre()) {
+    throw std::runtime_error("Unknown max-flow engine: " + nombre);
+  }
+  conPushRelabel_ = nombre == pushRelabel_.nombre();
+  conBoykovKolmogorov_ = nombre == boykovKolmogorov_.nombre();
+  conImplicita_ = nombre == implicita_.nombre();
+}
+
+void SolverContext::setDeadline(const Deadline &deadline) {
+  ek_.setDeadline(deadline);
+  pushRelabel_.setDeadline(deadline);
+  boykovKolmogorov_.setDeadline(deadline);
+  implicita_.setDeadline(deadline);
+  red_.setDeadline(deadline);
+}
+
+void SolverContext::exigirCertificado(bool cumple) const {
+  if (!cumple) {
+    throw std::runtime_error("Optimality certificate failed (" + getEngine() +
+                             " engine): " + certificado_.getError());
+  }
+}
+
+bool SolverContext::marcarParcial(ResultadoAsignacion &resultado,
+                                  bool interrumpido) {
+  // A flow that already covers every day is maximum, deadline or not
+  if (!interrumpido || resultado.factible) {
+    return false;
+  }
+  resultado.parcial = true;
+  return true;
+}
+
+const InstanceView &SolverContext::validar() {
+  if (!loaded_) {
+    throw std::runtime_error("No instance loaded in solver context");
+  }
+  const InstanceView &inst = builder_.internar();
+  if (inst.prioridadDia != nullptr &&
+      (inst.numPrevias > 0 || inst.numFijas > 0)) {
+    throw std::runtime_error("prioridadDias cannot be combined with "
+                             "asignacionesFijas or asignacionesPrevias");
+  }
+  if (inst.numPrevias > 0 && inst.numFijas > 0) {
+    throw std::runtime_error(
+        "asignacionesPrevias cannot be combined with asignacionesFijas");
+  }
+  return inst;
+}
+
+ResultadoAsignacion SolverContext::solve() {
+  Traza::Tramo tramo("solve");
+  residualValido_ = false;
+  AnchoCapacidad anchoPrevio = ancho_;
+  ancho_ = AnchoCapacidad::I32;
+  flujoReutilizado_ = false;
+  bool flujoPrevio = flujoValido_;
+  flujoValido_ = false;
+  bool arbolesPrevios = arbolesValidos_;
+  arbolesValidos_ = false;
+  const InstanceView &inst = validar();
+  if (inst.numPrevias > 0) {
+    return solveEstable();
+  }
+  if (conImplicita_ && inst.numFijas == 0 && inst.prioridadDia == nullptr) {
+    return solveImplicito();
+  }
+
+  // graph_ is only built here, so it always holds the builder's last build
+  topologiaReutilizada_ = builder_.rebuild(graph_);
+  if (!builder_.getCotasInferiores().empty() || !builder_.fijasColocables()) {
+    return solveConFijas();
+  }
+
+  int source = builder_.getSource();
+  int sink = builder_.getSink();
+  ancho_ = builder_.getAnchoCapacidad();
+  bool desde = false; // Warm start from the previous flow
+  MaxFlowEngine *usado = &ek_;
+  if (inst.prioridadDia == nullptr && conBoykovKolmogorov_) {
+    usado = &boykovKolmogorov_;
+    desde = arbolesPrevios;
+    arbolesValidos_ = true;
+  } else if (inst.prioridadDia == nullptr && reutilizarFlujo_ &&
+             flujoPrevio && topologiaReutilizada_) {
+    desde = true;
+    flujoReutilizado_ = true;
+  } else if (inst.prioridadDia == nullptr && conPushRelabel_) {
+    usado = &pushRelabel_;
+  }
+  if (desde && anchoPrevio > ancho_) {
+    ancho_ = anchoPrevio; // The previous residuals may not fit narrower
+  } else if (desde) {
+    ensanchar(anchoPrevio, ancho_);
+  }
+
+  maxFlow_ = conAncho(ancho_, [&](auto &residual, auto &flujo) {
+    if (inst.prioridadDia != nullptr) {
+      return ek_.maxFlowPorClases(graph_, source, sink,
+                                  builder_.clasesPrioridad(), residual, flujo);
+    }
+    if (usado == &boykovKolmogorov_) {
+      return desde ? boykovKolmogorov_.maxFlowDesde(graph_, source, sink,
+                                                    residual, flujo)
+                   : boykovKolmogorov_.maxFlow(graph_, source, sink, residual,
+                                               flujo);
+    }
+    if (desde) {
+      return ek_.maxFlowDesde(graph_, source, sink, residual, flujo);
+    }
+    if (usado == &pushRelabel_) {
+      return pushRelabel_.maxFlow(graph_, source, sink, residual, flujo);
+    }
+    return ek_.maxFlow(graph_, source, sink, residual, flujo);
+  });
+  if (usado == &boykovKolmogorov_) {
+    flujoReutilizado_ = boykovKolmogorov_.getReanudado();
+  }
+  flujoValido_ = true;
+
+  return conAncho(ancho_, [&](auto &residual, auto &flujo) {
+    ResultadoAsignacion resultado = builder_.extraerResultado(flujo);
+    resultado.coberturaPorPrioridad = builder_.coberturaPorPrioridad(flujo);
+    if (marcarParcial(resultado, usado->interrumpido())) {
+      return resultado;
+    }
+    residualValido_ = true;
+
+    if (!resultado.factible || verificar_) {
+      // Min-Cut to identify bottlenecks
+      std::vector<int> reachable = ek_.getReachableResidual(residual, source);
+      if (!resultado.factible) {
+        resultado.bottlenecks = builder_.analyzeMinCut(reachable);
+      }
+      if (verificar_) {
+        Traza::Tramo certificado("certificate");
+        exigirCertificado(certificado_.verificar(graph_, flujo, source, sink,
+                                                 maxFlow_, reachable));
+      }
+    }
+    return resultado;
+  });
+}
+
+void SolverContext::ensanchar(AnchoCapacidad desde, AnchoCapacidad ancho) {
+  conAncho(desde, [&](const auto &residual, const auto &flujo) {
+    conAncho(ancho, [&](auto &residualAncho, auto &flujoAncho) {
+      copiarEnsanchado(residual, flujo, residualAncho, flujoAncho);
+    });
+  });
+}
+
+size_t SolverContext::memoriaEstimada() const {
+  return graph_.memoria() + residualGraph_.memoria() + residual8_.memoria() +
+         residual16_.memoria() + implicita_.memoria() +
+         boykovKolmogorov_.memoria() +
+         flowGraph_.size() * flowGraph_.size() * sizeof(int) +
+         flujo8_.size() * flujo8_.size() * sizeof(int16_t);
+}
+
+std::vector<SensibilidadMedico> SolverContext::sensibilidad() {
+  if (!residualValido_) {
+    throw std::runtime_error("Sensitivity needs a solve without locked or "
+                             "previous assignments, not on the implicit "
+                             "engine");
+  }
+
+  Traza::Tramo tramo("sensitivity");
+  const InstanceView &inst = builder_.getInstance();
+  int source = builder_.getSource();
+  std::vector<SensibilidadMedico> tabla(inst.numMedicos);
+  for (uint32_t m = 0; m < inst.numMedicos; m++) {
+    int nodo = builder_.nodoMedico(m);
+    tabla[m].medico = std::string(inst.medico(m));
+    tabla[m].asignaciones =
+        conFlujo([&](const auto &flujo) { return int(flujo[source][nodo]); });
+    if (tabla[m].asignaciones > 0) {
+      tabla[m].diasPerdidos =
+          conAncho(ancho_, [&](auto &residual, auto &flujo) {
+            return ek_.perdidaSinNodo(residual, flujo, source,
+                                      builder_.getSink(), nodo);
+          });
+      if (ek_.interrumpido()) {
+        return {};
+      }
+    }
+  }
+
+  std::sort(tabla.begin(), tabla.end(),
+            [](const SensibilidadMedico &a, const SensibilidadMedico &b) {
+              if (a.diasPerdidos != b.diasPerdidos) {
+                return a.diasPerdidos > b.diasPerdidos;
+              }
+              return a.medico < b.medico;
+            });
+  return tabla;
+}
+
+ResultadoAsignacion SolverContext::solveConFijas() {
+  std::vector<size_t> insatisfechas;
+  int source = builder_.getSource();
+  int sink = builder_.getSink();
+  const std::vector<CotaInferior> &cotas = builder_.getCotasInferiores();
+  ancho_ = EdmondsKarp::anchoConCotas(graph_, source, cotas,
+                                      builder_.getAnchoCapacidad());
+  return conAncho(ancho_, [&](auto &residual, auto &flujo) {
+    maxFlow_ = -1;
+    if (builder_.fijasColocables()) {
+      maxFlow_ = ek_.maxFlowConCotas(graph_, source, sink, cotas, residual,
+                                     flujo, insatisfechas);
+    }
+
+    if (maxFlow_ < 0) {
+      // The locks alone cannot be met: report them, with no assignments
+      maxFlow_ = 0;
+      int n = graph_.getNumVertices();
+      flujo.resize(n);
+      for (auto &row : flujo) {
+        row.assign(n, 0);
+      }
+      ResultadoAsignacion resultado = builder_.extraerResultado(flujo);
+      resultado.factible = false;
+      if (!marcarParcial(resultado, ek_.interrumpido())) {
+        resultado.bottlenecks = builder_.analyzeFijas(insatisfechas);
+      }
+      return resultado;
+    }
+
+    ResultadoAsignacion resultado = builder_.extraerResultado(flujo);
+    if (marcarParcial(resultado, ek_.interrumpido())) {
+      return resultado;
+    }
+
+    if (!resultado.factible || verificar_) {
+      // The residual graph already accounts for the lower bounds
+      std::vector<int> reachable = ek_.getReachableResidual(residual, source);
+      if (!resultado.factible) {
+        resultado.bottlenecks = builder_.analyzeMinCut(reachable);
+      }
+      if (verificar_) {
+        Traza::Tramo certificado("certificate");
+        exigirCertificado(certificado_.verificar(
+            graph_, flujo, source, sink, maxFlow_, reachable, cotas));
+      }
+    }
+    return resultado;
+  });
+}
+
+ResultadoAsignacion SolverContext::solveEstable() {
+  topologiaReutilizada_ = false;
+  builder_.buildEstable(red_);
+  int source = builder_.getSource();
+  red_.solve(source, builder_.getSink());
+
+  // Flow matrix, as the other solves leave it, for result extraction
+  int n = red_.getNumVertices();
+  flowGraph_.resize(n);
+  for (auto &row : flowGraph_) {
+    row.assign(n, 0);
+  }
+  maxFlow_ = 0;
+  for (int a = 0; a < red_.numArcos(); a++) {
+    int f = red_.flujo(a);
+    if (f != 0) {
+      flowGraph_[red_.from(a)][red_.to(a)] += f;
+      flowGraph_[red_.to(a)][red_.from(a)] -= f;
+      if (red_.from(a) == source) {
+        maxFlow_ += f;
+      }
+    }
+  }
+
+  ResultadoAsignacion resultado = builder_.extraerResultado(flowGraph_);
+
+  if (!marcarParcial(resultado, red_.interrumpido()) &&
+      (!resultado.factible || verificar_)) {
+    std::vector<int> reachable = red_.getReachableNodes(source);
+    if (!resultado.factible) {
+      resultado.bottlenecks = builder_.analyzeMinCut(reachable);
+    }
+    if (verificar_) {
+      Traza::Tramo certificado("certificate");
+      certificado_.iniciar(n, source, builder_.getSink(), maxFlow_,
+                           reachable);
+      for (int a = 0; a < red_.numArcos(); a++) {
+        certificado_.arco(red_.from(a), red_.to(a), red_.capacidad(a),
+                          red_.flujo(a));
+      }
+      exigirCertificado(certificado_.cumple());
+    }
+  }
+
+  resultado.conEstabilidad = true;
+  resultado.estabilidad = builder_.medirEstabilidad(resultado);
+  return resultado;
+}
+
+ResultadoAsignacion SolverContext::solveImplicito() {
+  // Nothing of the matrix network is kept: the next plain solve rebuilds it
+  topologiaReutilizada_ = false;
+  graph_ = Graph(0);
+  flowGraph_.clear();
+  flujo8_.clear();
+  builder_.buildImplicita(implicita_);
+  int source = builder_.getSource();
+  maxFlow_ = implicita_.solve(source, builder_.getSink());
+
+  ResultadoAsignacion resultado = builder_.extraerResultado(implicita_);
+  if (!marcarParcial(resultado, implicita_.interrumpido()) &&
+      (!resultado.factible || verificar_)) {
+    std::vector<int> reachable = implicita_.getReachableNodes(source);
+    if (!resultado.factible) {
+      resultado.bottlenecks = builder_.analyzeMinCut(reachable);
+    }
+    if (verificar_) {
+      Traza::Tramo certificado("certificate");
+      certificado_.iniciar(implicita_.getNumVertices(), source,
+                           builder_.getSink(), maxFlow_, reachable);
+      implicita_.certificar(certificado_);
+      exigirCertificado(certificado_.cumple());
+    }
+  }
+  return resultado;
+}
@@ -0,0 +1,192 @@
+#include "thread_pool.h"
+#include "traza.h"
+#include <utility>
+
+namespace {
+
+// Pool and worker index of the current thread, if it is a pool worker
+thread_local const ThreadPool *poolActual = nullptr;
+thread_local int indiceTrabajador = -1;
+
+// Failed scans before an idle worker parks
+const int VUELTAS_ANTES_DE_APARCAR = 64;
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned hilos) {
+  if (hilos == 0) {
+    hilos = 1;
+  }
+  for (unsigned i = 0; i <= hilos; i++) {
+    colas_.push_back(std::make_unique<Cola>());
+  }
+  for (unsigned i = 0; i < hilos; i++) {
+    trabajadores_.emplace_back(&ThreadPool::trabajar, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(aparcarMutex_);
+    parar_.store(true);
+  }
+  aparcar_.notify_all();
+  for (auto &trabajador : trabajadores_) {
+    trabajador.join();
+  }
+}
+
+int ThreadPool::indiceActual() const {
+  return poolActual == this ? indiceTrabajador : -1;
+}
+
+void ThreadPool::encolar(Tarea tarea) {
+  int indice = indiceActual();
+  Cola &cola = *colas_[indice >= 0 ? indice : colas_.size() - 1];
+  {
+    std::lock_guard<std::mutex> lock(cola.m);
+    cola.tareas.push_back(std::move(tarea));
+  }
+  // A worker about to park re-checks epoca_ after announcing itself in
+  // dormidos_, so either it sees the new task or it is woken here
+  epoca_.fetch_add(1);
+  if (dormidos_.load() > 0) {
+    std::lock_guard<std::mutex> lock(aparcarMutex_);
+    aparcar_.notify_one();
+  }
+}
+
+bool ThreadPool::ejecutarUna(int indice) {
+  Tarea tarea;
+  bool hay = false;
+  const int n = colas_.size();
+
+  if (indice >= 0) {
+    Cola &propia = *colas_[indice];
+    std::lock_guard<std::mutex> lock(propia.m);
+    if (!propia.tareas.empty()) {
+      tarea = std::move(propia.tareas.back());
+      propia.tareas.pop_back();
+      hay = true;
+    }
+  }
+  // Shared queue first, then the other workers from the next one on, oldest
+  // tasks first
+  const int trabajadores = n - 1;
+  for (int k = 0; !hay && k <= trabajadores; k++) {
+    int victima = k == 0 ? trabajadores : (indice + k) % trabajadores;
+    if (victima == indice) {
+      continue;
+    }
+    Cola &cola = *colas_[victima];
+    std::lock_guard<std::mutex> lock(cola.m);
+    if (!cola.tareas.empty()) {
+      tarea = std::move(cola.tareas.front());
+      cola.tareas.pop_front();
+      hay = true;
+    }
+  }
+  if (!hay) {
+    return false;
+  }
+
+  std::exception_ptr error;
+  try {
+    tarea.f();
+  } catch (...) {
+    error = std::current_exception();
+  }
+  tarea.grupo->terminar(error);
+  return true;
+}
+
+void ThreadPool::trabajar(int indice) {
+  poolActual = this;
+  indiceTrabajador = indice;
+  Traza::nombrarHilo("worker " + std::to_string(indice));
+
+  while (!parar_.load()) {
+    unsigned epoca = epoca_.load();
+    bool trabajo = false;
+    for (int v = 0; v < VUELTAS_ANTES_DE_APARCAR && !trabajo; v++) {
+      trabajo = ejecutarUna(indice);
+      if (!trabajo) {
+        std::this_thread::yield();
+      }
+    }
+    if (trabajo) {
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(aparcarMutex_);
+    dormidos_.fetch_add(1);
+    aparcar_.wait(lock, [&] {
+      return parar_.load() || epoca_.load() != epoca;
+    });
+    dormidos_.fetch_sub(1);
+  }
+}
+
+void ThreadPool::Grupo::terminar(std::exception_ptr error) {
+  if (error) {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    if (!error_) {
+      error_ = error;
+    }
+  }
+  pendientes_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+ThreadPool::Grupo::~Grupo() {
+  while (pendientes_.load(std::memory_order_acquire) > 0) {
+    if (!pool_->ejecutarUna(pool_->indiceActual())) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void ThreadPool::Grupo::lanzar(std::function<void()> tarea) {
+  pendientes_.fetch_add(1, std::memory_order_relaxed);
+  if (pool_ == nullptr) {
+    std::exception_ptr error;
+    try {
+      tarea();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    terminar(error);
+    return;
+  }
+  pool_->encolar(Tarea{std::move(tarea), this});
+}
+
+void ThreadPool::Grupo::esperar() {
+  while (pendientes_.load(std::memory_order_acquire) > 0) {
+    if (!pool_->ejecutarUna(pool_->indiceActual())) {
+      std::this_thread::yield();
+    }
+  }
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    std::swap(error, error_);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void ThreadPool::paraCada(ThreadPool *pool, int n,
+                          const std::function<void(int)> &f) {
+  if (pool == nullptr || n <= 1) {
+    for (int i = 0; i < n; i++) {
+      f(i);
+    }
+    return;
+  }
+  Grupo grupo(pool);
+  for (int i = 0; i < n; i++) {
+    grupo.lanzar([&f, i] { f(i); });
+  }
+  grupo.esperar();
+}
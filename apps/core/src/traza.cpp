@@ -0,0 +1,218 @@
+#include "traza.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Past this many events a thread drops the rest (and says so in the trace)
+const size_t MAX_EVENTOS_HILO = size_t(1) << 20;
+
+struct Evento {
+  const char *nombre;
+  const char *categoria;
+  int64_t inicio;
+  int64_t duracion;
+  const char *claves[2];
+  long long valores[2];
+  int numArgs;
+};
+
+struct Buffer {
+  std::mutex m;
+  std::vector<Evento> eventos;
+  size_t descartados = 0;
+  int tid = 0;
+  std::string nombre; // Guarded by the registry's mutex
+};
+
+// Every thread's buffer. Buffers are never freed: a thread keeps a pointer
+// to its own for its whole life.
+struct Registro {
+  std::mutex m;
+  std::vector<std::unique_ptr<Buffer>> buffers;
+  std::atomic<int64_t> origen{0}; // ns, steady clock
+};
+
+Registro &registro() {
+  static Registro r;
+  return r;
+}
+
+thread_local Buffer *bufferHilo = nullptr;
+thread_local std::string nombreHilo;
+
+int64_t relojNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+Buffer &bufferPropio() {
+  if (bufferHilo == nullptr) {
+    Registro &r = registro();
+    std::lock_guard<std::mutex> lock(r.m);
+    r.buffers.push_back(std::make_unique<Buffer>());
+    bufferHilo = r.buffers.back().get();
+    bufferHilo->tid = r.buffers.size();
+    bufferHilo->nombre = nombreHilo.empty()
+                             ? "thread " + std::to_string(bufferHilo->tid)
+                             : nombreHilo;
+  }
+  return *bufferHilo;
+}
+
+std::string escapar(const std::string &s) {
+  std::string salida;
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      salida += '\\';
+    }
+    salida += static_cast<unsigned char>(c) < 0x20 ? ' ' : c;
+  }
+  return salida;
+}
+
+// Microseconds with ns precision, as the format expects
+std::string microsegundos(int64_t ns) {
+  char texto[32];
+  std::snprintf(texto, sizeof(texto), "%.3f", ns / 1000.0);
+  return texto;
+}
+
+} // namespace
+
+std::atomic<bool> Traza::activa_{false};
+
+Traza::Tramo::Tramo(const char *nombre, const char *categoria)
+    : nombre_(nombre), categoria_(categoria), inicio_(-1), numArgs_(0) {
+  if (activa()) {
+    inicio_ = relojNs() - registro().origen.load(std::memory_order_relaxed);
+  }
+}
+
+Traza::Tramo::~Tramo() { terminar(); }
+
+void Traza::Tramo::terminar() {
+  if (inicio_ < 0 || !activa()) {
+    return;
+  }
+  int64_t fin = relojNs() - registro().origen.load(std::memory_order_relaxed);
+  Evento evento{nombre_, categoria_, inicio_, fin - inicio_, {}, {},
+                numArgs_};
+  for (int i = 0; i < numArgs_; i++) {
+    evento.claves[i] = claves_[i];
+    evento.valores[i] = valores_[i];
+  }
+  inicio_ = -1;
+  Buffer &buffer = bufferPropio();
+  std::lock_guard<std::mutex> lock(buffer.m);
+  if (buffer.eventos.size() < MAX_EVENTOS_HILO) {
+    buffer.eventos.push_back(evento);
+  } else {
+    buffer.descartados++;
+  }
+}
+
+void Traza::Tramo::arg(const char *clave, long long valor) {
+  if (inicio_ < 0) {
+    return;
+  }
+  for (int i = 0; i < numArgs_; i++) {
+    if (claves_[i] == clave) {
+      valores_[i] = valor;
+      return;
+    }
+  }
+  if (numArgs_ < MAX_ARGS) {
+    claves_[numArgs_] = clave;
+    valores_[numArgs_] = valor;
+    numArgs_++;
+  }
+}
+
+void Traza::activar() {
+  desactivar();
+  registro().origen.store(relojNs());
+  activa_.store(true, std::memory_order_release);
+}
+
+void Traza::desactivar() {
+  activa_.store(false, std::memory_order_release);
+  Registro &r = registro();
+  std::lock_guard<std::mutex> lock(r.m);
+  for (auto &buffer : r.buffers) {
+    std::lock_guard<std::mutex> lockBuffer(buffer->m);
+    buffer->eventos.clear();
+    buffer->descartados = 0;
+  }
+}
+
+void Traza::nombrarHilo(const std::string &nombre) {
+  nombreHilo = nombre;
+  if (bufferHilo != nullptr) {
+    std::lock_guard<std::mutex> lock(registro().m);
+    bufferHilo->nombre = nombre;
+  }
+}
+
+std::string Traza::toJson() {
+  std::string json = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n"
+                     "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, "
+                     "\"tid\": 0, \"args\": {\"name\": \"solver\"}}";
+  Registro &r = registro();
+  std::lock_guard<std::mutex> lock(r.m);
+  for (auto &buffer : r.buffers) {
+    std::lock_guard<std::mutex> lockBuffer(buffer->m);
+    if (buffer->eventos.empty()) {
+      continue;
+    }
+    std::string tid = std::to_string(buffer->tid);
+    json += ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+            "\"tid\": " +
+            tid + ", \"args\": {\"name\": \"" + escapar(buffer->nombre) +
+            "\"}}";
+    json += ",\n{\"name\": \"thread_sort_index\", \"ph\": \"M\", \"pid\": 1, "
+            "\"tid\": " +
+            tid + ", \"args\": {\"sort_index\": " + tid + "}}";
+    int64_t ultimo = 0;
+    for (const Evento &e : buffer->eventos) {
+      json += ",\n{\"name\": \"" + std::string(e.nombre) + "\", \"cat\": \"" +
+              e.categoria + "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " + tid +
+              ", \"ts\": " + microsegundos(e.inicio) +
+              ", \"dur\": " + microsegundos(e.duracion);
+      if (e.numArgs > 0) {
+        json += ", \"args\": {";
+        for (int i = 0; i < e.numArgs; i++) {
+          json += std::string(i > 0 ? ", " : "") + "\"" + e.claves[i] +
+                  "\": " + std::to_string(e.valores[i]);
+        }
+        json += "}";
+      }
+      json += "}";
+      ultimo = std::max(ultimo, e.inicio + e.duracion);
+    }
+    if (buffer->descartados > 0) {
+      json += ",\n{\"name\": \"trace buffer full\", \"ph\": \"i\", \"s\": "
+              "\"t\", \"pid\": 1, \"tid\": " +
+              tid + ", \"ts\": " + microsegundos(ultimo) +
+              ", \"args\": {\"dropped\": " +
+              std::to_string(buffer->descartados) + "}}";
+    }
+  }
+  json += "\n]}\n";
+  return json;
+}
+
+void Traza::escribir(const std::string &ruta) {
+  std::ofstream salida(ruta, std::ios::binary);
+  salida << toJson();
+  if (!salida) {
+    throw std::runtime_error("Cannot write trace file: " + ruta);
+  }
+}
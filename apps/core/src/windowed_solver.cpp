@@ -0,0 +1,186 @@
+#include "windowed_solver.h"
+#include "traza.h"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+ResultadoAsignacion WindowedSolver::solve(const InstanceView &inst,
+                                          uint32_t periodosPorVentana,
+                                          bool reparar) {
+  if (periodosPorVentana == 0) {
+    throw std::runtime_error("A window needs at least one period");
+  }
+  if (reparar && (inst.numFijas > 0 || inst.numPrevias > 0 ||
+                  inst.prioridadDia != nullptr)) {
+    throw std::runtime_error("Window repair needs an instance without locked "
+                             "or previous assignments or day priorities");
+  }
+  const uint32_t M = inst.numMedicos;
+  const uint32_t D = inst.numDias;
+  const uint32_t P = inst.numPeriodos;
+
+  // Periods in chronological order (periods without days go last)
+  std::vector<uint32_t> primerDia(P, UINT32_MAX);
+  for (uint32_t p = 0; p < P; p++) {
+    for (uint32_t k = inst.periodoOffsets[p]; k < inst.periodoOffsets[p + 1];
+         k++) {
+      primerDia[p] = std::min(primerDia[p], inst.periodoDias[k]);
+    }
+  }
+  std::vector<uint32_t> orden(P);
+  std::iota(orden.begin(), orden.end(), 0);
+  std::stable_sort(orden.begin(), orden.end(), [&](uint32_t a, uint32_t b) {
+    return primerDia[a] < primerDia[b];
+  });
+
+  // Window of each day: that of its earliest period
+  numVentanas_ = std::max<uint32_t>(
+      1, (P + periodosPorVentana - 1) / periodosPorVentana);
+  std::vector<uint32_t> ventanaDia(D, 0);
+  for (uint32_t i = P; i-- > 0;) {
+    uint32_t p = orden[i];
+    for (uint32_t k = inst.periodoOffsets[p]; k < inst.periodoOffsets[p + 1];
+         k++) {
+      ventanaDia[inst.periodoDias[k]] = i / periodosPorVentana;
+    }
+  }
+
+  std::unordered_map<std::string_view, uint32_t> medicoIndex;
+  for (uint32_t m = 0; m < M; m++) {
+    medicoIndex.emplace(inst.medico(m), m);
+  }
+  std::unordered_map<std::string_view, uint32_t> diaIndex;
+  for (uint32_t d = 0; d < D; d++) {
+    diaIndex.emplace(inst.dia(d), d);
+  }
+
+  // Merged assignments are ordered as GraphBuilder::extraerResultado orders
+  // a plain solve's: by doctor, then period (the first one listing the day),
+  // then day name
+  std::vector<uint32_t> periodoDe(D, UINT32_MAX);
+  for (uint32_t p = P; p-- > 0;) {
+    for (uint32_t k = inst.periodoOffsets[p]; k < inst.periodoOffsets[p + 1];
+         k++) {
+      periodoDe[inst.periodoDias[k]] = p;
+    }
+  }
+  std::vector<uint32_t> porNombre(D);
+  std::iota(porNombre.begin(), porNombre.end(), 0);
+  std::stable_sort(porNombre.begin(), porNombre.end(),
+                   [&](uint32_t a, uint32_t b) {
+                     return inst.dia(a) < inst.dia(b);
+                   });
+  std::vector<uint32_t> rangoDia(D);
+  for (uint32_t i = 0; i < D; i++) {
+    rangoDia[porNombre[i]] = i;
+  }
+
+  ResultadoAsignacion resultado;
+  resultado.factible = false;
+  resultado.diasCubiertos = 0;
+  resultado.diasRequeridos = 0;
+  std::set<std::pair<std::string, std::string>> vistos; // Bottlenecks
+  std::map<int, CoberturaPrioridad, std::greater<int>> porPrioridad;
+  std::vector<int32_t> usados(M, 0);
+  // (doctor, period, day rank, i) of each merged assignment
+  std::vector<std::tuple<uint32_t, uint32_t, uint32_t, size_t>>
+      ordenAsignaciones;
+
+  std::vector<uint32_t> periodos;
+  std::vector<uint32_t> dias;
+  for (uint32_t w = 0; w < numVentanas_; w++) {
+    Traza::Tramo tramo("window");
+    tramo.arg("window", w);
+    periodos.assign(
+        orden.begin() + std::min(P, w * periodosPorVentana),
+        orden.begin() + std::min(P, (w + 1) * periodosPorVentana));
+    dias.clear();
+    for (uint32_t d = 0; d < D; d++) {
+      if (ventanaDia[d] == w) {
+        dias.push_back(d);
+      }
+    }
+
+    ventana_.internarVentana(inst, periodos, dias, usados);
+    context_.load(ventana_.view());
+    ResultadoAsignacion r = context_.solve();
+
+    resultado.diasCubiertos += r.diasCubiertos;
+    resultado.diasRequeridos += r.diasRequeridos;
+    resultado.parcial |= r.parcial;
+    for (auto &a : r.asignaciones) {
+      uint32_t m = medicoIndex.at(a.medico);
+      uint32_t d = diaIndex.at(a.dia);
+      usados[m]++;
+      ordenAsignaciones.emplace_back(m, periodoDe[d], rangoDia[d],
+                                     resultado.asignaciones.size());
+      resultado.asignaciones.push_back(std::move(a));
+    }
+    for (auto &b : r.bottlenecks) {
+      if (vistos.emplace(b.tipo, b.id).second) {
+        resultado.bottlenecks.push_back(std::move(b));
+      }
+    }
+    if (r.conEstabilidad) {
+      resultado.conEstabilidad = true;
+      resultado.estabilidad.previas += r.estabilidad.previas;
+      resultado.estabilidad.conservadas += r.estabilidad.conservadas;
+      resultado.estabilidad.cambios += r.estabilidad.cambios;
+    }
+    for (const auto &c : r.coberturaPorPrioridad) {
+      CoberturaPrioridad &total = porPrioridad[c.prioridad];
+      total.prioridad = c.prioridad;
+      total.diasCubiertos += c.diasCubiertos;
+      total.diasRequeridos += c.diasRequeridos;
+    }
+  }
+
+  std::sort(ordenAsignaciones.begin(), ordenAsignaciones.end());
+  std::vector<Asignacion> asignaciones;
+  asignaciones.reserve(ordenAsignaciones.size());
+  for (const auto &[m, p, rango, i] : ordenAsignaciones) {
+    asignaciones.push_back(std::move(resultado.asignaciones[i]));
+  }
+  resultado.asignaciones = std::move(asignaciones);
+  for (const auto &[prioridad, c] : porPrioridad) {
+    resultado.coberturaPorPrioridad.push_back(c);
+  }
+  resultado.factible = resultado.diasCubiertos == resultado.diasRequeridos;
+  if (resultado.factible || resultado.parcial) {
+    resultado.bottlenecks.clear();
+  }
+
+  if (!reparar || resultado.factible || resultado.parcial) {
+    return resultado;
+  }
+
+  // Repair: the whole instance, keeping as much of the windowed plan as the
+  // optimum allows
+  std::vector<std::pair<uint32_t, uint32_t>> pares;
+  for (const auto &a : resultado.asignaciones) {
+    pares.emplace_back(medicoIndex.at(a.medico), diaIndex.at(a.dia));
+  }
+  std::sort(pares.begin(), pares.end());
+  pares.erase(std::unique(pares.begin(), pares.end()), pares.end());
+  plan_.clear();
+  for (const auto &[m, d] : pares) {
+    plan_.push_back(m);
+    plan_.push_back(d);
+  }
+  reparacion_ = inst;
+  reparacion_.previas = plan_.data();
+  reparacion_.numPrevias = pares.size();
+  Traza::Tramo tramo("window repair");
+  context_.load(reparacion_);
+  ResultadoAsignacion reparado = context_.solve();
+  // The windowed plan only steers the repair as previous assignments: the
+  // request had none, so it gets no stability report
+  reparado.conEstabilidad = false;
+  reparado.estabilidad = Estabilidad();
+  return reparado;
+}
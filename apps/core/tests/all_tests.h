@@ -8,5 +8,19 @@ void run_hospital_tests();
 void run_graph_builder_tests();
 void run_json_parser_tests();
 void run_mincut_tests();
+void run_solver_context_tests();
+void run_c_api_tests();
+void run_binary_instance_tests();
+void run_result_cache_tests();
+void run_windowed_solver_tests();
+void run_session_store_tests();
+void run_bfs_bitset_tests();
+void run_push_relabel_tests();
+void run_thread_pool_tests();
+void run_red_implicita_tests();
+void run_boykov_kolmogorov_tests();
+void run_certificado_tests();
+void run_stress_tests();
+void run_traza_tests();
 
 #endif
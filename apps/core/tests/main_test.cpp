@@ -30,6 +30,48 @@ int main() {
   run_mincut_tests();
   std::cout << "\n";
 
+  run_solver_context_tests();
+  std::cout << "\n";
+
+  run_c_api_tests();
+  std::cout << "\n";
+
+  run_binary_instance_tests();
+  std::cout << "\n";
+
+  run_result_cache_tests();
+  std::cout << "\n";
+
+  run_windowed_solver_tests();
+  std::cout << "\n";
+
+  run_session_store_tests();
+  std::cout << "\n";
+
+  run_bfs_bitset_tests();
+  std::cout << "\n";
+
+  run_push_relabel_tests();
+  std::cout << "\n";
+
+  run_thread_pool_tests();
+  std::cout << "\n";
+
+  run_red_implicita_tests();
+  std::cout << "\n";
+
+  run_boykov_kolmogorov_tests();
+  std::cout << "\n";
+
+  run_certificado_tests();
+  std::cout << "\n";
+
+  run_stress_tests();
+  std::cout << "\n";
+
+  run_traza_tests();
+  std::cout << "\n";
+
   // Mostrar resumen final
   printSummary();
 
@@ -0,0 +1,165 @@
+/**
+ * Stress diferencial entre motores (make stress)
+ *
+ *   ./build/stress [--seed=N] [--scales=N] [--repro-dir=DIR] [--csv=FILE]
+ *
+ * Resuelve miles de instancias aleatorias y con forma de hospital, de
+ * tamaño creciente, con todas las variantes de motor (ver stress_utils.h).
+ * Cada instancia de hospital va seguida de dos ediciones de disponibilidad,
+ * que los motores con estado (boykov-kolmogorov, ek+reuse) resuelven desde
+ * el solve anterior. Si alguna variante difiere de Edmonds-Karp, la
+ * instancia se reduce a un reproductor mínimo y se guarda como JSON en
+ * DIR (por defecto build/stress_repro). Al final imprime, por escala, el tiempo
+ * medio de cada variante (load + solve + certificado) y, con --csv, lo
+ * escribe también como CSV. Sale con 1 si hubo diferencias.
+ */
+
+#include "stress_utils.h"
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+struct Escala {
+  int medicos;
+  int dias;
+  int instancias;
+};
+
+// De muchas instancias pequeñas a pocas del tamaño de un hospital grande
+const Escala ESCALAS[] = {
+    {4, 8, 2000}, {12, 30, 600}, {40, 120, 120}, {100, 365, 12}, {200, 365, 4}};
+
+std::string valor(const std::string &arg, const std::string &nombre) {
+  return arg.rfind(nombre + "=", 0) == 0 ? arg.substr(nombre.size() + 1) : "";
+}
+
+// Guarda el reproductor de una diferencia y devuelve su ruta
+std::string guardar(const std::string &dir, const std::string &nombre,
+                    const InputData &data) {
+  std::string ruta = dir + "/" + nombre + ".json";
+  std::ofstream(ruta) << JSONParser::inputToJson(data, 2) << "\n";
+  return ruta;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  unsigned semilla = 1;
+  size_t numEscalas = sizeof(ESCALAS) / sizeof(ESCALAS[0]);
+  std::string dir = "build/stress_repro";
+  std::string csv;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (!valor(arg, "--seed").empty()) {
+      semilla = std::stoul(valor(arg, "--seed"));
+    } else if (!valor(arg, "--scales").empty()) {
+      numEscalas =
+          std::min(numEscalas, size_t(std::stoul(valor(arg, "--scales"))));
+    } else if (!valor(arg, "--repro-dir").empty()) {
+      dir = valor(arg, "--repro-dir");
+    } else if (!valor(arg, "--csv").empty()) {
+      csv = valor(arg, "--csv");
+    } else {
+      std::cerr << "Uso: stress [--seed=N] [--scales=N] [--repro-dir=DIR] "
+                   "[--csv=FILE]\n";
+      return 2;
+    }
+  }
+  std::filesystem::create_directories(dir);
+
+  std::mt19937 rng(semilla);
+  const std::vector<VarianteStress> variantes = variantesStress();
+  std::vector<std::vector<double>> msTotal(
+      numEscalas, std::vector<double>(variantes.size()));
+  std::vector<int> resueltas(numEscalas, 0);
+  int diferencias = 0;
+
+  for (size_t e = 0; e < numEscalas; e++) {
+    const Escala &escala = ESCALAS[e];
+    std::cout << "Escala " << escala.medicos << " x " << escala.dias << ": "
+              << escala.instancias << " instancias" << std::endl;
+    DiferencialStress diferencial; // Motores con estado durante la escala
+    InputData anterior;
+
+    for (int k = 0; k < escala.instancias; k++) {
+      bool hospital = k % 2 == 1;
+      InputData data =
+          hospital ? instanciaHospital(rng, escala.medicos, escala.dias)
+                   : instanciaStress(rng, escala.medicos, escala.dias);
+      for (int edicion = 0; edicion < (hospital ? 3 : 1); edicion++) {
+        if (edicion > 0) {
+          editarStress(rng, data, 1 + rng() % 4);
+        }
+        std::string detalle = diferencial.comparar(data);
+        for (size_t v = 0; v < variantes.size(); v++) {
+          msTotal[e][v] += diferencial.getMs()[v];
+        }
+        resueltas[e]++;
+
+        if (!detalle.empty()) {
+          diferencias++;
+          std::string nombre = "stress_" + std::to_string(semilla) + "_" +
+                               std::to_string(diferencias);
+          std::cout << "DIFERENCIA en la instancia " << k << ":\n" << detalle;
+          FallaStress falla = [](const InputData &candidata) {
+            DiferencialStress nuevo;
+            return !nuevo.comparar(candidata).empty();
+          };
+          if (falla(data)) {
+            InputData minima = reducirStress(data, falla);
+            DiferencialStress nuevo;
+            std::cout << "Reducida a " << minima.medicos.size()
+                      << " médicos, " << minima.dias.size() << " días, "
+                      << minima.periodos.size() << " periodos:\n"
+                      << nuevo.comparar(minima) << "Reproductor: "
+                      << guardar(dir, nombre, minima) << "\n";
+          } else {
+            // Solo falla tras el solve anterior: se guardan los dos
+            std::cout << "Depende del solve anterior. Reproductor: "
+                      << guardar(dir, nombre + "_anterior", anterior)
+                      << " y luego " << guardar(dir, nombre, data) << "\n";
+          }
+        }
+        anterior = data;
+      }
+    }
+  }
+
+  std::cout << "\nTiempo medio por instancia (ms)\n"
+            << std::setw(12) << "escala";
+  for (const auto &v : variantes) {
+    std::cout << std::setw(19) << v.nombre;
+  }
+  std::cout << "\n" << std::fixed << std::setprecision(3);
+  std::ofstream salidaCsv;
+  if (!csv.empty()) {
+    salidaCsv.open(csv);
+    salidaCsv << "medicos,dias,instancias,variante,ms_medio\n";
+  }
+  for (size_t e = 0; e < numEscalas; e++) {
+    std::string nombre = std::to_string(ESCALAS[e].medicos) + "x" +
+                         std::to_string(ESCALAS[e].dias);
+    std::cout << std::setw(12) << nombre;
+    for (size_t v = 0; v < variantes.size(); v++) {
+      double ms = msTotal[e][v] / std::max(resueltas[e], 1);
+      std::cout << std::setw(19) << ms;
+      if (salidaCsv.is_open()) {
+        salidaCsv << ESCALAS[e].medicos << "," << ESCALAS[e].dias << ","
+                  << resueltas[e] << "," << variantes[v].nombre << "," << ms
+                  << "\n";
+      }
+    }
+    std::cout << "\n";
+  }
+
+  int total = 0;
+  for (int n : resueltas) {
+    total += n;
+  }
+  std::cout << "\n" << total << " instancias, " << diferencias
+            << " diferencias\n";
+  return diferencias == 0 ? 0 : 1;
+}
@@ -0,0 +1,430 @@
+#ifndef STRESS_UTILS_H
+#define STRESS_UTILS_H
+
+#include "json_parser.h"
+#include "solver_context.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * Stress diferencial entre motores (make stress y test_stress.cpp)
+ *
+ * Genera instancias aleatorias y con forma de hospital, las resuelve con
+ * todas las variantes de motor (cada una en su propio contexto, que guarda
+ * su estado entre instancias como en modo residente, y con el certificado
+ * de optimalidad activado), compara flujo, cobertura y bottlenecks con los
+ * de Edmonds-Karp y reduce las instancias en que difieren a un reproductor
+ * mínimo.
+ *
+ * Sus generadores de instancias aleatorias también los usan los tests que
+ * comparan motores o certifican solves (test_certificado.cpp,
+ * test_red_implicita.cpp).
+ */
+
+// Motor y opciones del contexto de una variante
+struct VarianteStress {
+  std::string nombre;
+  std::string motor;
+  bool renumerar;
+  bool reutilizarFlujo;
+  bool pool; // Pool de DiferencialStress, con varios hilos en toda red
+};
+
+// La primera es la referencia
+inline std::vector<VarianteStress> variantesStress() {
+  return {{"edmonds-karp", "edmonds-karp", false, false, false},
+          {"push-relabel", "push-relabel", false, false, false},
+          {"push-relabel+pool", "push-relabel", false, false, true},
+          {"implicit", "implicit", false, false, false},
+          {"boykov-kolmogorov", "boykov-kolmogorov", false, false, false},
+          {"ek+renumber", "edmonds-karp", true, false, false},
+          {"ek+reuse", "edmonds-karp", false, true, false}};
+}
+
+// Instancia aleatoria de hasta maxMedicos x maxDias: periodos que se solapan
+// o repiten días, capacidades, roles o turnos, y a veces fijas, previas o
+// prioridades
+inline InputData instanciaStress(std::mt19937 &rng, int maxMedicos,
+                                 int maxDias) {
+  InputData data;
+  int M = 1 + rng() % maxMedicos;
+  int D = 1 + rng() % maxDias;
+  int P = 1 + rng() % 4;
+  for (int m = 0; m < M; m++) {
+    data.medicos.push_back("M" + std::to_string(m));
+  }
+  for (int d = 0; d < D; d++) {
+    data.dias.push_back("D" + std::to_string(d));
+    data.medicosPorDia[data.dias[d]] = rng() % 3;
+  }
+  for (int p = 0; p < P; p++) {
+    Periodo periodo;
+    periodo.id = "P" + std::to_string(p);
+    for (int d = 0; d < D; d++) {
+      if (rng() % 3 == 0) {
+        periodo.dias.push_back(data.dias[d]);
+      }
+    }
+    if (!periodo.dias.empty() && rng() % 5 == 0) {
+      periodo.dias.push_back(periodo.dias.front()); // Día repetido
+    }
+    data.periodos.push_back(periodo);
+  }
+  for (int m = 0; m < M; m++) {
+    for (int d = 0; d < D; d++) {
+      if (rng() % 2 == 0) {
+        data.disponibilidad[data.medicos[m]].push_back(data.dias[d]);
+      }
+    }
+  }
+  data.maxGuardiasPorPeriodo = 1 + rng() % 3;
+  data.maxGuardiasTotales = 1 + rng() % (D + 1);
+  if (rng() % 4 == 0) {
+    data.personalCapacities[data.medicos[rng() % M]] = rng() % 4;
+  }
+  if (rng() % 4 == 0) {
+    data.capacidadesPorPeriodo[data.medicos[0]][data.periodos[0].id] =
+        rng() % 3;
+  }
+
+  int variante = rng() % 4;
+  if (variante == 1) {
+    for (int m = 0; m < M; m++) {
+      data.roles[data.medicos[m]] = m % 3 == 0 ? "R1" : "R2";
+    }
+    for (int d = 0; d < D; d += 2) {
+      data.demandaPorRol[data.dias[d]] = {{"R1", 1}, {"R2", int(rng() % 2)}};
+      data.medicosPorDia[data.dias[d]] =
+          1 + data.demandaPorRol[data.dias[d]]["R2"];
+    }
+  } else if (variante == 2) {
+    for (int d = 0; d < D; d += 2) {
+      data.demandaPorTurno[data.dias[d]] = {{"T1", 1}, {"T2", 1}};
+      data.medicosPorDia[data.dias[d]] = 2;
+      for (int m = 0; m < M; m += 3) {
+        data.disponibilidadPorTurno[data.medicos[m]][data.dias[d]] = {"T2"};
+      }
+    }
+  }
+
+  // Fijas, previas y prioridades no se combinan entre sí
+  const auto &disponibles = data.disponibilidad[data.medicos[0]];
+  int extra = rng() % 6;
+  if (extra == 1 && !disponibles.empty()) {
+    data.asignacionesFijas[data.medicos[0]] = {disponibles.front()};
+  } else if (extra == 2 && !disponibles.empty()) {
+    data.asignacionesPrevias[data.medicos[0]] = {disponibles.back()};
+  } else if (extra == 3) {
+    data.prioridadDias[data.dias[rng() % D]] = 1 + rng() % 3;
+  }
+  return data;
+}
+
+// Instancia con forma de hospital: meses de 30 días, más demanda en fin de
+// semana, un bloque de vacaciones por médico y un límite total cerca de la
+// demanda media (a veces por encima, a veces por debajo)
+inline InputData instanciaHospital(std::mt19937 &rng, int medicos, int dias) {
+  InputData data;
+  for (int m = 0; m < medicos; m++) {
+    data.medicos.push_back("Dr" + std::to_string(m));
+  }
+  int base = 1 + rng() % 2;
+  int demanda = 0;
+  for (int d = 0; d < dias; d++) {
+    data.dias.push_back("D" + std::to_string(d));
+    data.medicosPorDia[data.dias[d]] = d % 7 >= 5 ? base + 1 : base;
+    demanda += data.medicosPorDia[data.dias[d]];
+  }
+  for (int inicio = 0; inicio < dias; inicio += 30) {
+    Periodo periodo;
+    periodo.id = "Mes" + std::to_string(inicio / 30);
+    for (int d = inicio; d < std::min(dias, inicio + 30); d++) {
+      periodo.dias.push_back(data.dias[d]);
+    }
+    data.periodos.push_back(periodo);
+  }
+  for (const auto &medico : data.medicos) {
+    int vacaciones = rng() % dias;
+    int duracion = 7 + rng() % 14;
+    for (int d = 0; d < dias; d++) {
+      if ((d < vacaciones || d >= vacaciones + duracion) && rng() % 10 < 7) {
+        data.disponibilidad[medico].push_back(data.dias[d]);
+      }
+    }
+  }
+  data.maxGuardiasPorPeriodo = 3 + rng() % 4;
+  data.maxGuardiasTotales =
+      1 + demanda * (85 + int(rng() % 40)) / 100 / std::max(medicos, 1);
+
+  if (rng() % 4 == 0) {
+    // Un adjunto cada fin de semana
+    for (int m = 0; m < medicos; m++) {
+      data.roles[data.medicos[m]] = m % 3 == 0 ? "Adjunto" : "Residente";
+    }
+    for (int d = 5; d < dias; d += 7) {
+      int n = data.medicosPorDia[data.dias[d]];
+      data.demandaPorRol[data.dias[d]] = {{"Adjunto", 1},
+                                          {"Residente", n - 1}};
+    }
+  }
+  return data;
+}
+
+// Alterna la disponibilidad de `cambios` pares (médico, día) al azar
+inline void editarStress(std::mt19937 &rng, InputData &data, int cambios) {
+  for (int c = 0; c < cambios && !data.medicos.empty() && !data.dias.empty();
+       c++) {
+    const std::string &medico = data.medicos[rng() % data.medicos.size()];
+    auto &dias = data.disponibilidad[medico];
+    const std::string &dia = data.dias[rng() % data.dias.size()];
+    auto it = std::find(dias.begin(), dias.end(), dia);
+    if (it != dias.end()) {
+      dias.erase(it);
+    } else {
+      dias.push_back(dia);
+    }
+  }
+}
+
+// Lo que deben compartir todos los motores: flujo, cobertura y bottlenecks
+// (o el error, si lo hay)
+inline std::string resumenStress(SolverContext &context,
+                                 const InputData &data) {
+  try {
+    context.load(data);
+    ResultadoAsignacion r = context.solve();
+    std::string s = "flujo " + std::to_string(context.getMaxFlow()) +
+                    ", cubiertos " + std::to_string(r.diasCubiertos) + "/" +
+                    std::to_string(r.diasRequeridos) + ", bottlenecks [";
+    for (const auto &b : r.bottlenecks) {
+      s += b.tipo + ":" + b.id + ":" + b.razon + "; ";
+    }
+    return s + "]";
+  } catch (const std::exception &e) {
+    return std::string("error: ") + e.what();
+  }
+}
+
+// Un contexto por variante; compara cada instancia con la referencia
+class DiferencialStress {
+private:
+  static constexpr int HILOS_POOL = 3;
+
+  std::vector<VarianteStress> variantes_;
+  std::unique_ptr<ThreadPool> pool_; // Antes que los contextos que lo usan
+  std::vector<SolverContext> contextos_;
+  std::vector<double> ms_; // De la última instancia, por variante
+
+public:
+  DiferencialStress()
+      : variantes_(variantesStress()),
+        pool_(std::make_unique<ThreadPool>(HILOS_POOL)),
+        contextos_(variantes_.size()), ms_(variantes_.size(), 0.0) {
+    for (size_t i = 0; i < variantes_.size(); i++) {
+      if (variantes_[i].pool) {
+        // Varios hilos también en las redes pequeñas del stress
+        contextos_[i].setPool(pool_.get());
+        contextos_[i].setArcosPorHilo(1);
+      }
+      contextos_[i].setMotor(variantes_[i].motor);
+      contextos_[i].setRenumerar(variantes_[i].renumerar);
+      contextos_[i].setReutilizarFlujo(variantes_[i].reutilizarFlujo);
+      contextos_[i].setVerificar(true);
+    }
+  }
+
+  // "" si todas las variantes coinciden con la referencia; si no, qué dio
+  // cada una de las que difieren
+  std::string comparar(const InputData &data) {
+    std::string referencia;
+    std::string diferencias;
+    for (size_t i = 0; i < variantes_.size(); i++) {
+      auto inicio = std::chrono::steady_clock::now();
+      std::string resumen = resumenStress(contextos_[i], data);
+      ms_[i] = std::chrono::duration<double, std::milli>(
+                   std::chrono::steady_clock::now() - inicio)
+                   .count();
+      if (i == 0) {
+        referencia = resumen;
+      } else if (resumen != referencia) {
+        diferencias += "  " + variantes_[i].nombre + ": " + resumen + "\n";
+      }
+    }
+    if (diferencias.empty()) {
+      return "";
+    }
+    return "  " + variantes_[0].nombre + ": " + referencia + "\n" +
+           diferencias;
+  }
+
+  const std::vector<VarianteStress> &getVariantes() const {
+    return variantes_;
+  }
+  const std::vector<double> &getMs() const { return ms_; }
+};
+
+// Quita los médicos [i, j) y todo lo que los nombra
+inline void quitarMedicosStress(InputData &data, size_t i, size_t j) {
+  for (size_t k = i; k < j; k++) {
+    const std::string &m = data.medicos[k];
+    data.disponibilidad.erase(m);
+    data.personalCapacities.erase(m);
+    data.capacidadesPorPeriodo.erase(m);
+    data.asignacionesFijas.erase(m);
+    data.asignacionesPrevias.erase(m);
+    data.roles.erase(m);
+    data.disponibilidadPorTurno.erase(m);
+  }
+  data.medicos.erase(data.medicos.begin() + i, data.medicos.begin() + j);
+}
+
+// Quita los días [i, j) y todo lo que los nombra
+inline void quitarDiasStress(InputData &data, size_t i, size_t j) {
+  std::set<std::string> quitados(data.dias.begin() + i,
+                                 data.dias.begin() + j);
+  auto filtrar = [&](std::vector<std::string> &dias) {
+    dias.erase(std::remove_if(dias.begin(), dias.end(),
+                              [&](const std::string &d) {
+                                return quitados.count(d) > 0;
+                              }),
+               dias.end());
+  };
+  for (const auto &d : quitados) {
+    data.medicosPorDia.erase(d);
+    data.prioridadDias.erase(d);
+    data.demandaPorRol.erase(d);
+    data.demandaPorTurno.erase(d);
+  }
+  for (auto &periodo : data.periodos) {
+    filtrar(periodo.dias);
+  }
+  for (auto *pares : {&data.disponibilidad, &data.asignacionesFijas,
+                      &data.asignacionesPrevias}) {
+    for (auto &[medico, dias] : *pares) {
+      filtrar(dias);
+    }
+  }
+  for (auto &[medico, porDia] : data.disponibilidadPorTurno) {
+    for (const auto &d : quitados) {
+      porDia.erase(d);
+    }
+  }
+  data.dias.erase(data.dias.begin() + i, data.dias.begin() + j);
+}
+
+// Quita los periodos [i, j) y sus capacidades
+inline void quitarPeriodosStress(InputData &data, size_t i, size_t j) {
+  for (size_t k = i; k < j; k++) {
+    for (auto &[medico, caps] : data.capacidadesPorPeriodo) {
+      caps.erase(data.periodos[k].id);
+    }
+  }
+  data.periodos.erase(data.periodos.begin() + i, data.periodos.begin() + j);
+}
+
+inline size_t numDisponibilidadStress(const InputData &data) {
+  size_t n = 0;
+  for (const auto &[medico, dias] : data.disponibilidad) {
+    n += dias.size();
+  }
+  return n;
+}
+
+// Quita las entradas [i, j) de la disponibilidad, en el orden del mapa
+inline void quitarDisponibilidadStress(InputData &data, size_t i, size_t j) {
+  size_t k = 0;
+  for (auto &[medico, dias] : data.disponibilidad) {
+    size_t inicio = std::clamp(i, k, k + dias.size()) - k;
+    size_t fin = std::clamp(j, k, k + dias.size()) - k;
+    k += dias.size();
+    dias.erase(dias.begin() + inicio, dias.begin() + fin);
+  }
+}
+
+using FallaStress = std::function<bool(const InputData &)>;
+
+// Vacía los campos; false si ya lo estaban todos
+template <typename... Campos> bool vaciarStress(Campos &...campos) {
+  bool habia = (!campos.empty() || ...);
+  (campos.clear(), ...);
+  return habia;
+}
+
+// Quita bloques de `contar(data)` elementos (mitades, cuartos, ... hasta de
+// uno en uno) mientras la instancia siga fallando
+inline bool reducirBloquesStress(
+    InputData &data, const std::function<size_t(const InputData &)> &contar,
+    const std::function<void(InputData &, size_t, size_t)> &quitar,
+    const FallaStress &falla) {
+  bool reducido = false;
+  for (size_t bloque = std::max<size_t>(contar(data) / 2, 1);;
+       bloque /= 2) {
+    for (size_t i = 0; i < contar(data);) {
+      InputData candidata = data;
+      quitar(candidata, i, std::min(i + bloque, contar(data)));
+      if (falla(candidata)) {
+        data = std::move(candidata);
+        reducido = true;
+      } else {
+        i += bloque;
+      }
+    }
+    if (bloque <= 1) {
+      return reducido;
+    }
+  }
+}
+
+/**
+ * Reduce `data` mientras `falla` se siga cumpliendo: quita los campos
+ * opcionales, luego médicos, días, periodos y entradas de disponibilidad
+ * por bloques, y repite hasta que no se puede quitar nada más. Devuelve la
+ * instancia mínima encontrada (localmente: quitar cualquier elemento más
+ * hace que deje de fallar).
+ */
+inline InputData reducirStress(InputData data, const FallaStress &falla) {
+  // Cada una vacía un campo opcional; false si ya estaba vacío
+  std::vector<std::function<bool(InputData &)>> opcionales = {
+      [](InputData &d) { return vaciarStress(d.personalCapacities); },
+      [](InputData &d) { return vaciarStress(d.capacidadesPorPeriodo); },
+      [](InputData &d) { return vaciarStress(d.asignacionesFijas); },
+      [](InputData &d) { return vaciarStress(d.asignacionesPrevias); },
+      [](InputData &d) { return vaciarStress(d.prioridadDias); },
+      [](InputData &d) { return vaciarStress(d.roles, d.demandaPorRol); },
+      [](InputData &d) {
+        return vaciarStress(d.demandaPorTurno, d.disponibilidadPorTurno);
+      }};
+
+  bool cambio = true;
+  while (cambio) {
+    cambio = false;
+    for (const auto &vaciar : opcionales) {
+      InputData candidata = data;
+      if (vaciar(candidata) && falla(candidata)) {
+        data = std::move(candidata);
+        cambio = true;
+      }
+    }
+    cambio |= reducirBloquesStress(
+        data, [](const InputData &d) { return d.medicos.size(); },
+        quitarMedicosStress, falla);
+    cambio |= reducirBloquesStress(
+        data, [](const InputData &d) { return d.dias.size(); },
+        quitarDiasStress, falla);
+    cambio |= reducirBloquesStress(
+        data, [](const InputData &d) { return d.periodos.size(); },
+        quitarPeriodosStress, falla);
+    cambio |= reducirBloquesStress(data, numDisponibilidadStress,
+                                   quitarDisponibilidadStress, falla);
+  }
+  return data;
+}
+
+#endif
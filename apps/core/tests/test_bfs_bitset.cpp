@@ -0,0 +1,171 @@
+/**
+ * Tests unitarios para la BFS sobre bitsets
+ * Verifica que camino() da los mismos padres que una BFS con cola FIFO, en
+ * ambas direcciones, y que alcanzables() da el mismo conjunto
+ */
+
+#include "bfs_bitset.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+// BFS de referencia: cola FIFO, vecinos en orden ascendente
+bool caminoReferencia(const Graph &g, int source, int sink,
+                      std::vector<int> &parent, std::vector<int> &orden) {
+  int n = g.getNumVertices();
+  std::vector<bool> visto(n, false);
+  orden.assign(1, source);
+  visto[source] = true;
+  parent[source] = -1;
+  for (size_t head = 0; head < orden.size(); head++) {
+    int u = orden[head];
+    for (int v = 0; v < n; v++) {
+      if (!visto[v] && g.getCapacity(u, v) > 0) {
+        visto[v] = true;
+        parent[v] = u;
+        orden.push_back(v);
+        if (v == sink) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+std::vector<int> camino(const std::vector<int> &parent, int sink) {
+  std::vector<int> nodos;
+  for (int v = sink; v != -1; v = parent[v]) {
+    nodos.push_back(v);
+  }
+  return nodos;
+}
+
+} // namespace
+
+// Test: Mismos caminos que la BFS FIFO en grafos aleatorios
+void test_bfs_igual_a_fifo() {
+  std::cout << "\n=== Test: BFS Bitset Igual a FIFO ===\n";
+
+  std::mt19937 rng(7);
+  BfsBitset bfs;
+  int distintos = 0;
+  int conjuntosDistintos = 0;
+  bool huboAbajoArriba = false;
+  for (int it = 0; it < 300; it++) {
+    int n = 2 + rng() % 150;
+    double densidad = (rng() % 100) / 400.0;
+    Graph g(n);
+    for (int u = 0; u < n; u++) {
+      for (int v = 0; v < n; v++) {
+        if (u != v && (rng() % 1000) < densidad * 1000) {
+          g.addEdge(u, v, 1 + rng() % 3);
+        }
+      }
+    }
+    int source = rng() % n;
+    int sink = rng() % n;
+
+    std::vector<int> esperado(n, -2), obtenido(n, -2), orden;
+    bool hayRef = caminoReferencia(g, source, sink, esperado, orden);
+    bool hay = bfs.camino(g, source, sink, obtenido);
+    huboAbajoArriba = huboAbajoArriba || bfs.getNivelesAbajoArriba() > 0;
+    if (hay != hayRef || (hay && camino(obtenido, sink) !=
+                                     camino(esperado, sink))) {
+      distintos++;
+    }
+
+    caminoReferencia(g, source, -1, esperado, orden);
+    std::vector<int> alcanzados = bfs.alcanzables(g, source);
+    std::sort(orden.begin(), orden.end());
+    std::sort(alcanzados.begin(), alcanzados.end());
+    if (orden != alcanzados) {
+      conjuntosDistintos++;
+    }
+  }
+  printResult("Mismos caminos en 300 grafos", distintos == 0);
+  printResult("Mismos alcanzables en 300 grafos", conjuntosDistintos == 0);
+  printResult("Algún nivel se recorrió de abajo hacia arriba",
+              huboAbajoArriba);
+}
+
+// Test: En una capa ancha se cambia a abajo-arriba y el padre es el primero
+void test_bfs_capa_ancha() {
+  std::cout << "\n=== Test: BFS Capa Ancha ===\n";
+
+  // 0 -> {1..100} -> 101 -> 102; 101 tiene arcos desde 60 y 30 (en ese orden
+  // de cola el primero es 30)
+  Graph g(103);
+  for (int v = 1; v <= 100; v++) {
+    g.addEdge(0, v, 1);
+  }
+  g.addEdge(60, 101, 1);
+  g.addEdge(30, 101, 1);
+  g.addEdge(101, 102, 1);
+
+  BfsBitset bfs;
+  std::vector<int> parent(103, -2);
+  printResult("Camino encontrado", bfs.camino(g, 0, 102, parent));
+  printResult("Nivel de la capa ancha de abajo hacia arriba",
+              bfs.getNivelesAbajoArriba() > 0);
+  printResult("Padre = primero en la cola",
+              parent[102] == 101 && parent[101] == 30 && parent[30] == 0);
+
+  printResult("Source = sink no es un camino",
+              !bfs.camino(g, 5, 5, parent));
+  printResult("Desde una hoja solo ella misma",
+              bfs.alcanzables(g, 102).size() == 1);
+}
+
+// Test: Grafos de más de 4096 vértices (resumen de varias palabras), con
+// arcos que se añaden y se vuelven a quitar
+void test_bfs_resumen() {
+  std::cout << "\n=== Test: BFS con Resumen de Filas ===\n";
+
+  std::mt19937 rng(11);
+  BfsBitset bfs;
+  int distintos = 0;
+  for (int it = 0; it < 4; it++) {
+    int n = 4500 + rng() % 1000;
+    Graph g(n);
+    for (int u = 0; u < n; u++) {
+      for (int k = 0; k < 3; k++) {
+        int v = rng() % n;
+        if (v != u) {
+          g.addEdge(u, v, 1);
+          if (rng() % 3 == 0) {
+            g.setCapacity(u, v, 0);
+          }
+        }
+      }
+    }
+    int source = rng() % n;
+    int sink = rng() % n;
+
+    std::vector<int> esperado(n, -2), obtenido(n, -2), orden;
+    bool hayRef = caminoReferencia(g, source, sink, esperado, orden);
+    bool hay = bfs.camino(g, source, sink, obtenido);
+    if (hay != hayRef || (hay && camino(obtenido, sink) !=
+                                     camino(esperado, sink))) {
+      distintos++;
+    }
+  }
+  printResult("Resumen de dos palabras", Graph(4500).getPalabrasResumen() == 2);
+  printResult("Mismos caminos en 4 grafos grandes", distintos == 0);
+  printResult("Se leyeron palabras", bfs.getPalabrasLeidas() > 0);
+}
+
+// Runner para tests de la BFS sobre bitsets
+void run_bfs_bitset_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║       Tests Unitarios: BFS Bitset          ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_bfs_igual_a_fifo();
+  test_bfs_capa_ancha();
+  test_bfs_resumen();
+}
@@ -0,0 +1,180 @@
+/**
+ * Tests unitarios para el formato binario de instancias
+ * Verifica ida y vuelta JSON -> .bin -> mmap y que el resultado no cambie
+ */
+
+#include "binary_instance.h"
+#include "json_parser.h"
+#include "solver_context.h"
+#include "test_utils.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+const std::string RUTA_BIN = "build/test_instancia.bin";
+
+InputData instanciaEjemplo() {
+  return JSONParser::parseInput(R"({
+    "medicos": ["Ana", "Luis", "Carla"],
+    "dias": ["D1", "D2", "D3", "D4"],
+    "periodos": [{"id": "P1", "dias": ["D1", "D2"]},
+                 {"id": "P2", "dias": ["D3", "D4"]}],
+    "disponibilidad": {"Ana": ["D1", "D3", "X9"], "Luis": ["D2", "D4"]},
+    "maxGuardiasPorPeriodo": 1,
+    "maxGuardiasTotales": 2,
+    "medicosPorDia": {"D1": 1, "D2": 1, "D3": 2, "D4": 1},
+    "capacidades": {"Luis": 1},
+    "capacidadesPorPeriodo": {"Ana": {"P2": 0}, "Carla": {"P1": 2}},
+    "asignacionesFijas": {"Luis": ["D4", "D2", "X9"]},
+    "asignacionesPrevias": {"Carla": ["D3", "D1"]},
+    "prioridadDias": {"D4": 7, "X9": 3},
+    "roles": {"Ana": "uci", "Luis": "anestesia", "X9": "uci"},
+    "demandaPorRol": {"D3": {"uci": 1, "anestesia": 1}, "X9": {"uci": 1}},
+    "demandaPorTurno": {"D1": {"noche": 1, "dia": 2}},
+    "disponibilidadPorTurno": {"Ana": {"D1": ["noche", "tarde"]}}
+  })");
+}
+
+} // namespace
+
+// Test: Ida y vuelta conserva los datos
+void test_binario_ida_y_vuelta() {
+  std::cout << "\n=== Test: Binario Ida y Vuelta ===\n";
+
+  InternedInstance original;
+  JSONParser::internInput(instanciaEjemplo(), original);
+  BinaryInstance::write(original.view(), RUTA_BIN);
+
+  printResult("Archivo reconocido como binario",
+              BinaryInstance::esBinario(RUTA_BIN));
+  printResult("JSON no reconocido como binario",
+              !BinaryInstance::esBinario("data/ejemplo.json"));
+
+  BinaryInstance bin(RUTA_BIN);
+  const InstanceView &v = bin.view();
+
+  printResult("3 médicos, 4 días, 2 periodos",
+              v.numMedicos == 3 && v.numDias == 4 && v.numPeriodos == 2);
+  printResult("Nombres conservados", v.medico(2) == "Carla" &&
+                                         v.dia(3) == "D4" &&
+                                         v.periodo(1) == "P2");
+  printResult("Disponibilidad conservada",
+              v.disponible(0, 0) && v.disponible(0, 2) && !v.disponible(0, 1));
+  printResult("Días fuera de la instancia cuentan para la capacidad",
+              v.diasDisponibles[0] == 3);
+  printResult("Periodo P2 = {D3, D4}",
+              v.periodoOffsets[2] - v.periodoOffsets[1] == 2 &&
+                  v.periodoDias[v.periodoOffsets[1]] == 2);
+  printResult("Capacidad personal y límite global",
+              v.limite(1) == 1 && v.limite(0) == 2);
+  printResult("Médicos por día conservados", v.medicosPorDia[2] == 2);
+  printResult("Capacidades por periodo conservadas",
+              v.limitePeriodo(0, 1) == 0 && v.limitePeriodo(0, 0) == 1 &&
+                  v.limitePeriodo(2, 0) == 2 && v.limitePeriodo(1, 0) == 1);
+  printResult("Asignaciones fijas conservadas y ordenadas",
+              v.numFijas == 2 && v.fijas[0] == 1 && v.fijas[1] == 1 &&
+                  v.fijas[3] == 3);
+  printResult("Prioridades conservadas",
+              v.prioridadDia != nullptr && v.prioridadDia[3] == 7 &&
+                  v.prioridadDia[0] == 0);
+  printResult("Asignaciones previas conservadas y ordenadas",
+              v.numPrevias == 2 && v.previas[0] == 2 && v.previas[1] == 0 &&
+                  v.previas[3] == 2);
+  printResult("Roles conservados y ordenados por nombre",
+              v.numRoles == 2 && v.rol(0) == "anestesia" &&
+                  v.rolMedico[0] == 1 && v.rolMedico[1] == 0 &&
+                  v.rolMedico[2] == -1);
+  printResult("Demanda por rol conservada",
+              v.numDemandasRol() == 2 && v.demandaRol(2, 0) >= 0 &&
+                  v.demandaRolValores[v.demandaRol(2, 1)] == 1 &&
+                  v.demandaRol(0, 1) == -1 && v.medicosPorDia[2] == 2);
+  printResult("Turnos conservados y ordenados por nombre",
+              v.numTurnos == 2 && v.turno(1) == "noche" &&
+                  v.numDemandasTurno() == 2 && v.tieneTurnos(0) &&
+                  !v.tieneTurnos(1) && v.medicosPorDia[0] == 3);
+  printResult("Restricción de turnos conservada",
+              v.turnoMedicoOffsets != nullptr && !v.puedeTurno(0, 0, 0) &&
+                  v.puedeTurno(0, 0, 1) && v.puedeTurno(1, 0, 0));
+}
+
+// Test: Resolver desde .bin da el mismo resultado que desde JSON
+void test_binario_mismo_resultado() {
+  std::cout << "\n=== Test: Binario Mismo Resultado ===\n";
+
+  InputData data = JSONParser::parseInputFromFile("data/ejemplo.json");
+  InternedInstance interned;
+  JSONParser::internInput(data, interned);
+  BinaryInstance::write(interned.view(), RUTA_BIN);
+
+  SolverContext desdeJson;
+  desdeJson.load(data);
+  std::string esperado = JSONParser::toJson(desdeJson.solve());
+
+  BinaryInstance bin(RUTA_BIN);
+  SolverContext desdeBin;
+  desdeBin.load(bin.view());
+  std::string obtenido = JSONParser::toJson(desdeBin.solve());
+
+  printResult("Mismo JSON de salida", esperado == obtenido);
+}
+
+// Test: Archivos corruptos se rechazan
+void test_binario_corrupto() {
+  std::cout << "\n=== Test: Binario Corrupto ===\n";
+
+  InternedInstance interned;
+  JSONParser::internInput(instanciaEjemplo(), interned);
+  BinaryInstance::write(interned.view(), RUTA_BIN);
+
+  std::string contenido;
+  {
+    std::ifstream in(RUTA_BIN, std::ios::binary);
+    contenido.assign(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+  }
+
+  auto rechaza = [&](const std::string &bytes) {
+    {
+      std::ofstream out(RUTA_BIN, std::ios::binary | std::ios::trunc);
+      out.write(bytes.data(), bytes.size());
+    }
+    try {
+      BinaryInstance bin(RUTA_BIN);
+    } catch (const std::runtime_error &) {
+      return true;
+    }
+    return false;
+  };
+
+  printResult("Archivo truncado rechazado",
+              rechaza(contenido.substr(0, contenido.size() / 2)));
+
+  std::string otraVersion = contenido;
+  otraVersion[4] = 99;
+  printResult("Versión desconocida rechazada", rechaza(otraVersion));
+
+  printResult("Archivo vacío rechazado", rechaza(""));
+  std::remove(RUTA_BIN.c_str());
+
+  bool lanzo = false;
+  try {
+    BinaryInstance bin("build/no_existe.bin");
+  } catch (const std::runtime_error &) {
+    lanzo = true;
+  }
+  printResult("Archivo inexistente lanza excepción", lanzo);
+}
+
+// Runner para tests del formato binario
+void run_binary_instance_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║       Tests Unitarios: Instancia Binaria   ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_binario_ida_y_vuelta();
+  test_binario_mismo_resultado();
+  test_binario_corrupto();
+}
@@ -0,0 +1,270 @@
+/**
+ * Tests unitarios para el motor Boykov-Kolmogorov dinámico
+ * Verifica que da el mismo flujo máximo y el mismo corte que Edmonds-Karp,
+ * desde cero y tras cambios de capacidades sobre los árboles anteriores, y
+ * que en SolverContext cada edición reanuda el solve anterior
+ */
+
+#include "boykov_kolmogorov.h"
+#include "edmonds_karp.h"
+#include "solver_context.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Capacidades respetadas y conservación en los nodos internos
+template <typename F>
+bool flujoValido(const Graph &g, const std::vector<std::vector<F>> &flujo,
+                 int source, int sink) {
+  int n = g.getNumVertices();
+  for (int u = 0; u < n; u++) {
+    int balance = 0;
+    for (int v = 0; v < n; v++) {
+      if (flujo[u][v] > g.getCapacity(u, v) || flujo[u][v] != -flujo[v][u]) {
+        return false;
+      }
+      balance += flujo[u][v];
+    }
+    if (u != source && u != sink && balance != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<int> ordenados(std::vector<int> nodos) {
+  std::sort(nodos.begin(), nodos.end());
+  return nodos;
+}
+
+// Grafo aleatorio sin arcos antiparalelos, como la red del builder
+Graph grafoAleatorio(std::mt19937 &rng, int n) {
+  Graph g(n);
+  for (int u = 0; u < n; u++) {
+    for (int v = u + 1; v < n; v++) {
+      if (rng() % 4 == 0) {
+        bool adelante = rng() % 3 != 0;
+        g.addEdge(adelante ? u : v, adelante ? v : u, 1 + rng() % 5);
+      }
+    }
+  }
+  return g;
+}
+
+} // namespace
+
+// Test: Desde cero, mismo flujo y mismo corte que Edmonds-Karp
+void test_bk_igual_a_ek() {
+  std::cout << "\n=== Test: Boykov-Kolmogorov Igual a Edmonds-Karp ===\n";
+
+  std::mt19937 rng(3);
+  EdmondsKarp ek;
+  BoykovKolmogorov bk;
+  int distintos = 0;
+  int invalidos = 0;
+  for (int it = 0; it < 200; it++) {
+    int n = 2 + rng() % 60;
+    Graph g = grafoAleatorio(rng, n);
+    Graph residualEk(0), residualBk(0);
+    std::vector<std::vector<int>> flujoEk, flujoBk;
+    int a = ek.maxFlow(g, 0, n - 1, residualEk, flujoEk);
+    int b = bk.maxFlow(g, 0, n - 1, residualBk, flujoBk);
+    if (a != b || ordenados(ek.getReachableResidual(residualEk, 0)) !=
+                      ordenados(ek.getReachableResidual(residualBk, 0))) {
+      distintos++;
+    }
+    invalidos += !flujoValido(g, flujoBk, 0, n - 1);
+
+    // Capacidades de hasta 5: el mismo flujo a 8 bits
+    GraphT<uint8_t> residual8(0);
+    MatrizFlujo<uint8_t> flujo8;
+    if (bk.maxFlow(g, 0, n - 1, residual8, flujo8) != b ||
+        !std::equal(flujo8.begin(), flujo8.end(), flujoBk.begin(),
+                    [](const auto &fila8, const auto &fila) {
+                      return std::equal(fila8.begin(), fila8.end(),
+                                        fila.begin());
+                    })) {
+      distintos++;
+    }
+  }
+  printResult("Mismo flujo y corte en 200 grafos (también a 8 bits)",
+              distintos == 0);
+  printResult("Flujos válidos", invalidos == 0);
+  printResult("Motor informado", std::string(bk.nombre()) ==
+                                     "boykov-kolmogorov");
+}
+
+// Test: Cambios de capacidad reanudan los árboles y el flujo anteriores
+void test_bk_dinamico() {
+  std::cout << "\n=== Test: Boykov-Kolmogorov Dinámico ===\n";
+
+  std::mt19937 rng(9);
+  EdmondsKarp ek;
+  BoykovKolmogorov bk;
+  int distintos = 0;
+  int invalidos = 0;
+  int sinReanudar = 0;
+  int cambiosMal = 0;
+  for (int it = 0; it < 40; it++) {
+    int n = 4 + rng() % 50;
+    Graph g = grafoAleatorio(rng, n);
+    Graph residual(0);
+    std::vector<std::vector<int>> flujo;
+    bk.maxFlow(g, 0, n - 1, residual, flujo);
+
+    for (int edicion = 0; edicion < 30; edicion++) {
+      // Subir, bajar, quitar o añadir arcos, respetando la orientación
+      int cambios = 1 + rng() % 3;
+      std::vector<std::pair<int, int>> tocados;
+      for (int c = 0; c < cambios; c++) {
+        int u = rng() % n;
+        int v = rng() % n;
+        if (u == v || g.getCapacity(v, u) > 0 ||
+            std::find(tocados.begin(), tocados.end(), std::make_pair(u, v)) !=
+                tocados.end()) {
+          continue;
+        }
+        int antes = g.getCapacity(u, v);
+        int despues = rng() % 3 == 0 ? 0 : 1 + rng() % 5;
+        if (despues != antes) {
+          g.setCapacity(u, v, despues);
+          tocados.emplace_back(u, v);
+        }
+      }
+
+      // Las ediciones impares dicen qué arcos tocaron
+      int valor = edicion % 2 == 0
+                      ? bk.maxFlowDesde(g, 0, n - 1, residual, flujo)
+                      : bk.maxFlowDesde(g, 0, n - 1, residual, flujo, tocados);
+      Graph residualEk(0);
+      std::vector<std::vector<int>> flujoEk;
+      int esperado = ek.maxFlow(g, 0, n - 1, residualEk, flujoEk);
+      if (valor != esperado ||
+          ordenados(ek.getReachableResidual(residual, 0)) !=
+              ordenados(ek.getReachableResidual(residualEk, 0))) {
+        distintos++;
+      }
+      invalidos += !flujoValido(g, flujo, 0, n - 1);
+      sinReanudar += !bk.getReanudado();
+      cambiosMal += bk.getArcosCambiados() != int(tocados.size());
+    }
+  }
+  printResult("Mismo flujo y corte tras 1200 ediciones", distintos == 0);
+  printResult("Flujos válidos", invalidos == 0);
+  printResult("Todas reanudan el solve anterior", sinReanudar == 0);
+  printResult("Detecta exactamente los arcos cambiados", cambiosMal == 0);
+
+  // Otro tamaño no puede reanudar: empieza de cero
+  Graph otro = grafoAleatorio(rng, 10);
+  Graph residual(0);
+  std::vector<std::vector<int>> flujo;
+  bk.maxFlowDesde(otro, 0, 9, residual, flujo);
+  printResult("Otra red empieza de cero", !bk.getReanudado());
+}
+
+// Test: En SolverContext, alternar la disponibilidad de un médico reanuda
+// el solve anterior con la misma cobertura que un solve desde cero
+void test_bk_ediciones_interactivas() {
+  std::cout << "\n=== Test: Ediciones Interactivas ===\n";
+
+  InputData data;
+  std::mt19937 rng(4);
+  for (int m = 0; m < 60; m++) {
+    data.medicos.push_back("M" + std::to_string(m));
+  }
+  for (int d = 0; d < 120; d++) {
+    data.dias.push_back("D" + std::to_string(d));
+    data.medicosPorDia[data.dias.back()] = 2;
+  }
+  for (int p = 0; p < 4; p++) {
+    Periodo periodo;
+    periodo.id = "P" + std::to_string(p);
+    for (int d = p * 30; d < (p + 1) * 30; d++) {
+      periodo.dias.push_back(data.dias[d]);
+    }
+    data.periodos.push_back(periodo);
+  }
+  for (const auto &medico : data.medicos) {
+    for (const auto &dia : data.dias) {
+      if (rng() % 4 == 0) {
+        data.disponibilidad[medico].push_back(dia);
+      }
+    }
+  }
+  data.maxGuardiasPorPeriodo = 2;
+  data.maxGuardiasTotales = 3; // 180 guardias para 240 plazas
+
+  SolverContext dinamico;
+  dinamico.setMotor("boykov-kolmogorov");
+  SolverContext ek;
+  dinamico.load(data);
+  ResultadoAsignacion primero = dinamico.solve();
+  printResult("Primer solve desde cero", !dinamico.getFlujoReutilizado());
+
+  int distintos = 0;
+  int sinReanudar = 0;
+  double msDinamico = 0, msEk = 0;
+  for (int edicion = 0; edicion < 40; edicion++) {
+    // Quitar o devolver un día disponible de un médico
+    auto &dias = data.disponibilidad[data.medicos[rng() % 60]];
+    std::string dia = data.dias[rng() % 120];
+    auto it = std::find(dias.begin(), dias.end(), dia);
+    if (it != dias.end()) {
+      dias.erase(it);
+    } else {
+      dias.push_back(dia);
+    }
+
+    auto inicio = std::chrono::steady_clock::now();
+    dinamico.load(data);
+    ResultadoAsignacion a = dinamico.solve();
+    auto medio = std::chrono::steady_clock::now();
+    ek.load(data);
+    ResultadoAsignacion b = ek.solve();
+    auto fin = std::chrono::steady_clock::now();
+    msDinamico += std::chrono::duration<double, std::milli>(medio - inicio)
+                      .count();
+    msEk += std::chrono::duration<double, std::milli>(fin - medio).count();
+
+    bool mismos = a.diasCubiertos == b.diasCubiertos &&
+                  a.bottlenecks.size() == b.bottlenecks.size();
+    for (size_t i = 0; mismos && i < a.bottlenecks.size(); i++) {
+      mismos = a.bottlenecks[i].id == b.bottlenecks[i].id &&
+               a.bottlenecks[i].razon == b.bottlenecks[i].razon;
+    }
+    distintos += !mismos || dinamico.getMaxFlow() != ek.getMaxFlow();
+    sinReanudar += !dinamico.getFlujoReutilizado();
+  }
+  std::cout << "  Por edición: " << msDinamico / 40 << " ms (dinámico), "
+            << msEk / 40 << " ms (Edmonds-Karp)\n";
+  printResult("Instancia no factible", !primero.factible);
+  printResult("Misma cobertura y bottlenecks en 40 ediciones",
+              distintos == 0);
+  printResult("Cada edición reanuda el solve anterior", sinReanudar == 0);
+
+  // Un solve de otro tipo entre medias invalida los árboles
+  data.prioridadDias[data.dias[0]] = 1;
+  dinamico.load(data);
+  dinamico.solve();
+  data.prioridadDias.clear();
+  dinamico.load(data);
+  dinamico.solve();
+  printResult("Tras un solve por prioridades empieza de cero",
+              !dinamico.getFlujoReutilizado());
+}
+
+// Runner para tests del motor Boykov-Kolmogorov
+void run_boykov_kolmogorov_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║    Tests Unitarios: Boykov-Kolmogorov      ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_bk_igual_a_ek();
+  test_bk_dinamico();
+  test_bk_ediciones_interactivas();
+}
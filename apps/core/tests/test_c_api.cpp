@@ -0,0 +1,182 @@
+/**
+ * Tests unitarios para la API C (libmaxflow)
+ * Ejercita el ciclo create -> load -> solve -> leer resultado -> free
+ */
+
+#include "maxflow.h"
+#include "test_utils.h"
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Test: Carga por JSON y lectura de asignaciones
+void test_c_api_json() {
+  std::cout << "\n=== Test: API C con JSON ===\n";
+
+  const char *json = R"({
+    "medicos": ["Ana", "Luis"],
+    "dias": ["D1", "D2"],
+    "periodos": [{"id": "P1", "dias": ["D1", "D2"]}],
+    "disponibilidad": {"Ana": ["D1"], "Luis": ["D2"]},
+    "maxGuardiasPorPeriodo": 1,
+    "medicosPorDia": 1
+  })";
+
+  maxflow_context *ctx = maxflow_context_create();
+  printResult("Contexto creado", ctx != nullptr);
+  printResult("Versión de ABI", maxflow_abi_version() == MAXFLOW_ABI_VERSION);
+
+  printResult("load_json OK",
+              maxflow_load_json(ctx, json, std::strlen(json)) == MAXFLOW_OK);
+  printResult("solve OK", maxflow_solve(ctx) == MAXFLOW_OK);
+  printResult("Factible", maxflow_factible(ctx) == 1);
+  printResult("2 días cubiertos", maxflow_dias_cubiertos(ctx) == 2);
+  printResult("2 asignaciones", maxflow_num_asignaciones(ctx) == 2);
+
+  bool anaEnD1 = false;
+  for (size_t i = 0; i < maxflow_num_asignaciones(ctx); i++) {
+    const char *medico = nullptr;
+    const char *dia = nullptr;
+    maxflow_get_asignacion(ctx, i, &medico, &dia);
+    if (std::string(medico) == "Ana" && std::string(dia) == "D1") {
+      anaEnD1 = true;
+    }
+  }
+  printResult("Ana asignada a D1", anaEnD1);
+  printResult("Índice fuera de rango rechazado",
+              maxflow_get_asignacion(ctx, 99, nullptr, nullptr) ==
+                  MAXFLOW_ERROR_ARGUMENT);
+
+  const char *resultJson = maxflow_result_json(ctx);
+  printResult("JSON de resultado disponible",
+              resultJson != nullptr &&
+                  std::string(resultJson).find("\"factible\": true") !=
+                      std::string::npos);
+
+  maxflow_context_free(ctx);
+}
+
+// Test: Carga por arreglos estructurados con instancia no factible
+void test_c_api_instancia() {
+  std::cout << "\n=== Test: API C con Arreglos ===\n";
+
+  const char *medicos[] = {"M1"};
+  const char *dias[] = {"D1", "D2"};
+  const char *periodos[] = {"P1"};
+  uint32_t periodoOffsets[] = {0, 2};
+  uint32_t periodoDias[] = {0, 1};
+  uint32_t dispOffsets[] = {0, 1};
+  uint32_t dispDias[] = {0};
+
+  maxflow_instancia inst = {};
+  inst.medicos = medicos;
+  inst.num_medicos = 1;
+  inst.dias = dias;
+  inst.num_dias = 2;
+  inst.periodo_ids = periodos;
+  inst.num_periodos = 1;
+  inst.periodo_offsets = periodoOffsets;
+  inst.periodo_dias = periodoDias;
+  inst.disponibilidad_offsets = dispOffsets;
+  inst.disponibilidad_dias = dispDias;
+  inst.max_guardias_por_periodo = 2;
+  inst.max_guardias_totales = 5;
+
+  maxflow_context *ctx = maxflow_context_create();
+  printResult("load_instancia OK",
+              maxflow_load_instancia(ctx, &inst) == MAXFLOW_OK);
+  printResult("solve OK", maxflow_solve(ctx) == MAXFLOW_OK);
+  printResult("No factible", maxflow_factible(ctx) == 0);
+  printResult("1 de 2 días cubiertos", maxflow_dias_cubiertos(ctx) == 1 &&
+                                           maxflow_dias_requeridos(ctx) == 2);
+
+  bool d2Bottleneck = false;
+  for (size_t i = 0; i < maxflow_num_bottlenecks(ctx); i++) {
+    const char *tipo = nullptr;
+    const char *id = nullptr;
+    maxflow_get_bottleneck(ctx, i, &tipo, &id, nullptr);
+    if (std::string(tipo) == "Day" && std::string(id) == "D2") {
+      d2Bottleneck = true;
+    }
+  }
+  printResult("Bottleneck en D2", d2Bottleneck);
+
+  // Índice de día inválido
+  uint32_t malos[] = {7};
+  inst.disponibilidad_dias = malos;
+  printResult("Índice de día inválido rechazado",
+              maxflow_load_instancia(ctx, &inst) == MAXFLOW_ERROR_INPUT);
+  printResult("Mensaje de error disponible",
+              std::strlen(maxflow_last_error(ctx)) > 0);
+
+  // Nombres NULL
+  inst.disponibilidad_dias = dispDias;
+  const char *sinNombre[] = {nullptr};
+  inst.medicos = sinNombre;
+  printResult("Médico NULL -> ERROR_ARGUMENT",
+              maxflow_load_instancia(ctx, &inst) == MAXFLOW_ERROR_ARGUMENT);
+  inst.medicos = medicos;
+  const char *diaNulo[] = {"D1", nullptr};
+  inst.dias = diaNulo;
+  printResult("Día NULL -> ERROR_ARGUMENT",
+              maxflow_load_instancia(ctx, &inst) == MAXFLOW_ERROR_ARGUMENT);
+  inst.dias = dias;
+  inst.periodo_ids = sinNombre;
+  printResult("Periodo NULL -> ERROR_ARGUMENT",
+              maxflow_load_instancia(ctx, &inst) == MAXFLOW_ERROR_ARGUMENT);
+  inst.periodo_ids = periodos;
+  printResult("Con los nombres de nuevo, load_instancia OK",
+              maxflow_load_instancia(ctx, &inst) == MAXFLOW_OK);
+
+  maxflow_context_free(ctx);
+}
+
+// Test: Errores de estado y de entrada
+void test_c_api_errores() {
+  std::cout << "\n=== Test: API C Errores ===\n";
+
+  maxflow_context *ctx = maxflow_context_create();
+  printResult("solve sin load -> ERROR_STATE",
+              maxflow_solve(ctx) == MAXFLOW_ERROR_STATE);
+  printResult("result_json sin solve -> NULL",
+              maxflow_result_json(ctx) == nullptr);
+
+  const char *roto = "{ no es json";
+  printResult("JSON inválido -> ERROR_INPUT",
+              maxflow_load_json(ctx, roto, std::strlen(roto)) ==
+                  MAXFLOW_ERROR_INPUT);
+  printResult("Tras un load fallido no queda instancia cargada",
+              maxflow_solve(ctx) == MAXFLOW_ERROR_STATE);
+  printResult("NULL -> ERROR_ARGUMENT",
+              maxflow_load_json(nullptr, roto, 1) == MAXFLOW_ERROR_ARGUMENT);
+
+  // Campos que no se combinan: se detecta al resolver, pero es de entrada
+  const char *combinados = R"({
+    "medicos": ["Ana"],
+    "dias": ["D1"],
+    "periodos": [{"id": "P1", "dias": ["D1"]}],
+    "disponibilidad": {"Ana": ["D1"]},
+    "asignacionesFijas": {"Ana": ["D1"]},
+    "prioridadDias": {"D1": 2}
+  })";
+  printResult("load_json con fijas y prioridades OK",
+              maxflow_load_json(ctx, combinados, std::strlen(combinados)) ==
+                  MAXFLOW_OK);
+  printResult("Fijas con prioridades -> ERROR_INPUT",
+              maxflow_solve(ctx) == MAXFLOW_ERROR_INPUT &&
+                  std::strstr(maxflow_last_error(ctx), "prioridadDias") !=
+                      nullptr);
+
+  maxflow_context_free(ctx);
+}
+
+// Runner para tests de la API C
+void run_c_api_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║       Tests Unitarios: API C               ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_c_api_json();
+  test_c_api_instancia();
+  test_c_api_errores();
+}
@@ -0,0 +1,220 @@
+/**
+ * Tests unitarios para el certificado de optimalidad (--verify)
+ * Verifica que acepta los flujos máximos con su corte mínimo, que rechaza
+ * flujos alterados, no máximos o con un corte que no corresponde, y que
+ * los resultados de todos los motores y tipos de solve lo cumplen
+ */
+
+#include "certificado.h"
+#include "edmonds_karp.h"
+#include "solver_context.h"
+#include "stress_utils.h"
+#include "test_utils.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Test: Un flujo máximo con su corte mínimo cumple; alterado, no
+void test_certificado_red_pequena() {
+  std::cout << "\n=== Test: Certificado en Red Pequeña ===\n";
+
+  // s=0 -> 1, 2 -> 3 -> t=5, y 1 -> 4 -> 5 (flujo máximo 5)
+  Graph g(6);
+  g.addEdge(0, 1, 3);
+  g.addEdge(0, 2, 4);
+  g.addEdge(1, 3, 2);
+  g.addEdge(2, 3, 2);
+  g.addEdge(1, 4, 2);
+  g.addEdge(3, 5, 3);
+  g.addEdge(4, 5, 2);
+
+  EdmondsKarp ek;
+  Graph residual(0);
+  std::vector<std::vector<int>> flujo;
+  int valor = ek.maxFlow(g, 0, 5, residual, flujo);
+  std::vector<int> corte = ek.getReachableResidual(residual, 0);
+
+  Certificado certificado;
+  printResult("Flujo máximo y corte mínimo cumplen",
+              certificado.verificar(g, flujo, 0, 5, valor, corte) &&
+                  certificado.getError().empty());
+
+  printResult("Valor distinto rechazado",
+              !certificado.verificar(g, flujo, 0, 5, valor - 1, corte) &&
+                  !certificado.getError().empty());
+
+  printResult("Corte que no es mínimo rechazado",
+              !certificado.verificar(g, flujo, 0, 5, valor, {0}));
+
+  printResult("Corte que no separa rechazado",
+              !certificado.verificar(g, flujo, 0, 5, valor,
+                                     {0, 1, 2, 3, 4, 5}));
+
+  auto alterado = flujo;
+  alterado[0][2]++;
+  alterado[2][0]--;
+  printResult("Conservación rota rechazada",
+              !certificado.verificar(g, alterado, 0, 5, valor, corte));
+
+  alterado = flujo;
+  alterado[3][5] = 4;
+  alterado[5][3] = -4;
+  alterado[2][3] = 3;
+  alterado[3][2] = -3;
+  printResult("Capacidad excedida rechazada",
+              !certificado.verificar(g, alterado, 0, 5, valor, corte));
+
+  alterado = flujo;
+  alterado[1][3] = -alterado[3][1] + 1;
+  printResult("Matriz no antisimétrica rechazada",
+              !certificado.verificar(g, alterado, 0, 5, valor, corte));
+
+  // Flujo nulo: válido pero no máximo, ningún corte lo certifica
+  std::vector<std::vector<int>> nulo(6, std::vector<int>(6, 0));
+  printResult("Flujo no máximo rechazado",
+              !certificado.verificar(g, nulo, 0, 5, 0, corte) &&
+                  !certificado.verificar(g, nulo, 0, 5, 0, {0}));
+
+  // Cota inferior: el corte descuenta la de los arcos que entran en él
+  Certificado conCotas;
+  conCotas.iniciar(3, 0, 2, 1, {0, 1});
+  conCotas.arco(0, 1, 2, 2);
+  conCotas.arco(1, 2, 2, 2);
+  conCotas.arco(2, 1, 2, 1, 1);
+  conCotas.arco(1, 0, 1, 1);
+  printResult("Cotas inferiores en el corte", conCotas.cumple());
+  conCotas.iniciar(2, 0, 1, 0, {0});
+  conCotas.arco(0, 1, 2, 0, 1);
+  printResult("Flujo bajo la cota rechazado", !conCotas.cumple());
+}
+
+// Test: Todos los motores y tipos de solve cumplen el certificado
+void test_certificado_motores() {
+  std::cout << "\n=== Test: Certificado de Todos los Motores ===\n";
+
+  std::mt19937 rng(21);
+  const char *motores[] = {"edmonds-karp", "push-relabel", "implicit",
+                           "boykov-kolmogorov"};
+  std::vector<SolverContext> contextos(5);
+  for (int i = 0; i < 4; i++) {
+    contextos[i].setMotor(motores[i]);
+  }
+  contextos[4].setRenumerar(true);
+  contextos[4].setReutilizarFlujo(true);
+  for (auto &c : contextos) {
+    c.setVerificar(true);
+  }
+
+  int fallos = 0;
+  int solves = 0;
+  int noFactibles = 0;
+  std::string primerFallo;
+  for (int it = 0; it < 200; it++) {
+    // A veces con fijas, previas o prioridades
+    InputData data = instanciaStress(rng, 8, 12);
+
+    for (auto &c : contextos) {
+      try {
+        c.load(data);
+        noFactibles += !c.solve().factible;
+        solves++;
+      } catch (const std::runtime_error &e) {
+        fallos++;
+        if (primerFallo.empty()) {
+          primerFallo = e.what();
+        }
+      }
+    }
+  }
+  if (!primerFallo.empty()) {
+    std::cout << "  " << primerFallo << "\n";
+  }
+  printResult("1000 solves certificados", fallos == 0 && solves == 1000);
+  printResult("Hubo instancias no factibles", noFactibles > 0);
+
+  // Un resultado cortado por el plazo no es máximo: no se comprueba
+  SolverContext conPlazo;
+  conPlazo.setVerificar(true);
+  conPlazo.setDeadline(Deadline(Deadline::Reloj::now()));
+  bool lanza = false;
+  try {
+    conPlazo.load(instanciaStress(rng, 8, 12));
+    conPlazo.solve();
+  } catch (const std::runtime_error &) {
+    lanza = true;
+  }
+  printResult("Resultado parcial sin comprobar", !lanza);
+}
+
+// Test: Comprobar cuesta poco frente al solve
+void test_certificado_coste() {
+  std::cout << "\n=== Test: Coste del Certificado ===\n";
+
+  InputData data;
+  std::mt19937 rng(5);
+  for (int m = 0; m < 120; m++) {
+    data.medicos.push_back("M" + std::to_string(m));
+  }
+  for (int d = 0; d < 365; d++) {
+    data.dias.push_back("D" + std::to_string(d));
+    data.medicosPorDia[data.dias.back()] = 4; // 1460 plazas para 1440
+  }
+  for (int p = 0; p < 12; p++) {
+    Periodo periodo;
+    periodo.id = "P" + std::to_string(p);
+    for (int d = p * 365 / 12; d < (p + 1) * 365 / 12; d++) {
+      periodo.dias.push_back(data.dias[d]);
+    }
+    data.periodos.push_back(periodo);
+  }
+  for (const auto &medico : data.medicos) {
+    for (const auto &dia : data.dias) {
+      if (rng() % 3 != 0) {
+        data.disponibilidad[medico].push_back(dia);
+      }
+    }
+  }
+  data.maxGuardiasPorPeriodo = 1;
+  data.maxGuardiasTotales = 12;
+
+  SolverContext context;
+  context.load(data);
+  ResultadoAsignacion resultado = context.solve();
+
+  EdmondsKarp ek;
+  Graph residual(0);
+  std::vector<std::vector<int>> flujo;
+  const Graph &g = context.getGraph();
+  int source = context.getBuilder().getSource();
+  int sink = context.getBuilder().getSink();
+  auto inicio = std::chrono::steady_clock::now();
+  int valor = ek.maxFlow(g, source, sink, residual, flujo);
+  auto medio = std::chrono::steady_clock::now();
+  Certificado certificado;
+  bool cumple = certificado.verificar(g, flujo, source, sink, valor,
+                                      ek.getReachableResidual(residual,
+                                                              source));
+  auto fin = std::chrono::steady_clock::now();
+
+  double msSolve =
+      std::chrono::duration<double, std::milli>(medio - inicio).count();
+  double msCertificado =
+      std::chrono::duration<double, std::milli>(fin - medio).count();
+  std::cout << "  Max-flow: " << msSolve << " ms, corte y certificado: "
+            << msCertificado << " ms\n";
+  printResult("Instancia no factible", !resultado.factible);
+  printResult("Certificado del flujo máximo", cumple);
+}
+
+// Runner para tests del certificado de optimalidad
+void run_certificado_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║  Tests Unitarios: Certificado Optimalidad  ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_certificado_red_pequena();
+  test_certificado_motores();
+  test_certificado_coste();
+}
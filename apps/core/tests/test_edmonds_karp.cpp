@@ -5,8 +5,26 @@
 
 #include "edmonds_karp.h"
 #include "graph.h"
+#include "min_cost_flow.h"
 #include "test_utils.h"
+#include <algorithm>
 #include <iostream>
+#include <random>
+
+// Mismas matrices de flujo, aunque sean de distinto ancho
+template <typename A, typename B>
+bool mismoFlujo(const std::vector<std::vector<A>> &a,
+                const std::vector<std::vector<B>> &b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t u = 0; u < a.size(); u++) {
+    if (!std::equal(a[u].begin(), a[u].end(), b[u].begin(), b[u].end())) {
+      return false;
+    }
+  }
+  return true;
+}
 
 // Test: Flujo simple (una ruta)
 void test_flujo_simple() {
@@ -135,6 +153,335 @@ void test_source_igual_sink() {
   printResult("Flujo source=sink = 0", flow == 0);
 }
 
+// Test: Cotas inferiores fuerzan flujo por una arista
+void test_cotas_inferiores() {
+  std::cout << "\n=== Test: Cotas Inferiores ===\n";
+
+  // 0 -> 1 -> 3 y 0 -> 2 -> 3, pero 0 tiene capacidad total 1 por cada rama
+  // y la arista 2 -> 3 debe llevar al menos 1
+  Graph g(4);
+  g.addEdge(0, 1, 1);
+  g.addEdge(0, 2, 1);
+  g.addEdge(1, 3, 1);
+  g.addEdge(2, 3, 1);
+
+  EdmondsKarp ek;
+  Graph residual(0);
+  std::vector<std::vector<int>> flowGraph;
+  std::vector<size_t> insatisfechas;
+
+  int flujo = ek.maxFlowConCotas(g, 0, 3, {{2, 3, 1}}, residual, flowGraph,
+                                 insatisfechas);
+  printResult("Flujo máximo = 2", flujo == 2);
+  printResult("La arista acotada lleva flujo", flowGraph[2][3] == 1);
+  printResult("Residual inverso respeta la cota",
+              residual.getCapacity(3, 2) == 0);
+
+  // Dos aristas acotadas que compiten por la misma capacidad de entrada
+  Graph h(4);
+  h.addEdge(0, 1, 1);
+  h.addEdge(1, 2, 1);
+  h.addEdge(1, 3, 1);
+  h.addEdge(2, 3, 1);
+  flujo = ek.maxFlowConCotas(h, 0, 3, {{1, 2, 1}, {1, 3, 1}}, residual,
+                             flowGraph, insatisfechas);
+  printResult("Cotas imposibles devuelven -1", flujo == -1);
+  printResult("Se informan cotas insatisfechas", !insatisfechas.empty());
+}
+
+// Test: Flujo de coste mínimo con arranque en caliente
+void test_min_cost_flow() {
+  std::cout << "\n=== Test: Min Cost Flow ===\n";
+
+  // Dos caminos 0 -> 3 de capacidad 1: por 1 cuesta 1, por 2 cuesta 5
+  MinCostFlow red;
+  red.reset(4);
+  int a01 = red.addArc(0, 1, 1, 0);
+  red.addArc(0, 2, 1, 0);
+  int a13 = red.addArc(1, 3, 1, 1);
+  red.addArc(2, 3, 1, 5);
+
+  printResult("Flujo máximo = 2", red.solve(0, 3) == 2);
+  printResult("Coste total = 6", red.costoTotal() == 6);
+
+  // Con capacidad 1 en la salida solo se usa el camino barato
+  red.reset(5);
+  red.addArc(4, 0, 1, 0);
+  red.addArc(0, 1, 1, 0);
+  red.addArc(0, 2, 1, 0);
+  red.addArc(1, 3, 1, 1);
+  red.addArc(2, 3, 1, 5);
+  printResult("Elige el camino barato",
+              red.solve(4, 3) == 1 && red.costoTotal() == 1 &&
+                  red.flujo(3) == 1);
+
+  // Arranque en caliente: el flujo empujado se conserva
+  red.reset(4);
+  a01 = red.addArc(0, 1, 1, 0);
+  red.addArc(0, 2, 1, 0);
+  a13 = red.addArc(1, 3, 1, 0);
+  red.addArc(2, 3, 1, 0);
+  printResult("Empujar por un camino con capacidad",
+              red.empujar({a01, a13}, 1));
+  printResult("Empujar sin capacidad no cambia nada",
+              !red.empujar({a01, a13}, 1) && red.flujo(a01) == 1);
+  printResult("solve() añade solo el flujo restante", red.solve(0, 3) == 1);
+}
+
+// Test: Pérdida de flujo al quitar un nodo, sin resolver de nuevo
+void test_perdida_sin_nodo() {
+  std::cout << "\n=== Test: Pérdida Sin Nodo ===\n";
+
+  // 0 -> {1, 2} -> {3, 4} -> 5; el nodo 2 es el único que llega a 4
+  Graph g(6);
+  g.addEdge(0, 1, 1);
+  g.addEdge(0, 2, 2);
+  g.addEdge(1, 3, 1);
+  g.addEdge(2, 3, 1);
+  g.addEdge(2, 4, 1);
+  g.addEdge(3, 5, 1);
+  g.addEdge(4, 5, 1);
+
+  EdmondsKarp ek;
+  Graph residual(0);
+  std::vector<std::vector<int>> flowGraph;
+  int flujo = ek.maxFlow(g, 0, 5, residual, flowGraph);
+  printResult("Flujo máximo = 2", flujo == 2);
+  std::vector<std::vector<int>> capacidades(6, std::vector<int>(6));
+  for (int u = 0; u < 6; u++) {
+    for (int v = 0; v < 6; v++) {
+      capacidades[u][v] = residual.getCapacity(u, v);
+    }
+  }
+  std::vector<std::vector<int>> flujoAntes = flowGraph;
+
+  // Sin 1, el nodo 2 cubre 3 y 4; sin 2, solo queda 1 -> 3
+  printResult("Quitar 1 no pierde flujo",
+              ek.perdidaSinNodo(residual, flowGraph, 0, 5, 1) == 0);
+  printResult("Quitar 2 pierde 1",
+              ek.perdidaSinNodo(residual, flowGraph, 0, 5, 2) == 1);
+  printResult("Quitar 3 pierde 1",
+              ek.perdidaSinNodo(residual, flowGraph, 0, 5, 3) == 1);
+  bool igual = flowGraph == flujoAntes;
+  for (int u = 0; u < 6; u++) {
+    for (int v = 0; v < 6; v++) {
+      igual = igual && residual.getCapacity(u, v) == capacidades[u][v];
+    }
+  }
+  printResult("El residual y el flujo de entrada no cambian", igual);
+}
+
+// Test: Arranque en caliente tras cambiar capacidades
+void test_flujo_desde() {
+  std::cout << "\n=== Test: Flujo Desde el Anterior ===\n";
+
+  // Mismo grafo que en Pérdida Sin Nodo
+  Graph g(6);
+  g.addEdge(0, 1, 1);
+  g.addEdge(0, 2, 2);
+  g.addEdge(1, 3, 1);
+  g.addEdge(2, 3, 1);
+  g.addEdge(2, 4, 1);
+  g.addEdge(3, 5, 1);
+  g.addEdge(4, 5, 1);
+
+  EdmondsKarp ek;
+  Graph residual(0);
+  std::vector<std::vector<int>> flowGraph;
+  ek.maxFlow(g, 0, 5, residual, flowGraph);
+
+  // Cerrar 2 -> 4: el flujo que pasaba por ahí se cancela
+  g.setCapacity(2, 4, 0);
+  int flujo = ek.maxFlowDesde(g, 0, 5, residual, flowGraph);
+  printResult("Flujo máximo = 1", flujo == 1);
+  printResult("Ningún arco sobre su capacidad",
+              flowGraph[2][4] <= 0 && flowGraph[0][2] <= 2 &&
+                  flowGraph[3][5] == 1);
+  printResult("Residual coherente con el flujo",
+              residual.getCapacity(0, 2) == 2 - flowGraph[0][2] &&
+                  residual.getCapacity(5, 3) == 1);
+
+  // Reabrir: vuelve a 2 sin empezar de cero
+  g.setCapacity(2, 4, 1);
+  printResult("Reabrir recupera flujo 2",
+              ek.maxFlowDesde(g, 0, 5, residual, flowGraph) == 2);
+
+  // Un flujo de otro tamaño se ignora
+  std::vector<std::vector<int>> otro(3, std::vector<int>(3, 0));
+  printResult("Flujo de otro tamaño: desde cero",
+              ek.maxFlowDesde(g, 0, 5, residual, otro) == 2);
+}
+
+// Test: Un plazo vencido detiene la búsqueda con un flujo válido
+void test_deadline_vencido() {
+  std::cout << "\n=== Test: Deadline Vencido ===\n";
+
+  Graph g(4);
+  g.addEdge(0, 1, 2);
+  g.addEdge(1, 3, 2);
+  g.addEdge(0, 2, 1);
+  g.addEdge(2, 3, 1);
+
+  EdmondsKarp ek;
+  Graph residual(0);
+  std::vector<std::vector<int>> flowGraph;
+  ek.setDeadline(Deadline(Deadline::Reloj::now()));
+  int flujo = ek.maxFlow(g, 0, 3, residual, flowGraph);
+  printResult("Interrumpido sin flujo", ek.interrumpido() && flujo == 0);
+
+  ek.setDeadline(Deadline());
+  flujo = ek.maxFlow(g, 0, 3, residual, flowGraph);
+  printResult("Sin plazo llega al máximo", !ek.interrumpido() && flujo == 3);
+}
+
+// Test: Las aristas al sumidero se abren por clases, en orden
+void test_flujo_por_clases() {
+  std::cout << "\n=== Test: Flujo Por Clases ===\n";
+
+  // Una sola unidad desde 0 que puede terminar en 2 o en 3
+  Graph g(5);
+  g.addEdge(0, 1, 1);
+  g.addEdge(1, 2, 1);
+  g.addEdge(1, 3, 1);
+  g.addEdge(2, 4, 1);
+  g.addEdge(3, 4, 1);
+
+  EdmondsKarp ek;
+  Graph residual(0);
+  std::vector<std::vector<int>> flowGraph;
+  int flujo = ek.maxFlowPorClases(g, 0, 4, {{3}}, residual, flowGraph);
+  printResult("Flujo máximo = 1", flujo == 1);
+  printResult("La clase abierta primero se llena", flowGraph[3][4] == 1);
+
+  flujo = ek.maxFlowPorClases(g, 0, 4, {{2}, {3}}, residual, flowGraph);
+  printResult("El orden de las clases decide", flowGraph[2][4] == 1);
+  printResult("Nodos sin clase se abren al final",
+              ek.maxFlowPorClases(g, 0, 4, {}, residual, flowGraph) == 1);
+}
+
+// Test: Mismo flujo y misma sensibilidad con residuales de 8, 16 y 32 bits
+void test_residual_estrecho() {
+  std::cout << "\n=== Test: Residual de Ancho Estrecho ===\n";
+
+  std::mt19937 rng(5);
+  EdmondsKarp ek;
+  int distintos = 0;
+  for (int it = 0; it < 100; it++) {
+    int n = 3 + rng() % 40;
+    Graph g(n);
+    for (int u = 0; u < n; u++) {
+      for (int v = u + 1; v < n; v++) {
+        // Sin arcos antiparalelos, como en la red del builder
+        if (rng() % 4 == 0) {
+          bool adelante = rng() % 2 == 0;
+          g.addEdge(adelante ? u : v, adelante ? v : u, 1 + rng() % 255);
+        }
+      }
+    }
+    int source = 0;
+    int sink = n - 1;
+    int nodo = 1 + rng() % (n - 2);
+
+    Graph r32(0);
+    GraphT<uint8_t> r8(0);
+    GraphT<uint16_t> r16(0);
+    std::vector<std::vector<int>> f32;
+    MatrizFlujo<uint8_t> f8;
+    MatrizFlujo<uint16_t> f16;
+    int v32 = ek.maxFlow(g, source, sink, r32, f32);
+    int v8 = ek.maxFlow(g, source, sink, r8, f8);
+    int v16 = ek.maxFlow(g, source, sink, r16, f16);
+    int p32 = ek.perdidaSinNodo(r32, f32, source, sink, nodo);
+    int p8 = ek.perdidaSinNodo(r8, f8, source, sink, nodo);
+    if (v8 != v32 || v16 != v32 || !mismoFlujo(f8, f32) || f16 != f32 ||
+        p8 != p32 ||
+        ek.getReachableResidual(r8, source) !=
+            ek.getReachableResidual(r32, source)) {
+      distintos++;
+    }
+  }
+  printResult("Mismos flujos, cortes y pérdidas en 100 grafos",
+              distintos == 0);
+}
+
+// Test: Arranque en caliente, cotas y clases dan lo mismo a 8 y 32 bits
+void test_solves_estrechos() {
+  std::cout << "\n=== Test: Solves de Ancho Estrecho ===\n";
+
+  std::mt19937 rng(11);
+  EdmondsKarp ek;
+  int distintos = 0;
+  int conCotasEstrechas = 0;
+  for (int it = 0; it < 100; it++) {
+    int n = 4 + rng() % 10;
+    Graph g(n);
+    std::vector<std::pair<int, int>> arcos;
+    for (int u = 0; u < n; u++) {
+      for (int v = u + 1; v < n; v++) {
+        if (rng() % 3 == 0) {
+          g.addEdge(u, v, 1 + rng() % 20);
+          arcos.emplace_back(u, v);
+        }
+      }
+    }
+    int sink = n - 1;
+    Graph r32(0);
+    GraphT<uint8_t> r8(0);
+    std::vector<std::vector<int>> f32;
+    MatrizFlujo<uint8_t> f8;
+
+    // Clases: los nodos pares primero
+    std::vector<std::vector<int>> clases(1);
+    for (int v = 2; v < sink; v += 2) {
+      clases[0].push_back(v);
+    }
+    bool igual = ek.maxFlowPorClases(g, 0, sink, clases, r32, f32) ==
+                     ek.maxFlowPorClases(g, 0, sink, clases, r8, f8) &&
+                 mismoFlujo(f8, f32);
+
+    // Desde el flujo anterior, tras bajar y subir capacidades
+    for (int k = 0; k < 3 && !arcos.empty(); k++) {
+      auto [u, v] = arcos[rng() % arcos.size()];
+      g.setCapacity(u, v, rng() % 21);
+    }
+    igual = igual && ek.maxFlowDesde(g, 0, sink, r32, f32) ==
+                         ek.maxFlowDesde(g, 0, sink, r8, f8);
+    igual = igual && mismoFlujo(f8, f32) &&
+            ek.getReachableResidual(r8, 0) == ek.getReachableResidual(r32, 0);
+
+    // Una cota en un arco con capacidad, al ancho que pide la circulación
+    std::vector<CotaInferior> cotas;
+    for (const auto &[u, v] : arcos) {
+      if (cotas.empty() && g.getCapacity(u, v) > 0) {
+        cotas.push_back({u, v, 1});
+      }
+    }
+    std::vector<size_t> i32, i8;
+    if (EdmondsKarp::anchoConCotas(g, 0, cotas, AnchoCapacidad::U8) ==
+        AnchoCapacidad::U8) {
+      conCotasEstrechas++;
+      igual = igual &&
+              ek.maxFlowConCotas(g, 0, sink, cotas, r32, f32, i32) ==
+                  ek.maxFlowConCotas(g, 0, sink, cotas, r8, f8, i8) &&
+              mismoFlujo(f8, f32) && i8 == i32;
+    }
+    if (!igual) {
+      distintos++;
+    }
+  }
+  printResult("Mismos flujos en 100 grafos", distintos == 0);
+  printResult("Con cotas a 8 bits cuando caben", conCotasEstrechas > 50);
+
+  // 400 unidades pueden salir del source: la circulación no cabe en 8 bits
+  Graph ancha(3);
+  ancha.addEdge(0, 1, 200);
+  ancha.addEdge(0, 2, 200);
+  printResult("Circulación a 16 bits si no cabe en 8",
+              EdmondsKarp::anchoConCotas(ancha, 0, {{0, 1, 1}},
+                                         AnchoCapacidad::U8) ==
+                  AnchoCapacidad::U16);
+}
+
 // Runner para tests de Edmonds-Karp
 void run_edmonds_karp_tests() {
   std::cout << "╔════════════════════════════════════════════╗\n";
@@ -148,4 +495,12 @@ void run_edmonds_karp_tests() {
   test_grafo_clasico();
   test_flow_result();
   test_source_igual_sink();
+  test_cotas_inferiores();
+  test_min_cost_flow();
+  test_perdida_sin_nodo();
+  test_flujo_desde();
+  test_deadline_vencido();
+  test_flujo_por_clases();
+  test_residual_estrecho();
+  test_solves_estrechos();
 }
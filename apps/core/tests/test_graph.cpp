@@ -97,6 +97,79 @@ void test_multiples_aristas() {
   printResult("0->4 = 20", g.getCapacity(0, 4) == 20);
 }
 
+// Test: Los bitsets de arcos siguen a las capacidades
+void test_bitsets_arcos() {
+  std::cout << "\n=== Test: Bitsets de Arcos ===\n";
+
+  Graph g(70); // Dos palabras por fila
+  g.addEdge(1, 66, 3);
+  g.addEdge(66, 1, 2);
+
+  auto bit = [](const uint64_t *fila, int v) {
+    return ((fila[v >> 6] >> (v & 63)) & 1) != 0;
+  };
+  printResult("Dos palabras por fila", g.getPalabras() == 2);
+  printResult("Arco 1->66 en salientes y entrantes",
+              bit(g.getSalientes(1), 66) && bit(g.getEntrantes(66), 1));
+  printResult("Sin arco 1->2", !bit(g.getSalientes(1), 2));
+  printResult("Resumen: palabra 1 de la fila 1 y palabra 0 de la columna 66",
+              g.getPalabrasResumen() == 1 &&
+                  g.getResumenSalientes(1)[0] == 2 &&
+                  g.getResumenEntrantes(66)[0] == 1);
+
+  g.addEdge(1, 65, 1);
+  g.setCapacity(1, 66, 0);
+  printResult("Capacidad 0 borra el bit",
+              !bit(g.getSalientes(1), 66) && !bit(g.getEntrantes(66), 1) &&
+                  bit(g.getSalientes(66), 1));
+  printResult("El resumen sigue mientras la palabra tenga arcos",
+              g.getResumenSalientes(1)[0] == 2 &&
+                  g.getResumenEntrantes(66)[0] == 0);
+  g.setCapacity(1, 65, 0);
+  printResult("Palabra vacía borra su bit del resumen",
+              g.getResumenSalientes(1)[0] == 0);
+
+  Graph copia = g;
+  g.reset(3);
+  printResult("La copia conserva los bits", bit(copia.getSalientes(66), 1));
+  printResult("reset limpia los bits",
+              g.getPalabras() == 1 && g.getSalientes(2)[0] == 0);
+}
+
+// Test: Grafos de capacidades estrechas y elección del ancho
+void test_anchos_capacidad() {
+  std::cout << "\n=== Test: Anchos de Capacidad ===\n";
+
+  Graph g(4);
+  g.addEdge(0, 1, 200);
+  g.addEdge(1, 2, 7);
+  g.addEdge(2, 3, 1);
+
+  GraphT<uint8_t> estrecho(0);
+  estrecho.copiarDe(g);
+  printResult("Copia a uint8_t conserva capacidades",
+              estrecho.getNumVertices() == 4 &&
+                  estrecho.getCapacity(0, 1) == 200 &&
+                  estrecho.getCapacity(1, 2) == 7 &&
+                  estrecho.getCapacity(1, 0) == 0);
+  printResult("Copia conserva los bitsets",
+              (estrecho.getSalientes(2)[0] & (uint64_t(1) << 3)) != 0);
+  printResult("Capacidad máxima = 200", estrecho.getCapacidadMaxima() == 200);
+  printResult("Un cuarto de la memoria de capacidades",
+              estrecho.memoria() < g.memoria());
+
+  GraphT<uint16_t> medio(3);
+  medio.setCapacity(0, 2, 60000);
+  printResult("uint16_t guarda 60000", medio.getCapacity(0, 2) == 60000);
+
+  printResult("255 cabe en uint8_t",
+              anchoParaCapacidad(255) == AnchoCapacidad::U8);
+  printResult("256 necesita uint16_t",
+              anchoParaCapacidad(256) == AnchoCapacidad::U16);
+  printResult("65536 necesita int32_t",
+              anchoParaCapacidad(65536) == AnchoCapacidad::I32);
+}
+
 // Runner para tests de Graph
 void run_graph_tests() {
   std::cout << "╔════════════════════════════════════════════╗\n";
@@ -109,4 +182,6 @@ void run_graph_tests() {
   test_indices_invalidos();
   test_grafo_dirigido();
   test_multiples_aristas();
+  test_bitsets_arcos();
+  test_anchos_capacidad();
 }
@@ -6,7 +6,9 @@
 #include "edmonds_karp.h"
 #include "graph_builder.h"
 #include "test_utils.h"
+#include <chrono>
 #include <iostream>
+#include <random>
 
 // Test: Construcción básica
 void test_construccion_basica() {
@@ -182,6 +184,151 @@ void test_restriccion_c() {
   printResult("C=1 limita a 1 guardia", maxFlow == 1);
 }
 
+// Test: Capacidades por periodo reemplazan el límite global en su periodo
+void test_capacidades_por_periodo() {
+  std::cout << "\n=== Test: Capacidades por Periodo ===\n";
+
+  GraphBuilder builder;
+
+  builder.setMedicos({"M1", "M2"});
+  builder.setDias({"D1", "D2", "D3", "D4"});
+  builder.setPeriodos({{"P1", {"D1", "D2"}}, {"P2", {"D3", "D4"}}});
+  builder.setDisponibilidad({{"M1", {"D1", "D2", "D3", "D4"}},
+                             {"M2", {"D1", "D2", "D3", "D4"}}});
+  builder.setMaxGuardiasPorPeriodo(1);
+  // M1 ya tiene una guardia en P1 (0 restantes); M2 puede hacer 2 en P2
+  builder.setCapacidadesPorPeriodo(
+      {{"M1", {{"P1", 0}}}, {"M2", {{"P2", 2}, {"PX", 5}}}, {"MX", {{"P1", 3}}}});
+  builder.setMedicosRequeridosTodosDias(1);
+
+  Graph g = builder.build();
+
+  printResult("M1->(M1,P1) = 0",
+              g.getCapacity(builder.nodoMedico(0),
+                            builder.nodoMedicoPeriodo(0, 0)) == 0);
+  printResult("M1->(M1,P2) usa el global = 1",
+              g.getCapacity(builder.nodoMedico(0),
+                            builder.nodoMedicoPeriodo(0, 1)) == 1);
+  printResult("M2->(M2,P2) = 2",
+              g.getCapacity(builder.nodoMedico(1),
+                            builder.nodoMedicoPeriodo(1, 1)) == 2);
+  printResult("Residual de 8 bits",
+              builder.getAnchoCapacidad() == AnchoCapacidad::U8);
+
+  EdmondsKarp ek;
+  std::vector<std::vector<int>> flowGraph;
+  int maxFlow = ek.maxFlowWithResult(g, builder.getSource(), builder.getSink(),
+                                     flowGraph);
+
+  // P1: solo M2 puede cubrir 1 día; P2: M1 y M2 cubren D3 y D4 -> 3 días
+  std::cout << "  Flujo máximo: " << maxFlow << " (esperado: 3)\n";
+  printResult("Flujo limitado por capacidades por periodo", maxFlow == 3);
+}
+
+// Test: Numeración por periodos: mismos flujo y cuellos de botella, y las
+// búsquedas leen menos palabras de los bitsets
+void test_renumeracion() {
+  std::cout << "\n=== Test: Renumeración de Vértices ===\n";
+
+  std::vector<std::string> medicos, dias;
+  std::vector<Periodo> periodos;
+  std::map<std::string, std::vector<std::string>> disponibilidad;
+  std::mt19937 rng(5);
+  for (int m = 0; m < 120; m++) {
+    medicos.push_back("M" + std::to_string(m));
+  }
+  for (int d = 0; d < 365; d++) {
+    dias.push_back("D" + std::to_string(d));
+  }
+  for (int p = 0; p < 12; p++) {
+    Periodo periodo;
+    periodo.id = "P" + std::to_string(p);
+    for (int d = p * 365 / 12; d < (p + 1) * 365 / 12; d++) {
+      periodo.dias.push_back(dias[d]);
+    }
+    periodos.push_back(periodo);
+  }
+  for (const auto &medico : medicos) {
+    for (const auto &dia : dias) {
+      if (rng() % 4 == 0) {
+        disponibilidad[medico].push_back(dia);
+      }
+    }
+  }
+
+  struct Salida {
+    int maxFlow;
+    int diasCubiertos;
+    std::vector<Bottleneck> bottlenecks;
+    long long palabras;
+    double ms;
+  };
+  auto resolver = [&](bool renumerar, GraphBuilder &builder) {
+    builder.setMedicos(medicos);
+    builder.setDias(dias);
+    builder.setPeriodos(periodos);
+    builder.setDisponibilidad(disponibilidad);
+    builder.setMaxGuardiasPorPeriodo(2);
+    builder.setMaxGuardiasTotales(12);
+    builder.setMedicosRequeridosTodosDias(5); // No factible: 1440 < 1825
+    builder.setRenumerar(renumerar);
+    Graph g = builder.build();
+
+    EdmondsKarp ek;
+    Graph residual(0);
+    std::vector<std::vector<int>> flowGraph;
+    auto inicio = std::chrono::steady_clock::now();
+    Salida salida;
+    salida.maxFlow = ek.maxFlow(g, builder.getSource(), builder.getSink(),
+                                residual, flowGraph);
+    salida.ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - inicio)
+                    .count();
+    salida.palabras = ek.getPalabrasLeidas();
+    salida.diasCubiertos = builder.extraerResultado(flowGraph).diasCubiertos;
+    salida.bottlenecks = builder.analyzeMinCut(
+        ek.getReachableResidual(residual, builder.getSource()));
+    return salida;
+  };
+
+  GraphBuilder original, renumerado;
+  Salida a = resolver(false, original);
+  Salida b = resolver(true, renumerado);
+  std::cout << "  Palabras leídas: " << a.palabras << " -> " << b.palabras
+            << ", tiempo: " << a.ms << " ms -> " << b.ms << " ms\n";
+
+  bool inversa = true;
+  for (uint32_t m = 0; m < 120; m++) {
+    for (uint32_t p = 0; p < 12; p++) {
+      int nodo = renumerado.nodoMedicoPeriodo(m, p);
+      inversa = inversa &&
+                renumerado.medicoPeriodoDeNodo(nodo) == std::make_pair(m, p);
+    }
+  }
+  printResult("Nodos de un periodo consecutivos",
+              renumerado.nodoMedicoPeriodo(1, 0) ==
+                  renumerado.nodoMedicoPeriodo(0, 0) + 1);
+  printResult("medicoPeriodoDeNodo invierte nodoMedicoPeriodo", inversa);
+  bool mismos = a.bottlenecks.size() == b.bottlenecks.size();
+  for (size_t i = 0; mismos && i < a.bottlenecks.size(); i++) {
+    mismos = a.bottlenecks[i].tipo == b.bottlenecks[i].tipo &&
+             a.bottlenecks[i].id == b.bottlenecks[i].id &&
+             a.bottlenecks[i].razon == b.bottlenecks[i].razon;
+  }
+  printResult("Mismo flujo y cobertura", a.maxFlow == b.maxFlow &&
+                                             a.diasCubiertos == b.diasCubiertos);
+  printResult("Mismos cuellos de botella", mismos && !a.bottlenecks.empty());
+  printResult("Menos palabras leídas", b.palabras < a.palabras);
+
+  // Volver a la numeración original no reutiliza la topología renumerada
+  renumerado.setRenumerar(false);
+  Graph g(0);
+  printResult("Cambiar el orden invalida rebuild()", !renumerado.rebuild(g));
+  printResult("Y vuelve al orden por médico",
+              renumerado.nodoMedicoPeriodo(0, 1) ==
+                  renumerado.nodoMedicoPeriodo(0, 0) + 1);
+}
+
 // Runner para tests de GraphBuilder
 void run_graph_builder_tests() {
   std::cout << "╔════════════════════════════════════════════╗\n";
@@ -194,4 +341,6 @@ void run_graph_builder_tests() {
   builder_test_caso_no_factible();
   builder_test_multiples_medicos_por_dia();
   test_restriccion_c();
+  test_capacidades_por_periodo();
+  test_renumeracion();
 }
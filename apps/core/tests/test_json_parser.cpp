@@ -27,6 +27,31 @@ void testParseBasico() {
   printResult("Luis disponible 1 día", data.disponibilidad["Luis"].size() == 1);
 }
 
+void testParseCapacidadesPorPeriodo() {
+  std::cout << "\n=== Test: Parse Capacidades Por Periodo ===\n";
+
+  std::string json = R"({
+    "medicos": ["Ana", "Luis"],
+    "dias": ["Lunes", "Martes"],
+    "periodos": [
+      {"id": "P1", "dias": ["Lunes"]},
+      {"id": "P2", "dias": ["Martes"]}
+    ],
+    "disponibilidad": {"Ana": ["Lunes", "Martes"], "Luis": ["Martes"]},
+    "maxGuardiasPorPeriodo": 2,
+    "capacidadesPorPeriodo": {"Ana": {"P1": 0, "P2": 1}}
+  })";
+
+  InputData data = JSONParser::parseInput(json);
+
+  printResult("Capacidad de Ana en P1 = 0",
+              data.capacidadesPorPeriodo["Ana"]["P1"] == 0);
+  printResult("Capacidad de Ana en P2 = 1",
+              data.capacidadesPorPeriodo["Ana"]["P2"] == 1);
+  printResult("Luis sin capacidades por periodo",
+              data.capacidadesPorPeriodo.count("Luis") == 0);
+}
+
 void testParseFromFile() {
   std::cout << "\n=== Test: Parse From File ===\n";
 
@@ -71,7 +96,8 @@ void testToJson() {
   resultado.factible = true;
   resultado.diasCubiertos = 2;
   resultado.diasRequeridos = 2;
-  resultado.asignaciones = {{"Ana", "Lunes"}, {"Luis", "Martes"}};
+  resultado.asignaciones = {{"Ana", "Lunes", "", ""},
+                             {"Luis", "Martes", "", ""}};
 
   std::string jsonOutput = JSONParser::toJson(resultado);
 
@@ -84,6 +110,46 @@ void testToJson() {
               jsonOutput.find("\"Ana\"") != std::string::npos);
 }
 
+void testInputToJson() {
+  std::cout << "\n=== Test: Input To JSON ===\n";
+
+  std::string json = R"({
+    "medicos": ["Ana", "Luis"],
+    "dias": ["D1", "D2"],
+    "periodos": [{"id": "P1", "dias": ["D1", "D2"]}],
+    "disponibilidad": {"Ana": ["D1", "D2"], "Luis": ["D2"]},
+    "maxGuardiasPorPeriodo": 2,
+    "medicosPorDia": {"D1": 1},
+    "asignacionesFijas": {"Ana": ["D1"]},
+    "roles": {"Ana": "R1", "Luis": "R2"},
+    "demandaPorTurno": {"D2": {"T1": 1}},
+    "disponibilidadPorTurno": {"Luis": {"D2": ["T1"]}}
+  })";
+
+  InputData data = JSONParser::parseInput(json);
+  InputData vuelta =
+      JSONParser::parseInput(JSONParser::inputToJson(data, -1));
+
+  printResult("Mismos médicos, días y periodos",
+              vuelta.medicos == data.medicos && vuelta.dias == data.dias &&
+                  vuelta.periodos.size() == 1 &&
+                  vuelta.periodos[0].dias == data.periodos[0].dias);
+  printResult("Misma disponibilidad y límites",
+              vuelta.disponibilidad == data.disponibilidad &&
+                  vuelta.maxGuardiasPorPeriodo == 2 &&
+                  vuelta.maxGuardiasTotales == data.maxGuardiasTotales);
+  printResult("medicosPorDia sin completar con el valor por defecto",
+              vuelta.medicosPorDia == data.medicosPorDia &&
+                  vuelta.medicosPorDia.count("D2") == 0);
+  printResult("Mismos campos opcionales",
+              vuelta.asignacionesFijas == data.asignacionesFijas &&
+                  vuelta.roles == data.roles &&
+                  vuelta.demandaPorTurno == data.demandaPorTurno &&
+                  vuelta.disponibilidadPorTurno ==
+                      data.disponibilidadPorTurno &&
+                  vuelta.prioridadDias.empty());
+}
+
 void testFlujoCompleto() {
   std::cout << "\n=== Test: Flujo Completo (End-to-End) ===\n";
 
@@ -147,8 +213,10 @@ void run_json_parser_tests() {
   // para simplificar, dejamos que se acumulen.
 
   testParseBasico();
+  testParseCapacidadesPorPeriodo();
   testParseFromFile();
   testConfigureBuilder();
   testToJson();
+  testInputToJson();
   testFlujoCompleto();
 }
@@ -0,0 +1,184 @@
+/**
+ * Tests unitarios para el motor push-relabel multihilo
+ * Verifica que da el mismo valor de flujo y el mismo corte mínimo que
+ * Edmonds-Karp, sin pool y con pools de varios hilos, y que el flujo que
+ * deja es válido
+ */
+
+#include "edmonds_karp.h"
+#include "json_parser.h"
+#include "push_relabel.h"
+#include "solver_context.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Capacities, antisymmetry and conservation of a net flow matrix
+template <typename F>
+bool flujoValido(const Graph &g, const std::vector<std::vector<F>> &flow,
+                 int source, int sink, int valor) {
+  int n = g.getNumVertices();
+  for (int u = 0; u < n; u++) {
+    int balance = 0;
+    for (int v = 0; v < n; v++) {
+      if (flow[u][v] != -flow[v][u] || flow[u][v] > g.getCapacity(u, v)) {
+        return false;
+      }
+      balance += flow[u][v];
+    }
+    int esperado = u == source ? valor : u == sink ? -valor : 0;
+    if (source != sink && balance != esperado) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<int> corte(EdmondsKarp &ek, const GraphBase &residual,
+                       int source) {
+  std::vector<int> nodos = ek.getReachableResidual(residual, source);
+  std::sort(nodos.begin(), nodos.end());
+  return nodos;
+}
+
+} // namespace
+
+// Test: Mismo flujo máximo y mismo corte que Edmonds-Karp
+void test_push_relabel_igual_a_ek() {
+  std::cout << "\n=== Test: Push-Relabel Igual a Edmonds-Karp ===\n";
+
+  std::mt19937 rng(11);
+  EdmondsKarp ek;
+  PushRelabel pr;
+  ThreadPool uno(1), tres(3);
+  ThreadPool *pools[] = {nullptr, &uno, &tres};
+  pr.setArcosPorHilo(1); // Varios hilos también en grafos pequeños
+  int valoresDistintos = 0;
+  int cortesDistintos = 0;
+  int flujosInvalidos = 0;
+  int estrechosDistintos = 0;
+  for (int it = 0; it < 200; it++) {
+    int n = 2 + rng() % 80;
+    double densidad = (rng() % 100) / 300.0;
+    Graph g(n);
+    for (int u = 0; u < n; u++) {
+      for (int v = 0; v < n; v++) {
+        if (u != v && (rng() % 1000) < densidad * 1000) {
+          g.addEdge(u, v, 1 + rng() % 10);
+        }
+      }
+    }
+    int source = rng() % n;
+    int sink = rng() % n;
+    pr.setPool(pools[it % 3]);
+
+    Graph residualEk(0), residualPr(0);
+    std::vector<std::vector<int>> flowEk, flowPr;
+    int valorEk = ek.maxFlow(g, source, sink, residualEk, flowEk);
+    int valorPr = pr.maxFlow(g, source, sink, residualPr, flowPr);
+    if (valorEk != valorPr) {
+      valoresDistintos++;
+    }
+    if (corte(ek, residualEk, source) != corte(ek, residualPr, source)) {
+      cortesDistintos++;
+    }
+    if (!flujoValido(g, flowPr, source, sink, valorPr)) {
+      flujosInvalidos++;
+    }
+
+    // Pares de arcos de hasta 10 + 10: caben en 8 bits
+    GraphT<uint8_t> residual8(0);
+    MatrizFlujo<uint8_t> flow8;
+    int valor8 = pr.maxFlow(g, source, sink, residual8, flow8);
+    if (valor8 != valorEk ||
+        corte(ek, residual8, source) != corte(ek, residualEk, source) ||
+        !flujoValido(g, flow8, source, sink, valor8)) {
+      estrechosDistintos++;
+    }
+  }
+  printResult("Mismo valor en 200 grafos (0, 1 y 3 hilos)",
+              valoresDistintos == 0);
+  printResult("Mismo corte mínimo en 200 grafos", cortesDistintos == 0);
+  printResult("Flujos válidos", flujosInvalidos == 0);
+  printResult("Igual con residual y flujo de 8 bits", estrechosDistintos == 0);
+  printResult("Hubo relabels globales", pr.getRelabelsGlobales() > 0);
+}
+
+// Test: Un plazo vencido deja igualmente un flujo válido
+void test_push_relabel_plazo() {
+  std::cout << "\n=== Test: Push-Relabel con Plazo ===\n";
+
+  Graph g(6);
+  g.addEdge(0, 1, 5);
+  g.addEdge(0, 2, 5);
+  g.addEdge(1, 3, 4);
+  g.addEdge(2, 3, 2);
+  g.addEdge(2, 4, 4);
+  g.addEdge(3, 5, 5);
+  g.addEdge(4, 5, 3);
+
+  PushRelabel pr;
+  Graph residual(0);
+  std::vector<std::vector<int>> flow;
+  printResult("Flujo máximo", pr.maxFlow(g, 0, 5, residual, flow) == 8 &&
+                                  !pr.interrumpido());
+
+  pr.setDeadline(Deadline(Deadline::Reloj::now()));
+  int valor = pr.maxFlow(g, 0, 5, residual, flow);
+  printResult("Interrumpido con flujo válido",
+              pr.interrumpido() && valor <= 8 &&
+                  flujoValido(g, flow, 0, 5, valor));
+}
+
+// Test: El contexto resuelve con el motor elegido y el mismo resultado
+void test_push_relabel_en_contexto() {
+  std::cout << "\n=== Test: Push-Relabel en SolverContext ===\n";
+
+  InputData data = JSONParser::parseInput(
+      R"({"medicos": ["Ana", "Luis", "Carla"], "dias": ["D1", "D2", "D3", "D4"],
+          "periodos": [{"id": "P1", "dias": ["D1", "D2", "D3", "D4"]}],
+          "disponibilidad": {"Ana": ["D1", "D2"], "Luis": ["D1", "D2"],
+                             "Carla": ["D1", "D3"]},
+          "maxGuardiasPorPeriodo": 1})");
+
+  SolverContext context;
+  context.load(data);
+  ResultadoAsignacion conEk = context.solve();
+
+  context.setMotor("push-relabel");
+  context.load(data);
+  ResultadoAsignacion conPr = context.solve();
+  printResult("Motor informado", context.getEngine() == "push-relabel");
+  printResult("Misma cobertura",
+              conPr.diasCubiertos == conEk.diasCubiertos &&
+                  context.getMaxFlow() == 3);
+  printResult("Mismos cuellos de botella",
+              conPr.bottlenecks.size() == conEk.bottlenecks.size() &&
+                  !conPr.bottlenecks.empty());
+  printResult("Sensibilidad disponible",
+              context.sensibilidad().size() == 3);
+
+  bool lanzo = false;
+  try {
+    context.setMotor("dinic");
+  } catch (const std::runtime_error &) {
+    lanzo = true;
+  }
+  printResult("Motor desconocido lanza excepción", lanzo);
+}
+
+// Runner para tests del motor push-relabel
+void run_push_relabel_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║       Tests Unitarios: Push-Relabel        ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_push_relabel_igual_a_ek();
+  test_push_relabel_plazo();
+  test_push_relabel_en_contexto();
+}
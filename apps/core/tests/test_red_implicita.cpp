@@ -0,0 +1,226 @@
+/**
+ * Tests unitarios para el motor implícito (arcos de capa 3 sin guardar)
+ * Verifica que da la misma cobertura y los mismos cuellos de botella que
+ * Edmonds-Karp sobre la matriz, con roles, turnos y periodos solapados, que
+ * sus asignaciones son válidas y que ocupa mucha menos memoria
+ */
+
+#include "json_parser.h"
+#include "solver_context.h"
+#include "stress_utils.h"
+#include "test_utils.h"
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool mismosBottlenecks(const std::vector<Bottleneck> &a,
+                       const std::vector<Bottleneck> &b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].tipo != b[i].tipo || a[i].id != b[i].id ||
+        a[i].razon != b[i].razon) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Cada asignación en un día disponible del médico (con periodos solapados
+// la red, también la de matriz, permite el mismo día por dos periodos)
+bool asignacionesValidas(const InputData &data,
+                         const ResultadoAsignacion &resultado) {
+  for (const auto &a : resultado.asignaciones) {
+    const auto &dias = data.disponibilidad.count(a.medico)
+                           ? data.disponibilidad.at(a.medico)
+                           : std::vector<std::string>();
+    bool disponible = false;
+    for (const auto &d : dias) {
+      disponible = disponible || d == a.dia;
+    }
+    if (!disponible) {
+      return false;
+    }
+  }
+  return int(resultado.asignaciones.size()) == resultado.diasCubiertos;
+}
+
+} // namespace
+
+// Test: Misma cobertura y mismos cuellos de botella que Edmonds-Karp
+void test_implicita_igual_a_ek() {
+  std::cout << "\n=== Test: Motor Implícito Igual a Edmonds-Karp ===\n";
+
+  std::mt19937 rng(7);
+  SolverContext ek;
+  SolverContext implicito;
+  implicito.setMotor("implicit");
+  SolverContext renumerado; // Implícito con los nodos por periodo
+  renumerado.setMotor("implicit");
+  renumerado.setRenumerar(true);
+  int distintos = 0;
+  int invalidos = 0;
+  int noFactibles = 0;
+  for (int it = 0; it < 300; it++) {
+    InputData data = instanciaStress(rng, 10, 16);
+    ek.load(data);
+    implicito.load(data);
+    ResultadoAsignacion a = ek.solve();
+    ResultadoAsignacion b = implicito.solve();
+    renumerado.load(data);
+    ResultadoAsignacion c = renumerado.solve();
+    if (a.diasCubiertos != b.diasCubiertos || a.factible != b.factible ||
+        implicito.getMaxFlow() != ek.getMaxFlow() ||
+        !mismosBottlenecks(a.bottlenecks, b.bottlenecks) ||
+        c.diasCubiertos != a.diasCubiertos ||
+        !mismosBottlenecks(a.bottlenecks, c.bottlenecks)) {
+      distintos++;
+    }
+    if (!asignacionesValidas(data, b) || !asignacionesValidas(data, c)) {
+      invalidos++;
+    }
+    noFactibles += !a.factible;
+  }
+  printResult("Motor informado", implicito.getEngine() == "implicit");
+  printResult("Misma cobertura y bottlenecks en 300 instancias",
+              distintos == 0);
+  printResult("Asignaciones válidas", invalidos == 0);
+  printResult("Hubo instancias no factibles", noFactibles > 0);
+}
+
+// Test: Sin la capa 3 guardada, la memoria cae un orden de magnitud
+void test_implicita_memoria() {
+  std::cout << "\n=== Test: Memoria del Motor Implícito ===\n";
+
+  InputData data;
+  std::mt19937 rng(3);
+  for (int m = 0; m < 60; m++) {
+    data.medicos.push_back("M" + std::to_string(m));
+  }
+  for (int d = 0; d < 365; d++) {
+    data.dias.push_back("D" + std::to_string(d));
+    data.medicosPorDia[data.dias.back()] = 2;
+  }
+  for (int p = 0; p < 12; p++) {
+    Periodo periodo;
+    periodo.id = "P" + std::to_string(p);
+    for (int d = p * 365 / 12; d < (p + 1) * 365 / 12; d++) {
+      periodo.dias.push_back(data.dias[d]);
+    }
+    data.periodos.push_back(periodo);
+  }
+  for (const auto &medico : data.medicos) {
+    for (const auto &dia : data.dias) {
+      if (rng() % 3 != 0) {
+        data.disponibilidad[medico].push_back(dia);
+      }
+    }
+  }
+  data.maxGuardiasPorPeriodo = 3;
+  data.maxGuardiasTotales = 20;
+
+  SolverContext ek;
+  SolverContext implicito;
+  implicito.setMotor("implicit");
+  ek.load(data);
+  implicito.load(data);
+  ResultadoAsignacion a = ek.solve();
+  ResultadoAsignacion b = implicito.solve();
+
+  std::cout << "  Memoria: " << ek.memoriaEstimada() / 1024
+            << " KiB (matriz), " << implicito.memoriaEstimada() / 1024
+            << " KiB (implícito)\n";
+  printResult("Misma cobertura", a.diasCubiertos == b.diasCubiertos);
+  printResult("Menos de una décima parte de memoria",
+              implicito.memoriaEstimada() * 10 < ek.memoriaEstimada());
+  printResult("No deja grafo ni matriz de flujo",
+              implicito.getGraph().getNumVertices() == 0 &&
+                  implicito.conFlujo(
+                      [](const auto &flujo) { return flujo.empty(); }));
+}
+
+// Test: Plazo vencido y solves que no admite (fijas) siguen funcionando
+void test_implicita_plazo_y_fijas() {
+  std::cout << "\n=== Test: Motor Implícito con Plazo y Fijas ===\n";
+
+  InputData data = JSONParser::parseInput(
+      R"({"medicos": ["Ana", "Luis", "Carla"], "dias": ["D1", "D2", "D3", "D4"],
+          "periodos": [{"id": "P1", "dias": ["D1", "D2", "D3", "D4"]}],
+          "disponibilidad": {"Ana": ["D1", "D2"], "Luis": ["D1", "D2"],
+                             "Carla": ["D1", "D3"]},
+          "maxGuardiasPorPeriodo": 1})");
+
+  SolverContext context;
+  context.setMotor("implicit");
+  context.load(data);
+  ResultadoAsignacion resultado = context.solve();
+  printResult("Cubre 3 de 4", resultado.diasCubiertos == 3 &&
+                                  !resultado.bottlenecks.empty());
+
+  context.setDeadline(Deadline(Deadline::Reloj::now()));
+  context.load(data);
+  resultado = context.solve();
+  printResult("Plazo vencido: resultado parcial",
+              resultado.parcial && resultado.bottlenecks.empty());
+  context.setDeadline(Deadline());
+
+  data.asignacionesFijas["Carla"] = {"D3"};
+  context.load(data);
+  resultado = context.solve();
+  printResult("Con fijas resuelve sobre la matriz",
+              resultado.diasCubiertos == 3 &&
+                  context.getGraph().getNumVertices() > 0);
+}
+
+// Test: Límites negativos valen 0, como en la matriz, y el certificado pasa
+void test_implicita_limites_negativos() {
+  std::cout << "\n=== Test: Motor Implícito con Límites Negativos ===\n";
+
+  InputData data = JSONParser::parseInput(
+      R"({"medicos": ["Ana", "Luis"], "dias": ["D1", "D2"],
+          "periodos": [{"id": "P1", "dias": ["D1", "D2"]}],
+          "disponibilidad": {"Ana": ["D1", "D2"], "Luis": ["D1", "D2"]},
+          "maxGuardiasPorPeriodo": 2, "maxGuardiasTotales": 2,
+          "capacidadesPorPeriodo": {"Luis": {"P1": -2}}})");
+
+  SolverContext ek;
+  SolverContext implicito;
+  implicito.setMotor("implicit");
+  implicito.setVerificar(true);
+  bool certificado = true;
+  bool iguales = true;
+  for (int total : {2, -1}) {
+    data.maxGuardiasTotales = total;
+    ek.load(data);
+    implicito.load(data);
+    ResultadoAsignacion a = ek.solve();
+    try {
+      ResultadoAsignacion b = implicito.solve();
+      iguales = iguales && a.diasCubiertos == b.diasCubiertos &&
+                mismosBottlenecks(a.bottlenecks, b.bottlenecks);
+    } catch (const std::runtime_error &e) {
+      std::cout << "  " << e.what() << "\n";
+      certificado = false;
+    }
+  }
+  printResult("Certificado con capacidad por periodo y total negativos",
+              certificado);
+  printResult("Misma cobertura y bottlenecks que Edmonds-Karp", iguales);
+}
+
+// Runner para tests del motor implícito
+void run_red_implicita_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║       Tests Unitarios: Motor Implícito     ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_implicita_igual_a_ek();
+  test_implicita_memoria();
+  test_implicita_plazo_y_fijas();
+  test_implicita_limites_negativos();
+}
@@ -0,0 +1,256 @@
+/**
+ * Tests unitarios para la caché de resultados
+ * Verifica el hash canónico, la LRU en memoria, la caché en disco,
+ * las opciones de línea de comandos y el modo residente
+ */
+
+#include "cli_options.h"
+#include "instance_hash.h"
+#include "json_parser.h"
+#include "request_handler.h"
+#include "result_cache.h"
+#include "test_utils.h"
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+std::string hashDe(const std::string &json) {
+  InternedInstance interned;
+  JSONParser::internInput(JSONParser::parseInput(json), interned);
+  return hashInstancia(interned.view());
+}
+
+ResultadoAsignacion resultadoEjemplo() {
+  ResultadoAsignacion r;
+  r.factible = true;
+  r.diasCubiertos = 1;
+  r.diasRequeridos = 1;
+  r.asignaciones.push_back({"Ana", "D1", "", ""});
+  return r;
+}
+
+} // namespace
+
+// Test: El hash no depende del orden de las listas
+void test_hash_canonico() {
+  std::cout << "\n=== Test: Hash Canónico ===\n";
+
+  std::string a = R"({
+    "medicos": ["Ana", "Luis"], "dias": ["D1", "D2"],
+    "periodos": [{"id": "P1", "dias": ["D1", "D2"]}],
+    "disponibilidad": {"Ana": ["D1", "D2"], "Luis": ["D2"]},
+    "maxGuardiasPorPeriodo": 1})";
+  std::string reordenado = R"({
+    "medicos": ["Luis", "Ana"], "dias": ["D2", "D1"],
+    "periodos": [{"id": "P1", "dias": ["D2", "D1"]}],
+    "disponibilidad": {"Luis": ["D2"], "Ana": ["D2", "D1"]},
+    "maxGuardiasPorPeriodo": 1})";
+  std::string otraDisponibilidad = R"({
+    "medicos": ["Ana", "Luis"], "dias": ["D1", "D2"],
+    "periodos": [{"id": "P1", "dias": ["D1", "D2"]}],
+    "disponibilidad": {"Ana": ["D1"], "Luis": ["D2"]},
+    "maxGuardiasPorPeriodo": 1})";
+  std::string otroLimite = R"({
+    "medicos": ["Ana", "Luis"], "dias": ["D1", "D2"],
+    "periodos": [{"id": "P1", "dias": ["D1", "D2"]}],
+    "disponibilidad": {"Ana": ["D1", "D2"], "Luis": ["D2"]},
+    "maxGuardiasPorPeriodo": 2})";
+
+  std::string h = hashDe(a);
+  printResult("Hash de 32 caracteres hex", h.size() == 32);
+  printResult("Mismo hash con listas reordenadas", h == hashDe(reordenado));
+  printResult("Disponibilidad distinta cambia el hash",
+              h != hashDe(otraDisponibilidad));
+  printResult("Límite por periodo distinto cambia el hash",
+              h != hashDe(otroLimite));
+
+  std::string conCapacidad = a;
+  conCapacidad.insert(conCapacidad.size() - 1,
+                      R"(, "capacidadesPorPeriodo": {"Ana": {"P1": 0}})");
+  std::string capacidadIgualGlobal = a;
+  capacidadIgualGlobal.insert(capacidadIgualGlobal.size() - 1,
+                              R"(, "capacidadesPorPeriodo": {"Ana": {"P1": 1}})");
+  printResult("Capacidad por periodo cambia el hash",
+              h != hashDe(conCapacidad));
+  printResult("Capacidad igual al límite global no cambia el hash",
+              h == hashDe(capacidadIgualGlobal));
+
+  std::string conPrioridad = a;
+  conPrioridad.insert(conPrioridad.size() - 1,
+                      R"(, "prioridadDias": {"D2": 5})");
+  std::string prioridadCero = a;
+  prioridadCero.insert(prioridadCero.size() - 1,
+                       R"(, "prioridadDias": {"D2": 0})");
+  printResult("Prioridad de día cambia el hash", h != hashDe(conPrioridad));
+  printResult("Prioridad 0 no cambia el hash", h == hashDe(prioridadCero));
+
+  std::string conRoles = a;
+  conRoles.insert(conRoles.size() - 1,
+                  R"(, "roles": {"Ana": "uci"}, "demandaPorRol": {"D1": {"uci": 1}})");
+  std::string otroRol = a;
+  otroRol.insert(otroRol.size() - 1,
+                 R"(, "roles": {"Ana": "urg"}, "demandaPorRol": {"D1": {"urg": 1}})");
+  printResult("Roles cambian el hash", h != hashDe(conRoles));
+  printResult("Nombre de rol distinto cambia el hash",
+              hashDe(conRoles) != hashDe(otroRol));
+
+  std::string conTurnos = a;
+  conTurnos.insert(conTurnos.size() - 1,
+                   R"(, "demandaPorTurno": {"D2": {"dia": 1, "noche": 1}})");
+  std::string conRestriccion = conTurnos;
+  conRestriccion.insert(conRestriccion.size() - 1,
+                        R"(, "disponibilidadPorTurno": {"Ana": {"D2": ["dia"]}})");
+  printResult("Turnos cambian el hash", h != hashDe(conTurnos));
+  printResult("Restricción de turnos cambia el hash",
+              hashDe(conTurnos) != hashDe(conRestriccion));
+}
+
+// Test: LRU en memoria y contadores
+void test_cache_memoria() {
+  std::cout << "\n=== Test: Caché en Memoria ===\n";
+
+  ResultCache cache(2);
+  ResultadoAsignacion r;
+
+  printResult("Fallo en caché vacía", !cache.buscar("a-ek", r));
+  cache.guardar("a-ek", resultadoEjemplo());
+  printResult("Acierto tras guardar", cache.buscar("a-ek", r) &&
+                                          r.asignaciones.size() == 1 &&
+                                          r.asignaciones[0].medico == "Ana");
+
+  cache.guardar("b-ek", resultadoEjemplo());
+  cache.buscar("a-ek", r); // "a" pasa a ser la más reciente
+  cache.guardar("c-ek", resultadoEjemplo());
+  printResult("Se desaloja la menos usada", !cache.buscar("b-ek", r));
+  printResult("La más usada sigue en caché", cache.buscar("a-ek", r));
+
+  CacheStats s = cache.stats();
+  printResult("5 consultas, 3 aciertos", s.consultas == 5 && s.aciertos == 3);
+  printResult("Tasa de aciertos 0.6", s.tasaAciertos() > 0.59 &&
+                                          s.tasaAciertos() < 0.61);
+  printResult("Capacidad respetada", s.entradas == 2);
+  printResult("Clave incluye el motor",
+              ResultCache::clave("abc", "edmonds-karp") == "abc-edmonds-karp");
+}
+
+// Test: La caché en disco sobrevive a un reinicio
+void test_cache_disco() {
+  std::cout << "\n=== Test: Caché en Disco ===\n";
+
+  std::remove("build/test-disco.json");
+  {
+    ResultCache cache(4, "build");
+    cache.guardar("test-disco", resultadoEjemplo());
+  }
+
+  ResultCache nueva(4, "build");
+  ResultadoAsignacion r;
+  bool acierto = nueva.buscar("test-disco", r);
+  printResult("Resultado recuperado del disco",
+              acierto && r.factible && r.asignaciones.size() == 1 &&
+                  r.asignaciones[0].dia == "D1");
+  printResult("Acierto de disco contado", nueva.stats().aciertosDisco == 1);
+  std::remove("build/test-disco.json");
+}
+
+// Test: Opciones de línea de comandos
+void test_cli_options() {
+  std::cout << "\n=== Test: Opciones CLI ===\n";
+
+  const char *args1[] = {"solver",  "--stats", "--cache-size=8",
+                         "--cache-dir", "/tmp/c", "--sensitivity",
+                         "--deadline-ms=250", "in.json"};
+  CliOptions o = parseCliOptions(8, const_cast<char **>(args1));
+  printResult("Opciones leídas", o.stats && o.cacheSize == 8 &&
+                                     o.cacheDir == "/tmp/c" &&
+                                     o.archivo == "in.json" && o.cache &&
+                                     o.sensibilidad && o.deadlineMs == 250 &&
+                                     o.motor == "edmonds-karp");
+
+  const char *args2[] = {"solver",     "--threads", "4",
+                         "--engine=push-relabel", "--renumber", "--verify",
+                         "--trace=t.json"};
+  CliOptions o2 = parseCliOptions(7, const_cast<char **>(args2));
+  printResult("Hilos, motor, renumeración, verificación y traza leídos",
+              o2.hilos == 4 && o2.motor == "push-relabel" && o2.renumerar &&
+                  o2.verificar && o2.traza == "t.json" && !o.renumerar &&
+                  !o.verificar && o.traza.empty());
+
+  auto lanza = [](std::vector<const char *> args) {
+    try {
+      parseCliOptions(static_cast<int>(args.size()),
+                      const_cast<char **>(args.data()));
+    } catch (const std::invalid_argument &) {
+      return true;
+    }
+    return false;
+  };
+  printResult("Opción desconocida rechazada", lanza({"solver", "--foo"}));
+  printResult("Tamaño inválido rechazado",
+              lanza({"solver", "--cache-size=-1"}));
+  printResult("--resident con archivo rechazado",
+              lanza({"solver", "--resident", "a.json"}));
+  printResult("Motor desconocido rechazado",
+              lanza({"solver", "--engine=dinic"}));
+  printResult("--trace sin archivo rechazado",
+              lanza({"solver", "--trace="}));
+  printResult("Motor implícito aceptado",
+              !lanza({"solver", "--engine=implicit"}));
+  printResult("Motor dinámico aceptado",
+              !lanza({"solver", "--engine=boykov-kolmogorov"}));
+  printResult("Implícito con --sensitivity rechazado",
+              lanza({"solver", "--engine=implicit", "--sensitivity"}));
+}
+
+// Test: Modo residente responde una línea por petición y usa la caché
+void test_modo_residente() {
+  std::cout << "\n=== Test: Modo Residente ===\n";
+
+  std::string instancia =
+      R"({"medicos": ["Ana"], "dias": ["D1"], )"
+      R"("periodos": [{"id": "P1", "dias": ["D1"]}], )"
+      R"("disponibilidad": {"Ana": ["D1"]}, "maxGuardiasPorPeriodo": 1})";
+
+  CliOptions opciones;
+  opciones.stats = true;
+  RequestHandler handler(opciones);
+
+  std::istringstream in(instancia + "\n\n{mal json\n" + instancia + "\n");
+  std::ostringstream out;
+  handler.runResident(in, out);
+
+  std::vector<std::string> lineas;
+  std::istringstream salida(out.str());
+  for (std::string l; std::getline(salida, l);) {
+    lineas.push_back(l);
+  }
+
+  printResult("Tres respuestas (línea vacía ignorada)", lineas.size() == 3);
+  if (lineas.size() == 3) {
+    printResult("Primera respuesta sin acierto",
+                lineas[0].find("\"hit\":false") != std::string::npos);
+    printResult("JSON inválido responde error",
+                lineas[1].find("\"error\"") != std::string::npos);
+    printResult("Repetición servida desde la caché",
+                lineas[2].find("\"hit\":true") != std::string::npos);
+  }
+  printResult("Tasa de aciertos 0.5", handler.cacheStats().aciertos == 1 &&
+                                          handler.cacheStats().consultas == 2);
+}
+
+// Runner para tests de la caché de resultados
+void run_result_cache_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║       Tests Unitarios: Caché Resultados    ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_hash_canonico();
+  test_cache_memoria();
+  test_cache_disco();
+  test_cli_options();
+  test_modo_residente();
+}
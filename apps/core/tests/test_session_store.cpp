@@ -0,0 +1,169 @@
+/**
+ * Tests unitarios para las sesiones por versión de plan (modo residente)
+ * Verifica los deltas sobre la instancia de una sesión, el arranque en
+ * caliente desde el flujo anterior y la expiración por memoria
+ */
+
+#include "cli_options.h"
+#include "json_parser.h"
+#include "request_handler.h"
+#include "session_store.h"
+#include "test_utils.h"
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+const std::string INSTANCIA =
+    R"({"sesion": 7, "medicos": ["Ana", "Luis", "Carla"], )"
+    R"("dias": ["D1", "D2", "D3"], )"
+    R"("periodos": [{"id": "P1", "dias": ["D1", "D2", "D3"]}], )"
+    R"("disponibilidad": {"Ana": ["D1", "D2"], "Luis": ["D2", "D3"], )"
+    R"("Carla": ["D3"]}, "maxGuardiasPorPeriodo": 2, )"
+    R"("asignacionesPrevias": {"Ana": ["D1"]}})";
+
+std::vector<std::string> lineas(const std::string &texto) {
+  std::vector<std::string> out;
+  std::istringstream in(texto);
+  for (std::string l; std::getline(in, l);) {
+    out.push_back(l);
+  }
+  return out;
+}
+
+bool contiene(const std::string &texto, const std::string &parte) {
+  return texto.find(parte) != std::string::npos;
+}
+
+} // namespace
+
+// Test: Un delta parte de la instancia de la sesión
+void test_delta_sesion() {
+  std::cout << "\n=== Test: Delta de Sesión ===\n";
+
+  std::string sesion;
+  InputData base = JSONParser::parseInput(INSTANCIA, sesion, nullptr);
+  printResult("Sesión numérica leída como texto", sesion == "7");
+
+  auto deSesion = [&](const std::string &id) -> const InputData * {
+    return id == "7" ? &base : nullptr;
+  };
+  InputData delta = JSONParser::parseInput(
+      R"({"sesion": "7", "capacidades": {"Luis": 1},
+          "disponibilidad": {"Ana": ["D3"]},
+          "asignacionesPrevias": null, "maxGuardiasTotales": 5})",
+      sesion, deSesion);
+  printResult("Conserva médicos, días y periodos",
+              delta.medicos == base.medicos && delta.dias == base.dias &&
+                  delta.periodos.size() == 1);
+  printResult("Objetos se combinan por clave",
+              delta.personalCapacities.at("Luis") == 1 &&
+                  delta.disponibilidad.at("Luis").size() == 2);
+  printResult("La lista de un médico se reemplaza",
+              delta.disponibilidad.at("Ana") ==
+                  std::vector<std::string>{"D3"});
+  printResult("null borra el campo", delta.asignacionesPrevias.empty());
+  printResult("Escalares reemplazados",
+              delta.maxGuardiasTotales == 5 &&
+                  delta.maxGuardiasPorPeriodo == 2);
+  printResult("La instancia de la sesión no cambia",
+              base.asignacionesPrevias.size() == 1 &&
+                  base.personalCapacities.empty());
+
+  bool lanzo = false;
+  try {
+    JSONParser::parseInput(R"({"sesion": "8", "capacidades": {}})", sesion,
+                           deSesion);
+  } catch (const std::runtime_error &) {
+    lanzo = true;
+  }
+  printResult("Sesión desconocida lanza excepción", lanzo);
+
+  InputData completa = JSONParser::parseInput(
+      R"({"sesion": "8", "medicos": ["Ana"], "dias": ["D1"]})", sesion,
+      deSesion);
+  printResult("Con médicos es una instancia completa",
+              completa.medicos.size() == 1 &&
+                  completa.maxGuardiasTotales == 999 &&
+                  completa.medicosPorDia.at("D1") == 1);
+}
+
+// Test: Las sesiones resuelven deltas sobre su propio grafo y flujo
+void test_sesiones_residente() {
+  std::cout << "\n=== Test: Sesiones en Modo Residente ===\n";
+
+  CliOptions opciones;
+  opciones.stats = true;
+  opciones.cache = false;
+  RequestHandler handler(opciones);
+
+  // Abrir la sesión, pedir dos escenarios y volver a la versión
+  std::istringstream in(
+      INSTANCIA + "\n" +
+      R"({"sesion": 7, "asignacionesPrevias": null, )"
+      R"("capacidades": {"Luis": 0, "Carla": 0}})" + "\n" +
+      R"({"sesion": 7, "asignacionesPrevias": null, )"
+      R"("capacidades": {"Luis": 2}})" + "\n" + R"({"sesion": 9, "capacidades": {}})" + "\n" +
+      R"({"sesion": 7})" + "\n");
+  std::ostringstream out;
+  handler.runResident(in, out);
+  std::vector<std::string> r = lineas(out.str());
+
+  printResult("Cinco respuestas", r.size() == 5);
+  if (r.size() != 5) {
+    return;
+  }
+  printResult("Apertura: instancia completa con estabilidad",
+              contiene(r[0], "\"delta\":false") &&
+                  contiene(r[0], "\"estabilidad\""));
+  printResult("Sin Luis ni Carla: D3 queda sin cubrir",
+              contiene(r[1], "\"delta\":true") &&
+                  contiene(r[1], "\"diasCubiertos\":2"));
+  printResult("Con Luis: arranca del flujo anterior y cubre todo",
+              contiene(r[2], "\"flowReused\":true") &&
+                  contiene(r[2], "\"diasCubiertos\":3") &&
+                  contiene(r[2], "\"topologyReused\":true"));
+  printResult("Sesión no abierta responde error",
+              contiene(r[3], "\"error\"") && contiene(r[3], "Unknown session"));
+  printResult("Delta vacío resuelve la versión tal cual",
+              contiene(r[4], "\"estabilidad\"") &&
+                  contiene(r[4], "\"open\":1"));
+}
+
+// Test: Las sesiones expiran por memoria, la menos usada primero
+void test_expiracion_sesiones() {
+  std::cout << "\n=== Test: Expiración de Sesiones ===\n";
+
+  SessionStore sesiones(100);
+  sesiones.abrir("a", InputData(), 60);
+  sesiones.abrir("b", InputData(), 30);
+  sesiones.expirar();
+  printResult("Dentro del límite no expira nada",
+              sesiones.numSesiones() == 2 && sesiones.getExpiradas() == 0);
+
+  sesiones.buscar("a"); // "b" pasa a ser la menos usada
+  sesiones.abrir("c", InputData(), 30);
+  sesiones.expirar();
+  printResult("Expira la menos usada",
+              sesiones.buscar("b") == nullptr && sesiones.buscar("a") &&
+                  sesiones.buscar("c") && sesiones.getExpiradas() == 1);
+  printResult("Memoria estimada bajo el límite",
+              sesiones.memoriaEstimada() == 90);
+
+  sesiones.abrir("a", InputData(), 200);
+  sesiones.expirar();
+  printResult("Una sesión mayor que el límite no se guarda",
+              sesiones.buscar("a") == nullptr);
+}
+
+// Runner para tests de sesiones
+void run_session_store_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║       Tests Unitarios: Sesiones            ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_delta_sesion();
+  test_sesiones_residente();
+  test_expiracion_sesiones();
+}
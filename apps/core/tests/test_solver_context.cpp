@@ -0,0 +1,583 @@
+/**
+ * Tests unitarios para SolverContext
+ * Verifica que un contexto (y un builder) se puedan reutilizar entre instancias
+ */
+
+#include "edmonds_karp.h"
+#include "graph_builder.h"
+#include "json_parser.h"
+#include "solver_context.h"
+#include "test_utils.h"
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+InputData instanciaFactible() {
+  return JSONParser::parseInput(R"({
+    "medicos": ["Ana", "Luis"],
+    "dias": ["D1", "D2", "D3"],
+    "periodos": [{"id": "P1", "dias": ["D1", "D2", "D3"]}],
+    "disponibilidad": {"Ana": ["D1", "D2", "D3"], "Luis": ["D2", "D3"]},
+    "maxGuardiasPorPeriodo": 2,
+    "medicosPorDia": 1
+  })");
+}
+
+InputData instanciaNoFactible() {
+  return JSONParser::parseInput(R"({
+    "medicos": ["Carla"],
+    "dias": ["D1", "D2"],
+    "periodos": [{"id": "P1", "dias": ["D1", "D2"]}],
+    "disponibilidad": {"Carla": ["D1"]},
+    "maxGuardiasPorPeriodo": 2,
+    "medicosPorDia": 1
+  })");
+}
+
+} // namespace
+
+// Test: Un contexto resuelve varias instancias seguidas
+void test_contexto_reutilizable() {
+  std::cout << "\n=== Test: Contexto Reutilizable ===\n";
+
+  SolverContext context;
+
+  context.load(instanciaFactible());
+  ResultadoAsignacion primero = context.solve();
+  printResult("Primera instancia factible", primero.factible);
+  printResult("Primera instancia: flujo 3", context.getMaxFlow() == 3);
+
+  context.load(instanciaNoFactible());
+  ResultadoAsignacion segundo = context.solve();
+  printResult("Segunda instancia no factible", !segundo.factible);
+  printResult("Segunda instancia: 1 día cubierto",
+              segundo.diasCubiertos == 1);
+  printResult("Segunda instancia reporta bottlenecks",
+              !segundo.bottlenecks.empty());
+
+  bool sinRestos = true;
+  for (const auto &asig : segundo.asignaciones) {
+    if (asig.medico != "Carla") {
+      sinRestos = false;
+    }
+  }
+  printResult("Sin asignaciones de la instancia anterior", sinRestos);
+
+  context.load(instanciaFactible());
+  ResultadoAsignacion tercero = context.solve();
+  printResult("Recargar la primera instancia da el mismo resultado",
+              tercero.factible &&
+                  tercero.asignaciones.size() == primero.asignaciones.size());
+}
+
+// Test: Resolver sin instancia cargada lanza excepción
+void test_contexto_sin_instancia() {
+  std::cout << "\n=== Test: Contexto Sin Instancia ===\n";
+
+  SolverContext context;
+  bool lanzo = false;
+  try {
+    context.solve();
+  } catch (const std::runtime_error &) {
+    lanzo = true;
+  }
+  printResult("solve() sin load() lanza excepción", lanzo);
+
+  context.load(instanciaFactible());
+  context.reset();
+  lanzo = false;
+  try {
+    context.solve();
+  } catch (const std::runtime_error &) {
+    lanzo = true;
+  }
+  printResult("solve() después de reset() lanza excepción", lanzo);
+}
+
+// Test: Reconstruir un builder con menos médicos no deja nodos viejos
+void test_builder_reconstruible() {
+  std::cout << "\n=== Test: Builder Reconstruible ===\n";
+
+  GraphBuilder builder;
+  builder.setMedicos({"M1", "M2"});
+  builder.setDias({"D1", "D2"});
+  builder.setPeriodos({{"P1", {"D1", "D2"}}});
+  builder.setDisponibilidad({{"M1", {"D1"}}, {"M2", {"D2"}}});
+  builder.setMedicosRequeridosTodosDias(1);
+  builder.build();
+
+  builder.setMedicos({"M1"});
+  Graph g = builder.build();
+
+  // 1 source + 1 médico + 1 médico-periodo + 2 días + 1 sink = 6
+  printResult("Número de vértices = 6", g.getNumVertices() == 6);
+
+  EdmondsKarp ek;
+  std::vector<std::vector<int>> flowGraph;
+  ek.maxFlowWithResult(g, builder.getSource(), builder.getSink(), flowGraph);
+  ResultadoAsignacion resultado = builder.extraerResultado(flowGraph);
+
+  printResult("Solo 1 asignación", resultado.asignaciones.size() == 1);
+  printResult("Asignación de M1",
+              resultado.asignaciones.size() == 1 &&
+                  resultado.asignaciones[0].medico == "M1");
+}
+
+// Test: EdmondsKarp reutilizado con matrices de distinto tamaño
+void test_edmonds_karp_reutilizado() {
+  std::cout << "\n=== Test: Edmonds-Karp Reutilizado ===\n";
+
+  EdmondsKarp ek;
+  std::vector<std::vector<int>> flowGraph;
+  Graph residual(0);
+
+  Graph grande(4);
+  grande.addEdge(0, 1, 3);
+  grande.addEdge(1, 2, 3);
+  grande.addEdge(2, 3, 3);
+  int primero = ek.maxFlow(grande, 0, 3, residual, flowGraph);
+
+  Graph chico(3);
+  chico.addEdge(0, 1, 2);
+  chico.addEdge(1, 2, 1);
+  int segundo = ek.maxFlow(chico, 0, 2, residual, flowGraph);
+
+  printResult("Primer flujo = 3", primero == 3);
+  printResult("Segundo flujo = 1", segundo == 1);
+  printResult("Matriz de flujo redimensionada", flowGraph.size() == 3);
+  printResult("Flujo reiniciado entre llamadas", flowGraph[0][1] == 1);
+}
+
+// Test: Cambiar solo capacidades reutiliza la topología del grafo
+void test_topologia_reutilizada() {
+  std::cout << "\n=== Test: Topología Reutilizada ===\n";
+
+  SolverContext context;
+  InputData data = instanciaFactible();
+  context.load(data);
+  context.solve();
+  printResult("Primera resolución construye el grafo",
+              !context.getTopologiaReutilizada());
+
+  // Solo capacidades: demanda, límite por periodo y capacidad personal
+  data.medicosPorDia["D2"] = 2;
+  data.maxGuardiasPorPeriodo = 1;
+  data.personalCapacities["Luis"] = 1;
+  context.load(data);
+  ResultadoAsignacion reutilizado = context.solve();
+  printResult("Cambio de capacidades reutiliza la topología",
+              context.getTopologiaReutilizada());
+
+  SolverContext nuevo;
+  nuevo.load(data);
+  ResultadoAsignacion desdeCero = nuevo.solve();
+  printResult("Mismo resultado que construyendo desde cero",
+              JSONParser::toJson(reutilizado) == JSONParser::toJson(desdeCero));
+  printResult("Mismo grafo que construyendo desde cero",
+              context.getGraph().getNumVertices() ==
+                      nuevo.getGraph().getNumVertices() &&
+                  context.getGraph().getCapacity(0, 2) ==
+                      nuevo.getGraph().getCapacity(0, 2) &&
+                  context.getGraph().getCapacity(1, 3) == 1);
+
+  // Cambiar disponibilidad cambia las aristas de la capa 3
+  data.disponibilidad["Luis"] = {"D1"};
+  context.load(data);
+  context.solve();
+  printResult("Cambio de disponibilidad reconstruye el grafo",
+              !context.getTopologiaReutilizada());
+
+  // Reordenar médicos cambia la numeración de nodos
+  data.medicos = {"Luis", "Ana"};
+  context.load(data);
+  context.solve();
+  printResult("Reordenar médicos reconstruye el grafo",
+              !context.getTopologiaReutilizada());
+}
+
+// Test: Asignaciones fijas se respetan o se informan como conflicto
+void test_asignaciones_fijas() {
+  std::cout << "\n=== Test: Asignaciones Fijas ===\n";
+
+  // Sin fijas, Ana cubre D1 (Luis no puede D1); fijar a Ana en D2 obliga a
+  // que Luis cubra D3 y deja D1 a Ana solo si su límite total lo permite
+  InputData data = instanciaFactible();
+  data.maxGuardiasTotales = 2;
+  data.asignacionesFijas = {{"Ana", {"D2"}}};
+
+  SolverContext context;
+  context.load(data);
+  ResultadoAsignacion r = context.solve();
+
+  bool anaEnD2 = false;
+  for (const auto &a : r.asignaciones) {
+    anaEnD2 = anaEnD2 || (a.medico == "Ana" && a.dia == "D2");
+  }
+  printResult("Factible con Ana fija en D2", r.factible);
+  printResult("La asignación fija está en el resultado", anaEnD2);
+
+  // Dos fijas en un día que requiere un solo médico
+  data.asignacionesFijas = {{"Ana", {"D2"}}, {"Luis", {"D2"}}};
+  context.load(data);
+  r = context.solve();
+  printResult("Fijas incompatibles -> no factible", !r.factible);
+  printResult("Bottlenecks señalan las fijas",
+              r.bottlenecks.size() == 2 && r.bottlenecks[0].tipo == "Lock" &&
+                  r.bottlenecks[0].id == "Ana on D2");
+
+  // Una fija que excede el límite total del médico
+  data.maxGuardiasTotales = 1;
+  data.asignacionesFijas = {{"Ana", {"D1", "D2"}}};
+  context.load(data);
+  r = context.solve();
+  printResult("Fijas por encima del límite -> no factible",
+              !r.factible && !r.bottlenecks.empty() &&
+                  r.bottlenecks[0].razon ==
+                      "Locked shifts exceed the doctor's limits");
+
+  // Fijas que dejan un día sin cubrir: min-cut normal
+  data.maxGuardiasTotales = 1;
+  data.asignacionesFijas = {{"Ana", {"D2"}}};
+  context.load(data);
+  r = context.solve();
+  bool d1SinCubrir = false;
+  for (const auto &b : r.bottlenecks) {
+    d1SinCubrir = d1SinCubrir || (b.tipo == "Day" && b.id == "D1");
+  }
+  printResult("Día no cubierto por culpa de la fija se informa",
+              !r.factible && d1SinCubrir);
+}
+
+// Test: Con un plan previo se cambian las menos asignaciones posibles
+void test_asignaciones_previas() {
+  std::cout << "\n=== Test: Asignaciones Previas ===\n";
+
+  // El plan previo se puede mantener entero
+  InputData data = instanciaFactible();
+  data.asignacionesPrevias = {{"Ana", {"D1", "D3"}}, {"Luis", {"D2"}}};
+
+  SolverContext context;
+  context.load(data);
+  ResultadoAsignacion r = context.solve();
+  printResult("Plan previo válido se conserva",
+              r.factible && r.conEstabilidad && r.estabilidad.previas == 3 &&
+                  r.estabilidad.conservadas == 3 && r.estabilidad.cambios == 0);
+
+  // Ana deja de estar disponible en D3: basta con pasar D3 a Luis
+  data.disponibilidad["Ana"] = {"D1", "D2"};
+  context.load(data);
+  r = context.solve();
+  bool luisEnD3 = false;
+  for (const auto &a : r.asignaciones) {
+    luisEnD3 = luisEnD3 || (a.medico == "Luis" && a.dia == "D3");
+  }
+  printResult("Reparación factible", r.factible && luisEnD3);
+  printResult("Cambios mínimos (uno quitado, uno añadido)",
+              r.estabilidad.conservadas == 2 && r.estabilidad.cambios == 2);
+
+  // Sin plan previo no se informa estabilidad
+  context.load(instanciaFactible());
+  printResult("Sin previas no hay estabilidad",
+              !context.solve().conEstabilidad);
+
+  // Previas y fijas juntas no están soportadas
+  data.asignacionesFijas = {{"Ana", {"D1"}}};
+  context.load(data);
+  bool lanzo = false;
+  try {
+    context.solve();
+  } catch (const std::runtime_error &) {
+    lanzo = true;
+  }
+  printResult("Previas con fijas lanza excepción", lanzo);
+}
+
+// Test: Tabla de sensibilidad por médico
+void test_sensibilidad() {
+  std::cout << "\n=== Test: Sensibilidad ===\n";
+
+  // Ana es la única disponible en D1, pero sin ella Luis cubre D2 y D3;
+  // sin Luis, Ana no puede hacer más de 2 guardias en el periodo
+  SolverContext context;
+  context.load(instanciaFactible());
+  ResultadoAsignacion r = context.solve();
+  std::vector<SensibilidadMedico> tabla = context.sensibilidad();
+
+  printResult("Una fila por médico", tabla.size() == 2);
+  printResult("Sin Ana solo se pierde D1",
+              tabla[0].medico == "Ana" && tabla[0].asignaciones == 2 &&
+                  tabla[0].diasPerdidos == 1);
+  printResult("Sin Luis se pierde su día",
+              tabla[1].medico == "Luis" && tabla[1].asignaciones == 1 &&
+                  tabla[1].diasPerdidos == 1);
+  printResult("La solución no cambia", r.diasCubiertos == 3 &&
+                                           context.getMaxFlow() == 3);
+
+  // Con fijas no hay residual de un max-flow simple
+  InputData data = instanciaFactible();
+  data.asignacionesFijas = {{"Ana", {"D1"}}};
+  context.load(data);
+  context.solve();
+  bool lanzo = false;
+  try {
+    context.sensibilidad();
+  } catch (const std::runtime_error &) {
+    lanzo = true;
+  }
+  printResult("Con fijas lanza excepción", lanzo);
+}
+
+// Test: Con el plazo vencido se devuelve el mejor flujo parcial
+void test_deadline() {
+  std::cout << "\n=== Test: Deadline ===\n";
+
+  SolverContext context;
+  context.load(instanciaFactible());
+  context.setDeadline(Deadline(Deadline::Reloj::now()));
+  ResultadoAsignacion r = context.solve();
+  printResult("Resultado parcial y no factible", r.parcial && !r.factible);
+  printResult("Cobertura alcanzada informada, sin bottlenecks",
+              r.diasCubiertos == 0 && r.diasRequeridos == 3 &&
+                  r.bottlenecks.empty());
+
+  std::string json = JSONParser::toJson(r);
+  printResult("JSON marca el resultado como parcial",
+              json.find("\"parcial\": true") != std::string::npos &&
+                  JSONParser::parseResultado(json).parcial);
+
+  // Sin demanda el flujo vacío ya es máximo: no es parcial
+  InputData data = instanciaFactible();
+  data.medicosPorDia = {{"D1", 0}, {"D2", 0}, {"D3", 0}};
+  context.load(data);
+  r = context.solve();
+  printResult("Cobertura completa no es parcial", r.factible && !r.parcial);
+
+  // Con previas (flujo de coste mínimo) también se respeta el plazo
+  data = instanciaFactible();
+  data.asignacionesPrevias = {{"Luis", {"D2"}}};
+  context.load(data);
+  r = context.solve();
+  printResult("Reparación estable parcial", r.parcial && !r.factible);
+
+  context.setDeadline(Deadline());
+  context.load(instanciaFactible());
+  r = context.solve();
+  printResult("Sin plazo se resuelve completo", r.factible && !r.parcial);
+}
+
+// Test: Con prioridades se cubren primero los días más importantes
+void test_prioridades() {
+  std::cout << "\n=== Test: Prioridades ===\n";
+
+  // Carla solo puede cubrir uno de sus dos días
+  InputData data = instanciaNoFactible();
+  data.disponibilidad["Carla"] = {"D1", "D2"};
+  data.maxGuardiasPorPeriodo = 1;
+  data.prioridadDias = {{"D2", 10}};
+
+  SolverContext context;
+  context.load(data);
+  ResultadoAsignacion r = context.solve();
+  printResult("Se cubre el día prioritario",
+              r.asignaciones.size() == 1 && r.asignaciones[0].dia == "D2");
+  printResult("El día no cubierto aparece en los bottlenecks",
+              !r.bottlenecks.empty() && r.bottlenecks[0].tipo == "Day" &&
+                  r.bottlenecks[0].id == "D1");
+  printResult("Cobertura por prioridad, de mayor a menor",
+              r.coberturaPorPrioridad.size() == 2 &&
+                  r.coberturaPorPrioridad[0].prioridad == 10 &&
+                  r.coberturaPorPrioridad[0].diasCubiertos == 1 &&
+                  r.coberturaPorPrioridad[1].diasCubiertos == 0 &&
+                  r.coberturaPorPrioridad[1].diasRequeridos == 1);
+
+  data.prioridadDias = {{"D1", 10}};
+  context.load(data);
+  r = context.solve();
+  printResult("Cambiar la prioridad cambia el día cubierto",
+              r.asignaciones.size() == 1 && r.asignaciones[0].dia == "D1");
+
+  data.asignacionesFijas = {{"Carla", {"D1"}}};
+  context.load(data);
+  bool lanzo = false;
+  try {
+    context.solve();
+  } catch (const std::runtime_error &) {
+    lanzo = true;
+  }
+  printResult("Prioridades con fijas lanza excepción", lanzo);
+}
+
+// Test: Roles por día
+void test_roles() {
+  std::cout << "\n=== Test: Roles ===\n";
+
+  // D1 pide un cirujano y un anestesista; solo hay un cirujano (Ana)
+  InputData data;
+  data.medicos = {"Ana", "Luis", "Carla"};
+  data.dias = {"D1", "D2"};
+  data.periodos = {{"P1", {"D1", "D2"}}};
+  data.disponibilidad = {{"Ana", {"D1", "D2"}},
+                         {"Luis", {"D1", "D2"}},
+                         {"Carla", {"D1", "D2"}}};
+  data.maxGuardiasPorPeriodo = 2;
+  data.maxGuardiasTotales = 2;
+  data.medicosPorDia = {{"D1", 1}, {"D2", 1}};
+  data.roles = {{"Ana", "cirujano"}, {"Luis", "anestesista"}};
+  data.demandaPorRol = {{"D1", {{"cirujano", 2}, {"anestesista", 1}}}};
+
+  SolverContext context;
+  context.load(data);
+  ResultadoAsignacion r = context.solve();
+  printResult("Falta un cirujano: no factible",
+              !r.factible && r.diasCubiertos == 3 && r.diasRequeridos == 4);
+
+  bool cuelloRol = false;
+  for (const auto &b : r.bottlenecks) {
+    cuelloRol |= b.tipo == "Role" && b.id == "D1 / cirujano";
+  }
+  printResult("El rol escaso aparece en los bottlenecks", cuelloRol);
+
+  bool rolesCorrectos = true;
+  int enD1 = 0;
+  for (const auto &a : r.asignaciones) {
+    if (a.dia == "D1") {
+      enD1++;
+      rolesCorrectos &= (a.medico == "Ana" && a.rol == "cirujano") ||
+                        (a.medico == "Luis" && a.rol == "anestesista");
+    } else {
+      rolesCorrectos &= a.rol.empty();
+    }
+  }
+  printResult("Carla (sin rol) no cubre D1; las asignaciones llevan el rol",
+              rolesCorrectos && enD1 == 2);
+
+  data.demandaPorRol["D1"]["cirujano"] = 1;
+  context.load(data);
+  r = context.solve();
+  printResult("Con demanda cubrible es factible", r.factible);
+}
+
+// Test: Turnos (día/noche) dentro del día
+void test_turnos() {
+  std::cout << "\n=== Test: Turnos ===\n";
+
+  // D1 pide un turno de día y uno de noche; Luis solo puede de noche
+  InputData data;
+  data.medicos = {"Ana", "Luis"};
+  data.dias = {"D1", "D2"};
+  data.periodos = {{"P1", {"D1", "D2"}}};
+  data.disponibilidad = {{"Ana", {"D1", "D2"}}, {"Luis", {"D1"}}};
+  data.maxGuardiasPorPeriodo = 2;
+  data.maxGuardiasTotales = 2;
+  data.medicosPorDia = {{"D1", 1}, {"D2", 1}};
+  data.demandaPorTurno = {{"D1", {{"dia", 1}, {"noche", 1}}}};
+  data.disponibilidadPorTurno = {{"Luis", {{"D1", {"noche"}}}}};
+
+  SolverContext context;
+  context.load(data);
+  ResultadoAsignacion r = context.solve();
+  printResult("Factible: la demanda del día es la suma de sus turnos",
+              r.factible && r.diasRequeridos == 3 && r.diasCubiertos == 3);
+
+  bool turnosCorrectos = true;
+  for (const auto &a : r.asignaciones) {
+    if (a.dia == "D1") {
+      turnosCorrectos &= (a.medico == "Ana" && a.turno == "dia") ||
+                         (a.medico == "Luis" && a.turno == "noche");
+    } else {
+      turnosCorrectos &= a.turno.empty();
+    }
+  }
+  printResult("Cada asignación lleva su turno", turnosCorrectos);
+
+  // Sin Luis, Ana no puede cubrir los dos turnos del mismo día
+  data.disponibilidad["Luis"] = {};
+  context.load(data);
+  r = context.solve();
+  int enD1 = 0;
+  for (const auto &a : r.asignaciones) {
+    enD1 += a.dia == "D1";
+  }
+  bool cuelloTurno = false;
+  for (const auto &b : r.bottlenecks) {
+    cuelloTurno |= b.tipo == "Slot" && b.id.rfind("D1 / ", 0) == 0;
+  }
+  printResult("Como máximo un turno por médico y día",
+              !r.factible && r.diasCubiertos == 2 && enD1 == 1);
+  printResult("El turno sin cubrir aparece en los bottlenecks", cuelloTurno);
+
+  data.demandaPorRol = {{"D1", {{"cirujano", 1}}}};
+  bool lanzo = false;
+  try {
+    context.load(data);
+    context.solve();
+  } catch (const std::runtime_error &) {
+    lanzo = true;
+  }
+  printResult("Día con roles y turnos lanza excepción", lanzo);
+}
+
+// Test: Arranques en caliente cuando el ancho de capacidad cambia
+void test_ancho_entre_solves() {
+  std::cout << "\n=== Test: Ancho de Capacidad entre Solves ===\n";
+
+  // 300 días: límites de 200 caben en 8 bits, de 300 no
+  InputData data;
+  data.medicos = {"M1", "M2"};
+  data.periodos = {{"P1", {}}};
+  for (int d = 0; d < 300; d++) {
+    std::string dia = "D" + std::to_string(d);
+    data.dias.push_back(dia);
+    data.periodos[0].dias.push_back(dia);
+    data.disponibilidad["M1"].push_back(dia);
+    if (d % 3 == 0) {
+      data.disponibilidad["M2"].push_back(dia);
+    }
+  }
+
+  bool igual = true;
+  int reutilizados = 0;
+  for (const char *motor : {"edmonds-karp", "boykov-kolmogorov"}) {
+    SolverContext context;
+    context.setMotor(motor);
+    context.setReutilizarFlujo(true);
+    context.setVerificar(true);
+    for (int limite : {200, 300, 200}) {
+      data.maxGuardiasPorPeriodo = limite;
+      data.maxGuardiasTotales = limite;
+      context.load(data);
+      ResultadoAsignacion caliente = context.solve();
+      reutilizados += context.getFlujoReutilizado();
+      SolverContext nuevo;
+      nuevo.load(data);
+      ResultadoAsignacion frio = nuevo.solve();
+      igual = igual && caliente.diasCubiertos == frio.diasCubiertos &&
+              caliente.factible == frio.factible;
+    }
+  }
+  printResult("Reanuda al ensanchar y al volver a estrechar",
+              reutilizados == 4);
+  printResult("Misma cobertura que desde cero (certificada)", igual);
+}
+
+// Runner para tests de SolverContext
+void run_solver_context_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║       Tests Unitarios: SolverContext       ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_contexto_reutilizable();
+  test_contexto_sin_instancia();
+  test_builder_reconstruible();
+  test_edmonds_karp_reutilizado();
+  test_topologia_reutilizada();
+  test_asignaciones_fijas();
+  test_asignaciones_previas();
+  test_sensibilidad();
+  test_deadline();
+  test_prioridades();
+  test_roles();
+  test_turnos();
+  test_ancho_entre_solves();
+}
@@ -0,0 +1,103 @@
+/**
+ * Tests unitarios para el stress diferencial entre motores
+ * Una pasada corta del stress (make stress hace la larga): todas las
+ * variantes coinciden en instancias aleatorias y de hospital con ediciones,
+ * y la reducción lleva un caso que falla a un reproductor mínimo que sigue
+ * fallando tras guardarlo como JSON
+ */
+
+#include "stress_utils.h"
+#include "test_utils.h"
+#include <iostream>
+
+// Test: Todas las variantes coinciden con Edmonds-Karp
+void test_stress_diferencial() {
+  std::cout << "\n=== Test: Stress Diferencial Corto ===\n";
+
+  std::mt19937 rng(11);
+  DiferencialStress diferencial;
+  int diferencias = 0;
+  int instancias = 0;
+  std::string primera;
+  for (int k = 0; k < 150; k++) {
+    InputData data = instanciaStress(rng, 6, 12);
+    std::string detalle = diferencial.comparar(data);
+    diferencias += !detalle.empty();
+    primera = primera.empty() ? detalle : primera;
+    instancias++;
+  }
+  for (int k = 0; k < 4; k++) {
+    InputData data = instanciaHospital(rng, 20, 90);
+    for (int edicion = 0; edicion < 4; edicion++) {
+      editarStress(rng, data, edicion == 0 ? 0 : 3);
+      std::string detalle = diferencial.comparar(data);
+      diferencias += !detalle.empty();
+      primera = primera.empty() ? detalle : primera;
+      instancias++;
+    }
+  }
+  std::cout << primera;
+  printResult(std::to_string(instancias) + " instancias sin diferencias",
+              diferencias == 0);
+  printResult("Siete variantes cronometradas, una con pool",
+              diferencial.getMs().size() == 7 &&
+                  diferencial.getVariantes()[0].nombre == "edmonds-karp" &&
+                  diferencial.getVariantes()[2].pool);
+}
+
+// Test: La reducción deja solo lo necesario para fallar
+void test_stress_reduccion() {
+  std::cout << "\n=== Test: Reducción a Reproductor Mínimo ===\n";
+
+  // "Falla" si M2 puede hacer D3 y algún periodo lo incluye con demanda
+  FallaStress falla = [](const InputData &data) {
+    auto it = data.disponibilidad.find("M2");
+    bool disponible =
+        it != data.disponibilidad.end() &&
+        std::find(it->second.begin(), it->second.end(), "D3") !=
+            it->second.end();
+    bool enPeriodo = false;
+    for (const auto &periodo : data.periodos) {
+      enPeriodo = enPeriodo || std::find(periodo.dias.begin(),
+                                         periodo.dias.end(),
+                                         "D3") != periodo.dias.end();
+    }
+    auto demanda = data.medicosPorDia.find("D3");
+    return disponible && enPeriodo && demanda != data.medicosPorDia.end() &&
+           demanda->second > 0;
+  };
+
+  std::mt19937 rng(2);
+  InputData data;
+  do {
+    data = instanciaStress(rng, 8, 12);
+  } while (!falla(data) || data.roles.empty() || data.medicos.size() < 4 ||
+           data.dias.size() < 6);
+
+  InputData minima = reducirStress(data, falla);
+  printResult("Partía de una instancia mayor",
+              data.medicos.size() >= 4 && data.dias.size() >= 6);
+  printResult("Un médico, un día, un periodo",
+              minima.medicos == std::vector<std::string>{"M2"} &&
+                  minima.dias == std::vector<std::string>{"D3"} &&
+                  minima.periodos.size() == 1);
+  printResult("Solo la disponibilidad necesaria",
+              numDisponibilidadStress(minima) == 1);
+  printResult("Sin campos opcionales",
+              minima.roles.empty() && minima.demandaPorRol.empty() &&
+                  minima.asignacionesFijas.empty() &&
+                  minima.prioridadDias.empty());
+  printResult("El reproductor guardado sigue fallando",
+              falla(JSONParser::parseInput(
+                  JSONParser::inputToJson(minima, 2))));
+}
+
+// Runner para tests del stress diferencial
+void run_stress_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║    Tests Unitarios: Stress Diferencial     ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_stress_diferencial();
+  test_stress_reduccion();
+}
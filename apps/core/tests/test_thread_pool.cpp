@@ -0,0 +1,153 @@
+/**
+ * Tests unitarios para el pool de hilos con robo de tareas
+ * Verifica grupos, tareas anidadas, excepciones, el aparcado de hilos
+ * ociosos y mide el sobrecoste de planificación por tarea
+ */
+
+#include "thread_pool.h"
+#include "test_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Suma de [desde, hasta) partiendo el rango en tareas anidadas
+long sumaAnidada(ThreadPool *pool, long desde, long hasta) {
+  if (hasta - desde <= 64) {
+    long suma = 0;
+    for (long i = desde; i < hasta; i++) {
+      suma += i;
+    }
+    return suma;
+  }
+  long mitad = (desde + hasta) / 2;
+  long izquierda = 0;
+  ThreadPool::Grupo grupo(pool);
+  grupo.lanzar([&] { izquierda = sumaAnidada(pool, desde, mitad); });
+  long derecha = sumaAnidada(pool, mitad, hasta);
+  grupo.esperar();
+  return izquierda + derecha;
+}
+
+} // namespace
+
+// Test: Todas las tareas de un grupo corren antes de que esperar() vuelva
+void test_pool_grupos() {
+  std::cout << "\n=== Test: Grupos de Tareas ===\n";
+
+  ThreadPool pool(3);
+  printResult("Tres hilos", pool.getHilos() == 3);
+
+  std::atomic<int> hechas{0};
+  ThreadPool::Grupo grupo(&pool);
+  for (int i = 0; i < 10000; i++) {
+    grupo.lanzar([&] { hechas.fetch_add(1); });
+  }
+  grupo.esperar();
+  printResult("10000 tareas ejecutadas", hechas.load() == 10000);
+
+  std::vector<int> marcas(1000, 0);
+  ThreadPool::paraCada(&pool, 1000, [&](int i) { marcas[i] = i + 1; });
+  bool todas = true;
+  for (int i = 0; i < 1000; i++) {
+    todas = todas && marcas[i] == i + 1;
+  }
+  printResult("paraCada cubre todo el rango", todas);
+
+  std::thread::id llamador = std::this_thread::get_id();
+  bool enLlamador = true;
+  ThreadPool::paraCada(nullptr, 4, [&](int) {
+    enLlamador = enLlamador && std::this_thread::get_id() == llamador;
+  });
+  printResult("Sin pool corre en el hilo llamador", enLlamador);
+}
+
+// Test: Tareas que esperan a sus propias subtareas no bloquean el pool
+void test_pool_anidado() {
+  std::cout << "\n=== Test: Tareas Anidadas ===\n";
+
+  ThreadPool pool(2);
+  const long n = 1 << 16;
+  printResult("Suma con 1000+ grupos anidados",
+              sumaAnidada(&pool, 0, n) == n * (n - 1) / 2);
+  printResult("Igual sin pool",
+              sumaAnidada(nullptr, 0, n) == n * (n - 1) / 2);
+
+  bool lanzo = false;
+  try {
+    ThreadPool::paraCada(&pool, 8, [](int i) {
+      if (i == 5) {
+        throw std::runtime_error("fallo");
+      }
+    });
+  } catch (const std::runtime_error &) {
+    lanzo = true;
+  }
+  printResult("La excepción de una tarea llega a esperar()", lanzo);
+}
+
+// Test: Los hilos sin trabajo se aparcan y despiertan con trabajo nuevo
+void test_pool_aparcado() {
+  std::cout << "\n=== Test: Aparcado de Hilos Ociosos ===\n";
+
+  ThreadPool pool(2);
+  auto esperarDormidos = [&](unsigned n) {
+    auto limite = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (pool.getDormidos() != n &&
+           std::chrono::steady_clock::now() < limite) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return pool.getDormidos() == n;
+  };
+  printResult("Ociosos: todos aparcados", esperarDormidos(2));
+
+  std::atomic<int> hechas{0};
+  {
+    ThreadPool::Grupo grupo(&pool);
+    for (int i = 0; i < 100; i++) {
+      grupo.lanzar([&] { hechas.fetch_add(1); });
+    }
+  } // El destructor espera
+  printResult("Trabajo tras aparcar se ejecuta", hechas.load() == 100);
+  printResult("Vuelven a aparcar", esperarDormidos(2));
+}
+
+// Test: Sobrecoste de planificación (benchmark, con cota holgada)
+void test_pool_sobrecoste() {
+  std::cout << "\n=== Test: Sobrecoste de Planificación ===\n";
+
+  ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+  const int tareas = 200000;
+  std::atomic<long> suma{0};
+  auto inicio = std::chrono::steady_clock::now();
+  ThreadPool::paraCada(&pool, tareas, [&](int i) {
+    suma.fetch_add(i, std::memory_order_relaxed);
+  });
+  double ns = std::chrono::duration<double, std::nano>(
+                  std::chrono::steady_clock::now() - inicio)
+                  .count() /
+              tareas;
+
+  std::cout << "  Sobrecoste por tarea vacía: " << ns << " ns ("
+            << pool.getHilos() << " hilos)\n";
+  printResult("Todas las tareas ejecutadas",
+              suma.load() == long(tareas) * (tareas - 1) / 2);
+  printResult("Menos de 20 us por tarea", ns < 20000);
+}
+
+// Runner para tests del pool de hilos
+void run_thread_pool_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║       Tests Unitarios: Pool de Hilos       ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_pool_grupos();
+  test_pool_anidado();
+  test_pool_aparcado();
+  test_pool_sobrecoste();
+}
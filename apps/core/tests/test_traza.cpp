@@ -0,0 +1,197 @@
+/**
+ * Tests unitarios para la traza de fases (--trace)
+ * Verifica que sin activar no registra nada, que los tramos anidan y
+ * guardan sus argumentos, que cada hilo del pool es una pista propia, que
+ * un solve deja sus fases y que el archivo es JSON válido
+ */
+
+#include "external/json.hpp"
+#include "solver_context.h"
+#include "test_utils.h"
+#include "thread_pool.h"
+#include "traza.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using json = nlohmann::json;
+
+namespace {
+
+// Eventos "X" (tramos) de la traza registrada hasta ahora
+std::vector<json> tramos() {
+  std::vector<json> eventos;
+  json traza = json::parse(Traza::toJson());
+  for (const auto &e : traza["traceEvents"]) {
+    if (e["ph"] == "X") {
+      eventos.push_back(e);
+    }
+  }
+  return eventos;
+}
+
+bool contiene(const std::vector<json> &eventos, const std::string &nombre) {
+  for (const auto &e : eventos) {
+    if (e["name"] == nombre) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+// Test: Tramos anidados con argumentos; apagada no registra
+void test_traza_tramos() {
+  std::cout << "\n=== Test: Tramos de la Traza ===\n";
+
+  Traza::desactivar();
+  {
+    Traza::Tramo tramo("apagado");
+    tramo.arg("n", 1);
+  }
+  printResult("Sin activar no registra", tramos().empty());
+
+  Traza::activar();
+  {
+    Traza::Tramo exterior("exterior", "test");
+    exterior.arg("n", 1);
+    exterior.arg("n", 2);
+    exterior.arg("m", 3);
+    exterior.arg("descartado", 4);
+    Traza::Tramo interior("interior", "test");
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    interior.terminar();
+    Traza::Tramo despues("despues", "test");
+  }
+  std::vector<json> eventos = tramos();
+  std::map<std::string, json> porNombre;
+  for (const auto &e : eventos) {
+    porNombre[e["name"]] = e;
+  }
+  json &exterior = porNombre["exterior"];
+  json &interior = porNombre["interior"];
+  json &despues = porNombre["despues"];
+  printResult("Tres tramos", eventos.size() == 3);
+  printResult("Interior dentro del exterior",
+              interior["ts"] >= exterior["ts"] &&
+                  double(interior["ts"]) + double(interior["dur"]) <=
+                      double(exterior["ts"]) + double(exterior["dur"]) &&
+                  double(interior["dur"]) >= 1000.0);
+  printResult("terminar() cierra antes del final del ámbito",
+              double(despues["ts"]) >=
+                  double(interior["ts"]) + double(interior["dur"]));
+  printResult("Argumentos: repetir clave la reemplaza, máximo dos",
+              exterior["args"] == json({{"n", 2}, {"m", 3}}) &&
+                  exterior["cat"] == "test");
+
+  Traza::desactivar();
+  printResult("Desactivar descarta lo registrado", tramos().empty());
+}
+
+// Test: Cada hilo del pool es una pista con su nombre
+void test_traza_hilos() {
+  std::cout << "\n=== Test: Pistas por Hilo ===\n";
+
+  ThreadPool pool(3);
+  Traza::activar();
+  Traza::nombrarHilo("test");
+  ThreadPool::paraCada(&pool, 8, [](int) {
+    Traza::Tramo tramo("tarea", "test");
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  });
+
+  json traza = json::parse(Traza::toJson());
+  std::set<int> pistas;
+  std::set<std::string> nombres;
+  for (const auto &e : traza["traceEvents"]) {
+    if (e["ph"] == "X" && e["name"] == "tarea") {
+      pistas.insert(int(e["tid"]));
+    } else if (e["name"] == "thread_name") {
+      nombres.insert(std::string(e["args"]["name"]));
+    }
+  }
+  bool conTrabajador = false;
+  for (const auto &nombre : nombres) {
+    conTrabajador = conTrabajador || nombre.rfind("worker ", 0) == 0;
+  }
+  printResult("Tareas en varias pistas", pistas.size() >= 2);
+  printResult("Pistas nombradas (test y worker N)",
+              nombres.count("test") == 1 && conTrabajador &&
+                  nombres.size() == pistas.size());
+  Traza::desactivar();
+}
+
+// Test: Un solve deja sus fases, y el archivo se escribe
+void test_traza_solve() {
+  std::cout << "\n=== Test: Fases de un Solve ===\n";
+
+  InputData data;
+  data.medicos = {"M1", "M2"};
+  data.dias = {"D1", "D2", "D3"};
+  data.periodos = {{"P1", {"D1", "D2", "D3"}}};
+  data.disponibilidad = {{"M1", {"D1", "D2"}}, {"M2", {"D1"}}};
+  data.maxGuardiasPorPeriodo = 2;
+  data.maxGuardiasTotales = 2;
+
+  const char *motores[] = {"edmonds-karp", "push-relabel", "implicit",
+                           "boykov-kolmogorov"};
+  bool todas = true;
+  for (const char *motor : motores) {
+    SolverContext context;
+    context.setMotor(motor);
+    context.setVerificar(true);
+    Traza::activar();
+    context.load(data);
+    context.solve();
+    std::vector<json> eventos = tramos();
+    bool fases = true;
+    for (const char *fase : {"intern", "build", "solve", "extract", "min-cut",
+                             "bottlenecks", "certificate"}) {
+      fases = fases && contiene(eventos, fase);
+    }
+    bool delMotor = false;
+    for (const auto &e : eventos) {
+      delMotor = delMotor || e["cat"] == motor;
+    }
+    if (!fases || !delMotor) {
+      std::cout << "  Faltan fases con " << motor << "\n";
+      todas = false;
+    }
+  }
+  printResult("Fases de los cuatro motores", todas);
+
+  Traza::escribir("build/test_traza.json");
+  std::ifstream archivo("build/test_traza.json");
+  json leida = json::parse(archivo);
+  printResult("Archivo con traceEvents",
+              leida["traceEvents"].size() > 5 &&
+                  leida["displayTimeUnit"] == "ms");
+  std::remove("build/test_traza.json");
+
+  bool lanza = false;
+  try {
+    Traza::escribir("build/no/existe/traza.json");
+  } catch (const std::runtime_error &) {
+    lanza = true;
+  }
+  printResult("Ruta no escribible rechazada", lanza);
+  Traza::desactivar();
+}
+
+// Runner para tests de la traza de fases
+void run_traza_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║      Tests Unitarios: Traza de Fases       ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_traza_tramos();
+  test_traza_hilos();
+  test_traza_solve();
+}
@@ -0,0 +1,197 @@
+/**
+ * Tests unitarios para la resolución por ventanas (horizonte rodante)
+ * Verifica el recorte de instancias, el presupuesto que pasa de una ventana
+ * a la siguiente y la reparación global
+ */
+
+#include "json_parser.h"
+#include "solver_context.h"
+#include "test_utils.h"
+#include "windowed_solver.h"
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+// Cuatro periodos de un día, listados fuera de orden cronológico
+InputData instanciaAnual() {
+  return JSONParser::parseInput(R"({
+    "medicos": ["Ana", "Luis", "Carla"],
+    "dias": ["D1", "D2", "D3", "D4"],
+    "periodos": [{"id": "P3", "dias": ["D3"]}, {"id": "P1", "dias": ["D1"]},
+                 {"id": "P4", "dias": ["D4"]}, {"id": "P2", "dias": ["D2"]}],
+    "disponibilidad": {"Ana": ["D1", "D2", "D3", "D4"],
+                       "Luis": ["D1", "D3"], "Carla": ["D2", "D4"]},
+    "maxGuardiasPorPeriodo": 1,
+    "maxGuardiasTotales": 4,
+    "medicosPorDia": 1
+  })");
+}
+
+} // namespace
+
+// Test: Recortar una ventana conserva los datos de sus días
+void test_internar_ventana() {
+  std::cout << "\n=== Test: Internar Ventana ===\n";
+
+  InputData data = JSONParser::parseInput(R"({
+    "medicos": ["Ana", "Luis"],
+    "dias": ["D1", "D2", "D3"],
+    "periodos": [{"id": "P1", "dias": ["D1", "D2"]}, {"id": "P2", "dias": ["D3"]}],
+    "disponibilidad": {"Ana": ["D1", "D2", "D3"], "Luis": ["D3"]},
+    "maxGuardiasPorPeriodo": 2,
+    "maxGuardiasTotales": 3,
+    "capacidadesPorPeriodo": {"Ana": {"P2": 1}},
+    "asignacionesFijas": {"Ana": ["D1", "D3"]},
+    "prioridadDias": {"D3": 5},
+    "roles": {"Luis": "uci"},
+    "demandaPorRol": {"D3": {"uci": 1}},
+    "demandaPorTurno": {"D2": {"dia": 1, "noche": 1}},
+    "disponibilidadPorTurno": {"Ana": {"D2": ["noche"]}}
+  })");
+  InternedInstance completa;
+  JSONParser::internInput(data, completa);
+
+  InternedInstance ventana;
+  ventana.internarVentana(completa.view(), {1}, {2}, {2, 0});
+  const InstanceView &v = ventana.view();
+  printResult("Un periodo y un día", v.numPeriodos == 1 && v.numDias == 1 &&
+                                         v.periodo(0) == "P2" &&
+                                         v.dia(0) == "D3");
+  printResult("Límite total menos lo ya asignado",
+              v.limite(0) == 1 && v.limite(1) == 3);
+  printResult("Capacidad por periodo remapeada", v.limitePeriodo(0, 0) == 1);
+  printResult("Solo la fija de la ventana",
+              v.numFijas == 1 && v.fijas[0] == 0 && v.fijas[1] == 0);
+  printResult("Prioridad y demanda por rol del día",
+              v.prioridadDia[0] == 5 && v.demandaRol(0, 0) == 0 &&
+                  v.medicosPorDia[0] == 1);
+  printResult("Sin turnos en la ventana", v.numDemandasTurno() == 0);
+
+  ventana.internarVentana(completa.view(), {0}, {0, 1}, {0, 0});
+  const InstanceView &w = ventana.view();
+  printResult("Turnos y restricciones remapeados",
+              w.numDemandasTurno() == 2 && w.tieneTurnos(1) &&
+                  !w.puedeTurno(0, 1, 0) && w.puedeTurno(0, 1, 1) &&
+                  w.medicosPorDia[1] == 2);
+}
+
+// Test: Por ventanas se cubre lo mismo si el presupuesto no es el límite
+void test_ventanas_cobertura() {
+  std::cout << "\n=== Test: Ventanas Cobertura ===\n";
+
+  InternedInstance inst;
+  JSONParser::internInput(instanciaAnual(), inst);
+
+  WindowedSolver solver;
+  ResultadoAsignacion r = solver.solve(inst.view(), 1, false);
+  printResult("Cuatro ventanas de un periodo", solver.getNumVentanas() == 4);
+  printResult("Factible y todo cubierto",
+              r.factible && r.diasCubiertos == 4 && r.diasRequeridos == 4);
+
+  // Mismo orden que un solve sin ventanas: por médico y luego por periodo
+  // en el orden de entrada (P3, P1, P4, P2)
+  SolverContext context;
+  context.load(inst.view());
+  ResultadoAsignacion completo = context.solve();
+  bool mismoOrden = r.asignaciones.size() == completo.asignaciones.size();
+  for (size_t i = 0; mismoOrden && i < r.asignaciones.size(); i++) {
+    mismoOrden = r.asignaciones[i].medico == completo.asignaciones[i].medico &&
+                 r.asignaciones[i].dia == completo.asignaciones[i].dia;
+  }
+  printResult("Mismas asignaciones y en el mismo orden que sin ventanas",
+              mismoOrden);
+
+  r = solver.solve(inst.view(), 3, false);
+  printResult("Ventana parcial al final", solver.getNumVentanas() == 2 &&
+                                              r.factible);
+}
+
+// Test: El presupuesto restante pasa a la ventana siguiente
+void test_ventanas_presupuesto() {
+  std::cout << "\n=== Test: Ventanas Presupuesto ===\n";
+
+  InputData data = instanciaAnual();
+  data.disponibilidad = {{"Ana", {"D1", "D2", "D3", "D4"}}};
+  data.maxGuardiasTotales = 2;
+  InternedInstance inst;
+  JSONParser::internInput(data, inst);
+
+  WindowedSolver solver;
+  ResultadoAsignacion r = solver.solve(inst.view(), 1, false);
+  printResult("Ana solo cubre sus dos guardias",
+              !r.factible && r.diasCubiertos == 2 &&
+                  r.asignaciones.size() == 2);
+  printResult("Se gastan en las primeras ventanas",
+              r.asignaciones.size() == 2 && r.asignaciones[0].dia == "D1" &&
+                  r.asignaciones[1].dia == "D2");
+
+  bool cuelloMedico = false;
+  for (const auto &b : r.bottlenecks) {
+    cuelloMedico |= b.tipo == "Doctor" && b.id == "Ana";
+  }
+  printResult("Ana aparece en los bottlenecks", cuelloMedico);
+}
+
+// Test: La reparación global recupera el óptimo
+void test_ventanas_reparacion() {
+  std::cout << "\n=== Test: Ventanas Reparación ===\n";
+
+  // Solo Ana puede D2; si gasta su guardia en D1, la ventana 2 queda vacía
+  InputData data = JSONParser::parseInput(R"({
+    "medicos": ["Ana", "Luis"],
+    "dias": ["D1", "D2"],
+    "periodos": [{"id": "P1", "dias": ["D1"]}, {"id": "P2", "dias": ["D2"]}],
+    "disponibilidad": {"Ana": ["D1", "D2"], "Luis": ["D1"]},
+    "maxGuardiasPorPeriodo": 1,
+    "maxGuardiasTotales": 1,
+    "medicosPorDia": 1
+  })");
+  InternedInstance inst;
+  JSONParser::internInput(data, inst);
+
+  WindowedSolver solver;
+  ResultadoAsignacion voraz = solver.solve(inst.view(), 1, false);
+  ResultadoAsignacion reparado = solver.solve(inst.view(), 1, true);
+  printResult("Sin reparación no se supera el óptimo",
+              voraz.diasCubiertos <= 2);
+  printResult("Con reparación se alcanza el óptimo",
+              reparado.factible && reparado.diasCubiertos == 2);
+  std::set<std::pair<std::string, std::string>> plan;
+  for (const auto &a : voraz.asignaciones) {
+    plan.emplace(a.medico, a.dia);
+  }
+  int cambios = plan.size();
+  for (const auto &a : reparado.asignaciones) {
+    cambios += plan.count({a.medico, a.dia}) ? -1 : 1;
+  }
+  printResult("La reparación cambia lo mínimo del plan por ventanas",
+              voraz.factible || cambios == 3);
+  printResult("Sin previas en la petición, sin bloque de estabilidad",
+              !reparado.conEstabilidad);
+
+  data.asignacionesFijas = {{"Luis", {"D1"}}};
+  JSONParser::internInput(data, inst);
+  bool lanzo = false;
+  try {
+    solver.solve(inst.view(), 1, true);
+  } catch (const std::runtime_error &) {
+    lanzo = true;
+  }
+  printResult("Reparación con fijas lanza excepción", lanzo);
+}
+
+// Runner para tests de resolución por ventanas
+void run_windowed_solver_tests() {
+  std::cout << "╔════════════════════════════════════════════╗\n";
+  std::cout << "║       Tests Unitarios: Ventanas            ║\n";
+  std::cout << "╚════════════════════════════════════════════╝\n";
+
+  test_internar_ventana();
+  test_ventanas_cobertura();
+  test_ventanas_presupuesto();
+  test_ventanas_reparacion();
+}